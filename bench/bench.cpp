@@ -0,0 +1,758 @@
+/*
+ * Benchmarks for the parsing and formatting functions.
+ *
+ * Run `make bench` from the top-level directory. Each parse benchmark reports
+ * the time per call and an `allocs/op` counter of calls to `operator new`.
+ * The corpus benchmarks read the files in `bench/corpus`: `colors.txt` has
+ * one colour per line, as collected from the theme variables of several
+ * popular CSS frameworks, and `stylesheet.css` is a typical stylesheet used
+ * by the scanner benchmarks.
+ */
+
+// CPAR_USE_LIBRARY links against libcpar instead
+#ifndef CPAR_USE_LIBRARY
+#define CPAR_IMPLEMENTATION
+#endif
+#include "cpar.h"
+
+#include <benchmark/benchmark.h>
+
+#include <algorithm>
+#include <atomic>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <new>
+#include <sstream>
+#include <string>
+#include <vector>
+
+#ifndef CPAR_BENCH_CORPUS_DIR
+#define CPAR_BENCH_CORPUS_DIR "bench/corpus"
+#endif
+
+static std::atomic<size_t> n_allocs{0};
+
+// not inlined, otherwise GCC sees malloc() paired with operator delete
+[[gnu::noinline]] void *operator new(size_t size)
+{
+  n_allocs.fetch_add(1, std::memory_order_relaxed);
+  if (void *p = std::malloc(size ? size : 1))
+    return p;
+  throw std::bad_alloc{};
+}
+
+[[gnu::noinline]] void operator delete(void *p) noexcept { std::free(p); }
+[[gnu::noinline]] void operator delete(void *p, size_t) noexcept
+{
+  std::free(p);
+}
+
+// counts allocations made while a benchmark loop runs
+class alloc_counter
+{
+public:
+  alloc_counter() : m_start{n_allocs.load()} {}
+
+  void report(benchmark::State &state) const
+  {
+    state.counters["allocs/op"] =
+        benchmark::Counter(static_cast<double>(n_allocs.load() - m_start),
+                           benchmark::Counter::kAvgIterations);
+  }
+
+private:
+  size_t m_start;
+};
+
+static std::string read_file(const char *name)
+{
+  std::ifstream in{std::string{CPAR_BENCH_CORPUS_DIR} + "/" + name};
+  if (!in) {
+    std::fprintf(stderr, "failed to open corpus file '%s'\n", name);
+    std::exit(1);
+  }
+  std::ostringstream out;
+  out << in.rdbuf();
+  return out.str();
+}
+
+static std::vector<std::string> const &corpus_colors()
+{
+  static std::vector<std::string> colors = [] {
+    std::vector<std::string> lines;
+    std::istringstream in{read_file("colors.txt")};
+    for (std::string line; std::getline(in, line);) {
+      if (!line.empty())
+        lines.push_back(line);
+    }
+    return lines;
+  }();
+  return colors;
+}
+
+static std::string const &corpus_stylesheet()
+{
+  static std::string css = read_file("stylesheet.css");
+  return css;
+}
+
+//
+// Parsing individual syntaxes
+//
+
+static void BM_parse(benchmark::State &state, const char *str)
+{
+  uint32_t value = 0;
+  alloc_counter allocs;
+  for (auto _ : state) {
+    benchmark::DoNotOptimize(str);
+    benchmark::DoNotOptimize(cpar_color_parse(str, &value));
+    benchmark::DoNotOptimize(value);
+  }
+  allocs.report(state);
+}
+
+BENCHMARK_CAPTURE(BM_parse, hex_short, "#f0c");
+BENCHMARK_CAPTURE(BM_parse, hex_medium, "#ff00cc");
+BENCHMARK_CAPTURE(BM_parse, hex_long, "#ff00cc80");
+BENCHMARK_CAPTURE(BM_parse, hex_upper, "#FF00CC");
+BENCHMARK_CAPTURE(BM_parse, rgb, "rgb(255, 0, 204)");
+BENCHMARK_CAPTURE(BM_parse, rgb_percent, "rgb(100%, 0%, 80%)");
+BENCHMARK_CAPTURE(BM_parse, rgba, "rgba(255, 0, 204, 0.5)");
+BENCHMARK_CAPTURE(BM_parse, rgba_percent, "rgba(100%, 0%, 80%, 0.5)");
+BENCHMARK_CAPTURE(BM_parse, rgb_space, "rgb(255 0 204 / 50%)");
+BENCHMARK_CAPTURE(BM_parse, hsl, "hsl(312, 100%, 40%)");
+BENCHMARK_CAPTURE(BM_parse, hsl_space, "hsl(312deg 100% 40% / 0.5)");
+BENCHMARK_CAPTURE(BM_parse, hwb, "hwb(312 0% 20%)");
+BENCHMARK_CAPTURE(BM_parse, name_short, "red");
+BENCHMARK_CAPTURE(BM_parse, name_long, "lightgoldenrodyellow");
+BENCHMARK_CAPTURE(BM_parse, name_mixed_case, "LightGoldenrodYellow");
+BENCHMARK_CAPTURE(BM_parse, name_transparent, "transparent");
+BENCHMARK_CAPTURE(BM_parse, name_miss, "notacolour");
+BENCHMARK_CAPTURE(BM_parse, error_hex_digit, "#ff00zz");
+BENCHMARK_CAPTURE(BM_parse, error_hex_length, "#ff00c");
+BENCHMARK_CAPTURE(BM_parse, error_rgb_missing, "rgb(255, 0)");
+BENCHMARK_CAPTURE(BM_parse, error_rgb_range, "rgb(256, 0, 0)");
+
+static void BM_color_string_view(benchmark::State &state)
+{
+  std::string_view str{"#ff00cc80"};
+  alloc_counter allocs;
+  for (auto _ : state) {
+    benchmark::DoNotOptimize(str);
+    cpar::color c{str};
+    benchmark::DoNotOptimize(c);
+  }
+  allocs.report(state);
+}
+
+BENCHMARK(BM_color_string_view);
+
+static void BM_color_throwing(benchmark::State &state, const char *str)
+{
+  alloc_counter allocs;
+  for (auto _ : state) {
+    benchmark::DoNotOptimize(str);
+    try {
+      cpar::color c{std::string_view{str}};
+      benchmark::DoNotOptimize(c);
+    } catch (cpar::color::error const &e) {
+      benchmark::DoNotOptimize(e.code());
+    }
+  }
+  allocs.report(state);
+}
+
+BENCHMARK_CAPTURE(BM_color_throwing, valid, "#ff00cc");
+BENCHMARK_CAPTURE(BM_color_throwing, invalid, "#ff00zz");
+
+static void BM_cpp_parse(benchmark::State &state, const char *str)
+{
+  alloc_counter allocs;
+  for (auto _ : state) {
+    benchmark::DoNotOptimize(str);
+    benchmark::DoNotOptimize(cpar::parse(str));
+  }
+  allocs.report(state);
+}
+
+BENCHMARK_CAPTURE(BM_cpp_parse, valid, "#ff00cc");
+BENCHMARK_CAPTURE(BM_cpp_parse, invalid, "#ff00zz");
+
+//
+// Corpora
+//
+
+static void BM_parse_corpus(benchmark::State &state)
+{
+  auto const &colors = corpus_colors();
+  alloc_counter allocs;
+  for (auto _ : state) {
+    for (auto const &color : colors) {
+      uint32_t value = 0;
+      benchmark::DoNotOptimize(
+          cpar_color_parse_n(color.data(), color.size(), &value));
+      benchmark::DoNotOptimize(value);
+    }
+  }
+  state.SetItemsProcessed(state.iterations() *
+                          static_cast<int64_t>(colors.size()));
+  allocs.report(state);
+}
+
+BENCHMARK(BM_parse_corpus);
+
+static void BM_parse_batch_corpus(benchmark::State &state)
+{
+  auto const &colors = corpus_colors();
+  std::vector<cpar_string> strs;
+  for (auto const &color : colors)
+    strs.push_back({color.data(), color.size()});
+  std::vector<uint32_t> results(strs.size());
+  std::vector<cpar_status> statuses(strs.size());
+  alloc_counter allocs;
+  for (auto _ : state) {
+    benchmark::DoNotOptimize(cpar_color_parse_batch(
+        strs.data(), strs.size(), results.data(), statuses.data()));
+    benchmark::ClobberMemory();
+  }
+  state.SetItemsProcessed(state.iterations() *
+                          static_cast<int64_t>(strs.size()));
+  allocs.report(state);
+}
+
+BENCHMARK(BM_parse_batch_corpus);
+
+// the corpus repeated to about a million strings, parsed with 1..N threads
+static void BM_parse_batch_parallel(benchmark::State &state)
+{
+  auto const &colors = corpus_colors();
+  std::vector<cpar_string> strs;
+  while (strs.size() < (1 << 20)) {
+    for (auto const &color : colors)
+      strs.push_back({color.data(), color.size()});
+  }
+  std::vector<uint32_t> results(strs.size());
+  std::vector<cpar_status> statuses(strs.size());
+  cpar::thread_pool pool{static_cast<unsigned>(state.range(0))};
+  cpar_executor executor = pool.executor();
+  alloc_counter allocs;
+  for (auto _ : state) {
+    benchmark::DoNotOptimize(cpar_color_parse_batch_parallel(strs.data(),
+                                                             strs.size(),
+                                                             results.data(),
+                                                             statuses.data(),
+                                                             &executor));
+    benchmark::ClobberMemory();
+  }
+  state.SetItemsProcessed(state.iterations() *
+                          static_cast<int64_t>(strs.size()));
+  allocs.report(state);
+}
+
+BENCHMARK(BM_parse_batch_parallel)
+    ->DenseRange(1,
+                 std::max(1, static_cast<int>(
+                                 std::thread::hardware_concurrency())))
+    ->UseRealTime();
+
+static void BM_cache_parse_corpus(benchmark::State &state)
+{
+  auto const &colors = corpus_colors();
+  cpar::cache cache{static_cast<size_t>(state.range(0))};
+  alloc_counter allocs;
+  for (auto _ : state) {
+    for (auto const &color : colors)
+      benchmark::DoNotOptimize(cache.parse(color));
+  }
+  auto stats = cache.stats();
+  state.counters["hit_rate"] =
+      static_cast<double>(stats.hits) /
+      static_cast<double>(stats.hits + stats.misses);
+  state.SetItemsProcessed(state.iterations() *
+                          static_cast<int64_t>(colors.size()));
+  allocs.report(state);
+}
+
+BENCHMARK(BM_cache_parse_corpus)->Arg(64)->Arg(512);
+
+// a registry of N theme colour names, looked up in a shuffled order
+static void BM_names_parse(benchmark::State &state)
+{
+  const size_t n = static_cast<size_t>(state.range(0));
+  std::vector<std::pair<std::string, uint32_t>> pairs;
+  for (size_t i = 0; i < n; i++) {
+    pairs.emplace_back("theme-colour-" + std::to_string(i),
+                       static_cast<uint32_t>(i * 2654435761u));
+  }
+  cpar::names names{pairs};
+  std::vector<std::string> inputs;
+  for (size_t i = 0; i < 1024; i++)
+    inputs.push_back(pairs[(i * 7919) % n].first);
+  alloc_counter allocs;
+  for (auto _ : state) {
+    for (auto const &input : inputs)
+      benchmark::DoNotOptimize(names.parse(input));
+  }
+  state.SetItemsProcessed(state.iterations() *
+                          static_cast<int64_t>(inputs.size()));
+  allocs.report(state);
+}
+
+BENCHMARK(BM_names_parse)->Arg(100)->Arg(5000)->Arg(100000);
+
+// building a registry, against loading its image, which doesn't depend on
+// the number of names
+static void BM_names_build(benchmark::State &state)
+{
+  std::vector<std::pair<std::string, uint32_t>> pairs;
+  for (int64_t i = 0; i < state.range(0); i++) {
+    pairs.emplace_back("theme-colour-" + std::to_string(i),
+                       static_cast<uint32_t>(i * 2654435761u));
+  }
+  for (auto _ : state) {
+    cpar::names names{pairs};
+    benchmark::DoNotOptimize(names.get());
+  }
+}
+
+BENCHMARK(BM_names_build)->Arg(100000)->Unit(benchmark::kMillisecond);
+
+static void BM_names_from_image(benchmark::State &state)
+{
+  std::vector<std::pair<std::string, uint32_t>> pairs;
+  for (int64_t i = 0; i < state.range(0); i++) {
+    pairs.emplace_back("theme-colour-" + std::to_string(i),
+                       static_cast<uint32_t>(i * 2654435761u));
+  }
+  std::string image = cpar::names{pairs}.serialize();
+  for (auto _ : state) {
+    cpar_names *names = nullptr;
+    cpar_names_from_image(image.data(), image.size(), &names);
+    benchmark::DoNotOptimize(names);
+    cpar_names_free(names);
+  }
+}
+
+BENCHMARK(BM_names_from_image)->Arg(100000);
+
+static void BM_parse_hex8_batch(benchmark::State &state)
+{
+  const size_t n = static_cast<size_t>(state.range(0));
+  std::string records;
+  for (size_t i = 0; i < n; i++) {
+    char buf[CPAR_FORMAT_MAX];
+    cpar_color_format(static_cast<uint32_t>(i * 2654435761u),
+                      CPAR_FORMAT_HEX_ALPHA,
+                      buf,
+                      sizeof(buf));
+    records += buf;
+  }
+  std::vector<uint32_t> results(n);
+  std::vector<uint64_t> invalid((n + 63) / 64);
+  for (auto _ : state) {
+    benchmark::DoNotOptimize(cpar_color_parse_hex8_batch(
+        records.data(), 9, n, results.data(), invalid.data()));
+    benchmark::ClobberMemory();
+  }
+  state.SetItemsProcessed(state.iterations() * static_cast<int64_t>(n));
+  state.SetBytesProcessed(state.iterations() *
+                          static_cast<int64_t>(records.size()));
+}
+
+BENCHMARK(BM_parse_hex8_batch)->Arg(1024)->Arg(1 << 20);
+
+static void BM_scan_stylesheet(benchmark::State &state)
+{
+  auto const &css = corpus_stylesheet();
+  alloc_counter allocs;
+  for (auto _ : state) {
+    cpar_scanner scanner;
+    cpar_token token;
+    cpar_scanner_init(&scanner);
+    cpar_scanner_feed(&scanner, css.data(), css.size());
+    cpar_scanner_end(&scanner);
+    while (cpar_scanner_next(&scanner, &token))
+      benchmark::DoNotOptimize(token);
+  }
+  state.SetBytesProcessed(state.iterations() *
+                          static_cast<int64_t>(css.size()));
+  allocs.report(state);
+}
+
+BENCHMARK(BM_scan_stylesheet);
+
+// the same, polling with a budget of state.range(0) characters
+static void BM_scan_stylesheet_poll(benchmark::State &state)
+{
+  auto const &css = corpus_stylesheet();
+  size_t budget = static_cast<size_t>(state.range(0));
+  int64_t n_polls = 0;
+  for (auto _ : state) {
+    cpar_scanner scanner;
+    cpar_token token;
+    cpar_scanner_init(&scanner);
+    cpar_scanner_feed(&scanner, css.data(), css.size());
+    cpar_scanner_end(&scanner);
+    for (;;) {
+      cpar_scan_result result = cpar_scanner_poll(&scanner, budget, &token);
+      n_polls++;
+      if (result == CPAR_SCAN_END)
+        break;
+      benchmark::DoNotOptimize(token);
+    }
+  }
+  state.SetBytesProcessed(state.iterations() *
+                          static_cast<int64_t>(css.size()));
+  state.counters["polls"] = benchmark::Counter(
+      static_cast<double>(n_polls), benchmark::Counter::kAvgIterations);
+}
+
+BENCHMARK(BM_scan_stylesheet_poll)->Arg(256)->Arg(64 * 1024);
+
+//
+// Pixel conversions
+//
+
+static std::vector<uint32_t> pixel_buffer(size_t n)
+{
+  std::vector<uint32_t> colors(n);
+  for (size_t i = 0; i < n; i++)
+    colors[i] = static_cast<uint32_t>(i * 2654435761u);
+  return colors;
+}
+
+static void BM_pixels(benchmark::State &state,
+                      void (*kernel)(uint32_t *, size_t))
+{
+  auto colors = pixel_buffer(static_cast<size_t>(state.range(0)));
+  for (auto _ : state) {
+    kernel(colors.data(), colors.size());
+    benchmark::ClobberMemory();
+  }
+  state.SetItemsProcessed(state.iterations() *
+                          static_cast<int64_t>(colors.size()));
+  state.SetBytesProcessed(state.iterations() *
+                          static_cast<int64_t>(colors.size() * 4));
+}
+
+static void pixels_to_bgra(uint32_t *data, size_t n)
+{
+  cpar_pixels_from_colors(data, n, CPAR_PIXEL_BGRA8);
+}
+
+BENCHMARK_CAPTURE(BM_pixels, to_bgra, pixels_to_bgra)
+    ->Arg(1024)
+    ->Arg(1 << 22);
+BENCHMARK_CAPTURE(BM_pixels, premultiply, cpar_colors_premultiply)
+    ->Arg(1024)
+    ->Arg(1 << 22);
+BENCHMARK_CAPTURE(BM_pixels, unpremultiply, cpar_colors_unpremultiply)
+    ->Arg(1024)
+    ->Arg(1 << 22);
+BENCHMARK_CAPTURE(BM_pixels, srgb_to_linear, cpar_colors_srgb_to_linear)
+    ->Arg(1024)
+    ->Arg(1 << 22);
+
+static void BM_memcpy(benchmark::State &state)
+{
+  auto colors = pixel_buffer(static_cast<size_t>(state.range(0)));
+  std::vector<uint32_t> copy(colors.size());
+  for (auto _ : state) {
+    std::memcpy(copy.data(), colors.data(), colors.size() * 4);
+    benchmark::ClobberMemory();
+  }
+  state.SetBytesProcessed(state.iterations() *
+                          static_cast<int64_t>(colors.size() * 4));
+}
+
+// for comparison with the in-place pixel conversions
+BENCHMARK(BM_memcpy)->Arg(1 << 22);
+
+//
+// Name lookup and formatting
+//
+
+static void BM_lookup_color_name(benchmark::State &state, uint32_t value)
+{
+  for (auto _ : state) {
+    benchmark::DoNotOptimize(value);
+    benchmark::DoNotOptimize(cpar_lookup_color_name(value));
+  }
+}
+
+BENCHMARK_CAPTURE(BM_lookup_color_name, hit, 0x20b2aaffu);
+BENCHMARK_CAPTURE(BM_lookup_color_name, miss, 0x123456ffu);
+
+static const char palette[] =
+    "red, #0f0, rgba(0,0,255,.5), hsl(120deg 50% 50%), cornflowerblue, "
+    "#336699cc, rgb(12 34 56 / 75%), transparent, hwb(200 10% 20%), tan";
+
+// the usual way, splitting into strings first
+static void BM_parse_list_split(benchmark::State &state)
+{
+  alloc_counter allocs;
+  for (auto _ : state) {
+    std::vector<std::string> entries;
+    std::string entry;
+    int depth = 0;
+    for (const char *p = palette; *p; p++) {
+      if (*p == ',' && depth == 0) {
+        entries.push_back(entry);
+        entry.clear();
+        continue;
+      }
+      depth += *p == '(' ? 1 : *p == ')' ? -1 : 0;
+      if (*p != ' ' || depth > 0)
+        entry += *p;
+    }
+    entries.push_back(entry);
+    std::vector<uint32_t> values;
+    for (auto const &e : entries)
+      values.push_back(cpar::parse(e).value_or(cpar::color{}));
+    benchmark::DoNotOptimize(values.data());
+  }
+  state.SetItemsProcessed(state.iterations() * 10);
+  allocs.report(state);
+}
+
+BENCHMARK(BM_parse_list_split);
+
+static void BM_parse_list(benchmark::State &state)
+{
+  unsigned char buffer[1024];
+  cpar::arena arena{buffer, sizeof(buffer)};
+  alloc_counter allocs;
+  for (auto _ : state) {
+    cpar::color_list colors = cpar::parse_list(palette, arena);
+    benchmark::DoNotOptimize(colors.data());
+    arena.clear();
+  }
+  state.SetItemsProcessed(state.iterations() * 10);
+  allocs.report(state);
+}
+
+BENCHMARK(BM_parse_list);
+
+static std::vector<uint32_t> random_colors(size_t n)
+{
+  std::vector<uint32_t> values;
+  uint32_t seed = 42;
+  for (size_t i = 0; i < n; i++) {
+    seed = seed * 1664525 + 1013904223;
+    values.push_back(seed | 0xff);
+  }
+  return values;
+}
+
+static void BM_nearest_color_name(benchmark::State &state, cpar_metric metric)
+{
+  std::vector<uint32_t> values = random_colors(1024);
+  for (auto _ : state) {
+    for (uint32_t value : values)
+      benchmark::DoNotOptimize(cpar_nearest_color_name(value, metric));
+  }
+  state.SetItemsProcessed(state.iterations() *
+                          static_cast<int64_t>(values.size()));
+}
+
+BENCHMARK_CAPTURE(BM_nearest_color_name, rgb, CPAR_METRIC_RGB);
+BENCHMARK_CAPTURE(BM_nearest_color_name, oklab, CPAR_METRIC_OKLAB);
+
+// an image-like array, where neighbouring pixels are often the same
+static void BM_nearest_named_colors(benchmark::State &state,
+                                    cpar_metric metric)
+{
+  std::vector<uint32_t> values;
+  for (uint32_t value : random_colors(1024))
+    values.insert(values.end(), 4, value);
+  std::vector<uint32_t> nearest(values.size());
+  for (auto _ : state) {
+    cpar_nearest_named_colors(
+        values.data(), values.size(), metric, nearest.data());
+    benchmark::DoNotOptimize(nearest.data());
+  }
+  state.SetItemsProcessed(state.iterations() *
+                          static_cast<int64_t>(values.size()));
+}
+
+BENCHMARK_CAPTURE(BM_nearest_named_colors, rgb, CPAR_METRIC_RGB);
+BENCHMARK_CAPTURE(BM_nearest_named_colors, oklab, CPAR_METRIC_OKLAB);
+
+// a colour space conversion of 4096 colours, all at once or one at a time
+static void BM_to_space(benchmark::State &state, cpar_color_space space)
+{
+  std::vector<uint32_t> colors = random_colors(4096);
+  std::vector<float> out(4 * colors.size());
+  for (auto _ : state) {
+    cpar_colors_to_space(colors.data(), colors.size(), space, out.data());
+    benchmark::DoNotOptimize(out.data());
+  }
+  state.SetItemsProcessed(state.iterations() *
+                          static_cast<int64_t>(colors.size()));
+}
+
+BENCHMARK_CAPTURE(BM_to_space, linear, CPAR_SPACE_LINEAR_SRGB);
+BENCHMARK_CAPTURE(BM_to_space, hsl, CPAR_SPACE_HSL);
+BENCHMARK_CAPTURE(BM_to_space, oklab, CPAR_SPACE_OKLAB);
+
+template <typename Space>
+static void BM_to_space_single(benchmark::State &state,
+                               Space (*convert)(cpar::color))
+{
+  std::vector<uint32_t> colors = random_colors(4096);
+  std::vector<Space> out(colors.size());
+  for (auto _ : state) {
+    for (size_t i = 0; i < colors.size(); i++)
+      out[i] = convert(cpar::color{colors[i]});
+    benchmark::DoNotOptimize(out.data());
+  }
+  state.SetItemsProcessed(state.iterations() *
+                          static_cast<int64_t>(colors.size()));
+}
+
+BENCHMARK_CAPTURE(BM_to_space_single, linear, cpar::to_linear_rgb);
+BENCHMARK_CAPTURE(BM_to_space_single, hsl, cpar::to_hsl);
+BENCHMARK_CAPTURE(BM_to_space_single, oklab, cpar::to_oklab);
+
+static void BM_from_space(benchmark::State &state, cpar_color_space space)
+{
+  std::vector<uint32_t> colors = random_colors(4096);
+  std::vector<float> in(4 * colors.size());
+  cpar_colors_to_space(colors.data(), colors.size(), space, in.data());
+  for (auto _ : state) {
+    cpar_colors_from_space(in.data(), colors.size(), space, colors.data());
+    benchmark::DoNotOptimize(colors.data());
+  }
+  state.SetItemsProcessed(state.iterations() *
+                          static_cast<int64_t>(colors.size()));
+}
+
+BENCHMARK_CAPTURE(BM_from_space, linear, CPAR_SPACE_LINEAR_SRGB);
+BENCHMARK_CAPTURE(BM_from_space, hsl, CPAR_SPACE_HSL);
+BENCHMARK_CAPTURE(BM_from_space, oklab, CPAR_SPACE_OKLAB);
+
+template <typename Space>
+static void BM_from_space_single(benchmark::State &state, Space const &)
+{
+  std::vector<uint32_t> colors = random_colors(4096);
+  std::vector<Space> in(colors.size());
+  cpar::convert(colors.data(), colors.size(), in.data());
+  for (auto _ : state) {
+    for (size_t i = 0; i < colors.size(); i++)
+      colors[i] = cpar::to_color(in[i]);
+    benchmark::DoNotOptimize(colors.data());
+  }
+  state.SetItemsProcessed(state.iterations() *
+                          static_cast<int64_t>(colors.size()));
+}
+
+BENCHMARK_CAPTURE(BM_from_space_single, linear, cpar::linear_rgb{});
+BENCHMARK_CAPTURE(BM_from_space_single, hsl, cpar::hsl{});
+BENCHMARK_CAPTURE(BM_from_space_single, oklab, cpar::oklab{});
+
+static void BM_contrast_ratio(benchmark::State &state)
+{
+  std::vector<uint32_t> fg = random_colors(4096), bg = fg;
+  std::reverse(bg.begin(), bg.end());
+  std::vector<float> ratios(fg.size());
+  for (auto _ : state) {
+    for (size_t i = 0; i < fg.size(); i++)
+      ratios[i] = cpar_contrast_ratio(fg[i], bg[i]);
+    benchmark::DoNotOptimize(ratios.data());
+  }
+  state.SetItemsProcessed(state.iterations() *
+                          static_cast<int64_t>(fg.size()));
+}
+
+BENCHMARK(BM_contrast_ratio);
+
+static void BM_contrast_ratios(benchmark::State &state)
+{
+  std::vector<uint32_t> fg = random_colors(4096), bg = fg;
+  std::reverse(bg.begin(), bg.end());
+  std::vector<float> ratios(fg.size());
+  for (auto _ : state) {
+    cpar_contrast_ratios(fg.data(), bg.data(), fg.size(), ratios.data());
+    benchmark::DoNotOptimize(ratios.data());
+  }
+  state.SetItemsProcessed(state.iterations() *
+                          static_cast<int64_t>(fg.size()));
+}
+
+BENCHMARK(BM_contrast_ratios);
+
+static void BM_contrast_check(benchmark::State &state)
+{
+  std::vector<uint32_t> fg = random_colors(4096), bg = fg;
+  std::reverse(bg.begin(), bg.end());
+  std::vector<uint64_t> pass(fg.size() / 64);
+  for (auto _ : state) {
+    benchmark::DoNotOptimize(cpar_contrast_check(
+        fg.data(), bg.data(), fg.size(), CPAR_CONTRAST_AA, pass.data()));
+    benchmark::ClobberMemory();
+  }
+  state.SetItemsProcessed(state.iterations() *
+                          static_cast<int64_t>(fg.size()));
+}
+
+BENCHMARK(BM_contrast_check);
+
+static void BM_to_string(benchmark::State &state)
+{
+  cpar::color c{0x20b2aa80u};
+  alloc_counter allocs;
+  for (auto _ : state) {
+    benchmark::DoNotOptimize(c);
+    std::string str = cpar::to_string(c);
+    benchmark::DoNotOptimize(str);
+  }
+  allocs.report(state);
+}
+
+BENCHMARK(BM_to_string);
+
+static void BM_color_format(benchmark::State &state, cpar_format format)
+{
+  uint32_t value = 0x20b2aa80u;
+  char buf[CPAR_FORMAT_MAX];
+  for (auto _ : state) {
+    benchmark::DoNotOptimize(value);
+    benchmark::DoNotOptimize(
+        cpar_color_format(value, format, buf, sizeof(buf)));
+    benchmark::ClobberMemory();
+  }
+}
+
+BENCHMARK_CAPTURE(BM_color_format, hex, CPAR_FORMAT_HEX);
+BENCHMARK_CAPTURE(BM_color_format, hex_alpha, CPAR_FORMAT_HEX_ALPHA);
+BENCHMARK_CAPTURE(BM_color_format, rgb, CPAR_FORMAT_RGB);
+BENCHMARK_CAPTURE(BM_color_format, shortest, CPAR_FORMAT_SHORTEST);
+
+static void BM_color_format_corpus(benchmark::State &state)
+{
+  std::vector<uint32_t> values;
+  for (auto const &color : corpus_colors()) {
+    uint32_t value = 0;
+    if (cpar_color_parse_n(color.data(), color.size(), &value) ==
+        CPAR_STATUS_OK) {
+      values.push_back(value);
+    }
+  }
+  char buf[CPAR_FORMAT_MAX];
+  for (auto _ : state) {
+    for (uint32_t value : values) {
+      benchmark::DoNotOptimize(
+          cpar_color_format(value, CPAR_FORMAT_SHORTEST, buf, sizeof(buf)));
+      benchmark::ClobberMemory();
+    }
+  }
+  state.SetItemsProcessed(state.iterations() *
+                          static_cast<int64_t>(values.size()));
+}
+
+BENCHMARK(BM_color_format_corpus);
+
+BENCHMARK_MAIN();
@@ -0,0 +1,7 @@
+/*
+ * The implementation of cpar.h, for building cpar as a library instead of
+ * defining CPAR_IMPLEMENTATION in one of your own source files.
+ */
+
+#define CPAR_IMPLEMENTATION
+#include "cpar.h"
@@ -10,10 +10,16 @@
  *
  * In exactly one source file, define the @a CPAR_IMPLEMENTATION macro before
  * including this header to include the implementation code.
+ * Alternatively, link against the library built from `src/cpar.c` by the
+ * Makefile or CMake, which compiles it with optimization and LTO.
  *
  * If you want to translate the error strings, define the @a CPAR_T()
  * function-like macro to call whatever translation function/macro is needed.
  * For example with gettext, you might define `#define CPAR_T(x) _(x)`.
+ *
+ * The few functions which allocate memory use `malloc()` and `free()`. To
+ * use another allocator, define both the @a CPAR_MALLOC() and
+ * @a CPAR_FREE() function-like macros.
  */
 
 #ifndef CPAR_H
@@ -23,6 +29,7 @@
 extern "C" {
 #endif
 
+#include <stddef.h>
 #include <stdint.h>
 
 /**
@@ -34,10 +41,11 @@ enum cpar_status {
   /** A supplied parameter did not meet preconditions, for example it was @c
    * NULL. */
   CPAR_STATUS_INVALID_PARAMETER,
-  /** The supplied string was too large to fit into the working buffer. */
+  /** No longer returned, since there is no limit on the length of colour
+   * strings. Kept so that the other codes keep their values. */
   CPAR_STATUS_TOO_BIG,
   /** One of the numeric components in the colour string failed to parse, for
-   * example by the `strtol()` function. */
+   * example because it contains a character which isn't a digit. */
   CPAR_STATUS_INVALID_NUMBER,
   /** One of the numeric components in the colour string was outside of the
    * allowable range, for example larger than 255 for RGB components. */
@@ -47,6 +55,14 @@ enum cpar_status {
   CPAR_STATUS_SYNTAX_ERROR,
   /** Tried and failed to find a color name match. */
   CPAR_STATUS_NO_COLOR_NAME,
+  /** Memory couldn't be allocated. */
+  CPAR_STATUS_NO_MEMORY,
+  /** A file couldn't be read. */
+  CPAR_STATUS_IO_ERROR,
+  /** A colour name was given twice, see @a cpar_names_new(). */
+  CPAR_STATUS_DUPLICATE_NAME,
+  /** The colour names couldn't be hashed apart, see @a cpar_names_new(). */
+  CPAR_STATUS_NO_PERFECT_HASH,
 };
 
 /**
@@ -64,12 +80,65 @@ const char *cpar_strerror(enum cpar_status status);
 /**
  * Lookup the name of a colour, if any.
  *
+ * Some colours have more than one name, for example `aqua` and `cyan` or
+ * `gray` and `grey`. In that case the name which comes first alphabetically
+ * is returned, so `aqua`, `fuchsia`, `gray`, `darkgray` and so on.
+ *
  * @param value The colour value.
  * @returns The name of the colour, or @c NULL if no name was found for the
  *          given colour value.
  */
 const char *cpar_lookup_color_name(uint32_t value);
 
+/**
+ * How the distance between colours is measured when looking for the nearest
+ * named colour.
+ */
+enum cpar_metric {
+  /** Euclidean distance between the 8-bit sRGB components, quick but not
+   * very close to how different the colours look. */
+  CPAR_METRIC_RGB,
+  /** Euclidean distance in the OKLab colour space, which is close to how
+   * different colours look. */
+  CPAR_METRIC_OKLAB,
+};
+
+/**
+ * Finds the named colour which is nearest to a colour.
+ *
+ * The alpha component of @a value is ignored and only the opaque named
+ * colours are considered. Where a colour has more than one name, the name
+ * returned is the same as @a cpar_lookup_color_name() returns, and where
+ * several colours are equally near, the one with the smallest value wins.
+ * Each search only measures the distance to the few named colours which can
+ * be nearest to colours in that part of the colour space.
+ *
+ * @param value The colour value.
+ * @param metric How to measure the distance between colours.
+ *
+ * @returns The name of the nearest named colour, or @c NULL if @a metric is
+ *          not valid.
+ */
+const char *cpar_nearest_color_name(uint32_t value, enum cpar_metric metric);
+
+/**
+ * Finds the nearest named colour for each of an array of colours, like
+ * @a cpar_nearest_color_name().
+ *
+ * Runs of the same colour are only searched once.
+ *
+ * @param values The colour values.
+ * @param n The number of colour values.
+ * @param metric How to measure the distance between colours.
+ * @param nearest Where to store the value of each nearest named colour,
+ *                which can be the same array as @a values. Left unchanged
+ *                if @a metric is not valid.
+ */
+void cpar_nearest_named_colors(const uint32_t *values,
+                               size_t n,
+                               enum cpar_metric metric,
+                               uint32_t *nearest);
+
 /**
  * Parses a subset of CSS colours into a 32-bit integer.
  *
@@ -79,669 +148,8713 @@ const char *cpar_lookup_color_name(uint32_t value);
  *   * `#f00`
  *   * `#ff0000`
  *   * `#ff0000ff`
- *   * `rgb(255,0,0)`
- *   * `rgba(255,0,0,1)`
+ *   * `rgb(255,0,0)` or `rgb(255 0 0)`
+ *   * `rgba(255,0,0,1)` or `rgba(255 0 0 / 100%)`
+ *   * `hsl(0,100%,50%)` or `hsl(0deg 100% 50%)`
+ *   * `hsla(0,100%,50%,1)` or `hsla(0 100% 50% / 1)`
+ *   * `hwb(0 0% 0%)`
  *   * red
  *
+ * As in CSS Color Level 4, the space-separated syntax takes an optional
+ * alpha after a `/`, whether or not the function name ends in `a`, and hues
+ * can have a `deg`, `grad`, `rad` or `turn` unit. Alpha can be a number or
+ * a percentage. Unlike CSS, out of range components are errors rather than
+ * being clamped. The HSL and HWB conversions use integer arithmetic and are
+ * exact to within rounding of the result.
+ *
  * The @a result parameter can be @c NULL if only want to see whether the
  * colour string can be parsed successfully but don't need the actual value.
  *
  * If no other syntax is recognized, the string is looked up in a table of
  * colour names to see if it's a pre-defined colour.
  *
+ * This function is safe to call concurrently from multiple threads. It keeps
+ * no global state of its own, except that it updates the global statistics
+ * counters when the library is built with @a CPAR_ENABLE_STATS.
+ *
  * @param color_str The string to parse.
  * @param result Pointer to integer to store the parsed result in.
  *
- * @returns `true` on success, `false` on error. Check `errno` for the reason.
+ * @returns @a CPAR_STATUS_OK on success or another status code on error.
  */
 enum cpar_status cpar_color_parse(const char *color_str, uint32_t *result);
 
 /**
- * Extracts the red component from an RGBA 32-bit integer.
+ * Parses a colour string given as a pointer and length.
  *
- * @param c The 32-bit integer color.
- * @returns The 8-bit red component.
+ * This works like @a cpar_color_parse() except that @a color_str doesn't need
+ * to be zero-terminated, so colours can be parsed directly out of larger
+ * buffers such as memory-mapped files without copying the token first. The
+ * string must not contain embedded NUL characters.
+ *
+ * @param color_str The start of the string to parse.
+ * @param color_str_len The number of characters in @a color_str.
+ * @param result Pointer to integer to store the parsed result in, can be
+ *               @c NULL.
+ *
+ * @returns @a CPAR_STATUS_OK on success or another status code on error.
  */
-#define CPAR_COLOR_RED(c) ((uint8_t)(((uint32_t)(c) >> 24) & 0xFF))
+enum cpar_status cpar_color_parse_n(const char *color_str,
+                                    size_t color_str_len,
+                                    uint32_t *result);
 
 /**
- * Extracts the green component from an RGBA 32-bit integer.
- *
- * @param c The 32-bit integer color.
- * @returns The 8-bit green component.
+ * Output formats for @a cpar_color_format().
  */
-#define CPAR_COLOR_GREEN(c) ((uint8_t)(((uint32_t)(c) >> 16) & 0xFF))
+enum cpar_format {
+  /** `#rrggbb`, or `#rrggbbaa` if the colour isn't fully opaque. */
+  CPAR_FORMAT_HEX,
+  /** `#rrggbbaa`, always including the alpha component. */
+  CPAR_FORMAT_HEX_ALPHA,
+  /** `rgb(r,g,b)`, or `rgba(r,g,b,a)` if the colour isn't fully opaque. */
+  CPAR_FORMAT_RGB,
+  /** The shortest of the colour's name, `#rgb` or @a CPAR_FORMAT_HEX. */
+  CPAR_FORMAT_SHORTEST,
+};
 
 /**
- * Extracts the blue component from an RGBA 32-bit integer.
+ * The size of a buffer big enough to hold any string produced by
+ * @a cpar_color_format(), including the zero-terminator.
+ */
+#define CPAR_FORMAT_MAX 24
+
+/**
+ * Formats a colour as a string which @a cpar_color_parse() can parse back to
+ * the same value.
  *
- * @param c The 32-bit integer color.
- * @returns The 8-bit blue component.
+ * This behaves like `snprintf()`: at most @a buf_len - 1 characters are
+ * written followed by a zero-terminator, and the return value is the length
+ * of the whole formatted string, so if it's not less than @a buf_len the
+ * output was truncated. A buffer of @a CPAR_FORMAT_MAX characters is always
+ * big enough.
+ *
+ * @param value The colour value.
+ * @param format The format to produce.
+ * @param buf The buffer to write to, can be @c NULL if @a buf_len is 0.
+ * @param buf_len The size of @a buf.
+ *
+ * @returns The length of the formatted string, not counting the
+ *          zero-terminator.
  */
-#define CPAR_COLOR_BLUE(c) ((uint8_t)(((uint32_t)(c) >> 8) & 0xFF))
+size_t cpar_color_format(uint32_t value,
+                         enum cpar_format format,
+                         char *buf,
+                         size_t buf_len);
 
 /**
- * Extracts the alpha component from an RGBA 32-bit integer.
+ * A string given as a pointer and length, which need not be zero-terminated.
+ */
+struct cpar_string {
+  /** The first character of the string. */
+  const char *str;
+  /** The number of characters in the string. */
+  size_t len;
+};
+
+/**
+ * Parses an array of colour strings.
  *
- * @param c The 32-bit integer color.
- * @returns The 8-bit alpha component.
+ * This gives the same results as calling @a cpar_color_parse_n() on each
+ * string in turn, but avoids repeating the per-call setup, so it's the
+ * preferred way to parse large numbers of colours.
+ *
+ * Entries of @a results are only written for strings that parse successfully,
+ * the rest are left unchanged.
+ *
+ * @param strs The array of strings to parse.
+ * @param n_strs The number of strings in @a strs.
+ * @param results Array of @a n_strs integers to store the parsed results in,
+ *                can be @c NULL.
+ * @param statuses Array of @a n_strs status codes to store the status of
+ *                 each string in, can be @c NULL.
+ *
+ * @returns The number of strings that were parsed successfully.
  */
-#define CPAR_COLOR_ALPHA(c) ((uint8_t)((uint32_t)(c)&0xFF))
+size_t cpar_color_parse_batch(const struct cpar_string *strs,
+                              size_t n_strs,
+                              uint32_t *results,
+                              enum cpar_status *statuses);
 
 /**
- * Packs the 8-bit RGBA components into 32-bit integer.
+ * Decodes an array of fixed-width `#rrggbbaa` colours.
  *
- * @param r The red component.
- * @param g The green component.
- * @param b The blue component.
- * @param a The alpha component.
+ * This is a much faster alternative to @a cpar_color_parse_batch() for
+ * columns of colours which are already normalized to the long hex form, for
+ * example in generated manifests. Each record must be exactly a `#` followed
+ * by eight hex digits, with no whitespace. Depending on the CPU, it uses
+ * AVX2, SSSE3 or NEON to decode several records at a time, with a portable
+ * fallback.
  *
- * @returns The 4 8-bit components packed into a single 32-bit integer.
+ * Records that aren't valid are flagged in @a invalid and their entry in
+ * @a results is unspecified. Those can be passed to @a cpar_color_parse_n()
+ * to get their value or status, since they may still be valid in another
+ * syntax.
+ *
+ * @param strs The first record.
+ * @param stride The distance in bytes from the start of one record to the
+ *               start of the next, at least 9.
+ * @param n_strs The number of records.
+ * @param results Array of @a n_strs integers to store the decoded results in.
+ * @param invalid Array of `(n_strs + 63) / 64` bitmasks where bit `i % 64`
+ *                of element `i / 64` is set if record `i` is invalid, can be
+ *                @c NULL.
+ *
+ * @returns The number of invalid records.
  */
-#define CPAR_COLOR_MAKE(r, g, b, a)          \
-  (((uint32_t)(r) << 24) & 0xFF000000) |     \
-      (((uint32_t)(g) << 16) & 0x00FF0000) | \
-      (((uint32_t)(b) << 8) & 0x0000FF00) | ((uint32_t)(a)&0x000000FF)
+size_t cpar_color_parse_hex8_batch(const char *strs,
+                                   size_t stride,
+                                   size_t n_strs,
+                                   uint32_t *results,
+                                   uint64_t *invalid);
 
-#ifdef __cplusplus
-} // extern "C"
-#endif
+/**
+ * Runs the tasks of a parallel batch call, normally on a thread pool.
+ * @a cpar::thread_pool provides one for C++, unless @a CPAR_NO_THREAD_POOL
+ * is defined to leave it and the threading headers it needs out.
+ */
+struct cpar_executor {
+  /**
+   * Calls `task(arg, i)` once for each `i` from 0 to `n_tasks - 1`, and
+   * returns once all of the calls have finished. The calls may run in any
+   * order and on any threads, including the calling one.
+   */
+  void (*run)(void *user_data,
+              void (*task)(void *arg, size_t index),
+              void *arg,
+              size_t n_tasks);
+  /** Passed to @a run. */
+  void *user_data;
+};
 
-#ifdef __cplusplus
+/**
+ * The smallest number of strings which @a cpar_color_parse_batch_parallel()
+ * gives to one task, enough to make the cost of scheduling a task small.
+ */
+#define CPAR_PARALLEL_CHUNK 4096
 
-#include <cstdio>
-#include <ostream>
-#include <stdexcept>
-#include <string>
+/**
+ * The most tasks which @a cpar_color_parse_batch_parallel() splits a batch
+ * into. Larger batches get larger tasks.
+ */
+#define CPAR_PARALLEL_MAX_TASKS 1024
 
-namespace cpar
-{
+/**
+ * Parses an array of colour strings using several threads.
+ *
+ * This gives the same results as @a cpar_color_parse_batch(), but splits
+ * the array into chunks of at least @a CPAR_PARALLEL_CHUNK strings and runs
+ * them as tasks of @a executor. Each task writes directly to its own part
+ * of @a results and @a statuses, so there are no locks and nothing is
+ * allocated.
+ *
+ * @param strs The array of strings to parse.
+ * @param n_strs The number of strings in @a strs.
+ * @param results As for @a cpar_color_parse_batch().
+ * @param statuses As for @a cpar_color_parse_batch().
+ * @param executor Runs the tasks, if it's @c NULL or the batch is small
+ *                 then the strings are parsed on the calling thread.
+ *
+ * @returns The number of strings that were parsed successfully.
+ */
+size_t cpar_color_parse_batch_parallel(const struct cpar_string *strs,
+                                       size_t n_strs,
+                                       uint32_t *results,
+                                       enum cpar_status *statuses,
+                                       const struct cpar_executor *executor);
 
-  struct color {
+/**
+ * The longest token a @a cpar_scanner will recognize. Longer colour strings,
+ * for example `rgb()` with lots of whitespace, are skipped.
+ */
+#define CPAR_SCANNER_TOKEN_MAX 64
 
-    class error : public std::runtime_error
-    {
-    public:
-      error(cpar_status code, const char *what)
-          : std::runtime_error{what},
-            m_code{code}
-      {
-      }
+/**
+ * A colour found by @a cpar_scanner_next().
+ */
+struct cpar_token {
+  /** The offset of the token's first character from the start of input. */
+  uint64_t offset;
+  /** The number of characters in the token. */
+  size_t length;
+  /** The parsed colour value. */
+  uint32_t value;
+};
 
-      cpar_status code() const noexcept { return m_code; }
+/**
+ * State for scanning colours out of text, such as a stylesheet, which is
+ * supplied in chunks.
+ *
+ * The scanner finds hex colours, the `rgb()`, `rgba()`, `hsl()`, `hsla()`
+ * and `hwb()` functions and colour names that make up whole words, and
+ * reports each one that parses successfully along with its position.
+ * Tokens may be split across chunks, the scanner keeps the part it has
+ * already seen so the whole input never needs to be in memory at once. No
+ * memory is allocated.
+ *
+ * Usage looks like:
+ *
+ * ```
+ * struct cpar_scanner scanner;
+ * struct cpar_token token;
+ * cpar_scanner_init(&scanner);
+ * while ((len = read(fd, buf, sizeof(buf))) > 0) {
+ *   cpar_scanner_feed(&scanner, buf, len);
+ *   while (cpar_scanner_next(&scanner, &token))
+ *     use(&token);
+ * }
+ * cpar_scanner_end(&scanner);
+ * while (cpar_scanner_next(&scanner, &token))
+ *   use(&token);
+ * ```
+ *
+ * An event loop which mustn't be held up by a large chunk can use
+ * @a cpar_scanner_poll() instead of @a cpar_scanner_next(), which scans at
+ * most a given number of characters per call:
+ *
+ * ```
+ * // called whenever the loop is idle, or input arrives
+ * for (;;) {
+ *   switch (cpar_scanner_poll(&scanner, 64 * 1024, &token)) {
+ *   case CPAR_SCAN_COLOR:
+ *     use(&token);
+ *     continue;
+ *   case CPAR_SCAN_YIELD:
+ *     return schedule_again();
+ *   case CPAR_SCAN_NEED_INPUT:
+ *     return wait_for_input(); // then feed, or end at EOF
+ *   case CPAR_SCAN_END:
+ *     return done();
+ *   }
+ * }
+ * ```
+ *
+ * Scanning is purely lexical, so for example a CSS id selector like `#add`
+ * will be reported as a colour. As in CSS, the contents of `url()` are
+ * skipped.
+ *
+ * The members are private, use the functions to access the scanner.
+ */
+struct cpar_scanner {
+  const char *input;
+  size_t input_len;
+  size_t input_pos;
+  uint64_t offset;
+  uint64_t token_offset;
+  size_t token_len;
+  int state;
+  int at_end;
+  char token[CPAR_SCANNER_TOKEN_MAX];
+};
 
-    private:
-      cpar_status m_code;
-    };
+/**
+ * Initializes a scanner to the start of a new input.
+ *
+ * @param scanner The scanner to initialize.
+ */
+void cpar_scanner_init(struct cpar_scanner *scanner);
 
-    uint32_t value;
+/**
+ * Supplies the next chunk of input to a scanner.
+ *
+ * The previous chunk must have been used up, by calling
+ * @a cpar_scanner_next() until it returns zero, and @a chunk must stay valid
+ * until the same is true of it.
+ *
+ * @param scanner The scanner.
+ * @param chunk The next part of the input.
+ * @param chunk_len The number of characters in @a chunk.
+ */
+void cpar_scanner_feed(struct cpar_scanner *scanner,
+                       const char *chunk,
+                       size_t chunk_len);
 
-    constexpr color(uint32_t value) noexcept : value{value} {}
+/**
+ * Tells a scanner that there is no more input, so that a colour at the very
+ * end can be reported by the following call to @a cpar_scanner_next().
+ *
+ * @param scanner The scanner.
+ */
+void cpar_scanner_end(struct cpar_scanner *scanner);
 
-    constexpr color(uint8_t r = 0,
-                    uint8_t g = 0,
-                    uint8_t b = 0,
-                    uint8_t a = 255) noexcept
-        : value{CPAR_COLOR_MAKE(r, g, b, a)}
-    {
-    }
+/**
+ * Finds the next colour in the input.
+ *
+ * @param scanner The scanner.
+ * @param token Location to store the colour that was found.
+ *
+ * @returns 1 if a colour was found and stored in @a token, or 0 if more
+ *          input needs to be supplied (or the input has ended).
+ */
+int cpar_scanner_next(struct cpar_scanner *scanner, struct cpar_token *token);
 
-    color(std::string const &str) : value{0x000000ff}
-    {
-      if (cpar_status status = cpar_color_parse(str.c_str(), &value);
-          status != CPAR_STATUS_OK) {
-        throw error{status, cpar_strerror(status)};
-      }
-    }
+/**
+ * The results of @a cpar_scanner_poll().
+ */
+enum cpar_scan_result {
+  /** A colour was found and stored in the token. */
+  CPAR_SCAN_COLOR,
+  /** The budget ran out before the end of the chunk, call again to go on. */
+  CPAR_SCAN_YIELD,
+  /** The chunk is used up, so feed the next one or end the input. */
+  CPAR_SCAN_NEED_INPUT,
+  /** The input has ended and every colour in it was found. */
+  CPAR_SCAN_END,
+};
 
-    constexpr operator uint32_t() const noexcept { return value; }
+/**
+ * Finds the next colour in the input like @a cpar_scanner_next(), but
+ * moves past at most @a budget characters of the chunk, so that the time
+ * each call takes is bounded however long the chunk is. A colour can still
+ * be reported once the budget is used up, since parsing it takes time
+ * bounded by @a CPAR_SCANNER_TOKEN_MAX.
+ *
+ * Polling and @a cpar_scanner_next() can be mixed on the same scanner. As
+ * for that, the next chunk may only be fed once this has returned
+ * @a CPAR_SCAN_NEED_INPUT.
+ *
+ * @param scanner The scanner.
+ * @param budget The most characters to move past, or 0 for no limit.
+ * @param token Location to store the colour that was found.
+ *
+ * @returns Whether a colour was found, or else why not.
+ */
+enum cpar_scan_result cpar_scanner_poll(struct cpar_scanner *scanner,
+                                        size_t budget,
+                                        struct cpar_token *token);
 
-    constexpr bool operator==(color const &other) const noexcept
-    {
-      return value == other.value;
-    }
+/**
+ * The longest string a @a cpar_cache will store. Longer strings are parsed
+ * every time.
+ */
+#define CPAR_CACHE_KEY_MAX 54
 
-    constexpr bool operator!=(color const &other) const noexcept
-    {
-      return !operator==(other);
-    }
+/**
+ * A cache of parsed colour strings, for programs which parse the same
+ * strings over and over.
+ *
+ * The cache is a small fixed-size hash table keyed by the exact bytes of the
+ * string, so `#FFF` and `#fff` are cached separately. Failed parses are
+ * cached as well. When the table fills up, old entries are overwritten.
+ *
+ * A cache isn't thread-safe. Use a separate cache in each thread rather than
+ * sharing one.
+ *
+ * The members are private, use the functions to access the cache.
+ */
+struct cpar_cache;
 
-    constexpr uint8_t red() const noexcept { return CPAR_COLOR_RED(value); }
-    constexpr uint8_t green() const noexcept { return CPAR_COLOR_GREEN(value); }
-    constexpr uint8_t blue() const noexcept { return CPAR_COLOR_BLUE(value); }
-    constexpr uint8_t alpha() const noexcept { return CPAR_COLOR_ALPHA(value); }
-  };
+/**
+ * Counters of how well a @a cpar_cache is working.
+ */
+struct cpar_cache_stats {
+  /** The number of strings that were found in the cache. */
+  uint64_t hits;
+  /** The number of strings that had to be parsed. */
+  uint64_t misses;
+};
 
-  inline std::string to_string(color const &c)
-  {
-    char buf[10] = {0};
-    std::snprintf(buf,
-                  10,
-                  "#%02x%02x%02x%02x",
-                  c.red(),
-                  c.green(),
-                  c.blue(),
-                  c.alpha());
-    return buf;
-  }
+/**
+ * Creates a cache.
+ *
+ * Memory is allocated with `CPAR_MALLOC()`, which is `malloc()` unless
+ * defined otherwise along with `CPAR_FREE()` before including the
+ * implementation.
+ *
+ * @param n_entries The number of strings the cache can hold, which is
+ *                  rounded up to a power of two. A few hundred is usually
+ *                  plenty.
+ *
+ * @returns The new cache, or @c NULL if memory couldn't be allocated. Free
+ *          it with @a cpar_cache_free().
+ */
+struct cpar_cache *cpar_cache_new(size_t n_entries);
 
-  inline std::ostream &operator<<(std::ostream &out, color const &c)
-  {
-    out << to_string(c);
-    return out;
-  }
+/**
+ * Frees a cache created with @a cpar_cache_new().
+ *
+ * @param cache The cache to free, can be @c NULL.
+ */
+void cpar_cache_free(struct cpar_cache *cache);
 
-} // namespace cpar
+/**
+ * Removes all of the entries from a cache and resets its counters.
+ *
+ * @param cache The cache.
+ */
+void cpar_cache_clear(struct cpar_cache *cache);
 
-#endif
+/**
+ * Parses a colour string, using the cached result if the same string was
+ * parsed before.
+ *
+ * This gives the same results as @a cpar_color_parse_n().
+ *
+ * @param cache The cache.
+ * @param color_str The start of the string to parse.
+ * @param color_str_len The number of characters in @a color_str.
+ * @param result Pointer to integer to store the parsed result in, can be
+ *               @c NULL.
+ *
+ * @returns @a CPAR_STATUS_OK on success or another status code on error.
+ */
+enum cpar_status cpar_cache_parse(struct cpar_cache *cache,
+                                  const char *color_str,
+                                  size_t color_str_len,
+                                  uint32_t *result);
 
-#endif // CPAR_H
+/**
+ * Gets the hit and miss counters of a cache.
+ *
+ * @param cache The cache.
+ * @param stats Location to store the counters in.
+ */
+void cpar_cache_get_stats(const struct cpar_cache *cache,
+                          struct cpar_cache_stats *stats);
 
 /**
- * When defined, includes the implementation code.
+ * A table which gives each distinct colour string a small integer ID, so
+ * that documents can store colours as IDs rather than strings plus values.
  *
- * Define this before including the `cpar.h` header in one and only one source
- * file. If you get undefined symbol linking errors, you probably forgot to
- * define this in one source file. If you get duplicate symbol errors, you
- * probably defined it before more than one include of the header.
+ * IDs are allocated in order starting from zero. The first
+ * @a cpar_atoms_count() IDs of a new table are the lower-case colour names,
+ * in alphabetical order, so those don't use any memory. Strings are matched
+ * by their exact bytes, so `Red` and `red` get different IDs, which means
+ * the original spelling can always be recovered.
+ *
+ * The strings are stored in an arena, and everything is freed together by
+ * @a cpar_atoms_free(). A table isn't thread-safe.
+ *
+ * The members are private, use the functions to access the table.
  */
-#ifdef CPAR_IMPLEMENTATION
-#undef CPAR_IMPLEMENTATION
+struct cpar_atoms;
 
-#include <assert.h>
-#include <ctype.h>
-#include <errno.h>
-#include <stdlib.h>
-#include <string.h>
+/**
+ * Creates a colour atom table holding the colour names.
+ *
+ * Memory is allocated with `CPAR_MALLOC()`.
+ *
+ * @returns The new table, or @c NULL if memory couldn't be allocated. Free
+ *          it with @a cpar_atoms_free().
+ */
+struct cpar_atoms *cpar_atoms_new(void);
 
-#define CPAR_COLOR_PARSE_BUFFER_LEN 64
-#define CPAR_COLOR_PARSE_BUFFER_MAX (CPAR_COLOR_PARSE_BUFFER_LEN - 1)
+/**
+ * Frees a colour atom table and all of its strings.
+ *
+ * @param atoms The table to free, can be @c NULL.
+ */
+void cpar_atoms_free(struct cpar_atoms *atoms);
 
-#ifndef CPAR_T
 /**
- * A function-like macro that can allow translating the status messages.
+ * Gets the ID of a colour string, adding it to the table if it isn't there
+ * already.
  *
- * @param text The text to wrap in whatever macro/function you want.
- * @returns The result of the customized version or else the original text
- *          if not customized.
+ * Strings which don't parse as colours aren't added.
+ *
+ * @param atoms The table.
+ * @param color_str The start of the string.
+ * @param color_str_len The number of characters in @a color_str.
+ * @param id Location to store the ID in, can be @c NULL.
+ *
+ * @returns @a CPAR_STATUS_OK on success, @a CPAR_STATUS_NO_MEMORY if the
+ *          string couldn't be added, or the status code from parsing the
+ *          string if it isn't a valid colour.
  */
-#define CPAR_T(text) text
-#endif
+enum cpar_status cpar_atoms_intern(struct cpar_atoms *atoms,
+                                   const char *color_str,
+                                   size_t color_str_len,
+                                   uint32_t *id);
 
-const char *cpar_strerror(enum cpar_status status)
-{
-  static const char *error_strings[] = {
-      [CPAR_STATUS_OK] = CPAR_T("success"),
-      [CPAR_STATUS_INVALID_PARAMETER] = CPAR_T("invalid parameter"),
-      [CPAR_STATUS_TOO_BIG] = CPAR_T("color string too big"),
-      [CPAR_STATUS_INVALID_NUMBER] =
-          CPAR_T("numeric component failed to parse"),
-      [CPAR_STATUS_NUMBER_RANGE] = CPAR_T("numeric component out-of-range"),
-      [CPAR_STATUS_SYNTAX_ERROR] = CPAR_T("syntax error"),
-      [CPAR_STATUS_NO_COLOR_NAME] = CPAR_T("no matching color name"),
-  };
+/**
+ * Gets the number of IDs in a colour atom table. Valid IDs are less than
+ * this.
+ *
+ * @param atoms The table.
+ *
+ * @returns The number of IDs.
+ */
+uint32_t cpar_atoms_count(const struct cpar_atoms *atoms);
 
-  if ((size_t)status > (sizeof(error_strings) / sizeof(error_strings[0]))) {
-    return NULL;
-  }
-  return error_strings[status];
-}
+/**
+ * Gets the colour value of an ID.
+ *
+ * @param atoms The table.
+ * @param id The ID.
+ *
+ * @returns The colour value, or 0 if @a id isn't valid.
+ */
+uint32_t cpar_atoms_value(const struct cpar_atoms *atoms, uint32_t id);
 
-static enum cpar_status cpar_hex_byte_to_int(const char *hex_str,
-                                             uint8_t *result)
-{
-  char *ep = NULL;
-  int eno = errno;
-  long value;
-  if (!hex_str)
-    return CPAR_STATUS_INVALID_PARAMETER;
-  errno = 0;
-  value = strtol(hex_str, &ep, 16);
-  if (errno != 0) {
-    return CPAR_STATUS_INVALID_NUMBER;
-  } else if (value < 0 || value > 255) {
-    return CPAR_STATUS_NUMBER_RANGE;
-  } else if (*ep != '\0') {
-    return CPAR_STATUS_INVALID_NUMBER;
+/**
+ * Gets the string of an ID, which is zero-terminated and stays valid until
+ * the table is freed.
+ *
+ * @param atoms The table.
+ * @param id The ID.
+ * @param len Location to store the length of the string in, can be @c NULL.
+ *
+ * @returns The string, or @c NULL if @a id isn't valid.
+ */
+const char *
+cpar_atoms_string(const struct cpar_atoms *atoms, uint32_t id, size_t *len);
+
+/**
+ * An immutable registry of extra colour names, such as brand or theme
+ * colours, for use with @a cpar_names_parse() and @a cpar_names_lookup().
+ *
+ * Names are matched the same way as the built-in names, ignoring whitespace
+ * and case. The registry is built once into a minimal perfect hash over a
+ * single block of memory, so a lookup costs one hash of the name and one
+ * comparison however many names there are, and never allocates. As it's
+ * never modified after it's created, any number of threads can use a
+ * registry at once.
+ *
+ * The members are private, use the functions to access the registry.
+ */
+struct cpar_names;
+
+/**
+ * A registry holds fewer than this many names.
+ */
+#define CPAR_NAMES_MAX (UINT32_C(1) << 26)
+
+/**
+ * Creates a colour name registry.
+ *
+ * A name can't be empty, can't contain NUL or `(` and can't start with `#`,
+ * since the parser would never treat those as names, and no two names can
+ * be the same once whitespace and case are ignored. Names may be the same
+ * as built-in names, in which case they take precedence.
+ *
+ * Memory is allocated with `CPAR_MALLOC()`.
+ *
+ * @param strs The names.
+ * @param values The colour value of each name.
+ * @param n_strs The number of names.
+ * @param names Location to store the new registry in. Free it with
+ *              @a cpar_names_free().
+ * @param repeated Location to store the index of the first name which
+ *                 repeats an earlier one in, when
+ *                 @a CPAR_STATUS_DUPLICATE_NAME is returned. Can be @c NULL.
+ *
+ * @returns @a CPAR_STATUS_OK on success, @a CPAR_STATUS_INVALID_PARAMETER
+ *          if a name isn't valid or there are @a CPAR_NAMES_MAX or more
+ *          names, @a CPAR_STATUS_DUPLICATE_NAME if a name is repeated,
+ *          @a CPAR_STATUS_NO_PERFECT_HASH in the vanishingly unlikely case
+ *          that the names can't be hashed apart, or
+ *          @a CPAR_STATUS_NO_MEMORY if memory couldn't be allocated.
+ */
+enum cpar_status cpar_names_new(const struct cpar_string *strs,
+                                const uint32_t *values,
+                                size_t n_strs,
+                                struct cpar_names **names,
+                                size_t *repeated);
+
+/**
+ * Frees a colour name registry.
+ *
+ * @param names The registry to free, can be @c NULL.
+ */
+void cpar_names_free(struct cpar_names *names);
+
+/**
+ * Gets the number of names in a registry.
+ *
+ * @param names The registry.
+ *
+ * @returns The number of names.
+ */
+uint32_t cpar_names_count(const struct cpar_names *names);
+
+/**
+ * Parses a colour string like @a cpar_color_parse_n(), looking colour names
+ * up in a registry before the built-in names.
+ *
+ * @param names The registry, or @c NULL for just the built-in names.
+ * @param color_str The start of the string to parse.
+ * @param color_str_len The number of characters in @a color_str.
+ * @param result Pointer to integer to store the parsed result in, can be
+ *               @c NULL.
+ *
+ * @returns @a CPAR_STATUS_OK on success or another status code on error.
+ */
+enum cpar_status cpar_names_parse(const struct cpar_names *names,
+                                  const char *color_str,
+                                  size_t color_str_len,
+                                  uint32_t *result);
+
+/**
+ * Looks up the name of a colour like @a cpar_lookup_color_name(), trying
+ * the names in a registry first.
+ *
+ * Where several names in the registry have the value, the one which was
+ * given first to @a cpar_names_new() is returned. Names from the registry
+ * are returned in lower case without whitespace, as they're stored.
+ *
+ * @param names The registry, or @c NULL for just the built-in names.
+ * @param value The colour value.
+ *
+ * @returns The name, which stays valid until the registry is freed, or
+ *          @c NULL if no name was found.
+ */
+const char *cpar_names_lookup(const struct cpar_names *names, uint32_t value);
+
+/**
+ * The version of the binary registry format written by
+ * @a cpar_names_serialize(). Images of other versions aren't loaded.
+ */
+#define CPAR_NAMES_IMAGE_VERSION 1
+
+/**
+ * Writes a registry in a binary format which can be loaded again without
+ * building it, by @a cpar_names_from_image() or @a cpar_names_map().
+ *
+ * The image is a header followed by the registry's arrays as they are in
+ * memory: the perfect hash, the offsets of the names, their values, their
+ * order by value and the block of names. Numbers are in the byte order of
+ * the machine which wrote the image, which is checked when it's loaded.
+ *
+ * @param names The registry.
+ * @param buffer Where to write the image, or @c NULL to get its size.
+ * @param buffer_size The size of @a buffer in bytes.
+ *
+ * @returns The size of the image in bytes, which was only written if it's
+ *          at most @a buffer_size, or zero if @a names is @c NULL.
+ */
+size_t cpar_names_serialize(const struct cpar_names *names,
+                            void *buffer,
+                            size_t buffer_size);
+
+/**
+ * Makes a registry which uses an image from @a cpar_names_serialize() in
+ * place, without copying it.
+ *
+ * Only the header is checked, so loading costs the same for any number of
+ * names. An image which was corrupted afterwards can give wrong results
+ * but never makes lookups read outside of it.
+ *
+ * @param image The image, aligned to 4 bytes, which must stay valid and
+ *              unchanged until the registry is freed.
+ * @param image_size The size of @a image in bytes.
+ * @param names Location to store the new registry in, or @c NULL on error.
+ *
+ * @returns @a CPAR_STATUS_OK on success, @a CPAR_STATUS_INVALID_PARAMETER
+ *          if @a image isn't an image of this version, or
+ *          @a CPAR_STATUS_NO_MEMORY.
+ */
+enum cpar_status cpar_names_from_image(const void *image,
+                                       size_t image_size,
+                                       struct cpar_names **names);
+
+/**
+ * Loads a registry from a file written with @a cpar_names_serialize(), like
+ * @a cpar_names_from_image().
+ *
+ * Where the system has `mmap()`, the file is mapped rather than read, so
+ * only the pages which lookups touch are ever read from it. Define
+ * @a CPAR_NO_MMAP to always read the file instead.
+ *
+ * @param path The file's path.
+ * @param names Location to store the new registry in, or @c NULL on error.
+ *
+ * @returns @a CPAR_STATUS_OK on success, @a CPAR_STATUS_IO_ERROR if the
+ *          file couldn't be read, or the status codes of
+ *          @a cpar_names_from_image().
+ */
+enum cpar_status cpar_names_map(const char *path, struct cpar_names **names);
+
+struct cpar_arena_block;
+
+/**
+ * A monotonic arena, which hands out memory from a buffer supplied by the
+ * caller, if any, and then from blocks allocated with `CPAR_MALLOC()` as
+ * needed. Memory isn't freed piece by piece, only all at once by
+ * @a cpar_arena_clear() or @a cpar_arena_release(), which makes allocating
+ * it very cheap.
+ *
+ * The members are private, use the functions to access the arena.
+ */
+struct cpar_arena {
+  unsigned char *next;
+  unsigned char *end;
+  struct cpar_arena_block *blocks;
+  unsigned char *buffer;
+  size_t buffer_size;
+};
+
+/**
+ * Initializes an arena.
+ *
+ * @param arena The arena to initialize.
+ * @param buffer Memory to hand out before allocating any, which must stay
+ *               valid while the arena is in use, or @c NULL.
+ * @param buffer_size The size of @a buffer in bytes.
+ */
+void cpar_arena_init(struct cpar_arena *arena,
+                     void *buffer,
+                     size_t buffer_size);
+
+/**
+ * Allocates memory from an arena.
+ *
+ * @param arena The arena.
+ * @param size The number of bytes to allocate.
+ * @param align The alignment of the memory, a power of two.
+ *
+ * @returns The memory, which stays valid until the arena is cleared or
+ *          released, or @c NULL if it couldn't be allocated.
+ */
+void *cpar_arena_alloc(struct cpar_arena *arena, size_t size, size_t align);
+
+/**
+ * Frees everything allocated from an arena, so that it can be reused
+ * starting from the caller's buffer again.
+ *
+ * @param arena The arena.
+ */
+void cpar_arena_clear(struct cpar_arena *arena);
+
+/**
+ * Frees everything allocated from an arena, after which it needs to be
+ * initialized again to be reused.
+ *
+ * @param arena The arena, can be @c NULL.
+ */
+void cpar_arena_release(struct cpar_arena *arena);
+
+/**
+ * Parses a list of colours separated by commas or whitespace, like
+ * `red, #0f0, rgba(0,0,255,.5)` or `red #0f0 blue`, in a single pass.
+ *
+ * Commas and whitespace inside parentheses don't separate colours, and
+ * whitespace around the commas is ignored. An empty list, or one that's
+ * only whitespace, has no colours, but empty entries such as in `red,,blue`
+ * or `red,` are syntax errors.
+ *
+ * The colours are stored contiguously in memory from @a arena. If parsing
+ * fails, the colours before the one which failed are still stored.
+ *
+ * @param arena The arena to allocate the colours from.
+ * @param list_str The start of the list.
+ * @param list_str_len The number of characters in @a list_str.
+ * @param values Location to store a pointer to the colours in.
+ * @param n_values Location to store the number of colours in.
+ * @param error_offset Location to store the offset in @a list_str of the
+ *                     entry which failed to parse in, or the length of the
+ *                     list if none did, can be @c NULL.
+ *
+ * @returns @a CPAR_STATUS_OK on success, @a CPAR_STATUS_NO_MEMORY if the
+ *          colours couldn't be allocated, or the status code from parsing
+ *          the entry which failed.
+ */
+enum cpar_status cpar_color_parse_list(struct cpar_arena *arena,
+                                       const char *list_str,
+                                       size_t list_str_len,
+                                       uint32_t **values,
+                                       size_t *n_values,
+                                       size_t *error_offset);
+
+/**
+ * Extracts the red component from an RGBA 32-bit integer.
+ *
+ * @param c The 32-bit integer color.
+ * @returns The 8-bit red component.
+ */
+#define CPAR_COLOR_RED(c) ((uint8_t)(((uint32_t)(c) >> 24) & 0xFF))
+
+/**
+ * Extracts the green component from an RGBA 32-bit integer.
+ *
+ * @param c The 32-bit integer color.
+ * @returns The 8-bit green component.
+ */
+#define CPAR_COLOR_GREEN(c) ((uint8_t)(((uint32_t)(c) >> 16) & 0xFF))
+
+/**
+ * Extracts the blue component from an RGBA 32-bit integer.
+ *
+ * @param c The 32-bit integer color.
+ * @returns The 8-bit blue component.
+ */
+#define CPAR_COLOR_BLUE(c) ((uint8_t)(((uint32_t)(c) >> 8) & 0xFF))
+
+/**
+ * Extracts the alpha component from an RGBA 32-bit integer.
+ *
+ * @param c The 32-bit integer color.
+ * @returns The 8-bit alpha component.
+ */
+#define CPAR_COLOR_ALPHA(c) ((uint8_t)((uint32_t)(c)&0xFF))
+
+/**
+ * Packs the 8-bit RGBA components into 32-bit integer.
+ *
+ * @param r The red component.
+ * @param g The green component.
+ * @param b The blue component.
+ * @param a The alpha component.
+ *
+ * @returns The 4 8-bit components packed into a single 32-bit integer.
+ */
+#define CPAR_COLOR_MAKE(r, g, b, a)           \
+  ((((uint32_t)(r) << 24) & 0xFF000000) |     \
+   (((uint32_t)(g) << 16) & 0x00FF0000) |     \
+   (((uint32_t)(b) << 8) & 0x0000FF00) | ((uint32_t)(a)&0x000000FF))
+
+/* BEGIN GENERATED COLOR NAMES: do not edit, see tools/gen_color_tables.py */
+
+/**
+ * Expands to `X(name, r, g, b, a)` for each of the named colours, in
+ * alphabetical order.
+ */
+#define CPAR_COLOR_NAME_LIST(X)                 \
+  X("aliceblue", 240, 248, 255, 255)            \
+  X("antiquewhite", 250, 235, 215, 255)         \
+  X("aqua", 0, 255, 255, 255)                   \
+  X("aquamarine", 127, 255, 212, 255)           \
+  X("azure", 240, 255, 255, 255)                \
+  X("beige", 245, 245, 220, 255)                \
+  X("bisque", 255, 228, 196, 255)               \
+  X("black", 0, 0, 0, 255)                      \
+  X("blanchedalmond", 255, 235, 205, 255)       \
+  X("blue", 0, 0, 255, 255)                     \
+  X("blueviolet", 138, 43, 226, 255)            \
+  X("brown", 165, 42, 42, 255)                  \
+  X("burlywood", 222, 184, 135, 255)            \
+  X("cadetblue", 95, 158, 160, 255)             \
+  X("chartreuse", 127, 255, 0, 255)             \
+  X("chocolate", 210, 105, 30, 255)             \
+  X("coral", 255, 127, 80, 255)                 \
+  X("cornflowerblue", 100, 149, 237, 255)       \
+  X("cornsilk", 255, 248, 220, 255)             \
+  X("crimson", 220, 20, 60, 255)                \
+  X("cyan", 0, 255, 255, 255)                   \
+  X("darkblue", 0, 0, 139, 255)                 \
+  X("darkcyan", 0, 139, 139, 255)               \
+  X("darkgoldenrod", 184, 134, 11, 255)         \
+  X("darkgray", 169, 169, 169, 255)             \
+  X("darkgreen", 0, 100, 0, 255)                \
+  X("darkgrey", 169, 169, 169, 255)             \
+  X("darkkhaki", 189, 183, 107, 255)            \
+  X("darkmagenta", 139, 0, 139, 255)            \
+  X("darkolivegreen", 85, 107, 47, 255)         \
+  X("darkorange", 255, 140, 0, 255)             \
+  X("darkorchid", 153, 50, 204, 255)            \
+  X("darkred", 139, 0, 0, 255)                  \
+  X("darksalmon", 233, 150, 122, 255)           \
+  X("darkseagreen", 143, 188, 143, 255)         \
+  X("darkslateblue", 72, 61, 139, 255)          \
+  X("darkslategray", 47, 79, 79, 255)           \
+  X("darkslategrey", 47, 79, 79, 255)           \
+  X("darkturquoise", 0, 206, 209, 255)          \
+  X("darkviolet", 148, 0, 211, 255)             \
+  X("deeppink", 255, 20, 147, 255)              \
+  X("deepskyblue", 0, 191, 255, 255)            \
+  X("dimgray", 105, 105, 105, 255)              \
+  X("dimgrey", 105, 105, 105, 255)              \
+  X("dodgerblue", 30, 144, 255, 255)            \
+  X("firebrick", 178, 34, 34, 255)              \
+  X("floralwhite", 255, 250, 240, 255)          \
+  X("forestgreen", 34, 139, 34, 255)            \
+  X("fuchsia", 255, 0, 255, 255)                \
+  X("gainsboro", 220, 220, 220, 255)            \
+  X("ghostwhite", 248, 248, 255, 255)           \
+  X("gold", 255, 215, 0, 255)                   \
+  X("goldenrod", 218, 165, 32, 255)             \
+  X("gray", 128, 128, 128, 255)                 \
+  X("green", 0, 128, 0, 255)                    \
+  X("greenyellow", 173, 255, 47, 255)           \
+  X("grey", 128, 128, 128, 255)                 \
+  X("honeydew", 240, 255, 240, 255)             \
+  X("hotpink", 255, 105, 180, 255)              \
+  X("indianred", 205, 92, 92, 255)              \
+  X("indigo", 75, 0, 130, 255)                  \
+  X("ivory", 255, 255, 240, 255)                \
+  X("khaki", 240, 230, 140, 255)                \
+  X("lavender", 230, 230, 250, 255)             \
+  X("lavenderblush", 255, 240, 245, 255)        \
+  X("lawngreen", 124, 252, 0, 255)              \
+  X("lemonchiffon", 255, 250, 205, 255)         \
+  X("lightblue", 173, 216, 230, 255)            \
+  X("lightcoral", 240, 128, 128, 255)           \
+  X("lightcyan", 224, 255, 255, 255)            \
+  X("lightgoldenrodyellow", 250, 250, 210, 255) \
+  X("lightgray", 211, 211, 211, 255)            \
+  X("lightgreen", 144, 238, 144, 255)           \
+  X("lightgrey", 211, 211, 211, 255)            \
+  X("lightpink", 255, 182, 193, 255)            \
+  X("lightsalmon", 255, 160, 122, 255)          \
+  X("lightseagreen", 32, 178, 170, 255)         \
+  X("lightskyblue", 135, 206, 250, 255)         \
+  X("lightslategray", 119, 136, 153, 255)       \
+  X("lightslategrey", 119, 136, 153, 255)       \
+  X("lightsteelblue", 176, 196, 222, 255)       \
+  X("lightyellow", 255, 255, 224, 255)          \
+  X("lime", 0, 255, 0, 255)                     \
+  X("limegreen", 50, 205, 50, 255)              \
+  X("linen", 250, 240, 230, 255)                \
+  X("magenta", 255, 0, 255, 255)                \
+  X("maroon", 128, 0, 0, 255)                   \
+  X("mediumaquamarine", 102, 205, 170, 255)     \
+  X("mediumblue", 0, 0, 205, 255)               \
+  X("mediumorchid", 186, 85, 211, 255)          \
+  X("mediumpurple", 147, 112, 219, 255)         \
+  X("mediumseagreen", 60, 179, 113, 255)        \
+  X("mediumslateblue", 123, 104, 238, 255)      \
+  X("mediumspringgreen", 0, 250, 154, 255)      \
+  X("mediumturquoise", 72, 209, 204, 255)       \
+  X("mediumvioletred", 199, 21, 133, 255)       \
+  X("midnightblue", 25, 25, 112, 255)           \
+  X("mintcream", 245, 255, 250, 255)            \
+  X("mistyrose", 255, 228, 225, 255)            \
+  X("moccasin", 255, 228, 181, 255)             \
+  X("navajowhite", 255, 222, 173, 255)          \
+  X("navy", 0, 0, 128, 255)                     \
+  X("oldlace", 253, 245, 230, 255)              \
+  X("olive", 128, 128, 0, 255)                  \
+  X("olivedrab", 107, 142, 35, 255)             \
+  X("orange", 255, 165, 0, 255)                 \
+  X("orangered", 255, 69, 0, 255)               \
+  X("orchid", 218, 112, 214, 255)               \
+  X("palegoldenrod", 238, 232, 170, 255)        \
+  X("palegreen", 152, 251, 152, 255)            \
+  X("paleturquoise", 175, 238, 238, 255)        \
+  X("palevioletred", 219, 112, 147, 255)        \
+  X("papayawhip", 255, 239, 213, 255)           \
+  X("peachpuff", 255, 218, 185, 255)            \
+  X("peru", 205, 133, 63, 255)                  \
+  X("pink", 255, 192, 203, 255)                 \
+  X("plum", 221, 160, 221, 255)                 \
+  X("powderblue", 176, 224, 230, 255)           \
+  X("purple", 128, 0, 128, 255)                 \
+  X("rebeccapurple", 102, 51, 153, 255)         \
+  X("red", 255, 0, 0, 255)                      \
+  X("rosybrown", 188, 143, 143, 255)            \
+  X("royalblue", 65, 105, 225, 255)             \
+  X("saddlebrown", 139, 69, 19, 255)            \
+  X("salmon", 250, 128, 114, 255)               \
+  X("sandybrown", 244, 164, 96, 255)            \
+  X("seagreen", 46, 139, 87, 255)               \
+  X("seashell", 255, 245, 238, 255)             \
+  X("sienna", 160, 82, 45, 255)                 \
+  X("silver", 192, 192, 192, 255)               \
+  X("skyblue", 135, 206, 235, 255)              \
+  X("slateblue", 106, 90, 205, 255)             \
+  X("slategray", 112, 128, 144, 255)            \
+  X("slategrey", 112, 128, 144, 255)            \
+  X("snow", 255, 250, 250, 255)                 \
+  X("springgreen", 0, 255, 127, 255)            \
+  X("steelblue", 70, 130, 180, 255)             \
+  X("tan", 210, 180, 140, 255)                  \
+  X("teal", 0, 128, 128, 255)                   \
+  X("thistle", 216, 191, 216, 255)              \
+  X("tomato", 255, 99, 71, 255)                 \
+  X("transparent", 0, 0, 0, 0)                  \
+  X("turquoise", 64, 224, 208, 255)             \
+  X("violet", 238, 130, 238, 255)               \
+  X("wheat", 245, 222, 179, 255)                \
+  X("white", 255, 255, 255, 255)                \
+  X("whitesmoke", 245, 245, 245, 255)           \
+  X("yellow", 255, 255, 0, 255)                 \
+  X("yellowgreen", 154, 205, 50, 255)
+
+/* END GENERATED COLOR NAMES */
+
+/**
+ * Byte orders of 8-bit pixels for @a cpar_pixels_from_colors() and
+ * @a cpar_pixels_to_colors(). Each names the channels in the order they're
+ * stored in memory, whatever the endianness of the CPU, as for
+ * `VK_FORMAT_B8G8R8A8_UNORM` and the like.
+ */
+enum cpar_pixel_format {
+  /** Red, green, blue, alpha. */
+  CPAR_PIXEL_RGBA8,
+  /** Blue, green, red, alpha. */
+  CPAR_PIXEL_BGRA8,
+  /** Alpha, red, green, blue. */
+  CPAR_PIXEL_ARGB8,
+  /** Alpha, blue, green, red. */
+  CPAR_PIXEL_ABGR8,
+};
+
+/**
+ * Converts an array of colours, as made by @a CPAR_COLOR_MAKE(), to pixels
+ * in place.
+ *
+ * Depending on the CPU, this uses AVX2, SSSE3 or NEON to convert several
+ * pixels at a time, with a portable fallback.
+ *
+ * @param data The colours to convert, which are replaced by the pixels.
+ * @param n The number of colours.
+ * @param format The byte order of the pixels.
+ */
+void cpar_pixels_from_colors(uint32_t *data,
+                             size_t n,
+                             enum cpar_pixel_format format);
+
+/**
+ * Converts an array of pixels to colours in place, the reverse of
+ * @a cpar_pixels_from_colors().
+ *
+ * @param data The pixels to convert, which are replaced by the colours.
+ * @param n The number of pixels.
+ * @param format The byte order of the pixels.
+ */
+void cpar_pixels_to_colors(uint32_t *data,
+                           size_t n,
+                           enum cpar_pixel_format format);
+
+/**
+ * Multiplies the red, green and blue components of an array of colours by
+ * their alpha in place, rounding to the nearest value.
+ *
+ * @param colors The colours to convert.
+ * @param n The number of colours.
+ */
+void cpar_colors_premultiply(uint32_t *colors, size_t n);
+
+/**
+ * Divides the red, green and blue components of an array of premultiplied
+ * colours by their alpha in place, rounding to the nearest value, the
+ * reverse of @a cpar_colors_premultiply(). Fully transparent colours become
+ * transparent black. Components which are larger than the alpha, so aren't
+ * valid for premultiplied colours, are clamped to 255.
+ *
+ * This loses precision for small alphas, but premultiplying the result
+ * always gives back the original colour.
+ *
+ * @param colors The colours to convert.
+ * @param n The number of colours.
+ */
+void cpar_colors_unpremultiply(uint32_t *colors, size_t n);
+
+/**
+ * Converts the red, green and blue components of an array of sRGB colours
+ * to linear light in place, leaving alpha alone.
+ *
+ * Both this and @a cpar_colors_linear_to_srgb() use a lookup table of the
+ * exact conversion rounded to 8 bits. Dark colours lose precision in linear
+ * light, so converting there and back isn't lossless.
+ *
+ * @param colors The colours to convert.
+ * @param n The number of colours.
+ */
+void cpar_colors_srgb_to_linear(uint32_t *colors, size_t n);
+
+/**
+ * Converts the red, green and blue components of an array of linear light
+ * colours to the sRGB encoding in place, leaving alpha alone.
+ *
+ * @param colors The colours to convert.
+ * @param n The number of colours.
+ */
+void cpar_colors_linear_to_srgb(uint32_t *colors, size_t n);
+
+/**
+ * Colour spaces for @a cpar_colors_to_space() and
+ * @a cpar_colors_from_space(). Each colour is 4 floats, with alpha last in
+ * [0, 1].
+ */
+enum cpar_color_space {
+  /** Red, green and blue in linear light, in [0, 1]. */
+  CPAR_SPACE_LINEAR_SRGB,
+  /** Hue in degrees in [0, 360), then saturation and lightness in [0, 1],
+   * as for `hsl()` in CSS. The hue of greys is 0. */
+  CPAR_SPACE_HSL,
+  /** Hue in degrees in [0, 360), then saturation and value in [0, 1]. The
+   * hue of greys is 0. */
+  CPAR_SPACE_HSV,
+  /** Lightness in [0, 1], then the a and b axes, which are within about
+   * 0.4 of 0 for sRGB colours. */
+  CPAR_SPACE_OKLAB,
+};
+
+/**
+ * Converts an array of colours to another colour space.
+ *
+ * Linear light and OKLab are converted 8 colours at a time on CPUs with
+ * AVX2.
+ *
+ * @param colors The colours to convert.
+ * @param n The number of colours.
+ * @param space The colour space to convert to. Nothing is written if it
+ * isn't valid.
+ * @param out Where to store the 4 floats of each colour, `4 * n` in all.
+ */
+void cpar_colors_to_space(const uint32_t *colors,
+                          size_t n,
+                          enum cpar_color_space space,
+                          float *out);
+
+/**
+ * Converts an array of colours from another colour space, the reverse of
+ * @a cpar_colors_to_space(), rounding each channel to the nearest 8-bit
+ * value. Colours outside the sRGB gamut are clamped to it channel by
+ * channel, hues are taken modulo 360 degrees, and the other components of
+ * HSL and HSV are clamped to [0, 1].
+ *
+ * Converting any colour to a space and back gives the colour again.
+ *
+ * @param in The 4 floats of each colour, `4 * n` in all.
+ * @param n The number of colours.
+ * @param space The colour space to convert from. Nothing is written if it
+ * isn't valid.
+ * @param colors Where to store the colours.
+ */
+void cpar_colors_from_space(const float *in,
+                            size_t n,
+                            enum cpar_color_space space,
+                            uint32_t *colors);
+
+/**
+ * The contrast thresholds of WCAG 2 for @a cpar_contrast_check().
+ */
+enum cpar_contrast_level {
+  /** 3:1, level AA for large text and user interface components. */
+  CPAR_CONTRAST_AA_LARGE,
+  /** 4.5:1, level AA for normal text and AAA for large text. */
+  CPAR_CONTRAST_AA,
+  /** 7:1, level AAA for normal text. */
+  CPAR_CONTRAST_AAA,
+};
+
+/**
+ * Returns the relative luminance of a colour as defined by WCAG 2, from 0
+ * for black to 1 for white. Alpha is ignored, so translucent colours should
+ * be composited over their background first.
+ *
+ * Luminances come from a table of each component's share, in fixed point
+ * with a resolution of about 1e-7. WCAG's threshold of 0.03928 for the
+ * linear part of the sRGB curve gives the same values as 0.04045 for
+ * 8-bit components.
+ *
+ * @param value The colour.
+ * @return The luminance, in [0, 1].
+ */
+float cpar_relative_luminance(uint32_t value);
+
+/**
+ * Returns the contrast ratio of two colours as defined by WCAG 2, from 1
+ * for colours with the same luminance to 21 for black and white, whichever
+ * order they're in.
+ *
+ * @param fg The foreground colour.
+ * @param bg The background colour.
+ * @return The contrast ratio, in [1, 21].
+ */
+float cpar_contrast_ratio(uint32_t fg, uint32_t bg);
+
+/**
+ * Computes the contrast ratios of pairs of colours, like
+ * @a cpar_contrast_ratio(), 8 pairs at a time on CPUs with AVX2.
+ *
+ * @param fg The foreground colours.
+ * @param bg The background colours.
+ * @param n The number of pairs.
+ * @param ratios Where to store the ratio of each pair.
+ */
+void cpar_contrast_ratios(const uint32_t *fg,
+                          const uint32_t *bg,
+                          size_t n,
+                          float *ratios);
+
+/**
+ * Checks which pairs of colours meet a contrast level, without computing
+ * the ratios as floats. The check is exact for the fixed point
+ * luminances, so a ratio from @a cpar_contrast_ratio() which rounds to
+ * exactly the threshold may still fail it.
+ *
+ * @param fg The foreground colours.
+ * @param bg The background colours.
+ * @param n The number of pairs.
+ * @param level The contrast level to check.
+ * @param pass Where to store a bit for each pair, set when it passes, with
+ * pair `i` in bit `i % 64` of word `i / 64`. All `(n + 63) / 64` words are
+ * written, and the bits after the last pair are clear.
+ * @return The number of pairs which pass, or 0 without writing anything if
+ * @a level isn't valid.
+ */
+size_t cpar_contrast_check(const uint32_t *fg,
+                           const uint32_t *bg,
+                           size_t n,
+                           enum cpar_contrast_level level,
+                           uint64_t *pass);
+
+/**
+ * The syntaxes counted by @a cpar_stats.
+ */
+enum cpar_syntax {
+  CPAR_SYNTAX_HEX,
+  CPAR_SYNTAX_RGB,
+  CPAR_SYNTAX_RGBA,
+  CPAR_SYNTAX_HSL,
+  CPAR_SYNTAX_HSLA,
+  CPAR_SYNTAX_HWB,
+  /** Colour names, and anything else which doesn't look like a colour
+   * function or hex colour. */
+  CPAR_SYNTAX_NAME,
+  /** The number of syntaxes. */
+  CPAR_SYNTAX_COUNT,
+};
+
+/** The number of @a cpar_status codes. */
+#define CPAR_STATUS_COUNT (CPAR_STATUS_NO_PERFECT_HASH + 1)
+
+/** The number of buckets in @a cpar_stats::cycles. */
+#define CPAR_STATS_CYCLE_BUCKETS 32
+
+/**
+ * Counts of calls to @a cpar_color_parse_n() and the functions built on it,
+ * see @a cpar_stats_snapshot().
+ */
+struct cpar_stats {
+  /** The number of calls. */
+  uint64_t calls;
+  /** The number of calls for each @a cpar_syntax. */
+  uint64_t syntax[CPAR_SYNTAX_COUNT];
+  /** The number of calls which returned each @a cpar_status, so
+   * `status[CPAR_STATUS_NO_COLOR_NAME]` counts names which weren't found. */
+  uint64_t status[CPAR_STATUS_COUNT];
+  /** A histogram of the time spent in each call, where bucket `i` counts
+   * calls which took from `2^i` up to `2^(i+1)` CPU timestamp ticks. */
+  uint64_t cycles[CPAR_STATS_CYCLE_BUCKETS];
+};
+
+/**
+ * Gets the statistics collected since startup or since the last call to
+ * @a cpar_stats_reset().
+ *
+ * Statistics are only collected when the implementation is compiled with
+ * @a CPAR_ENABLE_STATS defined, and otherwise parsing costs nothing extra.
+ * The cycle histogram also needs @a CPAR_ENABLE_STATS_CYCLES, and a CPU
+ * with a timestamp counter. Each thread updates its own counters with
+ * relaxed atomics, so threads don't contend. A snapshot taken while other
+ * threads are parsing is a little out of date, and calls which finish
+ * while @a cpar_stats_reset() runs may be lost.
+ *
+ * @param stats Receives the statistics, all zero when they aren't
+ *              collected.
+ *
+ * @returns Non-zero if statistics are collected.
+ */
+int cpar_stats_snapshot(struct cpar_stats *stats);
+
+/**
+ * Sets all the statistics back to zero.
+ */
+void cpar_stats_reset(void);
+
+#ifdef __cplusplus
+} // extern "C"
+#endif
+
+#endif // CPAR_H
+
+/* BEGIN GENERATED COLOR SPACE TABLES: do not edit,
+ * see tools/gen_color_tables.py */
+
+/*
+ * The tables of the colour space conversions, as lists for initializers so
+ * that the C implementation and the constexpr conversions in C++ share
+ * them. CPAR_SRGB_TO_LINEAR_FLOATS is each 8-bit sRGB-encoded value in
+ * linear light, and CPAR_SRGB_MIDPOINT_FLOATS the linear values halfway
+ * between each one and the next. CPAR_LINEAR_BUCKET_VALUES is the sRGB
+ * encoding of the start of each 1/4096 of linear light, padded so that it
+ * can be read 4 bytes at a time.
+ *
+ * They're only defined where they're needed, the first time the header is
+ * included in C++ and for the implementation in C, and are undefined once
+ * the arrays are, so they aren't part of the API.
+ */
+#if defined(__cplusplus) ? !defined(CPAR_HPP) : defined(CPAR_IMPLEMENTATION)
+
+#define CPAR_SRGB_TO_LINEAR_FLOATS                                           \
+  0.0f, 0.000303526984f, 0.000607053967f, 0.000910580951f, 0.00121410793f,   \
+  0.00151763492f, 0.0018211619f, 0.00212468888f, 0.00242821587f,             \
+  0.00273174285f, 0.00303526984f, 0.00334653576f, 0.00367650732f,            \
+  0.00402471702f, 0.00439144204f, 0.00477695348f, 0.0051815167f,             \
+  0.00560539162f, 0.00604883302f, 0.00651209079f, 0.00699541019f,            \
+  0.00749903204f, 0.00802319299f, 0.00856812562f, 0.0091340587f,             \
+  0.00972121732f, 0.010329823f, 0.010960094f, 0.0116122452f, 0.0122864884f,  \
+  0.0129830323f, 0.013702083f, 0.0144438436f, 0.0152085144f, 0.0159962934f,  \
+  0.0168073758f, 0.0176419545f, 0.0185002201f, 0.019382361f, 0.0202885631f,  \
+  0.0212190104f, 0.0221738848f, 0.0231533662f, 0.0241576324f, 0.0251868596f, \
+  0.0262412219f, 0.0273208916f, 0.0284260395f, 0.0295568344f, 0.0307134437f, \
+  0.0318960331f, 0.0331047666f, 0.0343398068f, 0.0356013149f, 0.0368894504f, \
+  0.0382043716f, 0.0395462353f, 0.0409151969f, 0.0423114106f, 0.0437350293f, \
+  0.0451862044f, 0.0466650863f, 0.0481718242f, 0.049706566f, 0.0512694584f,  \
+  0.052860647f, 0.0544802764f, 0.05612849f, 0.0578054302f, 0.0595112382f,    \
+  0.0612460542f, 0.0630100177f, 0.0648032667f, 0.0666259386f, 0.0684781698f, \
+  0.0703600957f, 0.0722718507f, 0.0742135684f, 0.0761853815f, 0.0781874218f, \
+  0.0802198203f, 0.0822827071f, 0.0843762115f, 0.086500462f, 0.0886555863f,  \
+  0.0908417112f, 0.0930589628f, 0.0953074666f, 0.0975873471f, 0.0998987282f, \
+  0.102241733f, 0.104616484f, 0.107023103f, 0.109461711f, 0.111932428f,      \
+  0.114435374f, 0.116970668f, 0.119538428f, 0.122138772f, 0.124771818f,      \
+  0.12743768f, 0.130136477f, 0.132868322f, 0.13563333f, 0.138431615f,        \
+  0.141263291f, 0.144128471f, 0.147027266f, 0.14995979f, 0.152926152f,       \
+  0.155926464f, 0.158960835f, 0.162029376f, 0.165132195f, 0.1682694f,        \
+  0.171441101f, 0.174647404f, 0.177888416f, 0.181164244f, 0.184474995f,      \
+  0.187820772f, 0.191201683f, 0.19461783f, 0.19806932f, 0.201556254f,        \
+  0.205078736f, 0.20863687f, 0.212230757f, 0.2158605f, 0.2195262f,           \
+  0.223227957f, 0.226965874f, 0.230740049f, 0.234550582f, 0.238397574f,      \
+  0.242281122f, 0.246201327f, 0.250158285f, 0.254152094f, 0.258182853f,      \
+  0.262250658f, 0.266355605f, 0.270497791f, 0.274677312f, 0.278894263f,      \
+  0.28314874f, 0.287440838f, 0.29177065f, 0.296138271f, 0.300543794f,        \
+  0.304987314f, 0.309468923f, 0.313988713f, 0.318546778f, 0.323143209f,      \
+  0.327778098f, 0.332451536f, 0.337163615f, 0.341914425f, 0.346704056f,      \
+  0.3515326f, 0.356400144f, 0.36130678f, 0.366252596f, 0.37123768f,          \
+  0.376262123f, 0.381326011f, 0.386429434f, 0.391572478f, 0.396755231f,      \
+  0.40197778f, 0.407240212f, 0.412542613f, 0.417885071f, 0.42326767f,        \
+  0.428690497f, 0.434153636f, 0.439657174f, 0.445201195f, 0.450785783f,      \
+  0.456411023f, 0.462077f, 0.467783796f, 0.473531496f, 0.479320183f,         \
+  0.48514994f, 0.49102085f, 0.496932995f, 0.502886458f, 0.508881321f,        \
+  0.514917665f, 0.520995573f, 0.527115126f, 0.533276404f, 0.539479489f,      \
+  0.545724461f, 0.552011402f, 0.55834039f, 0.564711506f, 0.571124829f,       \
+  0.57758044f, 0.584078418f, 0.590618841f, 0.597201788f, 0.603827339f,       \
+  0.610495571f, 0.617206562f, 0.623960392f, 0.630757136f, 0.637596874f,      \
+  0.644479682f, 0.651405637f, 0.658374817f, 0.665387298f, 0.672443157f,      \
+  0.67954247f, 0.686685312f, 0.693871761f, 0.701101892f, 0.70837578f,        \
+  0.715693501f, 0.723055129f, 0.73046074f, 0.737910409f, 0.74540421f,        \
+  0.752942217f, 0.760524505f, 0.768151147f, 0.775822218f, 0.783537792f,      \
+  0.79129794f, 0.799102738f, 0.806952258f, 0.814846572f, 0.822785754f,       \
+  0.830769877f, 0.838799012f, 0.846873232f, 0.854992608f, 0.863157213f,      \
+  0.871367119f, 0.879622397f, 0.887923118f, 0.896269353f, 0.904661174f,      \
+  0.913098652f, 0.921581856f, 0.930110858f, 0.938685728f, 0.947306537f,      \
+  0.955973353f, 0.964686248f, 0.97344529f, 0.98225055f, 0.991102097f, 1.0f,
+
+#define CPAR_SRGB_MIDPOINT_FLOATS                                            \
+  0.000151763496f, 0.000455290487f, 0.000758817478f, 0.00106234441f,         \
+  0.0013658714f, 0.00166939839f, 0.00197292538f, 0.00227645249f,             \
+  0.00257997937f, 0.00288350624f, 0.00318830088f, 0.00350925932f,            \
+  0.00384831498f, 0.00420574797f, 0.00458183279f, 0.00497683743f,            \
+  0.00539102405f, 0.00582465064f, 0.00627796957f, 0.00675122766f,            \
+  0.00724466844f, 0.00775853032f, 0.00829304848f, 0.00884845294f,            \
+  0.00942497049f, 0.0100228256f, 0.010642237f, 0.011283421f, 0.0119465925f,  \
+  0.0126319602f, 0.0133397318f, 0.0140701123f, 0.0148233026f, 0.0155995032f, \
+  0.0163989104f, 0.0172217153f, 0.0180681143f, 0.0189382937f, 0.0198324434f, \
+  0.0207507443f, 0.0216933824f, 0.0226605386f, 0.0236523896f, 0.0246691145f, \
+  0.0257108882f, 0.0267778821f, 0.0278702695f, 0.0289882198f, 0.0301319025f, \
+  0.0313014798f, 0.0324971229f, 0.0337189883f, 0.0349672437f, 0.0362420455f, \
+  0.0375435539f, 0.0388719253f, 0.04022732f, 0.041609887f, 0.0430197865f,    \
+  0.0444571637f, 0.0459221713f, 0.0474149622f, 0.0489356853f, 0.0504844859f, \
+  0.0520615056f, 0.0536668971f, 0.055300802f, 0.0569633618f, 0.0586547181f,  \
+  0.0603750125f, 0.0621243827f, 0.0639029741f, 0.0657109171f, 0.0675483495f, \
+  0.0694154128f, 0.0713122338f, 0.0732389539f, 0.0751957074f, 0.0771826133f, \
+  0.0791998208f, 0.0812474415f, 0.0833256245f, 0.085434489f, 0.0875741541f,  \
+  0.089744769f, 0.091946438f, 0.0941793025f, 0.0964434743f, 0.098739095f,    \
+  0.101066269f, 0.10342513f, 0.105815805f, 0.108238399f, 0.110693045f,       \
+  0.113179862f, 0.115698971f, 0.118250482f, 0.120834522f, 0.123451203f,      \
+  0.126100644f, 0.128782958f, 0.131498262f, 0.134246677f, 0.137028307f,      \
+  0.13984327f, 0.142691687f, 0.145573661f, 0.148489311f, 0.151438728f,       \
+  0.15442206f, 0.157439381f, 0.160490826f, 0.163576499f, 0.166696489f,       \
+  0.169850931f, 0.173039913f, 0.176263571f, 0.179521978f, 0.182815254f,      \
+  0.186143503f, 0.189506829f, 0.192905352f, 0.196339145f, 0.199808344f,      \
+  0.203313038f, 0.206853345f, 0.210429341f, 0.214041144f, 0.217688844f,      \
+  0.22137256f, 0.225092396f, 0.228848428f, 0.232640758f, 0.236469507f,       \
+  0.240334779f, 0.244236633f, 0.248175204f, 0.252150565f, 0.256162852f,      \
+  0.260212123f, 0.264298469f, 0.268422037f, 0.272582889f, 0.276781112f,      \
+  0.281016797f, 0.285290092f, 0.289601028f, 0.293949723f, 0.298336297f,      \
+  0.30276081f, 0.30722335f, 0.311724037f, 0.31626296f, 0.32084018f,          \
+  0.325455844f, 0.330109984f, 0.334802747f, 0.339534163f, 0.344304383f,      \
+  0.349113464f, 0.353961498f, 0.358848572f, 0.363774776f, 0.368740231f,      \
+  0.373744965f, 0.378789127f, 0.383872777f, 0.388996005f, 0.3941589f,        \
+  0.399361521f, 0.404604018f, 0.40988642f, 0.415208817f, 0.420571357f,       \
+  0.425974041f, 0.431417018f, 0.436900347f, 0.442424119f, 0.447988421f,      \
+  0.453593314f, 0.459238917f, 0.464925289f, 0.470652521f, 0.476420701f,      \
+  0.482229918f, 0.488080233f, 0.493971765f, 0.499904543f, 0.505878687f,      \
+  0.511894286f, 0.517951429f, 0.524050117f, 0.530190527f, 0.536372721f,      \
+  0.542596757f, 0.548862696f, 0.555170655f, 0.561520696f, 0.567912877f,      \
+  0.574347317f, 0.580824137f, 0.587343335f, 0.593904972f, 0.600509226f,      \
+  0.607156098f, 0.613845706f, 0.62057811f, 0.62735337f, 0.634171605f,        \
+  0.641032875f, 0.647937238f, 0.654884815f, 0.661875665f, 0.668909788f,      \
+  0.675987363f, 0.683108449f, 0.690273106f, 0.697481334f, 0.704733372f,      \
+  0.712029159f, 0.719368815f, 0.72675246f, 0.734180033f, 0.741651773f,       \
+  0.749167681f, 0.756727815f, 0.764332294f, 0.77198112f, 0.779674411f,       \
+  0.787412286f, 0.795194745f, 0.803021908f, 0.810893834f, 0.818810523f,      \
+  0.826772213f, 0.834778786f, 0.842830479f, 0.850927293f, 0.859069228f,      \
+  0.867256522f, 0.875489056f, 0.883767068f, 0.892090559f, 0.900459588f,      \
+  0.908874214f, 0.917334557f, 0.925840616f, 0.934392571f, 0.942990363f,      \
+  0.951634169f, 0.960324049f, 0.969060004f, 0.977842152f, 0.986670554f,      \
+  0.995545268f,
+
+#define CPAR_LINEAR_BUCKET_VALUES                                            \
+  0, 1, 2, 2, 3, 4, 5, 6, 6, 7, 8, 9, 10, 10, 11, 12, 13, 13, 14, 15, 15,    \
+  16, 16, 17, 18, 18, 19, 19, 20, 20, 21, 21, 22, 22, 23, 23, 23, 24, 24,    \
+  25, 25, 25, 26, 26, 27, 27, 27, 28, 28, 29, 29, 29, 30, 30, 30, 31, 31,    \
+  31, 32, 32, 32, 33, 33, 33, 34, 34, 34, 34, 35, 35, 35, 36, 36, 36, 36,    \
+  37, 37, 37, 38, 38, 38, 38, 39, 39, 39, 40, 40, 40, 40, 41, 41, 41, 41,    \
+  42, 42, 42, 42, 43, 43, 43, 43, 43, 44, 44, 44, 44, 45, 45, 45, 45, 46,    \
+  46, 46, 46, 46, 47, 47, 47, 47, 48, 48, 48, 48, 48, 49, 49, 49, 49, 49,    \
+  50, 50, 50, 50, 50, 51, 51, 51, 51, 51, 52, 52, 52, 52, 52, 53, 53, 53,    \
+  53, 53, 54, 54, 54, 54, 54, 55, 55, 55, 55, 55, 55, 56, 56, 56, 56, 56,    \
+  57, 57, 57, 57, 57, 57, 58, 58, 58, 58, 58, 58, 59, 59, 59, 59, 59, 59,    \
+  60, 60, 60, 60, 60, 60, 61, 61, 61, 61, 61, 61, 62, 62, 62, 62, 62, 62,    \
+  63, 63, 63, 63, 63, 63, 64, 64, 64, 64, 64, 64, 64, 65, 65, 65, 65, 65,    \
+  65, 66, 66, 66, 66, 66, 66, 66, 67, 67, 67, 67, 67, 67, 67, 68, 68, 68,    \
+  68, 68, 68, 68, 69, 69, 69, 69, 69, 69, 69, 70, 70, 70, 70, 70, 70, 70,    \
+  71, 71, 71, 71, 71, 71, 71, 72, 72, 72, 72, 72, 72, 72, 72, 73, 73, 73,    \
+  73, 73, 73, 73, 74, 74, 74, 74, 74, 74, 74, 74, 75, 75, 75, 75, 75, 75,    \
+  75, 75, 76, 76, 76, 76, 76, 76, 76, 77, 77, 77, 77, 77, 77, 77, 77, 77,    \
+  78, 78, 78, 78, 78, 78, 78, 78, 79, 79, 79, 79, 79, 79, 79, 79, 80, 80,    \
+  80, 80, 80, 80, 80, 80, 81, 81, 81, 81, 81, 81, 81, 81, 81, 82, 82, 82,    \
+  82, 82, 82, 82, 82, 83, 83, 83, 83, 83, 83, 83, 83, 83, 84, 84, 84, 84,    \
+  84, 84, 84, 84, 84, 85, 85, 85, 85, 85, 85, 85, 85, 85, 86, 86, 86, 86,    \
+  86, 86, 86, 86, 86, 87, 87, 87, 87, 87, 87, 87, 87, 87, 87, 88, 88, 88,    \
+  88, 88, 88, 88, 88, 88, 89, 89, 89, 89, 89, 89, 89, 89, 89, 90, 90, 90,    \
+  90, 90, 90, 90, 90, 90, 90, 91, 91, 91, 91, 91, 91, 91, 91, 91, 91, 92,    \
+  92, 92, 92, 92, 92, 92, 92, 92, 92, 93, 93, 93, 93, 93, 93, 93, 93, 93,    \
+  93, 94, 94, 94, 94, 94, 94, 94, 94, 94, 94, 95, 95, 95, 95, 95, 95, 95,    \
+  95, 95, 95, 96, 96, 96, 96, 96, 96, 96, 96, 96, 96, 96, 97, 97, 97, 97,    \
+  97, 97, 97, 97, 97, 97, 98, 98, 98, 98, 98, 98, 98, 98, 98, 98, 98, 99,    \
+  99, 99, 99, 99, 99, 99, 99, 99, 99, 99, 100, 100, 100, 100, 100, 100, 100, \
+  100, 100, 100, 100, 101, 101, 101, 101, 101, 101, 101, 101, 101, 101, 101, \
+  102, 102, 102, 102, 102, 102, 102, 102, 102, 102, 102, 103, 103, 103, 103, \
+  103, 103, 103, 103, 103, 103, 103, 103, 104, 104, 104, 104, 104, 104, 104, \
+  104, 104, 104, 104, 105, 105, 105, 105, 105, 105, 105, 105, 105, 105, 105, \
+  105, 106, 106, 106, 106, 106, 106, 106, 106, 106, 106, 106, 106, 107, 107, \
+  107, 107, 107, 107, 107, 107, 107, 107, 107, 107, 108, 108, 108, 108, 108, \
+  108, 108, 108, 108, 108, 108, 108, 109, 109, 109, 109, 109, 109, 109, 109, \
+  109, 109, 109, 109, 110, 110, 110, 110, 110, 110, 110, 110, 110, 110, 110, \
+  110, 111, 111, 111, 111, 111, 111, 111, 111, 111, 111, 111, 111, 111, 112, \
+  112, 112, 112, 112, 112, 112, 112, 112, 112, 112, 112, 112, 113, 113, 113, \
+  113, 113, 113, 113, 113, 113, 113, 113, 113, 114, 114, 114, 114, 114, 114, \
+  114, 114, 114, 114, 114, 114, 114, 115, 115, 115, 115, 115, 115, 115, 115, \
+  115, 115, 115, 115, 115, 116, 116, 116, 116, 116, 116, 116, 116, 116, 116, \
+  116, 116, 116, 117, 117, 117, 117, 117, 117, 117, 117, 117, 117, 117, 117, \
+  117, 117, 118, 118, 118, 118, 118, 118, 118, 118, 118, 118, 118, 118, 118, \
+  119, 119, 119, 119, 119, 119, 119, 119, 119, 119, 119, 119, 119, 119, 120, \
+  120, 120, 120, 120, 120, 120, 120, 120, 120, 120, 120, 120, 120, 121, 121, \
+  121, 121, 121, 121, 121, 121, 121, 121, 121, 121, 121, 121, 122, 122, 122, \
+  122, 122, 122, 122, 122, 122, 122, 122, 122, 122, 122, 123, 123, 123, 123, \
+  123, 123, 123, 123, 123, 123, 123, 123, 123, 123, 124, 124, 124, 124, 124, \
+  124, 124, 124, 124, 124, 124, 124, 124, 124, 125, 125, 125, 125, 125, 125, \
+  125, 125, 125, 125, 125, 125, 125, 125, 125, 126, 126, 126, 126, 126, 126, \
+  126, 126, 126, 126, 126, 126, 126, 126, 127, 127, 127, 127, 127, 127, 127, \
+  127, 127, 127, 127, 127, 127, 127, 127, 128, 128, 128, 128, 128, 128, 128, \
+  128, 128, 128, 128, 128, 128, 128, 128, 129, 129, 129, 129, 129, 129, 129, \
+  129, 129, 129, 129, 129, 129, 129, 129, 130, 130, 130, 130, 130, 130, 130, \
+  130, 130, 130, 130, 130, 130, 130, 130, 131, 131, 131, 131, 131, 131, 131, \
+  131, 131, 131, 131, 131, 131, 131, 131, 131, 132, 132, 132, 132, 132, 132, \
+  132, 132, 132, 132, 132, 132, 132, 132, 132, 133, 133, 133, 133, 133, 133, \
+  133, 133, 133, 133, 133, 133, 133, 133, 133, 133, 134, 134, 134, 134, 134, \
+  134, 134, 134, 134, 134, 134, 134, 134, 134, 134, 134, 135, 135, 135, 135, \
+  135, 135, 135, 135, 135, 135, 135, 135, 135, 135, 135, 135, 136, 136, 136, \
+  136, 136, 136, 136, 136, 136, 136, 136, 136, 136, 136, 136, 136, 137, 137, \
+  137, 137, 137, 137, 137, 137, 137, 137, 137, 137, 137, 137, 137, 137, 138, \
+  138, 138, 138, 138, 138, 138, 138, 138, 138, 138, 138, 138, 138, 138, 138, \
+  138, 139, 139, 139, 139, 139, 139, 139, 139, 139, 139, 139, 139, 139, 139, \
+  139, 139, 140, 140, 140, 140, 140, 140, 140, 140, 140, 140, 140, 140, 140, \
+  140, 140, 140, 140, 141, 141, 141, 141, 141, 141, 141, 141, 141, 141, 141, \
+  141, 141, 141, 141, 141, 141, 142, 142, 142, 142, 142, 142, 142, 142, 142, \
+  142, 142, 142, 142, 142, 142, 142, 142, 143, 143, 143, 143, 143, 143, 143, \
+  143, 143, 143, 143, 143, 143, 143, 143, 143, 143, 144, 144, 144, 144, 144, \
+  144, 144, 144, 144, 144, 144, 144, 144, 144, 144, 144, 144, 144, 145, 145, \
+  145, 145, 145, 145, 145, 145, 145, 145, 145, 145, 145, 145, 145, 145, 145, \
+  146, 146, 146, 146, 146, 146, 146, 146, 146, 146, 146, 146, 146, 146, 146, \
+  146, 146, 146, 147, 147, 147, 147, 147, 147, 147, 147, 147, 147, 147, 147, \
+  147, 147, 147, 147, 147, 147, 148, 148, 148, 148, 148, 148, 148, 148, 148, \
+  148, 148, 148, 148, 148, 148, 148, 148, 149, 149, 149, 149, 149, 149, 149, \
+  149, 149, 149, 149, 149, 149, 149, 149, 149, 149, 149, 149, 150, 150, 150, \
+  150, 150, 150, 150, 150, 150, 150, 150, 150, 150, 150, 150, 150, 150, 150, \
+  151, 151, 151, 151, 151, 151, 151, 151, 151, 151, 151, 151, 151, 151, 151, \
+  151, 151, 151, 152, 152, 152, 152, 152, 152, 152, 152, 152, 152, 152, 152, \
+  152, 152, 152, 152, 152, 152, 152, 153, 153, 153, 153, 153, 153, 153, 153, \
+  153, 153, 153, 153, 153, 153, 153, 153, 153, 153, 153, 154, 154, 154, 154, \
+  154, 154, 154, 154, 154, 154, 154, 154, 154, 154, 154, 154, 154, 154, 154, \
+  155, 155, 155, 155, 155, 155, 155, 155, 155, 155, 155, 155, 155, 155, 155, \
+  155, 155, 155, 155, 156, 156, 156, 156, 156, 156, 156, 156, 156, 156, 156, \
+  156, 156, 156, 156, 156, 156, 156, 156, 157, 157, 157, 157, 157, 157, 157, \
+  157, 157, 157, 157, 157, 157, 157, 157, 157, 157, 157, 157, 158, 158, 158, \
+  158, 158, 158, 158, 158, 158, 158, 158, 158, 158, 158, 158, 158, 158, 158, \
+  158, 158, 159, 159, 159, 159, 159, 159, 159, 159, 159, 159, 159, 159, 159, \
+  159, 159, 159, 159, 159, 159, 160, 160, 160, 160, 160, 160, 160, 160, 160, \
+  160, 160, 160, 160, 160, 160, 160, 160, 160, 160, 160, 161, 161, 161, 161, \
+  161, 161, 161, 161, 161, 161, 161, 161, 161, 161, 161, 161, 161, 161, 161, \
+  161, 162, 162, 162, 162, 162, 162, 162, 162, 162, 162, 162, 162, 162, 162, \
+  162, 162, 162, 162, 162, 162, 162, 163, 163, 163, 163, 163, 163, 163, 163, \
+  163, 163, 163, 163, 163, 163, 163, 163, 163, 163, 163, 163, 164, 164, 164, \
+  164, 164, 164, 164, 164, 164, 164, 164, 164, 164, 164, 164, 164, 164, 164, \
+  164, 164, 165, 165, 165, 165, 165, 165, 165, 165, 165, 165, 165, 165, 165, \
+  165, 165, 165, 165, 165, 165, 165, 165, 166, 166, 166, 166, 166, 166, 166, \
+  166, 166, 166, 166, 166, 166, 166, 166, 166, 166, 166, 166, 166, 166, 167, \
+  167, 167, 167, 167, 167, 167, 167, 167, 167, 167, 167, 167, 167, 167, 167, \
+  167, 167, 167, 167, 167, 168, 168, 168, 168, 168, 168, 168, 168, 168, 168, \
+  168, 168, 168, 168, 168, 168, 168, 168, 168, 168, 168, 169, 169, 169, 169, \
+  169, 169, 169, 169, 169, 169, 169, 169, 169, 169, 169, 169, 169, 169, 169, \
+  169, 169, 170, 170, 170, 170, 170, 170, 170, 170, 170, 170, 170, 170, 170, \
+  170, 170, 170, 170, 170, 170, 170, 170, 170, 171, 171, 171, 171, 171, 171, \
+  171, 171, 171, 171, 171, 171, 171, 171, 171, 171, 171, 171, 171, 171, 171, \
+  172, 172, 172, 172, 172, 172, 172, 172, 172, 172, 172, 172, 172, 172, 172, \
+  172, 172, 172, 172, 172, 172, 172, 173, 173, 173, 173, 173, 173, 173, 173, \
+  173, 173, 173, 173, 173, 173, 173, 173, 173, 173, 173, 173, 173, 173, 174, \
+  174, 174, 174, 174, 174, 174, 174, 174, 174, 174, 174, 174, 174, 174, 174, \
+  174, 174, 174, 174, 174, 174, 175, 175, 175, 175, 175, 175, 175, 175, 175, \
+  175, 175, 175, 175, 175, 175, 175, 175, 175, 175, 175, 175, 175, 175, 176, \
+  176, 176, 176, 176, 176, 176, 176, 176, 176, 176, 176, 176, 176, 176, 176, \
+  176, 176, 176, 176, 176, 176, 177, 177, 177, 177, 177, 177, 177, 177, 177, \
+  177, 177, 177, 177, 177, 177, 177, 177, 177, 177, 177, 177, 177, 177, 178, \
+  178, 178, 178, 178, 178, 178, 178, 178, 178, 178, 178, 178, 178, 178, 178, \
+  178, 178, 178, 178, 178, 178, 179, 179, 179, 179, 179, 179, 179, 179, 179, \
+  179, 179, 179, 179, 179, 179, 179, 179, 179, 179, 179, 179, 179, 179, 180, \
+  180, 180, 180, 180, 180, 180, 180, 180, 180, 180, 180, 180, 180, 180, 180, \
+  180, 180, 180, 180, 180, 180, 180, 180, 181, 181, 181, 181, 181, 181, 181, \
+  181, 181, 181, 181, 181, 181, 181, 181, 181, 181, 181, 181, 181, 181, 181, \
+  181, 182, 182, 182, 182, 182, 182, 182, 182, 182, 182, 182, 182, 182, 182, \
+  182, 182, 182, 182, 182, 182, 182, 182, 182, 183, 183, 183, 183, 183, 183, \
+  183, 183, 183, 183, 183, 183, 183, 183, 183, 183, 183, 183, 183, 183, 183, \
+  183, 183, 183, 184, 184, 184, 184, 184, 184, 184, 184, 184, 184, 184, 184, \
+  184, 184, 184, 184, 184, 184, 184, 184, 184, 184, 184, 184, 185, 185, 185, \
+  185, 185, 185, 185, 185, 185, 185, 185, 185, 185, 185, 185, 185, 185, 185, \
+  185, 185, 185, 185, 185, 185, 186, 186, 186, 186, 186, 186, 186, 186, 186, \
+  186, 186, 186, 186, 186, 186, 186, 186, 186, 186, 186, 186, 186, 186, 186, \
+  187, 187, 187, 187, 187, 187, 187, 187, 187, 187, 187, 187, 187, 187, 187, \
+  187, 187, 187, 187, 187, 187, 187, 187, 187, 188, 188, 188, 188, 188, 188, \
+  188, 188, 188, 188, 188, 188, 188, 188, 188, 188, 188, 188, 188, 188, 188, \
+  188, 188, 188, 188, 189, 189, 189, 189, 189, 189, 189, 189, 189, 189, 189, \
+  189, 189, 189, 189, 189, 189, 189, 189, 189, 189, 189, 189, 189, 190, 190, \
+  190, 190, 190, 190, 190, 190, 190, 190, 190, 190, 190, 190, 190, 190, 190, \
+  190, 190, 190, 190, 190, 190, 190, 190, 191, 191, 191, 191, 191, 191, 191, \
+  191, 191, 191, 191, 191, 191, 191, 191, 191, 191, 191, 191, 191, 191, 191, \
+  191, 191, 191, 192, 192, 192, 192, 192, 192, 192, 192, 192, 192, 192, 192, \
+  192, 192, 192, 192, 192, 192, 192, 192, 192, 192, 192, 192, 192, 193, 193, \
+  193, 193, 193, 193, 193, 193, 193, 193, 193, 193, 193, 193, 193, 193, 193, \
+  193, 193, 193, 193, 193, 193, 193, 193, 194, 194, 194, 194, 194, 194, 194, \
+  194, 194, 194, 194, 194, 194, 194, 194, 194, 194, 194, 194, 194, 194, 194, \
+  194, 194, 194, 194, 195, 195, 195, 195, 195, 195, 195, 195, 195, 195, 195, \
+  195, 195, 195, 195, 195, 195, 195, 195, 195, 195, 195, 195, 195, 195, 195, \
+  196, 196, 196, 196, 196, 196, 196, 196, 196, 196, 196, 196, 196, 196, 196, \
+  196, 196, 196, 196, 196, 196, 196, 196, 196, 196, 197, 197, 197, 197, 197, \
+  197, 197, 197, 197, 197, 197, 197, 197, 197, 197, 197, 197, 197, 197, 197, \
+  197, 197, 197, 197, 197, 197, 198, 198, 198, 198, 198, 198, 198, 198, 198, \
+  198, 198, 198, 198, 198, 198, 198, 198, 198, 198, 198, 198, 198, 198, 198, \
+  198, 198, 198, 199, 199, 199, 199, 199, 199, 199, 199, 199, 199, 199, 199, \
+  199, 199, 199, 199, 199, 199, 199, 199, 199, 199, 199, 199, 199, 199, 200, \
+  200, 200, 200, 200, 200, 200, 200, 200, 200, 200, 200, 200, 200, 200, 200, \
+  200, 200, 200, 200, 200, 200, 200, 200, 200, 200, 200, 201, 201, 201, 201, \
+  201, 201, 201, 201, 201, 201, 201, 201, 201, 201, 201, 201, 201, 201, 201, \
+  201, 201, 201, 201, 201, 201, 201, 202, 202, 202, 202, 202, 202, 202, 202, \
+  202, 202, 202, 202, 202, 202, 202, 202, 202, 202, 202, 202, 202, 202, 202, \
+  202, 202, 202, 202, 203, 203, 203, 203, 203, 203, 203, 203, 203, 203, 203, \
+  203, 203, 203, 203, 203, 203, 203, 203, 203, 203, 203, 203, 203, 203, 203, \
+  203, 204, 204, 204, 204, 204, 204, 204, 204, 204, 204, 204, 204, 204, 204, \
+  204, 204, 204, 204, 204, 204, 204, 204, 204, 204, 204, 204, 204, 205, 205, \
+  205, 205, 205, 205, 205, 205, 205, 205, 205, 205, 205, 205, 205, 205, 205, \
+  205, 205, 205, 205, 205, 205, 205, 205, 205, 205, 205, 206, 206, 206, 206, \
+  206, 206, 206, 206, 206, 206, 206, 206, 206, 206, 206, 206, 206, 206, 206, \
+  206, 206, 206, 206, 206, 206, 206, 206, 207, 207, 207, 207, 207, 207, 207, \
+  207, 207, 207, 207, 207, 207, 207, 207, 207, 207, 207, 207, 207, 207, 207, \
+  207, 207, 207, 207, 207, 207, 208, 208, 208, 208, 208, 208, 208, 208, 208, \
+  208, 208, 208, 208, 208, 208, 208, 208, 208, 208, 208, 208, 208, 208, 208, \
+  208, 208, 208, 208, 209, 209, 209, 209, 209, 209, 209, 209, 209, 209, 209, \
+  209, 209, 209, 209, 209, 209, 209, 209, 209, 209, 209, 209, 209, 209, 209, \
+  209, 209, 210, 210, 210, 210, 210, 210, 210, 210, 210, 210, 210, 210, 210, \
+  210, 210, 210, 210, 210, 210, 210, 210, 210, 210, 210, 210, 210, 210, 210, \
+  211, 211, 211, 211, 211, 211, 211, 211, 211, 211, 211, 211, 211, 211, 211, \
+  211, 211, 211, 211, 211, 211, 211, 211, 211, 211, 211, 211, 211, 211, 212, \
+  212, 212, 212, 212, 212, 212, 212, 212, 212, 212, 212, 212, 212, 212, 212, \
+  212, 212, 212, 212, 212, 212, 212, 212, 212, 212, 212, 212, 212, 213, 213, \
+  213, 213, 213, 213, 213, 213, 213, 213, 213, 213, 213, 213, 213, 213, 213, \
+  213, 213, 213, 213, 213, 213, 213, 213, 213, 213, 213, 214, 214, 214, 214, \
+  214, 214, 214, 214, 214, 214, 214, 214, 214, 214, 214, 214, 214, 214, 214, \
+  214, 214, 214, 214, 214, 214, 214, 214, 214, 214, 215, 215, 215, 215, 215, \
+  215, 215, 215, 215, 215, 215, 215, 215, 215, 215, 215, 215, 215, 215, 215, \
+  215, 215, 215, 215, 215, 215, 215, 215, 215, 215, 216, 216, 216, 216, 216, \
+  216, 216, 216, 216, 216, 216, 216, 216, 216, 216, 216, 216, 216, 216, 216, \
+  216, 216, 216, 216, 216, 216, 216, 216, 216, 217, 217, 217, 217, 217, 217, \
+  217, 217, 217, 217, 217, 217, 217, 217, 217, 217, 217, 217, 217, 217, 217, \
+  217, 217, 217, 217, 217, 217, 217, 217, 218, 218, 218, 218, 218, 218, 218, \
+  218, 218, 218, 218, 218, 218, 218, 218, 218, 218, 218, 218, 218, 218, 218, \
+  218, 218, 218, 218, 218, 218, 218, 218, 219, 219, 219, 219, 219, 219, 219, \
+  219, 219, 219, 219, 219, 219, 219, 219, 219, 219, 219, 219, 219, 219, 219, \
+  219, 219, 219, 219, 219, 219, 219, 219, 220, 220, 220, 220, 220, 220, 220, \
+  220, 220, 220, 220, 220, 220, 220, 220, 220, 220, 220, 220, 220, 220, 220, \
+  220, 220, 220, 220, 220, 220, 220, 220, 221, 221, 221, 221, 221, 221, 221, \
+  221, 221, 221, 221, 221, 221, 221, 221, 221, 221, 221, 221, 221, 221, 221, \
+  221, 221, 221, 221, 221, 221, 221, 221, 222, 222, 222, 222, 222, 222, 222, \
+  222, 222, 222, 222, 222, 222, 222, 222, 222, 222, 222, 222, 222, 222, 222, \
+  222, 222, 222, 222, 222, 222, 222, 222, 222, 223, 223, 223, 223, 223, 223, \
+  223, 223, 223, 223, 223, 223, 223, 223, 223, 223, 223, 223, 223, 223, 223, \
+  223, 223, 223, 223, 223, 223, 223, 223, 223, 224, 224, 224, 224, 224, 224, \
+  224, 224, 224, 224, 224, 224, 224, 224, 224, 224, 224, 224, 224, 224, 224, \
+  224, 224, 224, 224, 224, 224, 224, 224, 224, 224, 225, 225, 225, 225, 225, \
+  225, 225, 225, 225, 225, 225, 225, 225, 225, 225, 225, 225, 225, 225, 225, \
+  225, 225, 225, 225, 225, 225, 225, 225, 225, 225, 225, 226, 226, 226, 226, \
+  226, 226, 226, 226, 226, 226, 226, 226, 226, 226, 226, 226, 226, 226, 226, \
+  226, 226, 226, 226, 226, 226, 226, 226, 226, 226, 226, 226, 227, 227, 227, \
+  227, 227, 227, 227, 227, 227, 227, 227, 227, 227, 227, 227, 227, 227, 227, \
+  227, 227, 227, 227, 227, 227, 227, 227, 227, 227, 227, 227, 227, 227, 228, \
+  228, 228, 228, 228, 228, 228, 228, 228, 228, 228, 228, 228, 228, 228, 228, \
+  228, 228, 228, 228, 228, 228, 228, 228, 228, 228, 228, 228, 228, 228, 228, \
+  229, 229, 229, 229, 229, 229, 229, 229, 229, 229, 229, 229, 229, 229, 229, \
+  229, 229, 229, 229, 229, 229, 229, 229, 229, 229, 229, 229, 229, 229, 229, \
+  229, 229, 230, 230, 230, 230, 230, 230, 230, 230, 230, 230, 230, 230, 230, \
+  230, 230, 230, 230, 230, 230, 230, 230, 230, 230, 230, 230, 230, 230, 230, \
+  230, 230, 230, 230, 231, 231, 231, 231, 231, 231, 231, 231, 231, 231, 231, \
+  231, 231, 231, 231, 231, 231, 231, 231, 231, 231, 231, 231, 231, 231, 231, \
+  231, 231, 231, 231, 231, 231, 232, 232, 232, 232, 232, 232, 232, 232, 232, \
+  232, 232, 232, 232, 232, 232, 232, 232, 232, 232, 232, 232, 232, 232, 232, \
+  232, 232, 232, 232, 232, 232, 232, 232, 233, 233, 233, 233, 233, 233, 233, \
+  233, 233, 233, 233, 233, 233, 233, 233, 233, 233, 233, 233, 233, 233, 233, \
+  233, 233, 233, 233, 233, 233, 233, 233, 233, 233, 234, 234, 234, 234, 234, \
+  234, 234, 234, 234, 234, 234, 234, 234, 234, 234, 234, 234, 234, 234, 234, \
+  234, 234, 234, 234, 234, 234, 234, 234, 234, 234, 234, 234, 234, 235, 235, \
+  235, 235, 235, 235, 235, 235, 235, 235, 235, 235, 235, 235, 235, 235, 235, \
+  235, 235, 235, 235, 235, 235, 235, 235, 235, 235, 235, 235, 235, 235, 235, \
+  235, 236, 236, 236, 236, 236, 236, 236, 236, 236, 236, 236, 236, 236, 236, \
+  236, 236, 236, 236, 236, 236, 236, 236, 236, 236, 236, 236, 236, 236, 236, \
+  236, 236, 236, 236, 237, 237, 237, 237, 237, 237, 237, 237, 237, 237, 237, \
+  237, 237, 237, 237, 237, 237, 237, 237, 237, 237, 237, 237, 237, 237, 237, \
+  237, 237, 237, 237, 237, 237, 237, 238, 238, 238, 238, 238, 238, 238, 238, \
+  238, 238, 238, 238, 238, 238, 238, 238, 238, 238, 238, 238, 238, 238, 238, \
+  238, 238, 238, 238, 238, 238, 238, 238, 238, 238, 239, 239, 239, 239, 239, \
+  239, 239, 239, 239, 239, 239, 239, 239, 239, 239, 239, 239, 239, 239, 239, \
+  239, 239, 239, 239, 239, 239, 239, 239, 239, 239, 239, 239, 239, 239, 240, \
+  240, 240, 240, 240, 240, 240, 240, 240, 240, 240, 240, 240, 240, 240, 240, \
+  240, 240, 240, 240, 240, 240, 240, 240, 240, 240, 240, 240, 240, 240, 240, \
+  240, 240, 240, 241, 241, 241, 241, 241, 241, 241, 241, 241, 241, 241, 241, \
+  241, 241, 241, 241, 241, 241, 241, 241, 241, 241, 241, 241, 241, 241, 241, \
+  241, 241, 241, 241, 241, 241, 242, 242, 242, 242, 242, 242, 242, 242, 242, \
+  242, 242, 242, 242, 242, 242, 242, 242, 242, 242, 242, 242, 242, 242, 242, \
+  242, 242, 242, 242, 242, 242, 242, 242, 242, 242, 242, 243, 243, 243, 243, \
+  243, 243, 243, 243, 243, 243, 243, 243, 243, 243, 243, 243, 243, 243, 243, \
+  243, 243, 243, 243, 243, 243, 243, 243, 243, 243, 243, 243, 243, 243, 243, \
+  244, 244, 244, 244, 244, 244, 244, 244, 244, 244, 244, 244, 244, 244, 244, \
+  244, 244, 244, 244, 244, 244, 244, 244, 244, 244, 244, 244, 244, 244, 244, \
+  244, 244, 244, 244, 245, 245, 245, 245, 245, 245, 245, 245, 245, 245, 245, \
+  245, 245, 245, 245, 245, 245, 245, 245, 245, 245, 245, 245, 245, 245, 245, \
+  245, 245, 245, 245, 245, 245, 245, 245, 245, 246, 246, 246, 246, 246, 246, \
+  246, 246, 246, 246, 246, 246, 246, 246, 246, 246, 246, 246, 246, 246, 246, \
+  246, 246, 246, 246, 246, 246, 246, 246, 246, 246, 246, 246, 246, 246, 247, \
+  247, 247, 247, 247, 247, 247, 247, 247, 247, 247, 247, 247, 247, 247, 247, \
+  247, 247, 247, 247, 247, 247, 247, 247, 247, 247, 247, 247, 247, 247, 247, \
+  247, 247, 247, 247, 248, 248, 248, 248, 248, 248, 248, 248, 248, 248, 248, \
+  248, 248, 248, 248, 248, 248, 248, 248, 248, 248, 248, 248, 248, 248, 248, \
+  248, 248, 248, 248, 248, 248, 248, 248, 248, 249, 249, 249, 249, 249, 249, \
+  249, 249, 249, 249, 249, 249, 249, 249, 249, 249, 249, 249, 249, 249, 249, \
+  249, 249, 249, 249, 249, 249, 249, 249, 249, 249, 249, 249, 249, 249, 250, \
+  250, 250, 250, 250, 250, 250, 250, 250, 250, 250, 250, 250, 250, 250, 250, \
+  250, 250, 250, 250, 250, 250, 250, 250, 250, 250, 250, 250, 250, 250, 250, \
+  250, 250, 250, 250, 250, 251, 251, 251, 251, 251, 251, 251, 251, 251, 251, \
+  251, 251, 251, 251, 251, 251, 251, 251, 251, 251, 251, 251, 251, 251, 251, \
+  251, 251, 251, 251, 251, 251, 251, 251, 251, 251, 251, 252, 252, 252, 252, \
+  252, 252, 252, 252, 252, 252, 252, 252, 252, 252, 252, 252, 252, 252, 252, \
+  252, 252, 252, 252, 252, 252, 252, 252, 252, 252, 252, 252, 252, 252, 252, \
+  252, 252, 253, 253, 253, 253, 253, 253, 253, 253, 253, 253, 253, 253, 253, \
+  253, 253, 253, 253, 253, 253, 253, 253, 253, 253, 253, 253, 253, 253, 253, \
+  253, 253, 253, 253, 253, 253, 253, 253, 254, 254, 254, 254, 254, 254, 254, \
+  254, 254, 254, 254, 254, 254, 254, 254, 254, 254, 254, 254, 254, 254, 254, \
+  254, 254, 254, 254, 254, 254, 254, 254, 254, 254, 254, 254, 254, 254, 255, \
+  255, 255, 255, 255, 255, 255, 255, 255, 255, 255, 255, 255, 255, 255, 255, \
+  255, 255, 255, 255, 255,
+
+#endif
+
+/* END GENERATED COLOR SPACE TABLES */
+
+#if defined(__cplusplus) && !defined(CPAR_HPP)
+#define CPAR_HPP 1
+
+#include <charconv>
+#include <cstddef>
+#include <cstring>
+#include <initializer_list>
+#include <iterator>
+#include <new>
+#include <ostream>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+#ifndef CPAR_NO_THREAD_POOL
+#include <atomic>
+#include <condition_variable>
+#include <mutex>
+#include <thread>
+#endif
+
+/**
+ * Expands to `consteval` where the compiler supports it, so that parsing a
+ * colour literal which isn't valid is always a compile error, or to
+ * `constexpr` before C++20.
+ */
+#if defined(__cpp_consteval) && __cpp_consteval >= 201811L
+#define CPAR_CONSTEVAL consteval
+#else
+#define CPAR_CONSTEVAL constexpr
+#endif
+
+// whether the compiler can reinterpret the bits of a float in a constant
+// expression, which is quicker at run time than working them out
+#if defined(__has_builtin)
+#if __has_builtin(__builtin_bit_cast)
+#define CPAR_HAVE_BIT_CAST 1
+#endif
+#endif
+
+namespace cpar
+{
+
+  /*
+   * A constexpr version of cpar_color_parse_n(), used for colour literals.
+   * It must give the same results as the C implementation, which the tests
+   * check.
+   */
+  namespace detail
+  {
+
+    struct color_name {
+      std::string_view name;
+      uint32_t value;
+    };
+
+    inline constexpr color_name color_names[] = {
+#define CPAR_COLOR_NAME_ENTRY(name, r, g, b, a) \
+  {name, CPAR_COLOR_MAKE(r, g, b, a)},
+        CPAR_COLOR_NAME_LIST(CPAR_COLOR_NAME_ENTRY)
+#undef CPAR_COLOR_NAME_ENTRY
+    };
+
+    constexpr bool is_space(char c) noexcept
+    {
+      return c == ' ' || (c >= '\t' && c <= '\r');
+    }
+
+    constexpr bool is_digit(char c) noexcept { return c >= '0' && c <= '9'; }
+
+    constexpr char to_lower(char c) noexcept
+    {
+      return (c >= 'A' && c <= 'Z') ? static_cast<char>(c - 'A' + 'a') : c;
+    }
+
+    constexpr int hex_digit(char c) noexcept
+    {
+      if (is_digit(c))
+        return c - '0';
+      else if (c >= 'a' && c <= 'f')
+        return c - 'a' + 10;
+      else if (c >= 'A' && c <= 'F')
+        return c - 'A' + 10;
+      return -1;
+    }
+
+    constexpr std::string_view trim(std::string_view str) noexcept
+    {
+      while (!str.empty() && is_space(str.front()))
+        str.remove_prefix(1);
+      while (!str.empty() && is_space(str.back()))
+        str.remove_suffix(1);
+      return str;
+    }
+
+    constexpr bool match_word(std::string_view &str,
+                              std::string_view word) noexcept
+    {
+      std::string_view rest = str;
+      for (char c : word) {
+        rest = trim(rest);
+        if (rest.empty() || to_lower(rest.front()) != c)
+          return false;
+        rest.remove_prefix(1);
+      }
+      str = rest;
+      return true;
+    }
+
+    constexpr cpar_status parse_hex(std::string_view hex,
+                                    uint32_t &value) noexcept
+    {
+      uint32_t v = 0;
+      size_t n_digits = 0;
+      bool bad = false;
+
+      for (char c : hex) {
+        if (is_space(c))
+          continue;
+        int digit = hex_digit(c);
+        bad |= digit < 0;
+        v = (v << 4) | static_cast<uint32_t>(digit & 0xF);
+        n_digits++;
+      }
+
+      if (n_digits == 3) {
+        v = ((((v >> 8) & 0xF) * 0x11u) << 24) |
+            ((((v >> 4) & 0xF) * 0x11u) << 16) | (((v & 0xF) * 0x11u) << 8) |
+            0xFF;
+      } else if (n_digits == 6) {
+        v = (v << 8) | 0xFF;
+      } else if (n_digits != 8) {
+        return CPAR_STATUS_SYNTAX_ERROR;
+      }
+
+      if (bad)
+        return CPAR_STATUS_INVALID_NUMBER;
+
+      value = v;
+      return CPAR_STATUS_OK;
+    }
+
+    inline constexpr int64_t fixed_one = 1000000000;
+    inline constexpr int64_t fixed_max = 1000000 * fixed_one;
+
+    constexpr uint64_t pow10(long n) noexcept
+    {
+      uint64_t p = 1;
+      for (; n > 0; n--)
+        p *= 10;
+      return p;
+    }
+
+    constexpr cpar_status parse_fixed(std::string_view str,
+                                      int64_t &out) noexcept
+    {
+      uint64_t mantissa = 0;
+      int n_significant = 0;
+      bool seen_digit = false;
+      bool seen_point = false;
+      bool negative = false;
+      long exponent = 0;
+      size_t i = 0;
+
+      str = trim(str);
+      if (!str.empty() && (str[0] == '+' || str[0] == '-'))
+        negative = str[i++] == '-';
+
+      for (; i < str.size(); i++) {
+        char c = str[i];
+        if (is_space(c)) {
+          continue;
+        } else if (is_digit(c)) {
+          seen_digit = true;
+          if (n_significant < 18) {
+            mantissa = mantissa * 10 + static_cast<uint64_t>(c - '0');
+            n_significant += mantissa != 0;
+            exponent -= seen_point;
+          } else if (!seen_point) {
+            exponent++;
+          }
+        } else if (c == '.' && !seen_point) {
+          seen_point = true;
+        } else {
+          break;
+        }
+      }
+
+      if (!seen_digit)
+        return CPAR_STATUS_INVALID_NUMBER;
+
+      if (i < str.size() && (str[i] == 'e' || str[i] == 'E')) {
+        std::string_view rest = trim(str.substr(i + 1));
+        bool exp_negative = false;
+        if (!rest.empty() && (rest[0] == '+' || rest[0] == '-')) {
+          exp_negative = rest[0] == '-';
+          rest = trim(rest.substr(1));
+        }
+        if (rest.empty())
+          return CPAR_STATUS_INVALID_NUMBER;
+
+        long exp = 0;
+        for (char c : rest) {
+          if (is_space(c))
+            continue;
+          else if (!is_digit(c))
+            return CPAR_STATUS_INVALID_NUMBER;
+          if (exp < 10000)
+            exp = exp * 10 + (c - '0');
+        }
+        exponent += exp_negative ? -exp : exp;
+        i = str.size();
+      }
+
+      if (i != str.size())
+        return CPAR_STATUS_INVALID_NUMBER;
+
+      constexpr uint64_t max = static_cast<uint64_t>(fixed_max);
+      exponent += 9;
+      if (exponent > 0) {
+        if (exponent > 15 || mantissa > max / pow10(exponent))
+          mantissa = mantissa ? max : 0;
+        else
+          mantissa *= pow10(exponent);
+      } else if (exponent < 0) {
+        mantissa = (exponent < -18) ? 0 : mantissa / pow10(-exponent);
+      }
+
+      out = negative ? -static_cast<int64_t>(mantissa)
+                     : static_cast<int64_t>(mantissa);
+      return CPAR_STATUS_OK;
+    }
+
+    constexpr bool strip_suffix(std::string_view &str,
+                                std::string_view suffix) noexcept
+    {
+      std::string_view rest = str;
+      while (!rest.empty() && is_space(rest.back()))
+        rest.remove_suffix(1);
+      if (rest.size() < suffix.size())
+        return false;
+      for (size_t i = 0; i < suffix.size(); i++) {
+        if (to_lower(rest[rest.size() - suffix.size() + i]) != suffix[i])
+          return false;
+      }
+      rest.remove_suffix(suffix.size());
+      str = rest;
+      return true;
+    }
+
+    constexpr cpar_status parse_component_rgb(std::string_view str,
+                                              uint8_t &out) noexcept
+    {
+      bool negative = false;
+      size_t n_digits = 0;
+      uint32_t val = 0;
+
+      if (strip_suffix(str, "%")) {
+        int64_t fixed = 0;
+        if (cpar_status status = parse_fixed(str, fixed);
+            status != CPAR_STATUS_OK) {
+          return status;
+        } else if (fixed < 0 || fixed > 100 * fixed_one) {
+          return CPAR_STATUS_NUMBER_RANGE;
+        }
+        out = static_cast<uint8_t>((fixed * 255 + 50 * fixed_one) /
+                                   (100 * fixed_one));
+        return CPAR_STATUS_OK;
+      }
+
+      str = trim(str);
+      if (!str.empty() && (str.front() == '+' || str.front() == '-')) {
+        negative = str.front() == '-';
+        str.remove_prefix(1);
+      }
+
+      for (char c : str) {
+        if (is_space(c))
+          continue;
+        if (!is_digit(c))
+          return CPAR_STATUS_INVALID_NUMBER;
+        if (val <= 255)
+          val = val * 10 + static_cast<uint32_t>(c - '0');
+        n_digits++;
+      }
+
+      if (n_digits == 0)
+        return CPAR_STATUS_INVALID_NUMBER;
+      else if ((negative && val != 0) || val > 255)
+        return CPAR_STATUS_NUMBER_RANGE;
+
+      out = static_cast<uint8_t>(val);
+      return CPAR_STATUS_OK;
+    }
+
+    constexpr cpar_status parse_component_a(std::string_view str,
+                                            uint8_t &out) noexcept
+    {
+      int64_t fixed = 0;
+      bool percent = strip_suffix(str, "%");
+      if (cpar_status status = parse_fixed(str, fixed);
+          status != CPAR_STATUS_OK) {
+        return status;
+      }
+      if (percent)
+        fixed /= 100;
+      if (fixed < 0 || fixed > fixed_one)
+        return CPAR_STATUS_NUMBER_RANGE;
+
+      out = static_cast<uint8_t>((fixed * 255 + fixed_one / 2) / fixed_one);
+      return CPAR_STATUS_OK;
+    }
+
+    inline constexpr int64_t percent_one = 10000;
+    inline constexpr int64_t hue_turn = 360000;
+
+    constexpr cpar_status parse_component_percent(std::string_view str,
+                                                  int32_t &out) noexcept
+    {
+      int64_t fixed = 0;
+      strip_suffix(str, "%");
+      if (cpar_status status = parse_fixed(str, fixed);
+          status != CPAR_STATUS_OK) {
+        return status;
+      } else if (fixed < 0 || fixed > 100 * fixed_one) {
+        return CPAR_STATUS_NUMBER_RANGE;
+      }
+
+      out = static_cast<int32_t>((fixed + fixed_one / 200) / (fixed_one / 100));
+      return CPAR_STATUS_OK;
+    }
+
+    constexpr cpar_status parse_component_hue(std::string_view str,
+                                              int32_t &out) noexcept
+    {
+      int64_t turn = 360 * fixed_one;
+      int64_t fixed = 0;
+
+      if (strip_suffix(str, "deg"))
+        turn = 360 * fixed_one;
+      else if (strip_suffix(str, "grad"))
+        turn = 400 * fixed_one;
+      else if (strip_suffix(str, "rad"))
+        turn = 6283185307;
+      else if (strip_suffix(str, "turn"))
+        turn = fixed_one;
+
+      if (cpar_status status = parse_fixed(str, fixed);
+          status != CPAR_STATUS_OK) {
+        return status;
+      }
+
+      fixed %= turn;
+      if (fixed < 0)
+        fixed += turn;
+      out = static_cast<int32_t>(fixed * hue_turn / turn);
+      return CPAR_STATUS_OK;
+    }
+
+    constexpr int64_t hue_ramp(int32_t hue, int n) noexcept
+    {
+      constexpr int64_t sector = hue_turn / 12;
+      int64_t k = (n * sector + hue) % hue_turn;
+      int64_t t = k - 3 * sector;
+      if (9 * sector - k < t)
+        t = 9 * sector - k;
+      if (t > sector)
+        t = sector;
+      else if (t < -sector)
+        t = -sector;
+      return t;
+    }
+
+    constexpr void hsl_to_rgb(int32_t hue,
+                              int32_t sat,
+                              int32_t light,
+                              uint8_t (&rgb)[3]) noexcept
+    {
+      constexpr int64_t sector = hue_turn / 12;
+      constexpr int64_t denom = percent_one * percent_one * sector;
+      int64_t chroma =
+          sat * (light < percent_one - light ? light : percent_one - light);
+      for (int i = 0; i < 3; i++) {
+        int64_t v = light * percent_one * sector -
+                    chroma * hue_ramp(hue, (12 - 4 * i) % 12);
+        rgb[i] = static_cast<uint8_t>((255 * v + denom / 2) / denom);
+      }
+    }
+
+    constexpr void hwb_to_rgb(int32_t hue,
+                              int32_t white,
+                              int32_t black,
+                              uint8_t (&rgb)[3]) noexcept
+    {
+      constexpr int64_t sector = hue_turn / 12;
+      constexpr int64_t denom = 2 * sector * percent_one;
+      if (white + black >= percent_one) {
+        int64_t sum = white + black;
+        rgb[0] = rgb[1] = rgb[2] =
+            static_cast<uint8_t>((255 * white + sum / 2) / sum);
+        return;
+      }
+      for (int i = 0; i < 3; i++) {
+        int64_t v = (sector - hue_ramp(hue, (12 - 4 * i) % 12)) *
+                        (percent_one - white - black) +
+                    2 * sector * white;
+        rgb[i] = static_cast<uint8_t>((255 * v + denom / 2) / denom);
+      }
+    }
+
+    // skips empty components like cpar_split_comma()
+    constexpr int split_comma(std::string_view str,
+                              int n_comp,
+                              std::string_view (&comp)[4]) noexcept
+    {
+      int i = 0;
+      size_t pos = 0;
+
+      while (i < n_comp) {
+        while (pos < str.size() && (str[pos] == ',' || is_space(str[pos])))
+          pos++;
+        if (pos == str.size())
+          break;
+
+        size_t end = str.find(',', pos);
+        if (end == std::string_view::npos)
+          end = str.size();
+
+        comp[i++] = str.substr(pos, end - pos);
+        pos = end;
+      }
+
+      return i;
+    }
+
+    constexpr int split_space(std::string_view str,
+                              std::string_view (&comp)[4]) noexcept
+    {
+      int n = 0;
+      bool seen_slash = false;
+      size_t pos = 0;
+
+      for (;;) {
+        while (pos < str.size() && is_space(str[pos]))
+          pos++;
+        if (pos == str.size())
+          break;
+
+        if (str[pos] == '/') {
+          if (seen_slash || n != 3)
+            return 0;
+          seen_slash = true;
+          pos++;
+          continue;
+        } else if (n == (seen_slash ? 4 : 3)) {
+          return 0;
+        }
+
+        size_t end = pos;
+        while (end < str.size() && str[end] != '/' && !is_space(str[end]))
+          end++;
+        comp[n++] = str.substr(pos, end - pos);
+        pos = end;
+      }
+
+      return (n == (seen_slash ? 4 : 3)) ? n : 0;
+    }
+
+    enum class function { rgb, hsl, hwb };
+
+    constexpr cpar_status parse_function(function func,
+                                         std::string_view const (&comp)[4],
+                                         int n_found,
+                                         int n_comp,
+                                         uint32_t &value) noexcept
+    {
+      uint8_t rgb[3] = {0, 0, 0};
+      uint8_t alpha = 255;
+      int32_t hue = 0;
+      int32_t percent[3] = {0, 0, 0};
+
+      for (int i = 0; i < n_found; i++) {
+        cpar_status status = CPAR_STATUS_OK;
+        if (i == 3)
+          status = parse_component_a(comp[i], alpha);
+        else if (func == function::rgb)
+          status = parse_component_rgb(comp[i], rgb[i]);
+        else if (i == 0)
+          status = parse_component_hue(comp[i], hue);
+        else
+          status = parse_component_percent(comp[i], percent[i]);
+        if (status != CPAR_STATUS_OK)
+          return status;
+      }
+
+      if (n_found != n_comp)
+        return CPAR_STATUS_SYNTAX_ERROR;
+
+      if (func == function::hsl)
+        hsl_to_rgb(hue, percent[1], percent[2], rgb);
+      else if (func == function::hwb)
+        hwb_to_rgb(hue, percent[1], percent[2], rgb);
+
+      value = CPAR_COLOR_MAKE(rgb[0], rgb[1], rgb[2], alpha);
+      return CPAR_STATUS_OK;
+    }
+
+    // longer than any colour name
+    inline constexpr size_t name_buffer_len = 32;
+
+    constexpr cpar_status parse_name(std::string_view str,
+                                     uint32_t &value) noexcept
+    {
+      char buffer[name_buffer_len] = {};
+      size_t buffer_len = 0;
+      for (char c : str) {
+        if (is_space(c))
+          continue;
+        if (buffer_len == name_buffer_len)
+          return CPAR_STATUS_NO_COLOR_NAME;
+        buffer[buffer_len++] = to_lower(c);
+      }
+      std::string_view name{buffer, buffer_len};
+
+      size_t lo = 0;
+      size_t hi = std::size(color_names);
+
+      while (lo < hi) {
+        size_t mid = lo + (hi - lo) / 2;
+        if (color_names[mid].name < name)
+          lo = mid + 1;
+        else
+          hi = mid;
+      }
+
+      if (lo == std::size(color_names) || color_names[lo].name != name)
+        return CPAR_STATUS_NO_COLOR_NAME;
+
+      value = color_names[lo].value;
+      return CPAR_STATUS_OK;
+    }
+
+    constexpr cpar_status parse(std::string_view str, uint32_t &value) noexcept
+    {
+      if (str.data() == nullptr || str.empty())
+        return CPAR_STATUS_INVALID_PARAMETER;
+
+      if (str.find('\0') != std::string_view::npos)
+        return CPAR_STATUS_SYNTAX_ERROR;
+
+      str = trim(str);
+
+      if (!str.empty() && str.front() == '#')
+        return parse_hex(str.substr(1), value);
+
+      function func = function::rgb;
+      int n_comp = 0;
+      if (match_word(str, "rgb(")) {
+        n_comp = 3;
+      } else if (match_word(str, "rgba(")) {
+        n_comp = 4;
+      } else if (match_word(str, "hsl(")) {
+        func = function::hsl;
+        n_comp = 3;
+      } else if (match_word(str, "hsla(")) {
+        func = function::hsl;
+        n_comp = 4;
+      } else if (match_word(str, "hwb(")) {
+        func = function::hwb;
+        n_comp = 3;
+      } else {
+        return parse_name(str, value);
+      }
+
+      if (str.empty() || str.back() != ')')
+        return CPAR_STATUS_SYNTAX_ERROR;
+      str.remove_suffix(1);
+
+      std::string_view comp[4] = {};
+      int n_found = 0;
+      if (str.find(',') != std::string_view::npos) {
+        if (func == function::hwb)
+          return CPAR_STATUS_SYNTAX_ERROR;
+        n_found = split_comma(str, n_comp, comp);
+      } else if ((n_found = n_comp = split_space(str, comp)) == 0) {
+        return CPAR_STATUS_SYNTAX_ERROR;
+      }
+
+      return parse_function(func, comp, n_found, n_comp, value);
+    }
+
+  } // namespace detail
+
+  struct color {
+
+    class error : public std::runtime_error
+    {
+    public:
+      error(cpar_status code, const char *what)
+          : std::runtime_error{what},
+            m_code{code}
+      {
+      }
+
+      cpar_status code() const noexcept { return m_code; }
+
+    private:
+      cpar_status m_code;
+    };
+
+    uint32_t value;
+
+    constexpr color(uint32_t value) noexcept : value{value} {}
+
+    constexpr color(uint8_t r = 0,
+                    uint8_t g = 0,
+                    uint8_t b = 0,
+                    uint8_t a = 255) noexcept
+        : value{CPAR_COLOR_MAKE(r, g, b, a)}
+    {
+    }
+
+    color(const char *str) : value{0x000000ff}
+    {
+      if (cpar_status status = cpar_color_parse(str, &value);
+          status != CPAR_STATUS_OK) {
+        throw error{status, cpar_strerror(status)};
+      }
+    }
+
+    color(std::string_view str);
+
+    color(std::string const &str) : color{std::string_view{str}} {}
+
+    constexpr operator uint32_t() const noexcept { return value; }
+
+    constexpr bool operator==(color const &other) const noexcept
+    {
+      return value == other.value;
+    }
+
+    constexpr bool operator!=(color const &other) const noexcept
+    {
+      return !operator==(other);
+    }
+
+    constexpr uint8_t red() const noexcept { return CPAR_COLOR_RED(value); }
+    constexpr uint8_t green() const noexcept { return CPAR_COLOR_GREEN(value); }
+    constexpr uint8_t blue() const noexcept { return CPAR_COLOR_BLUE(value); }
+    constexpr uint8_t alpha() const noexcept { return CPAR_COLOR_ALPHA(value); }
+  };
+
+  /**
+   * The result of @a parse(), which holds either the parsed colour or the
+   * status code saying why parsing failed, like a
+   * `std::expected<color, cpar_status>`.
+   */
+  class parse_result
+  {
+  public:
+    constexpr parse_result(color c) noexcept
+        : m_color{c},
+          m_status{CPAR_STATUS_OK}
+    {
+    }
+
+    constexpr parse_result(cpar_status status) noexcept
+        : m_color{},
+          m_status{status}
+    {
+    }
+
+    constexpr bool has_value() const noexcept
+    {
+      return m_status == CPAR_STATUS_OK;
+    }
+
+    constexpr explicit operator bool() const noexcept { return has_value(); }
+
+    /** Returns the colour, or throws @a color::error if there isn't one. */
+    color value() const
+    {
+      if (!has_value())
+        throw color::error{m_status, cpar_strerror(m_status)};
+      return m_color;
+    }
+
+    constexpr color value_or(color fallback) const noexcept
+    {
+      return has_value() ? m_color : fallback;
+    }
+
+    /** Returns the status code, which is @a CPAR_STATUS_OK on success. */
+    constexpr cpar_status error() const noexcept { return m_status; }
+
+    /** Returns the colour, which must be present. */
+    constexpr color const &operator*() const noexcept { return m_color; }
+    constexpr color const *operator->() const noexcept { return &m_color; }
+
+  private:
+    color m_color;
+    cpar_status m_status;
+  };
+
+  /**
+   * Parses a colour string without throwing or allocating, which makes it
+   * the better choice than the @a color constructors for input where failure
+   * is common.
+   */
+  inline parse_result parse(std::string_view str) noexcept
+  {
+    uint32_t value = 0;
+    if (cpar_status status = cpar_color_parse_n(str.data(), str.size(), &value);
+        status != CPAR_STATUS_OK) {
+      return status;
+    }
+    return color{value};
+  }
+
+  inline color::color(std::string_view str) : color{parse(str).value()} {}
+
+  /**
+   * Owns a @a cpar_cache, see @a cpar_cache_new().
+   */
+  class cache
+  {
+  public:
+    explicit cache(size_t n_entries = 256)
+        : m_cache{cpar_cache_new(n_entries)}
+    {
+      if (!m_cache)
+        throw std::bad_alloc{};
+    }
+
+    cache(cache &&other) noexcept
+        : m_cache{std::exchange(other.m_cache, nullptr)}
+    {
+    }
+
+    cache &operator=(cache &&other) noexcept
+    {
+      std::swap(m_cache, other.m_cache);
+      return *this;
+    }
+
+    cache(cache const &) = delete;
+    cache &operator=(cache const &) = delete;
+
+    ~cache() { cpar_cache_free(m_cache); }
+
+    parse_result parse(std::string_view str) noexcept
+    {
+      uint32_t value = 0;
+      if (cpar_status status =
+              cpar_cache_parse(m_cache, str.data(), str.size(), &value);
+          status != CPAR_STATUS_OK) {
+        return status;
+      }
+      return color{value};
+    }
+
+    void clear() noexcept { cpar_cache_clear(m_cache); }
+
+    cpar_cache_stats stats() const noexcept
+    {
+      cpar_cache_stats stats{};
+      cpar_cache_get_stats(m_cache, &stats);
+      return stats;
+    }
+
+    cpar_cache *get() const noexcept { return m_cache; }
+
+  private:
+    cpar_cache *m_cache;
+  };
+
+  /**
+   * Owns a @a cpar_atoms table, see @a cpar_atoms_new().
+   */
+  class atoms
+  {
+  public:
+    atoms() : m_atoms{cpar_atoms_new()}
+    {
+      if (!m_atoms)
+        throw std::bad_alloc{};
+    }
+
+    atoms(atoms &&other) noexcept
+        : m_atoms{std::exchange(other.m_atoms, nullptr)}
+    {
+    }
+
+    atoms &operator=(atoms &&other) noexcept
+    {
+      std::swap(m_atoms, other.m_atoms);
+      return *this;
+    }
+
+    atoms(atoms const &) = delete;
+    atoms &operator=(atoms const &) = delete;
+
+    ~atoms() { cpar_atoms_free(m_atoms); }
+
+    cpar_status intern(std::string_view str, uint32_t &id) noexcept
+    {
+      return cpar_atoms_intern(m_atoms, str.data(), str.size(), &id);
+    }
+
+    uint32_t size() const noexcept { return cpar_atoms_count(m_atoms); }
+
+    color value(uint32_t id) const noexcept
+    {
+      return color{cpar_atoms_value(m_atoms, id)};
+    }
+
+    std::string_view string(uint32_t id) const noexcept
+    {
+      size_t len = 0;
+      const char *str = cpar_atoms_string(m_atoms, id, &len);
+      return str ? std::string_view{str, len} : std::string_view{};
+    }
+
+    cpar_atoms *get() const noexcept { return m_atoms; }
+
+  private:
+    cpar_atoms *m_atoms;
+  };
+
+  /**
+   * Owns an immutable @a cpar_names registry, see @a cpar_names_new(). A
+   * default-constructed or moved-from registry has no names of its own, so
+   * only the built-in names are used.
+   */
+  class names
+  {
+  public:
+    names() noexcept = default;
+
+    /**
+     * Builds a registry from pairs of names and colours, for example
+     * `{{"brand", 0x336699ffu}}`, and throws @a color::error if a name
+     * isn't valid or is repeated.
+     */
+    names(std::initializer_list<std::pair<std::string_view, color>> pairs)
+    {
+      build(pairs);
+    }
+
+    /**
+     * Builds a registry from any range of pairs of names and colour values,
+     * such as a `std::unordered_map<std::string, uint32_t>`, and throws
+     * @a color::error if a name isn't valid or is repeated.
+     */
+    template <typename Range,
+              typename = decltype(std::begin(std::declval<Range const &>()))>
+    explicit names(Range const &pairs)
+    {
+      build(pairs);
+    }
+
+    names(names &&other) noexcept
+        : m_names{std::exchange(other.m_names, nullptr)}
+    {
+    }
+
+    names &operator=(names &&other) noexcept
+    {
+      std::swap(m_names, other.m_names);
+      return *this;
+    }
+
+    names(names const &) = delete;
+    names &operator=(names const &) = delete;
+
+    ~names() { cpar_names_free(m_names); }
+
+    parse_result parse(std::string_view str) const noexcept
+    {
+      uint32_t value = 0;
+      if (cpar_status status =
+              cpar_names_parse(m_names, str.data(), str.size(), &value);
+          status != CPAR_STATUS_OK) {
+        return status;
+      }
+      return color{value};
+    }
+
+    /** Returns the name of a colour, or an empty string if it hasn't one. */
+    std::string_view lookup(color c) const noexcept
+    {
+      const char *name = cpar_names_lookup(m_names, c.value);
+      return name ? std::string_view{name} : std::string_view{};
+    }
+
+    uint32_t size() const noexcept { return cpar_names_count(m_names); }
+
+    /** Returns the binary image of the registry, see
+     * @a cpar_names_serialize(). */
+    std::string serialize() const
+    {
+      std::string image(cpar_names_serialize(m_names, nullptr, 0), '\0');
+      cpar_names_serialize(m_names, image.data(), image.size());
+      return image;
+    }
+
+    /**
+     * Loads a registry from a file written from @a serialize(), see
+     * @a cpar_names_map(), and throws @a color::error if it can't be.
+     */
+    static names map(const char *path)
+    {
+      names loaded;
+      if (cpar_status status = cpar_names_map(path, &loaded.m_names);
+          status == CPAR_STATUS_NO_MEMORY) {
+        throw std::bad_alloc{};
+      } else if (status != CPAR_STATUS_OK) {
+        throw color::error{status, cpar_strerror(status)};
+      }
+      return loaded;
+    }
+
+    cpar_names *get() const noexcept { return m_names; }
+
+  private:
+    template <typename Range> void build(Range const &pairs)
+    {
+      std::vector<cpar_string> strs;
+      std::vector<uint32_t> values;
+      for (auto const &[name, value] : pairs) {
+        std::string_view str{name};
+        strs.push_back(cpar_string{str.data(), str.size()});
+        values.push_back(value_of(value));
+      }
+      size_t repeated = 0;
+      if (cpar_status status = cpar_names_new(
+              strs.data(), values.data(), strs.size(), &m_names, &repeated);
+          status == CPAR_STATUS_NO_MEMORY) {
+        throw std::bad_alloc{};
+      } else if (status == CPAR_STATUS_DUPLICATE_NAME) {
+        std::string name{strs[repeated].str, strs[repeated].len};
+        throw color::error{status, ("repeated colour name \"" + name + "\"")
+                                       .c_str()};
+      } else if (status == CPAR_STATUS_INVALID_PARAMETER) {
+        throw color::error{status, "invalid colour name"};
+      } else if (status != CPAR_STATUS_OK) {
+        throw color::error{status, cpar_strerror(status)};
+      }
+    }
+
+    static uint32_t value_of(color c) noexcept { return c.value; }
+
+    template <typename T,
+              typename = std::enable_if_t<std::is_integral_v<T>>>
+    static uint32_t value_of(T value) noexcept
+    {
+      return static_cast<uint32_t>(value);
+    }
+
+    cpar_names *m_names = nullptr;
+  };
+
+  /**
+   * Owns a @a cpar_arena, see @a cpar_arena_init(). Memory comes from the
+   * buffer given to the constructor, if any, and then from the heap.
+   */
+  class arena
+  {
+  public:
+    arena() noexcept { cpar_arena_init(&m_arena, nullptr, 0); }
+
+    arena(void *buffer, size_t size) noexcept
+    {
+      cpar_arena_init(&m_arena, buffer, size);
+    }
+
+    arena(arena const &) = delete;
+    arena &operator=(arena const &) = delete;
+
+    ~arena() { cpar_arena_release(&m_arena); }
+
+    /** Returns memory which stays valid until @a clear(), or throws
+     * `std::bad_alloc`. */
+    void *allocate(size_t size, size_t align = alignof(std::max_align_t))
+    {
+      void *p = cpar_arena_alloc(&m_arena, size, align);
+      if (!p)
+        throw std::bad_alloc{};
+      return p;
+    }
+
+    void clear() noexcept { cpar_arena_clear(&m_arena); }
+
+    cpar_arena *get() noexcept { return &m_arena; }
+
+  private:
+    cpar_arena m_arena;
+  };
+
+  /**
+   * The colours from @a parse_list(), which are stored in an @a arena and
+   * stay valid until it's cleared. If parsing failed, the list has the
+   * colours before the entry which failed, and says why and where.
+   */
+  class color_list
+  {
+  public:
+    using value_type = uint32_t;
+    using const_iterator = const uint32_t *;
+
+    color_list(const uint32_t *values,
+               size_t size,
+               cpar_status status,
+               size_t error_offset) noexcept
+        : m_values{values},
+          m_size{size},
+          m_status{status},
+          m_error_offset{error_offset}
+    {
+    }
+
+    const uint32_t *data() const noexcept { return m_values; }
+    size_t size() const noexcept { return m_size; }
+    bool empty() const noexcept { return m_size == 0; }
+    const_iterator begin() const noexcept { return m_values; }
+    const_iterator end() const noexcept { return m_values + m_size; }
+    color operator[](size_t i) const noexcept { return color{m_values[i]}; }
+
+    /** Whether the whole list was parsed. */
+    explicit operator bool() const noexcept
+    {
+      return m_status == CPAR_STATUS_OK;
+    }
+
+    /** Returns the status code, which is @a CPAR_STATUS_OK on success. */
+    cpar_status error() const noexcept { return m_status; }
+
+    /** Returns the offset of the entry which failed to parse, or the length
+     * of the list if none did. */
+    size_t error_offset() const noexcept { return m_error_offset; }
+
+  private:
+    const uint32_t *m_values;
+    size_t m_size;
+    cpar_status m_status;
+    size_t m_error_offset;
+  };
+
+  /**
+   * Parses a list of colours separated by commas or whitespace into memory
+   * from @a a, without throwing, see @a cpar_color_parse_list().
+   */
+  inline color_list parse_list(std::string_view str, arena &a) noexcept
+  {
+    uint32_t *values = nullptr;
+    size_t n_values = 0;
+    size_t error_offset = 0;
+    cpar_status status = cpar_color_parse_list(
+        a.get(), str.data(), str.size(), &values, &n_values, &error_offset);
+    return color_list{values, n_values, status, error_offset};
+  }
+
+#ifndef CPAR_NO_THREAD_POOL
+
+  /**
+   * A fixed set of worker threads which implements @a cpar_executor, for
+   * use with @a cpar_color_parse_batch_parallel().
+   *
+   * The calling thread takes part in each run, and tasks are handed out one
+   * at a time so that the threads stay busy when some tasks are slower than
+   * others. Runs from several threads at once take turns.
+   *
+   * Define @a CPAR_NO_THREAD_POOL to leave this class out, along with the
+   * `<thread>`, `<mutex>`, `<condition_variable>` and `<atomic>` headers.
+   */
+  class thread_pool
+  {
+  public:
+    /**
+     * Starts the pool with @a n_threads threads in total, counting the
+     * calling thread, so one less worker is started.
+     */
+    explicit thread_pool(
+        unsigned n_threads = std::thread::hardware_concurrency())
+    {
+      try {
+        for (unsigned i = 1; i < n_threads; i++)
+          m_workers.emplace_back([this] { work(); });
+      } catch (...) {
+        stop();
+        throw;
+      }
+    }
+
+    thread_pool(thread_pool const &) = delete;
+    thread_pool &operator=(thread_pool const &) = delete;
+
+    ~thread_pool() { stop(); }
+
+    /** Returns the number of threads, counting the calling thread. */
+    unsigned size() const noexcept
+    {
+      return static_cast<unsigned>(m_workers.size() + 1);
+    }
+
+    /** Runs the tasks as described for @a cpar_executor::run. */
+    void run(void (*task)(void *arg, size_t index), void *arg, size_t n_tasks)
+    {
+      std::lock_guard<std::mutex> run_lock{m_run_mutex};
+      {
+        std::lock_guard<std::mutex> lock{m_mutex};
+        m_task = task;
+        m_arg = arg;
+        m_n_tasks = n_tasks;
+        m_next.store(0, std::memory_order_relaxed);
+        m_n_busy = m_workers.size();
+        m_generation++;
+      }
+      m_wake.notify_all();
+
+      run_tasks();
+
+      std::unique_lock<std::mutex> lock{m_mutex};
+      m_done.wait(lock, [this] { return m_n_busy == 0; });
+    }
+
+    /** Returns an executor which runs tasks on this pool. */
+    cpar_executor executor() noexcept
+    {
+      return {[](void *pool,
+                 void (*task)(void *arg, size_t index),
+                 void *arg,
+                 size_t n_tasks) {
+                static_cast<thread_pool *>(pool)->run(task, arg, n_tasks);
+              },
+              this};
+    }
+
+  private:
+    void run_tasks() noexcept
+    {
+      for (;;) {
+        size_t i = m_next.fetch_add(1, std::memory_order_relaxed);
+        if (i >= m_n_tasks)
+          break;
+        m_task(m_arg, i);
+      }
+    }
+
+    // each worker joins every run once, which the caller waits for
+    void work()
+    {
+      uint64_t generation = 0;
+      for (;;) {
+        {
+          std::unique_lock<std::mutex> lock{m_mutex};
+          m_wake.wait(lock, [&] {
+            return m_stopping || m_generation != generation;
+          });
+          if (m_stopping)
+            return;
+          generation = m_generation;
+        }
+
+        run_tasks();
+
+        std::lock_guard<std::mutex> lock{m_mutex};
+        if (--m_n_busy == 0)
+          m_done.notify_one();
+      }
+    }
+
+    void stop() noexcept
+    {
+      {
+        std::lock_guard<std::mutex> lock{m_mutex};
+        m_stopping = true;
+      }
+      m_wake.notify_all();
+      for (auto &worker : m_workers)
+        worker.join();
+    }
+
+    std::vector<std::thread> m_workers;
+    std::mutex m_run_mutex;
+    std::mutex m_mutex;
+    std::condition_variable m_wake;
+    std::condition_variable m_done;
+    void (*m_task)(void *arg, size_t index) = nullptr;
+    void *m_arg = nullptr;
+    size_t m_n_tasks = 0;
+    std::atomic<size_t> m_next{0};
+    size_t m_n_busy = 0;
+    uint64_t m_generation = 0;
+    bool m_stopping = false;
+  };
+
+#endif // CPAR_NO_THREAD_POOL
+
+  namespace detail
+  {
+
+    // the same tables as the implementation, see CPAR_SRGB_TO_LINEAR_FLOATS
+    inline constexpr float srgb_to_linear[256] = {CPAR_SRGB_TO_LINEAR_FLOATS};
+    inline constexpr float srgb_midpoints[255] = {CPAR_SRGB_MIDPOINT_FLOATS};
+    inline constexpr uint8_t linear_buckets[] = {CPAR_LINEAR_BUCKET_VALUES};
+#undef CPAR_SRGB_TO_LINEAR_FLOATS
+#undef CPAR_SRGB_MIDPOINT_FLOATS
+#undef CPAR_LINEAR_BUCKET_VALUES
+
+    constexpr float unit_alpha(uint8_t a) noexcept
+    {
+      return static_cast<float>(a) * (1.0f / 255.0f);
+    }
+
+    constexpr float clamp_unit(float x) noexcept
+    {
+      x = x > 0.0f ? x : 0.0f;
+      return x < 1.0f ? x : 1.0f;
+    }
+
+    // an 8-bit value from x in [0, 1], rounded and clamped
+    constexpr uint8_t encode_unit(float x) noexcept
+    {
+      return static_cast<uint8_t>(clamp_unit(x) * 255.0f + 0.5f);
+    }
+
+    // the 8-bit sRGB encoding of linear light, see cpar_linear_to_srgb8()
+    constexpr uint8_t encode_linear(float x) noexcept
+    {
+      if (!(x > 0.0f))
+        return 0;
+      if (x >= 1.0f)
+        return 255;
+      uint8_t b = linear_buckets[static_cast<int>(
+          x * static_cast<float>(sizeof(linear_buckets) - 3))];
+      return b < 255 && x >= srgb_midpoints[b] ? b + 1 : b;
+    }
+
+    // the bits of a finite x > 0, as memcpy() would give in cpar_cbrtf()
+    constexpr uint32_t float_bits(float x) noexcept
+    {
+#ifdef CPAR_HAVE_BIT_CAST
+      return __builtin_bit_cast(uint32_t, x);
+#else
+      uint32_t e = 127;
+      if (x < 1.17549435e-38f)
+        return static_cast<uint32_t>(static_cast<double>(x) * 0x1p149);
+      for (; x >= 2.0f; x *= 0.5f)
+        e++;
+      for (; x < 1.0f; x *= 2.0f)
+        e--;
+      return e << 23 | static_cast<uint32_t>((x - 1.0f) * 8388608.0f);
+#endif
+    }
+
+    // the normal float with the bits i
+    constexpr float float_from_bits(uint32_t i) noexcept
+    {
+#ifdef CPAR_HAVE_BIT_CAST
+      return __builtin_bit_cast(float, i);
+#else
+      int e = static_cast<int>(i >> 23) - 127;
+      float x = 1.0f + static_cast<float>(i & 0x7FFFFF) / 8388608.0f;
+      for (; e > 0; e--)
+        x *= 2.0f;
+      for (; e < 0; e++)
+        x *= 0.5f;
+      return x;
+#endif
+    }
+
+    // the cube root of x, the same as cpar_cbrtf() for finite x
+    constexpr float cbrt(float x) noexcept
+    {
+      if (!(x > 0.0f) || x > 3.40282347e38f)
+        return x > 0.0f ? x : 0.0f;
+      float y = float_from_bits(float_bits(x) / 3 + 0x2A5137A0u);
+      y = y * (y * y * y + 2.0f * x) / (2.0f * y * y * y + x);
+      y = y * (y * y * y + 2.0f * x) / (2.0f * y * y * y + x);
+      return y;
+    }
+
+    // see cpar_hue() and the rest in the implementation, which these must
+    // match exactly
+    constexpr float hue(int r, int g, int b, int max, int d) noexcept
+    {
+      int num = max == r ? g - b : max == g ? b - r : r - g;
+      float sector = max == r ? 0.0f : max == g ? 2.0f : 4.0f;
+      if (d == 0)
+        return 0.0f;
+      float h = (static_cast<float>(num) / static_cast<float>(d) + sector) *
+                60.0f;
+      return h < 0.0f ? h + 360.0f : h;
+    }
+
+    constexpr float wrap_hue(float h) noexcept
+    {
+      if (h >= 0.0f && h < 360.0f)
+        return h;
+      if (!(h > -1e9f && h < 1e9f))
+        return 0.0f;
+      h -= 360.0f * static_cast<float>(static_cast<int64_t>(h / 360.0f));
+      return h < 0.0f ? h + 360.0f : h;
+    }
+
+    constexpr float hsl_channel(float n, float h, float s, float l) noexcept
+    {
+      float k = n + h;
+      float a = s * (l < 1.0f - l ? l : 1.0f - l);
+      float t = 0.0f;
+      if (k >= 12.0f)
+        k -= 12.0f;
+      t = k - 3.0f < 9.0f - k ? k - 3.0f : 9.0f - k;
+      t = t < 1.0f ? t : 1.0f;
+      t = t > -1.0f ? t : -1.0f;
+      return l - a * t;
+    }
+
+    constexpr float hsv_channel(float n, float h, float s, float v) noexcept
+    {
+      float k = n + h;
+      float t = 0.0f;
+      if (k >= 6.0f)
+        k -= 6.0f;
+      t = k < 4.0f - k ? k : 4.0f - k;
+      t = t < 1.0f ? t : 1.0f;
+      t = t > 0.0f ? t : 0.0f;
+      return v - v * s * t;
+    }
+
+  } // namespace detail
+
+  /** A colour in linear light, see @a CPAR_SPACE_LINEAR_SRGB. */
+  struct linear_rgb {
+    float r;
+    float g;
+    float b;
+    float alpha;
+  };
+
+  /** A colour as hue, saturation and lightness, see @a CPAR_SPACE_HSL. */
+  struct hsl {
+    float h;
+    float s;
+    float l;
+    float alpha;
+  };
+
+  /** A colour as hue, saturation and value, see @a CPAR_SPACE_HSV. */
+  struct hsv {
+    float h;
+    float s;
+    float v;
+    float alpha;
+  };
+
+  /** A colour in OKLab, see @a CPAR_SPACE_OKLAB. */
+  struct oklab {
+    float l;
+    float a;
+    float b;
+    float alpha;
+  };
+
+  /**
+   * Converts a colour to linear light. This and the other single colour
+   * conversions can be evaluated at compile time, and use the same tables
+   * and arithmetic as @a cpar_colors_to_space() and
+   * @a cpar_colors_from_space(), so at compile time they give exactly the
+   * same results. At run time they're compiled with the caller's options,
+   * and a compiler which fuses multiplies and adds, as GCC does by default
+   * in GNU modes when FMA is available, may change the last bits of a
+   * result, and so rarely an 8-bit channel converted from another space.
+   */
+  constexpr linear_rgb to_linear_rgb(color c) noexcept
+  {
+    return {detail::srgb_to_linear[c.red()],
+            detail::srgb_to_linear[c.green()],
+            detail::srgb_to_linear[c.blue()],
+            detail::unit_alpha(c.alpha())};
+  }
+
+  /** Converts a colour to HSL, see @a to_linear_rgb(). */
+  constexpr hsl to_hsl(color c) noexcept
+  {
+    int r = c.red();
+    int g = c.green();
+    int b = c.blue();
+    int max = r > g ? (r > b ? r : b) : (g > b ? g : b);
+    int min = r < g ? (r < b ? r : b) : (g < b ? g : b);
+    int d = max - min;
+    int sum = max + min;
+    int range = 255 - (sum > 255 ? sum - 255 : 255 - sum);
+    return {detail::hue(r, g, b, max, d),
+            d == 0 ? 0.0f : static_cast<float>(d) / static_cast<float>(range),
+            static_cast<float>(sum) / 510.0f,
+            detail::unit_alpha(c.alpha())};
+  }
+
+  /** Converts a colour to HSV, see @a to_linear_rgb(). */
+  constexpr hsv to_hsv(color c) noexcept
+  {
+    int r = c.red();
+    int g = c.green();
+    int b = c.blue();
+    int max = r > g ? (r > b ? r : b) : (g > b ? g : b);
+    int min = r < g ? (r < b ? r : b) : (g < b ? g : b);
+    int d = max - min;
+    return {detail::hue(r, g, b, max, d),
+            max == 0 ? 0.0f : static_cast<float>(d) / static_cast<float>(max),
+            static_cast<float>(max) / 255.0f,
+            detail::unit_alpha(c.alpha())};
+  }
+
+  /** Converts a colour to OKLab, see @a to_linear_rgb(). */
+  constexpr oklab to_oklab(color c) noexcept
+  {
+    linear_rgb x = to_linear_rgb(c);
+    float l = detail::cbrt(0.4122214708f * x.r + 0.5363325363f * x.g +
+                           0.0514459929f * x.b);
+    float m = detail::cbrt(0.2119034982f * x.r + 0.6806995451f * x.g +
+                           0.1073969566f * x.b);
+    float s = detail::cbrt(0.0883024619f * x.r + 0.2817188376f * x.g +
+                           0.6299787005f * x.b);
+    return {0.2104542553f * l + 0.7936177850f * m - 0.0040720468f * s,
+            1.9779984951f * l - 2.4285922050f * m + 0.4505937099f * s,
+            0.0259040371f * l + 0.7827717662f * m - 0.8086757660f * s,
+            x.alpha};
+  }
+
+  /** Converts a colour from linear light, clamping it to the gamut. */
+  constexpr color to_color(linear_rgb const &c) noexcept
+  {
+    return color{detail::encode_linear(c.r),
+                 detail::encode_linear(c.g),
+                 detail::encode_linear(c.b),
+                 detail::encode_unit(c.alpha)};
+  }
+
+  /** Converts a colour from HSL, see @a cpar_colors_from_space(). */
+  constexpr color to_color(hsl const &c) noexcept
+  {
+    float h = detail::wrap_hue(c.h) / 30.0f;
+    float s = detail::clamp_unit(c.s);
+    float l = detail::clamp_unit(c.l);
+    return color{detail::encode_unit(detail::hsl_channel(0.0f, h, s, l)),
+                 detail::encode_unit(detail::hsl_channel(8.0f, h, s, l)),
+                 detail::encode_unit(detail::hsl_channel(4.0f, h, s, l)),
+                 detail::encode_unit(c.alpha)};
+  }
+
+  /** Converts a colour from HSV, see @a cpar_colors_from_space(). */
+  constexpr color to_color(hsv const &c) noexcept
+  {
+    float h = detail::wrap_hue(c.h) / 60.0f;
+    float s = detail::clamp_unit(c.s);
+    float v = detail::clamp_unit(c.v);
+    return color{detail::encode_unit(detail::hsv_channel(5.0f, h, s, v)),
+                 detail::encode_unit(detail::hsv_channel(3.0f, h, s, v)),
+                 detail::encode_unit(detail::hsv_channel(1.0f, h, s, v)),
+                 detail::encode_unit(c.alpha)};
+  }
+
+  /** Converts a colour from OKLab, clamping it to the sRGB gamut. */
+  constexpr color to_color(oklab const &c) noexcept
+  {
+    float l = c.l + 0.3963377774f * c.a + 0.2158037573f * c.b;
+    float m = c.l - 0.1055613458f * c.a - 0.0638541728f * c.b;
+    float s = c.l - 0.0894841775f * c.a - 1.2914855480f * c.b;
+    l = l * l * l;
+    m = m * m * m;
+    s = s * s * s;
+    return to_color(linear_rgb{
+        4.0767416621f * l - 3.3077115913f * m + 0.2309699292f * s,
+        -1.2684380046f * l + 2.6097574011f * m - 0.3413193965f * s,
+        -0.0041960863f * l - 0.7034186147f * m + 1.7076147010f * s,
+        c.alpha});
+  }
+
+  namespace detail
+  {
+
+    template <typename Space> struct color_space;
+
+    template <> struct color_space<linear_rgb> {
+      static constexpr cpar_color_space value = CPAR_SPACE_LINEAR_SRGB;
+    };
+
+    template <> struct color_space<hsl> {
+      static constexpr cpar_color_space value = CPAR_SPACE_HSL;
+    };
+
+    template <> struct color_space<hsv> {
+      static constexpr cpar_color_space value = CPAR_SPACE_HSV;
+    };
+
+    template <> struct color_space<oklab> {
+      static constexpr cpar_color_space value = CPAR_SPACE_OKLAB;
+    };
+
+  } // namespace detail
+
+  static_assert(sizeof(color) == sizeof(uint32_t));
+  static_assert(sizeof(linear_rgb) == 4 * sizeof(float) &&
+                sizeof(hsl) == 4 * sizeof(float) &&
+                sizeof(hsv) == 4 * sizeof(float) &&
+                sizeof(oklab) == 4 * sizeof(float));
+
+  /**
+   * Converts an array of colours to @a linear_rgb, @a hsl, @a hsv or
+   * @a oklab, see @a cpar_colors_to_space().
+   */
+  template <typename Space>
+  inline void convert(const uint32_t *colors, size_t n, Space *out) noexcept
+  {
+    cpar_colors_to_space(colors,
+                         n,
+                         detail::color_space<Space>::value,
+                         reinterpret_cast<float *>(out));
+  }
+
+  template <typename Space>
+  inline void convert(const color *colors, size_t n, Space *out) noexcept
+  {
+    convert(reinterpret_cast<const uint32_t *>(colors), n, out);
+  }
+
+  /**
+   * Converts an array of colours from @a linear_rgb, @a hsl, @a hsv or
+   * @a oklab, see @a cpar_colors_from_space().
+   */
+  template <typename Space>
+  inline void convert(const Space *in, size_t n, uint32_t *colors) noexcept
+  {
+    cpar_colors_from_space(reinterpret_cast<const float *>(in),
+                           n,
+                           detail::color_space<Space>::value,
+                           colors);
+  }
+
+  template <typename Space>
+  inline void convert(const Space *in, size_t n, color *colors) noexcept
+  {
+    convert(in, n, reinterpret_cast<uint32_t *>(colors));
+  }
+
+  inline namespace literals
+  {
+
+    /**
+     * Parses a colour literal at compile time, for example
+     * `constexpr cpar::color orange = "#ff8800"_color;`.
+     *
+     * This accepts exactly the same syntaxes as @a cpar_color_parse(). With
+     * C++20 a literal that isn't valid is a compile error. Before C++20 that
+     * is only guaranteed where a constant is required, for example when
+     * initializing a `constexpr` variable, and otherwise @a color::error is
+     * thrown at run time.
+     */
+    CPAR_CONSTEVAL color operator""_color(const char *str, size_t len)
+    {
+      uint32_t value = 0;
+      if (cpar_status status = detail::parse(std::string_view{str, len}, value);
+          status != CPAR_STATUS_OK) {
+        throw color::error{status, "invalid colour literal"};
+      }
+      return color{value};
+    }
+
+  } // namespace literals
+
+  inline std::to_chars_result
+  to_chars(char *first,
+           char *last,
+           color const &c,
+           cpar_format format = CPAR_FORMAT_HEX_ALPHA) noexcept
+  {
+    size_t avail = static_cast<size_t>(last - first);
+    if (avail >= CPAR_FORMAT_MAX) {
+      return {first + cpar_color_format(c.value, format, first, avail),
+              std::errc{}};
+    }
+    char buf[CPAR_FORMAT_MAX];
+    size_t len = cpar_color_format(c.value, format, buf, sizeof(buf));
+    if (len > avail)
+      return {last, std::errc::value_too_large};
+    std::memcpy(first, buf, len);
+    return {first + len, std::errc{}};
+  }
+
+  inline std::string to_string(color const &c,
+                               cpar_format format = CPAR_FORMAT_HEX_ALPHA)
+  {
+    char buf[CPAR_FORMAT_MAX];
+    size_t len = cpar_color_format(c.value, format, buf, sizeof(buf));
+    return std::string(buf, len);
+  }
+
+  inline std::ostream &operator<<(std::ostream &out, color const &c)
+  {
+    char buf[CPAR_FORMAT_MAX];
+    out.write(buf,
+              static_cast<std::streamsize>(cpar_color_format(
+                  c.value, CPAR_FORMAT_HEX_ALPHA, buf, sizeof(buf))));
+    return out;
+  }
+
+} // namespace cpar
+
+#endif // CPAR_HPP
+
+/**
+ * When defined, includes the implementation code.
+ *
+ * Define this before including the `cpar.h` header in one and only one source
+ * file. If you get undefined symbol linking errors, you probably forgot to
+ * define this in one source file. If you get duplicate symbol errors, you
+ * probably defined it before more than one include of the header.
+ */
+#ifdef CPAR_IMPLEMENTATION
+#undef CPAR_IMPLEMENTATION
+
+#include <assert.h>
+#include <string.h>
+
+#ifndef CPAR_T
+/**
+ * A function-like macro that can allow translating the status messages.
+ *
+ * @param text The text to wrap in whatever macro/function you want.
+ * @returns The result of the customized version or else the original text
+ *          if not customized.
+ */
+#define CPAR_T(text) text
+#endif
+
+#if !defined(CPAR_NO_MMAP) && (defined(__unix__) || defined(__APPLE__))
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#define CPAR_HAVE_MMAP 1
+#else
+#include <stdio.h>
+#endif
+
+#ifndef CPAR_MALLOC
+#include <stdlib.h>
+/**
+ * Function-like macros used to allocate and free memory, which can be
+ * defined together to use a custom allocator.
+ */
+#define CPAR_MALLOC(size) malloc(size)
+#define CPAR_FREE(ptr) free(ptr)
+#endif
+
+const char *cpar_strerror(enum cpar_status status)
+{
+  static const char *error_strings[] = {
+      [CPAR_STATUS_OK] = CPAR_T("success"),
+      [CPAR_STATUS_INVALID_PARAMETER] = CPAR_T("invalid parameter"),
+      [CPAR_STATUS_TOO_BIG] = CPAR_T("color string too big"),
+      [CPAR_STATUS_INVALID_NUMBER] =
+          CPAR_T("numeric component failed to parse"),
+      [CPAR_STATUS_NUMBER_RANGE] = CPAR_T("numeric component out-of-range"),
+      [CPAR_STATUS_SYNTAX_ERROR] = CPAR_T("syntax error"),
+      [CPAR_STATUS_NO_COLOR_NAME] = CPAR_T("no matching color name"),
+      [CPAR_STATUS_NO_MEMORY] = CPAR_T("out of memory"),
+      [CPAR_STATUS_IO_ERROR] = CPAR_T("input/output error"),
+      [CPAR_STATUS_DUPLICATE_NAME] = CPAR_T("repeated color name"),
+      [CPAR_STATUS_NO_PERFECT_HASH] =
+          CPAR_T("color names can't be hashed apart"),
+  };
+
+  if ((size_t)status >= (sizeof(error_strings) / sizeof(error_strings[0]))) {
+    return NULL;
+  }
+  return error_strings[status];
+}
+
+/*
+ * Maps an ASCII character to the value of the hex digit it represents, or to
+ * 0xFF if it isn't a hex digit.
+ */
+static const uint8_t cpar_hex_digit_table[256] = {
+    0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff,
+    0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff,
+    0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff,
+    0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff,
+    0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff,
+    0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff,
+    0x00, 0x01, 0x02, 0x03, 0x04, 0x05, 0x06, 0x07,
+    0x08, 0x09, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff,
+    0xff, 0x0a, 0x0b, 0x0c, 0x0d, 0x0e, 0x0f, 0xff,
+    0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff,
+    0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff,
+    0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff,
+    0xff, 0x0a, 0x0b, 0x0c, 0x0d, 0x0e, 0x0f, 0xff,
+    0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff,
+    0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff,
+    0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff,
+    0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff,
+    0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff,
+    0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff,
+    0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff,
+    0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff,
+    0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff,
+    0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff,
+    0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff,
+    0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff,
+    0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff,
+    0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff,
+    0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff,
+    0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff,
+    0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff,
+    0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff,
+    0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff,
+};
+
+/*
+ * Decodes the digits of a `#rgb`, `#rrggbb` or `#rrggbbaa` colour (without
+ * the leading `#`). Invalid digits are accumulated in @a bad rather than
+ * tested one at a time so the loops have no early exits.
+ */
+static enum cpar_status cpar_hex_decode(const char *hex,
+                                        size_t hex_len,
+                                        uint32_t *result)
+{
+  uint32_t value = 0;
+  uint8_t bad = 0;
+  size_t i;
+
+  if (hex_len == 3) {
+    for (i = 0; i < 3; i++) {
+      uint8_t nibble = cpar_hex_digit_table[(uint8_t)hex[i]];
+      bad |= nibble;
+      value = (value << 8) | (uint32_t)(nibble * 0x11);
+    }
+    value = (value << 8) | 0xFF;
+  } else if (hex_len == 6 || hex_len == 8) {
+    for (i = 0; i < hex_len; i++) {
+      uint8_t nibble = cpar_hex_digit_table[(uint8_t)hex[i]];
+      bad |= nibble;
+      value = (value << 4) | nibble;
+    }
+    if (hex_len == 6)
+      value = (value << 8) | 0xFF;
+  } else {
+    return CPAR_STATUS_SYNTAX_ERROR;
+  }
+
+  if (bad & 0xF0)
+    return CPAR_STATUS_INVALID_NUMBER;
+
+  if (result)
+    *result = value;
+
+  return CPAR_STATUS_OK;
+}
+
+/* ASCII whitespace, which is what isspace() matches in the "C" locale. */
+static int cpar_is_space(char c)
+{
+  return c == ' ' || (c >= '\t' && c <= '\r');
+}
+
+/* ASCII-only tolower(), which doesn't depend on the locale. */
+static char cpar_to_lower(char c)
+{
+  return (c >= 'A' && c <= 'Z') ? (char)(c - 'A' + 'a') : c;
+}
+
+static const char *cpar_skip_space(const char *p, const char *end)
+{
+  while (p < end && cpar_is_space(*p))
+    p++;
+  return p;
+}
+
+/*
+ * Matches the lower-case @a word at @a *p, ignoring whitespace and case, and
+ * advances @a *p past it if it matched.
+ */
+static int cpar_match_word(const char **p, const char *end, const char *word)
+{
+  const char *q = *p;
+
+  for (; *word; word++) {
+    q = cpar_skip_space(q, end);
+    if (q == end || cpar_to_lower(*q) != *word)
+      return 0;
+    q++;
+  }
+
+  *p = q;
+  return 1;
+}
+
+/*
+ * Like cpar_hex_decode() for digits which may be separated by whitespace,
+ * from @a p up to @a end.
+ */
+static enum cpar_status
+cpar_hex_decode_spaced(const char *p, const char *end, uint32_t *result)
+{
+  uint32_t value = 0;
+  uint8_t bad = 0;
+  size_t n_digits = 0;
+
+  for (; p < end; p++) {
+    uint8_t nibble = 0;
+    if (cpar_is_space(*p))
+      continue;
+    nibble = cpar_hex_digit_table[(uint8_t)*p];
+    bad |= nibble;
+    value = (value << 4) | (nibble & 0x0F);
+    n_digits++;
+  }
+
+  if (n_digits == 3) {
+    value = ((((value >> 8) & 0xF) * 0x11u) << 24) |
+            ((((value >> 4) & 0xF) * 0x11u) << 16) |
+            (((value & 0xF) * 0x11u) << 8) | 0xFF;
+  } else if (n_digits == 6) {
+    value = (value << 8) | 0xFF;
+  } else if (n_digits != 8) {
+    return CPAR_STATUS_SYNTAX_ERROR;
+  }
+
+  if (bad & 0xF0)
+    return CPAR_STATUS_INVALID_NUMBER;
+
+  if (result)
+    *result = value;
+
+  return CPAR_STATUS_OK;
+}
+
+/*
+ * Fixed-point numbers used for non-integer components, scaled so that
+ * CPAR_FIXED_ONE is 1.0. Magnitudes above CPAR_FIXED_MAX are clamped to it,
+ * which is far larger than any valid component but leaves room for hues of
+ * many turns.
+ */
+#define CPAR_FIXED_ONE INT64_C(1000000000)
+#define CPAR_FIXED_MAX (1000000 * CPAR_FIXED_ONE)
+
+static const uint64_t cpar_pow10[19] = {
+    UINT64_C(1),
+    UINT64_C(10),
+    UINT64_C(100),
+    UINT64_C(1000),
+    UINT64_C(10000),
+    UINT64_C(100000),
+    UINT64_C(1000000),
+    UINT64_C(10000000),
+    UINT64_C(100000000),
+    UINT64_C(1000000000),
+    UINT64_C(10000000000),
+    UINT64_C(100000000000),
+    UINT64_C(1000000000000),
+    UINT64_C(10000000000000),
+    UINT64_C(100000000000000),
+    UINT64_C(1000000000000000),
+    UINT64_C(10000000000000000),
+    UINT64_C(100000000000000000),
+    UINT64_C(1000000000000000000),
+};
+
+/*
+ * Parses a decimal number such as `0.5`, `.25` or `5e-1` from @a p up to
+ * @a end, ignoring whitespace, into a fixed-point value. Only integer
+ * arithmetic is used, so unlike `strtof()` the result doesn't depend on the
+ * locale. Digits past the ninth decimal place are ignored. The value may be
+ * negative, it's up to the caller to check the range.
+ */
+static enum cpar_status
+cpar_parse_fixed(const char *p, const char *end, int64_t *out)
+{
+  uint64_t mantissa = 0;
+  int n_significant = 0;
+  int seen_digit = 0;
+  int seen_point = 0;
+  int negative = 0;
+  long exponent = 0;
+
+  p = cpar_skip_space(p, end);
+  if (p < end && (*p == '+' || *p == '-'))
+    negative = *p++ == '-';
+
+  for (; p < end; p++) {
+    if (cpar_is_space(*p)) {
+      continue;
+    } else if (*p >= '0' && *p <= '9') {
+      seen_digit = 1;
+      if (n_significant < 18) {
+        mantissa = mantissa * 10 + (uint64_t)(*p - '0');
+        n_significant += mantissa != 0;
+        exponent -= seen_point;
+      } else if (!seen_point) {
+        exponent++;
+      }
+    } else if (*p == '.' && !seen_point) {
+      seen_point = 1;
+    } else {
+      break;
+    }
+  }
+
+  if (!seen_digit)
+    return CPAR_STATUS_INVALID_NUMBER;
+
+  if (p < end && (*p == 'e' || *p == 'E')) {
+    int exp_negative = 0;
+    long exp = 0;
+
+    p = cpar_skip_space(p + 1, end);
+    if (p < end && (*p == '+' || *p == '-'))
+      exp_negative = *p++ == '-';
+    p = cpar_skip_space(p, end);
+    if (p == end)
+      return CPAR_STATUS_INVALID_NUMBER;
+
+    for (; p < end; p++) {
+      if (cpar_is_space(*p))
+        continue;
+      else if (*p < '0' || *p > '9')
+        return CPAR_STATUS_INVALID_NUMBER;
+      if (exp < 10000)
+        exp = exp * 10 + (*p - '0');
+    }
+    exponent += exp_negative ? -exp : exp;
+  }
+
+  if (p != end)
+    return CPAR_STATUS_INVALID_NUMBER;
+
+  // scale the mantissa to the fixed-point representation
+  exponent += 9;
+  if (exponent > 0) {
+    if (exponent > 15 ||
+        mantissa > (uint64_t)CPAR_FIXED_MAX / cpar_pow10[exponent]) {
+      mantissa = mantissa ? (uint64_t)CPAR_FIXED_MAX : 0;
+    } else {
+      mantissa *= cpar_pow10[exponent];
+    }
+  } else if (exponent < 0) {
+    mantissa = (exponent < -18) ? 0 : mantissa / cpar_pow10[-exponent];
+  }
+
+  *out = negative ? -(int64_t)mantissa : (int64_t)mantissa;
+  return CPAR_STATUS_OK;
+}
+
+/*
+ * Removes whitespace and then @a suffix, ignoring case, from the end of the
+ * string from @a p up to @a *end, and returns whether the suffix was there.
+ */
+static int
+cpar_strip_suffix(const char *p, const char **end, const char *suffix)
+{
+  const char *e = *end;
+  size_t len = strlen(suffix);
+  size_t i = 0;
+
+  while (e > p && cpar_is_space(e[-1]))
+    e--;
+  if ((size_t)(e - p) < len)
+    return 0;
+  e -= len;
+  for (i = 0; i < len; i++) {
+    if (cpar_to_lower(e[i]) != suffix[i])
+      return 0;
+  }
+
+  *end = e;
+  return 1;
+}
+
+/*
+ * Parses an integer or percentage component from @a p up to @a end,
+ * ignoring whitespace.
+ */
+static enum cpar_status
+cpar_parse_component_rgb(const char *p, const char *end, uint8_t *out)
+{
+  int negative = 0;
+  size_t n_digits = 0;
+  uint32_t val = 0;
+
+  while (end > p && cpar_is_space(end[-1]))
+    end--;
+
+  // percentages are rounded to the nearest integer value
+  if (end > p && end[-1] == '%') {
+    int64_t fixed = 0;
+    enum cpar_status status = cpar_parse_fixed(p, end - 1, &fixed);
+    if (status != CPAR_STATUS_OK)
+      return status;
+    else if (fixed < 0 || fixed > 100 * CPAR_FIXED_ONE)
+      return CPAR_STATUS_NUMBER_RANGE;
+    if (out) {
+      *out = (uint8_t)((fixed * 255 + 50 * CPAR_FIXED_ONE) /
+                       (100 * CPAR_FIXED_ONE));
+    }
+    return CPAR_STATUS_OK;
+  }
+
+  p = cpar_skip_space(p, end);
+  if (p < end && (*p == '+' || *p == '-'))
+    negative = *p++ == '-';
+
+  for (; p < end; p++) {
+    if (cpar_is_space(*p))
+      continue;
+    if (*p < '0' || *p > '9')
+      return CPAR_STATUS_INVALID_NUMBER;
+    // stop accumulating once out of range so it can't overflow
+    if (val <= 255)
+      val = val * 10 + (uint32_t)(*p - '0');
+    n_digits++;
+  }
+
+  if (n_digits == 0)
+    return CPAR_STATUS_INVALID_NUMBER;
+  else if ((negative && val != 0) || val > 255)
+    return CPAR_STATUS_NUMBER_RANGE;
+
+  if (out)
+    *out = (uint8_t)val;
+
+  return CPAR_STATUS_OK;
+}
+
+/*
+ * Parses an alpha component, a number or a percentage, from @a p up to
+ * @a end, ignoring whitespace, and rounds it to the nearest 8-bit value.
+ */
+static enum cpar_status
+cpar_parse_component_a(const char *p, const char *end, uint8_t *out)
+{
+  int64_t fixed = 0;
+  int percent = 0;
+  enum cpar_status status = CPAR_STATUS_OK;
+
+  while (end > p && cpar_is_space(end[-1]))
+    end--;
+  if (end > p && end[-1] == '%') {
+    percent = 1;
+    end--;
+  }
+
+  if ((status = cpar_parse_fixed(p, end, &fixed)) != CPAR_STATUS_OK)
+    return status;
+  if (percent)
+    fixed /= 100;
+  if (fixed < 0 || fixed > CPAR_FIXED_ONE)
+    return CPAR_STATUS_NUMBER_RANGE;
+
+  if (out)
+    *out = (uint8_t)((fixed * 255 + CPAR_FIXED_ONE / 2) / CPAR_FIXED_ONE);
+
+  return CPAR_STATUS_OK;
+}
+
+/*
+ * Saturation, lightness, whiteness and blackness are kept in units of
+ * 0.01%, and hues in millidegrees, so that the conversions to RGB need only
+ * integer arithmetic.
+ */
+#define CPAR_PERCENT_ONE 10000
+#define CPAR_HUE_TURN 360000
+
+/*
+ * Parses a saturation, lightness, whiteness or blackness component from @a p
+ * up to @a end, ignoring whitespace. As in the modern CSS syntax, the `%` is
+ * optional.
+ */
+static enum cpar_status
+cpar_parse_component_percent(const char *p, const char *end, int32_t *out)
+{
+  int64_t fixed = 0;
+  enum cpar_status status = CPAR_STATUS_OK;
+
+  while (end > p && cpar_is_space(end[-1]))
+    end--;
+  if (end > p && end[-1] == '%')
+    end--;
+
+  if ((status = cpar_parse_fixed(p, end, &fixed)) != CPAR_STATUS_OK)
+    return status;
+  else if (fixed < 0 || fixed > 100 * CPAR_FIXED_ONE)
+    return CPAR_STATUS_NUMBER_RANGE;
+
+  *out = (int32_t)((fixed + CPAR_FIXED_ONE / 200) / (CPAR_FIXED_ONE / 100));
+  return CPAR_STATUS_OK;
+}
+
+/*
+ * Parses a hue from @a p up to @a end, ignoring whitespace, as a number of
+ * degrees or an angle with a `deg`, `grad`, `rad` or `turn` unit. Hues wrap
+ * around, so any value is in range.
+ */
+static enum cpar_status
+cpar_parse_component_hue(const char *p, const char *end, int32_t *out)
+{
+  // the size of a full turn in each unit, as fixed-point numbers
+  int64_t turn = 360 * CPAR_FIXED_ONE;
+  int64_t fixed = 0;
+  enum cpar_status status = CPAR_STATUS_OK;
+
+  if (cpar_strip_suffix(p, &end, "deg"))
+    turn = 360 * CPAR_FIXED_ONE;
+  else if (cpar_strip_suffix(p, &end, "grad"))
+    turn = 400 * CPAR_FIXED_ONE;
+  else if (cpar_strip_suffix(p, &end, "rad"))
+    turn = INT64_C(6283185307); // 2 * pi
+  else if (cpar_strip_suffix(p, &end, "turn"))
+    turn = CPAR_FIXED_ONE;
+
+  if ((status = cpar_parse_fixed(p, end, &fixed)) != CPAR_STATUS_OK)
+    return status;
+
+  fixed %= turn;
+  if (fixed < 0)
+    fixed += turn;
+  *out = (int32_t)(fixed * CPAR_HUE_TURN / turn);
+  return CPAR_STATUS_OK;
+}
+
+/*
+ * The piecewise-linear function of the hue which the CSS Color 4 HSL
+ * conversion scales each channel by, for the red (@a n = 0), green (8) or
+ * blue (4) channel. The result is between -CPAR_HUE_TURN / 12 and
+ * CPAR_HUE_TURN / 12, standing for -1 and 1.
+ */
+static int64_t cpar_hue_ramp(int32_t hue, int n)
+{
+  const int64_t sector = CPAR_HUE_TURN / 12;
+  int64_t k = (n * sector + hue) % CPAR_HUE_TURN;
+  int64_t t = k - 3 * sector;
+
+  if (9 * sector - k < t)
+    t = 9 * sector - k;
+  if (t > sector)
+    t = sector;
+  else if (t < -sector)
+    t = -sector;
+  return t;
+}
+
+static void
+cpar_hsl_to_rgb(int32_t hue, int32_t sat, int32_t light, uint8_t rgb[3])
+{
+  const int64_t sector = CPAR_HUE_TURN / 12;
+  const int64_t one = CPAR_PERCENT_ONE;
+  const int64_t denom = one * one * sector;
+  int64_t chroma = sat * (int64_t)(light < one - light ? light : one - light);
+  int i = 0;
+
+  for (i = 0; i < 3; i++) {
+    int64_t v =
+        light * one * sector - chroma * cpar_hue_ramp(hue, (12 - 4 * i) % 12);
+    rgb[i] = (uint8_t)((255 * v + denom / 2) / denom);
+  }
+}
+
+static void
+cpar_hwb_to_rgb(int32_t hue, int32_t white, int32_t black, uint8_t rgb[3])
+{
+  const int64_t sector = CPAR_HUE_TURN / 12;
+  const int64_t one = CPAR_PERCENT_ONE;
+  const int64_t denom = 2 * sector * one;
+  int i = 0;
+
+  // whiteness and blackness which add up to more than 100% give a grey
+  if (white + black >= one) {
+    int64_t sum = white + black;
+    rgb[0] = rgb[1] = rgb[2] = (uint8_t)((255 * white + sum / 2) / sum);
+    return;
+  }
+
+  for (i = 0; i < 3; i++) {
+    int64_t v = (sector - cpar_hue_ramp(hue, (12 - 4 * i) % 12)) *
+                    (one - white - black) +
+                2 * sector * white;
+    rgb[i] = (uint8_t)((255 * v + denom / 2) / denom);
+  }
+}
+
+/* A component of a colour function, from p up to end. */
+struct cpar_span {
+  const char *p;
+  const char *end;
+};
+
+/*
+ * Finds up to @a n_comp comma-separated components of the legacy syntax,
+ * such as `255, 0, 0`, from @a p up to @a end. Like `strtok()`, empty
+ * components are skipped, and any past @a n_comp are ignored. Returns the
+ * number of components found.
+ */
+static int cpar_split_comma(const char *p,
+                            const char *end,
+                            int n_comp,
+                            struct cpar_span comp[4])
+{
+  int i = 0;
+
+  while (i < n_comp) {
+    const char *tok_end = NULL;
+
+    while (p < end && (*p == ',' || cpar_is_space(*p)))
+      p++;
+    if (p == end)
+      break;
+
+    tok_end = (const char *)memchr(p, ',', (size_t)(end - p));
+    if (!tok_end)
+      tok_end = end;
+
+    comp[i].p = p;
+    comp[i].end = tok_end;
+    p = tok_end;
+    i++;
+  }
+
+  return i;
+}
+
+/*
+ * Finds the space-separated components of the modern syntax, such as
+ * `255 0 0 / 50%`, from @a p up to @a end. Returns the number of
+ * components, which is 3 or 4 with an alpha, or 0 if the syntax is wrong.
+ */
+static int
+cpar_split_space(const char *p, const char *end, struct cpar_span comp[4])
+{
+  int n = 0;
+  int seen_slash = 0;
+
+  while ((p = cpar_skip_space(p, end)) < end) {
+    if (*p == '/') {
+      if (seen_slash || n != 3)
+        return 0;
+      seen_slash = 1;
+      p++;
+      continue;
+    } else if (n == (seen_slash ? 4 : 3)) {
+      return 0;
+    }
+
+    comp[n].p = p;
+    while (p < end && *p != '/' && !cpar_is_space(*p))
+      p++;
+    comp[n++].end = p;
+  }
+
+  return (n == (seen_slash ? 4 : 3)) ? n : 0;
+}
+
+enum cpar_function {
+  CPAR_FUNCTION_RGB,
+  CPAR_FUNCTION_HSL,
+  CPAR_FUNCTION_HWB,
+};
+
+/*
+ * Parses the @a n_found components of a colour function which needs
+ * @a n_comp, and converts them to a colour. Errors in the components are
+ * reported before a missing component.
+ */
+static enum cpar_status cpar_parse_function(enum cpar_function func,
+                                            const struct cpar_span comp[4],
+                                            int n_found,
+                                            int n_comp,
+                                            uint32_t *result)
+{
+  uint8_t rgb[3] = {0, 0, 0};
+  uint8_t alpha = 255;
+  int32_t hue = 0;
+  int32_t percent[3] = {0, 0, 0};
+  int i = 0;
+  enum cpar_status status = CPAR_STATUS_OK;
+
+  for (i = 0; i < n_found; i++) {
+    if (i == 3)
+      status = cpar_parse_component_a(comp[i].p, comp[i].end, &alpha);
+    else if (func == CPAR_FUNCTION_RGB)
+      status = cpar_parse_component_rgb(comp[i].p, comp[i].end, &rgb[i]);
+    else if (i == 0)
+      status = cpar_parse_component_hue(comp[i].p, comp[i].end, &hue);
+    else
+      status =
+          cpar_parse_component_percent(comp[i].p, comp[i].end, &percent[i]);
+    if (status != CPAR_STATUS_OK)
+      return status;
+  }
+
+  if (n_found != n_comp)
+    return CPAR_STATUS_SYNTAX_ERROR;
+
+  if (func == CPAR_FUNCTION_HSL)
+    cpar_hsl_to_rgb(hue, percent[1], percent[2], rgb);
+  else if (func == CPAR_FUNCTION_HWB)
+    cpar_hwb_to_rgb(hue, percent[1], percent[2], rgb);
+
+  if (result)
+    *result = CPAR_COLOR_MAKE(rgb[0], rgb[1], rgb[2], alpha);
+
+  return CPAR_STATUS_OK;
+}
+
+/* BEGIN GENERATED COLOR TABLES: do not edit, see tools/gen_color_tables.py */
+
+#define CPAR_N_COLOR_NAMES 149
+#define CPAR_N_COLOR_NAME_BUCKETS 38
+#define CPAR_N_COLOR_VALUES 140
+#define CPAR_MAX_COLOR_NAME_LEN 20
+
+/*
+ * The names are stored as a structure of arrays: every name in one
+ * block, each followed by a NUL, the offset of each in the block and
+ * the values separately. There are no pointers to relocate, and the
+ * length of name i is the difference of offsets i + 1 and i, less one.
+ */
+static const char cpar_color_names[] =
+#define CPAR_COLOR_NAME_ENTRY(name, r, g, b, a) name "\0"
+    CPAR_COLOR_NAME_LIST(CPAR_COLOR_NAME_ENTRY);
+#undef CPAR_COLOR_NAME_ENTRY
+
+static const uint16_t
+    cpar_color_name_offsets[CPAR_N_COLOR_NAMES + 1] = {
+    0, 10, 23, 28, 39, 45, 51, 58, 64, 79, 84, 95, 101, 111, 121, 132, 142,
+    148, 163, 172, 180, 185, 194, 203, 217, 226, 236, 245, 255, 267, 282, 293,
+    304, 312, 323, 336, 350, 364, 378, 392, 403, 412, 424, 432, 440, 451, 461,
+    473, 485, 493, 503, 514, 519, 529, 534, 540, 552, 557, 566, 574, 584, 591,
+    597, 603, 612, 626, 636, 649, 659, 670, 680, 701, 711, 722, 732, 742, 754,
+    768, 781, 796, 811, 826, 838, 843, 853, 859, 867, 874, 891, 902, 915, 928,
+    943, 959, 977, 993, 1009, 1022, 1032, 1042, 1051, 1063, 1068, 1076, 1082,
+    1092, 1099, 1109, 1116, 1130, 1140, 1154, 1168, 1179, 1189, 1194, 1199,
+    1204, 1215, 1222, 1236, 1240, 1250, 1260, 1272, 1279, 1290, 1299, 1308,
+    1315, 1322, 1330, 1340, 1350, 1360, 1365, 1377, 1387, 1391, 1396, 1404,
+    1411, 1423, 1433, 1440, 1446, 1452, 1463, 1470, 1482,
+};
+
+static const uint32_t cpar_color_name_values[CPAR_N_COLOR_NAMES] = {
+#define CPAR_COLOR_NAME_ENTRY(name, r, g, b, a) \
+  CPAR_COLOR_MAKE(r, g, b, a),
+    CPAR_COLOR_NAME_LIST(CPAR_COLOR_NAME_ENTRY)
+#undef CPAR_COLOR_NAME_ENTRY
+};
+
+/* Per-bucket displacements of the perfect hash. */
+static const uint16_t
+    cpar_color_name_displacements[CPAR_N_COLOR_NAME_BUCKETS] = {
+    7, 9, 1, 30, 58, 60, 8, 35, 36, 0, 9, 151, 35, 29, 27, 42, 25, 95, 4, 193,
+    277, 86, 8, 2, 99, 71, 92, 0, 144, 10, 72, 160, 70, 129, 72, 1823, 30, 3,
+};
+
+/* Maps each perfect hash slot to an index in the name table. */
+static const uint8_t cpar_color_name_slots[CPAR_N_COLOR_NAMES] = {
+    49, 34, 56, 105, 71, 109, 92, 47, 108, 147, 22, 118, 104, 75, 113, 122, 46,
+    32, 83, 15, 14, 12, 96, 45, 142, 25, 7, 38, 79, 136, 24, 0, 124, 30, 19,
+    50, 101, 97, 103, 57, 48, 86, 53, 139, 9, 54, 20, 123, 76, 132, 129, 33,
+    141, 23, 121, 69, 135, 120, 39, 85, 131, 17, 90, 114, 106, 89, 148, 40, 26,
+    88, 43, 28, 11, 1, 107, 94, 137, 128, 36, 140, 42, 130, 81, 111, 35, 62,
+    84, 91, 144, 55, 52, 64, 73, 125, 98, 58, 77, 31, 110, 72, 51, 115, 6, 112,
+    18, 4, 67, 143, 10, 87, 78, 5, 29, 80, 65, 2, 126, 138, 59, 66, 3, 133, 8,
+    70, 74, 82, 99, 44, 116, 134, 145, 119, 146, 37, 60, 27, 102, 13, 41, 100,
+    61, 93, 95, 16, 63, 68, 117, 127, 21,
+};
+
+/* The distinct colour values in ascending order. */
+static const uint32_t cpar_color_value_table[CPAR_N_COLOR_VALUES] = {
+    0x00000000u, 0x000000ffu, 0x000080ffu, 0x00008bffu, 0x0000cdffu,
+    0x0000ffffu, 0x006400ffu, 0x008000ffu, 0x008080ffu, 0x008b8bffu,
+    0x00bfffffu, 0x00ced1ffu, 0x00fa9affu, 0x00ff00ffu, 0x00ff7fffu,
+    0x00ffffffu, 0x191970ffu, 0x1e90ffffu, 0x20b2aaffu, 0x228b22ffu,
+    0x2e8b57ffu, 0x2f4f4fffu, 0x32cd32ffu, 0x3cb371ffu, 0x40e0d0ffu,
+    0x4169e1ffu, 0x4682b4ffu, 0x483d8bffu, 0x48d1ccffu, 0x4b0082ffu,
+    0x556b2fffu, 0x5f9ea0ffu, 0x6495edffu, 0x663399ffu, 0x66cdaaffu,
+    0x696969ffu, 0x6a5acdffu, 0x6b8e23ffu, 0x708090ffu, 0x778899ffu,
+    0x7b68eeffu, 0x7cfc00ffu, 0x7fff00ffu, 0x7fffd4ffu, 0x800000ffu,
+    0x800080ffu, 0x808000ffu, 0x808080ffu, 0x87ceebffu, 0x87cefaffu,
+    0x8a2be2ffu, 0x8b0000ffu, 0x8b008bffu, 0x8b4513ffu, 0x8fbc8fffu,
+    0x90ee90ffu, 0x9370dbffu, 0x9400d3ffu, 0x98fb98ffu, 0x9932ccffu,
+    0x9acd32ffu, 0xa0522dffu, 0xa52a2affu, 0xa9a9a9ffu, 0xadd8e6ffu,
+    0xadff2fffu, 0xafeeeeffu, 0xb0c4deffu, 0xb0e0e6ffu, 0xb22222ffu,
+    0xb8860bffu, 0xba55d3ffu, 0xbc8f8fffu, 0xbdb76bffu, 0xc0c0c0ffu,
+    0xc71585ffu, 0xcd5c5cffu, 0xcd853fffu, 0xd2691effu, 0xd2b48cffu,
+    0xd3d3d3ffu, 0xd8bfd8ffu, 0xda70d6ffu, 0xdaa520ffu, 0xdb7093ffu,
+    0xdc143cffu, 0xdcdcdcffu, 0xdda0ddffu, 0xdeb887ffu, 0xe0ffffffu,
+    0xe6e6faffu, 0xe9967affu, 0xee82eeffu, 0xeee8aaffu, 0xf08080ffu,
+    0xf0e68cffu, 0xf0f8ffffu, 0xf0fff0ffu, 0xf0ffffffu, 0xf4a460ffu,
+    0xf5deb3ffu, 0xf5f5dcffu, 0xf5f5f5ffu, 0xf5fffaffu, 0xf8f8ffffu,
+    0xfa8072ffu, 0xfaebd7ffu, 0xfaf0e6ffu, 0xfafad2ffu, 0xfdf5e6ffu,
+    0xff0000ffu, 0xff00ffffu, 0xff1493ffu, 0xff4500ffu, 0xff6347ffu,
+    0xff69b4ffu, 0xff7f50ffu, 0xff8c00ffu, 0xffa07affu, 0xffa500ffu,
+    0xffb6c1ffu, 0xffc0cbffu, 0xffd700ffu, 0xffdab9ffu, 0xffdeadffu,
+    0xffe4b5ffu, 0xffe4c4ffu, 0xffe4e1ffu, 0xffebcdffu, 0xffefd5ffu,
+    0xfff0f5ffu, 0xfff5eeffu, 0xfff8dcffu, 0xfffacdffu, 0xfffaf0ffu,
+    0xfffafaffu, 0xffff00ffu, 0xffffe0ffu, 0xfffff0ffu, 0xffffffffu,
+};
+
+/* Maps each entry of the value table to an index in the name table. */
+static const uint8_t cpar_color_value_names[CPAR_N_COLOR_VALUES] = {
+    141, 7, 101, 21, 88, 9, 25, 54, 138, 22, 41, 38, 93, 82, 135, 2, 96, 44,
+    76, 47, 126, 36, 83, 91, 142, 122, 136, 35, 94, 60, 29, 13, 17, 119, 87,
+    42, 131, 104, 132, 78, 92, 65, 14, 3, 86, 118, 103, 53, 130, 77, 10, 32,
+    28, 123, 34, 72, 90, 39, 109, 31, 148, 128, 11, 24, 67, 55, 110, 80, 117,
+    45, 23, 89, 121, 27, 129, 95, 59, 114, 15, 137, 71, 139, 107, 52, 111, 19,
+    49, 116, 12, 69, 63, 33, 143, 108, 68, 62, 0, 57, 4, 125, 144, 5, 146, 97,
+    50, 124, 1, 84, 70, 102, 120, 48, 40, 106, 140, 58, 16, 30, 75, 105, 74,
+    115, 51, 113, 100, 99, 6, 98, 8, 112, 64, 127, 18, 66, 46, 134, 147, 81,
+    61, 145,
+};
+
+/* END GENERATED COLOR TABLES */
+
+/*
+ * One step of the 32-bit FNV-1a hash, starting from CPAR_HASH_INIT. Must
+ * match `fnv1a()` in `tools/gen_color_tables.py`.
+ */
+#define CPAR_HASH_INIT 0x811C9DC5u
+
+static uint32_t cpar_hash_byte(uint32_t h, uint8_t c)
+{
+  return (h ^ c) * 0x01000193u;
+}
+
+/*
+ * The MurmurHash3 finalizer, used to mix a bucket's displacement into a hash.
+ * Must match `mix32()` in `tools/gen_color_tables.py`.
+ */
+static uint32_t cpar_mix32(uint32_t h)
+{
+  h ^= h >> 16;
+  h *= 0x85EBCA6Bu;
+  h ^= h >> 13;
+  h *= 0xC2B2AE35u;
+  h ^= h >> 16;
+  return h;
+}
+
+/*
+ * Looks up the colour name from @a p up to @a end, ignoring whitespace and
+ * case, using the generated perfect hash. A lookup costs one hash of the
+ * name, which is folded into a small buffer as it goes, and a single
+ * comparison against the candidate in the name block.
+ */
+static enum cpar_status
+cpar_color_from_name(const char *p, const char *end, uint32_t *result)
+{
+  char name[CPAR_MAX_COLOR_NAME_LEN];
+  size_t len = 0;
+  uint32_t h = CPAR_HASH_INIT;
+  uint32_t slot = 0;
+  uint32_t index = 0;
+  uint32_t offset = 0;
+
+  for (; p < end; p++) {
+    if (cpar_is_space(*p))
+      continue;
+    if (len == CPAR_MAX_COLOR_NAME_LEN)
+      return CPAR_STATUS_NO_COLOR_NAME;
+    name[len] = cpar_to_lower(*p);
+    h = cpar_hash_byte(h, (uint8_t)name[len++]);
+  }
+
+  slot = cpar_mix32(h ^ cpar_color_name_displacements
+                            [h % CPAR_N_COLOR_NAME_BUCKETS]) %
+         CPAR_N_COLOR_NAMES;
+  index = cpar_color_name_slots[slot];
+  offset = cpar_color_name_offsets[index];
+
+  if (cpar_color_name_offsets[index + 1] - offset - 1 != len ||
+      memcmp(name, cpar_color_names + offset, len) != 0)
+    return CPAR_STATUS_NO_COLOR_NAME;
+
+  if (result)
+    *result = cpar_color_name_values[index];
+  return CPAR_STATUS_OK;
+}
+
+const char *cpar_lookup_color_name(uint32_t value)
+{
+  size_t lo = 0;
+  size_t hi = CPAR_N_COLOR_VALUES;
+
+  while (lo < hi) {
+    size_t mid = lo + (hi - lo) / 2;
+    if (cpar_color_value_table[mid] < value)
+      lo = mid + 1;
+    else
+      hi = mid;
+  }
+
+  if (lo == CPAR_N_COLOR_VALUES || cpar_color_value_table[lo] != value)
+    return NULL;
+
+  return cpar_color_names + cpar_color_name_offsets[cpar_color_value_names[lo]];
+}
+
+/* BEGIN GENERATED NEAREST TABLES: do not edit, see tools/gen_color_tables.py */
+
+#define CPAR_NEAREST_GRID 8
+
+/* The OKLab coordinates of each entry of the value table. */
+static const float cpar_color_value_oklab[CPAR_N_COLOR_VALUES][3] = {
+    {0.0f, 0.0f, 0.0f},
+    {0.0f, 0.0f, 0.0f},
+    {0.271149833f, -0.0194699972f, -0.186876641f},
+    {0.287824271f, -0.0206673104f, -0.198368674f},
+    {0.383453278f, -0.0275339806f, -0.264276248f},
+    {0.452013718f, -0.0324569842f, -0.311528148f},
+    {0.436017832f, -0.117699089f, 0.0903289013f},
+    {0.519751828f, -0.140302328f, 0.107675898f},
+    {0.543122566f, -0.0896470564f, -0.0236338046f},
+    {0.576522046f, -0.0951599283f, -0.0250871723f},
+    {0.755350014f, -0.0952156039f, -0.120300967f},
+    {0.771928783f, -0.125933551f, -0.0376461614f},
+    {0.866805852f, -0.190175371f, 0.0810971245f},
+    {0.866439612f, -0.233887574f, 0.17949848f},
+    {0.874929876f, -0.205812626f, 0.113971035f},
+    {0.90539923f, -0.14944394f, -0.0393981577f},
+    {0.288118868f, 0.00692758783f, -0.143458745f},
+    {0.652005559f, -0.0549332601f, -0.182009846f},
+    {0.691200979f, -0.112819219f, -0.0177914714f},
+    {0.557804607f, -0.134605091f, 0.10182646f},
+    {0.568526386f, -0.107546543f, 0.0502660481f},
+    {0.402962914f, -0.0363059792f, -0.0102446099f},
+    {0.741874439f, -0.182207172f, 0.138128412f},
+    {0.684042016f, -0.130523082f, 0.0608666431f},
+    {0.82233419f, -0.130228551f, -0.0115973027f},
+    {0.559848185f, -0.0118206103f, -0.187862008f},
+    {0.588000908f, -0.0408170726f, -0.0905658466f},
+    {0.414342789f, 0.0344914741f, -0.11997692f},
+    {0.786802104f, -0.11386521f, -0.0232865364f},
+    {0.338982071f, 0.0941615217f, -0.152551245f},
+    {0.49552081f, -0.0528993371f, 0.0723153933f},
+    {0.657681473f, -0.0617223226f, -0.0204101072f},
+    {0.674622014f, -0.0212890195f, -0.139744506f},
+    {0.440271794f, 0.0881767564f, -0.133864341f},
+    {0.776686234f, -0.107762347f, 0.0212899003f},
+    {0.52080655f, 4.21608304e-11f, 1.94124953e-08f},
+    {0.543567165f, 0.0458772452f, -0.164965739f},
+    {0.599483841f, -0.0813767753f, 0.110690019f},
+    {0.592504148f, -0.01141009f, -0.0287427291f},
+    {0.61902017f, -0.0119892329f, -0.0302063425f},
+    {0.604472873f, 0.0518098934f, -0.186839988f},
+    {0.881753139f, -0.189778937f, 0.182177459f},
+    {0.890262506f, -0.190506982f, 0.183924227f},
+    {0.914994557f, -0.127986315f, 0.0248966374f},
+    {0.376692088f, 0.134888786f, 0.0754915205f},
+    {0.420913661f, 0.164704304f, -0.101471782f},
+    {0.580664574f, -0.0428122277f, 0.119116199f},
+    {0.599870802f, 4.85615437e-11f, 2.23595289e-08f},
+    {0.814817245f, -0.0571562729f, -0.05868004f},
+    {0.820618801f, -0.0518242173f, -0.0790558659f},
+    {0.533764951f, 0.130318077f, -0.213705227f},
+    {0.399856878f, 0.143183811f, 0.0801338936f},
+    {0.44679787f, 0.174832843f, -0.107711818f},
+    {0.470783513f, 0.070808723f, 0.0869601217f},
+    {0.75086478f, -0.06507693f, 0.0460258852f},
+    {0.868003274f, -0.126183997f, 0.0913816452f},
+    {0.626914249f, 0.070936681f, -0.141214886f},
+    {0.514909716f, 0.166898379f, -0.200239044f},
+    {0.903542836f, -0.131545205f, 0.0952728474f},
+    {0.541114544f, 0.15060078f, -0.17016659f},
+    {0.784852281f, -0.109642468f, 0.147442119f},
+    {0.526482172f, 0.0819615042f, 0.0808375163f},
+    {0.480612545f, 0.144029479f, 0.068890295f},
+    {0.734808578f, 5.94848615e-11f, 2.73891873e-08f},
+    {0.856233107f, -0.0376794063f, -0.0312312965f},
+    {0.913048858f, -0.150120096f, 0.178796996f},
+    {0.906908658f, -0.0607531873f, -0.0175265497f},
+    {0.813623142f, -0.0110553873f, -0.0413557281f},
+    {0.875083188f, -0.0452260522f, -0.0217958479f},
+    {0.496771074f, 0.1603672f, 0.0810593147f},
+    {0.652069565f, 0.0193769199f, 0.130771636f},
+    {0.625579548f, 0.153305335f, -0.132207011f},
+    {0.692743724f, 0.051944138f, 0.0174461148f},
+    {0.76747404f, -0.0245712499f, 0.0949104682f},
+    {0.807796233f, 6.53934129e-11f, 3.01097223e-08f},
+    {0.55336697f, 0.218071684f, -0.0396820734f},
+    {0.615440842f, 0.133438899f, 0.0545325703f},
+    {0.678192573f, 0.057283257f, 0.108562768f},
+    {0.634398417f, 0.0990739096f, 0.11919316f},
+    {0.786186635f, 0.0169276371f, 0.0615352114f},
+    {0.86686307f, 7.0175199e-11f, 3.23113742e-08f},
+    {0.833292917f, 0.0363855188f, -0.0245764731f},
+    {0.702131782f, 0.15488695f, -0.094151888f},
+    {0.751572316f, 0.0153890603f, 0.146125592f},
+    {0.677922855f, 0.138206893f, 0.00164249095f},
+    {0.571189286f, 0.208437656f, 0.0762252405f},
+    {0.894490409f, 7.24114657e-11f, 3.33411531e-08f},
+    {0.783283511f, 0.0899080379f, -0.0594083834f},
+    {0.804539902f, 0.0222205755f, 0.0746197107f},
+    {0.977858185f, -0.0306879581f, -0.00917160402f},
+    {0.93090233f, 0.00736493156f, -0.0259152113f},
+    {0.750736233f, 0.083602667f, 0.0686568048f},
+    {0.761898542f, 0.156465268f, -0.10079778f},
+    {0.921047645f, -0.0182012019f, 0.0777031756f},
+    {0.724640938f, 0.128565388f, 0.0494258247f},
+    {0.913489037f, -0.024851901f, 0.109128264f},
+    {0.975142855f, -0.00550054822f, -0.0114041691f},
+    {0.984841849f, -0.0207461873f, 0.0143222547f},
+    {0.988950645f, -0.0150410589f, -0.00457050246f},
+    {0.783997328f, 0.0640124309f, 0.10958705f},
+    {0.908833393f, 0.00745988139f, 0.0610445235f},
+    {0.963573592f, -0.00958483352f, 0.0313518448f},
+    {0.970150766f, 7.85364551e-11f, 3.61613102e-08f},
+    {0.991171992f, -0.0119392056f, 0.00324098786f},
+    {0.981118758f, 0.00258996045f, -0.00889866457f},
+    {0.735002345f, 0.133698685f, 0.0712699139f},
+    {0.946691539f, 0.00793001255f, 0.0300542896f},
+    {0.960238468f, 0.006529202f, 0.0158579626f},
+    {0.975006496f, -0.0154359469f, 0.0494870303f},
+    {0.972341443f, 0.00252866903f, 0.0214105072f},
+    {0.627955361f, 0.224863061f, 0.125846299f},
+    {0.701673856f, 0.274566294f, -0.169156059f},
+    {0.654934994f, 0.260965038f, -0.0139288591f},
+    {0.660199484f, 0.186948685f, 0.132869861f},
+    {0.696219343f, 0.165230393f, 0.104540881f},
+    {0.728297393f, 0.195155f, -0.0274456277f},
+    {0.735112858f, 0.128225071f, 0.108537744f},
+    {0.750544247f, 0.094165646f, 0.15236417f},
+    {0.793755025f, 0.0921470788f, 0.0842149769f},
+    {0.792688431f, 0.0566111997f, 0.161384549f},
+    {0.847387809f, 0.0847158264f, 0.0135488756f},
+    {0.867738445f, 0.0729803698f, 0.00907144876f},
+    {0.886771073f, -0.0169251764f, 0.18139816f},
+    {0.91125287f, 0.0265852711f, 0.0537882024f},
+    {0.916402189f, 0.0158814886f, 0.0712577656f},
+    {0.92962211f, 0.0101239652f, 0.0667744623f},
+    {0.932856204f, 0.0160261227f, 0.0488854651f},
+    {0.940011681f, 0.0271957321f, 0.0128444663f},
+    {0.948439356f, 0.00929648507f, 0.0439622961f},
+    {0.958079908f, 0.00662236728f, 0.037681178f},
+    {0.968334857f, 0.0173429038f, -0.00148634637f},
+    {0.976018104f, 0.00763863186f, 0.0120331041f},
+    {0.977300675f, -0.00353118704f, 0.0370898498f},
+    {0.97780961f, -0.0122590158f, 0.0569111673f},
+    {0.986232753f, 0.00134251666f, 0.014156463f},
+    {0.988936922f, 0.00509696798f, 0.00158240839f},
+    {0.96798272f, -0.0713690804f, 0.198569755f},
+    {0.992007428f, -0.0118410245f, 0.0384629074f},
+    {0.995976324f, -0.00565336468f, 0.018783517f},
+    {0.999999993f, 8.09528555e-11f, 3.72739076e-08f},
+};
+
+/* The corner of the OKLab grid and the cells per unit. */
+static const float cpar_oklab_grid_min[3] = {
+    -0.0001f, -0.233987574f, -0.311628148f,
+};
+static const float cpar_oklab_grid_scale[3] = {
+    7.99840037f, 15.6769307f, 15.6771172f,
+};
+
+/* The candidates of cell i of the RGB grid are entries offsets[i] to
+ * offsets[i + 1] - 1 of the candidates, which are indices in the value
+ * table. */
+static const uint16_t cpar_nearest_rgb_offsets[513] = {
+    0, 1, 7, 12, 15, 20, 26, 28, 30, 36, 45, 51, 56, 64, 77, 83, 86, 90, 97,
+    101, 109, 120, 140, 151, 157, 160, 166, 175, 179, 186, 194, 204, 208, 211,
+    215, 222, 228, 232, 239, 250, 253, 259, 265, 273, 281, 288, 291, 299, 304,
+    308, 311, 318, 326, 336, 344, 348, 354, 356, 359, 364, 368, 371, 377, 384,
+    389, 394, 407, 413, 418, 425, 436, 443, 448, 460, 465, 470, 477, 484, 494,
+    507, 517, 527, 532, 533, 540, 548, 562, 568, 572, 579, 586, 592, 603, 619,
+    628, 633, 638, 643, 648, 652, 658, 672, 680, 692, 697, 704, 709, 716, 718,
+    727, 734, 745, 754, 757, 758, 760, 766, 778, 787, 793, 801, 805, 807, 811,
+    817, 825, 833, 837, 842, 848, 865, 877, 883, 889, 901, 917, 927, 941, 953,
+    962, 970, 973, 980, 992, 1003, 1011, 1016, 1021, 1031, 1036, 1050, 1056,
+    1063, 1069, 1074, 1083, 1092, 1104, 1113, 1121, 1127, 1132, 1140, 1150,
+    1165, 1175, 1182, 1195, 1201, 1211, 1219, 1229, 1234, 1245, 1256, 1268,
+    1277, 1283, 1285, 1290, 1298, 1306, 1311, 1314, 1321, 1326, 1331, 1342,
+    1355, 1367, 1377, 1382, 1389, 1394, 1405, 1419, 1424, 1429, 1438, 1444,
+    1448, 1455, 1464, 1484, 1493, 1498, 1507, 1515, 1522, 1528, 1537, 1548,
+    1554, 1563, 1576, 1582, 1588, 1593, 1599, 1606, 1610, 1616, 1630, 1638,
+    1643, 1646, 1649, 1662, 1671, 1678, 1689, 1703, 1707, 1714, 1720, 1738,
+    1756, 1767, 1780, 1800, 1808, 1815, 1822, 1837, 1852, 1860, 1866, 1882,
+    1889, 1893, 1898, 1910, 1918, 1924, 1932, 1940, 1950, 1955, 1961, 1974,
+    1979, 1983, 1991, 1994, 1997, 2003, 2009, 2021, 2036, 2048, 2057, 2062,
+    2067, 2072, 2076, 2087, 2103, 2123, 2141, 2148, 2154, 2161, 2172, 2188,
+    2195, 2204, 2223, 2227, 2232, 2238, 2250, 2272, 2281, 2290, 2307, 2323,
+    2336, 2346, 2352, 2367, 2379, 2387, 2400, 2423, 2432, 2437, 2439, 2444,
+    2455, 2461, 2480, 2494, 2501, 2505, 2509, 2517, 2523, 2525, 2536, 2547,
+    2554, 2560, 2566, 2577, 2582, 2586, 2595, 2599, 2604, 2612, 2617, 2627,
+    2638, 2647, 2658, 2662, 2670, 2678, 2684, 2695, 2706, 2730, 2744, 2749,
+    2755, 2762, 2772, 2789, 2808, 2819, 2842, 2851, 2860, 2865, 2875, 2893,
+    2908, 2915, 2931, 2958, 2976, 2984, 2992, 3003, 3009, 3020, 3028, 3040,
+    3052, 3059, 3063, 3073, 3083, 3098, 3120, 3131, 3141, 3145, 3147, 3152,
+    3163, 3172, 3193, 3208, 3213, 3222, 3225, 3229, 3232, 3234, 3241, 3251,
+    3256, 3266, 3276, 3284, 3291, 3295, 3308, 3319, 3328, 3338, 3350, 3356,
+    3363, 3374, 3386, 3391, 3398, 3404, 3412, 3422, 3433, 3439, 3451, 3456,
+    3461, 3467, 3474, 3486, 3501, 3512, 3535, 3550, 3561, 3568, 3575, 3588,
+    3599, 3606, 3634, 3648, 3664, 3673, 3684, 3695, 3709, 3729, 3765, 3784,
+    3823, 3831, 3837, 3849, 3864, 3880, 3913, 3953, 3990, 3994, 3997, 4000,
+    4003, 4005, 4007, 4014, 4015, 4021, 4029, 4039, 4049, 4054, 4060, 4071,
+    4077, 4081, 4092, 4100, 4114, 4126, 4132, 4138, 4144, 4153, 4165, 4175,
+    4186, 4194, 4199, 4205, 4209, 4215, 4228, 4241, 4253, 4264, 4287, 4297,
+    4301, 4307, 4315, 4325, 4336, 4354, 4378, 4399, 4428, 4432, 4447, 4461,
+    4473, 4488, 4511, 4550, 4591, 4594, 4602, 4616, 4622, 4628, 4647, 4682,
+    4711,
+};
+
+static const uint8_t cpar_nearest_rgb_candidates[4711] = {
+    1, 1, 2, 3, 6, 16, 21, 2, 3, 16, 21, 29, 2, 3, 16, 2, 3, 4, 16, 29, 2, 3,
+    4, 16, 27, 29, 4, 5, 4, 5, 1, 6, 7, 19, 21, 30, 1, 2, 6, 7, 16, 19, 20, 21,
+    30, 2, 3, 16, 21, 27, 29, 2, 3, 16, 21, 27, 2, 3, 4, 8, 16, 21, 27, 29, 2,
+    3, 4, 5, 8, 9, 16, 25, 26, 27, 29, 33, 36, 2, 3, 4, 5, 25, 27, 4, 5, 25, 6,
+    7, 19, 21, 6, 7, 16, 19, 20, 21, 30, 8, 16, 20, 21, 2, 3, 8, 9, 16, 20, 21,
+    27, 2, 3, 8, 9, 16, 20, 21, 25, 26, 27, 33, 2, 3, 4, 5, 8, 9, 16, 17, 18,
+    20, 21, 25, 26, 27, 29, 31, 33, 35, 36, 38, 3, 4, 5, 8, 9, 17, 25, 26, 27,
+    33, 36, 4, 5, 17, 25, 26, 36, 6, 7, 19, 6, 7, 19, 20, 21, 30, 6, 7, 8, 9,
+    19, 20, 21, 23, 30, 8, 9, 20, 21, 8, 9, 18, 20, 21, 26, 27, 8, 9, 17, 18,
+    25, 26, 27, 31, 8, 9, 10, 17, 18, 25, 26, 27, 32, 36, 10, 17, 25, 26, 6, 7,
+    19, 6, 7, 19, 20, 8, 9, 19, 20, 21, 22, 23, 8, 9, 18, 20, 21, 23, 8, 9, 18,
+    23, 8, 9, 11, 18, 23, 25, 26, 8, 9, 10, 11, 17, 18, 25, 26, 28, 31, 32, 10,
+    17, 25, 6, 7, 13, 19, 20, 22, 6, 7, 19, 20, 22, 23, 7, 8, 9, 14, 19, 20,
+    22, 23, 8, 9, 12, 14, 18, 20, 22, 23, 8, 9, 11, 18, 20, 23, 26, 9, 11, 18,
+    9, 10, 11, 17, 18, 24, 26, 28, 10, 11, 17, 24, 28, 7, 13, 19, 22, 13, 19,
+    22, 9, 12, 14, 19, 20, 22, 23, 8, 9, 12, 14, 18, 20, 22, 23, 8, 9, 11, 12,
+    14, 18, 20, 23, 24, 28, 9, 11, 12, 14, 18, 23, 24, 28, 10, 11, 18, 24, 10,
+    11, 15, 17, 24, 28, 13, 22, 13, 14, 22, 12, 13, 14, 22, 23, 12, 14, 22, 23,
+    12, 14, 18, 11, 12, 14, 18, 24, 28, 10, 11, 12, 15, 18, 24, 28, 10, 11, 15,
+    24, 28, 1, 6, 21, 44, 51, 1, 2, 3, 6, 16, 21, 27, 29, 30, 44, 45, 51, 53,
+    2, 3, 16, 21, 27, 29, 2, 3, 16, 27, 29, 2, 3, 4, 16, 27, 29, 33, 2, 3, 4,
+    5, 16, 27, 29, 33, 36, 45, 52, 2, 3, 4, 5, 27, 29, 33, 4, 5, 25, 36, 50, 1,
+    6, 7, 16, 19, 21, 30, 37, 44, 46, 51, 53, 1, 6, 16, 21, 30, 16, 21, 27, 29,
+    30, 2, 3, 16, 21, 27, 29, 33, 2, 3, 16, 21, 27, 29, 33, 2, 3, 4, 16, 25,
+    26, 27, 29, 33, 36, 2, 3, 4, 5, 16, 25, 26, 27, 29, 33, 36, 40, 50, 4, 5,
+    17, 25, 26, 27, 33, 36, 40, 50, 1, 6, 7, 19, 20, 21, 30, 37, 46, 53, 6, 19,
+    20, 21, 30, 21, 8, 16, 20, 21, 27, 33, 35, 8, 9, 16, 21, 26, 27, 33, 35, 4,
+    8, 9, 16, 25, 26, 27, 29, 31, 33, 35, 36, 38, 39, 17, 25, 26, 27, 33, 36,
+    17, 25, 26, 36, 6, 7, 19, 20, 21, 30, 37, 6, 7, 19, 20, 21, 30, 37, 8, 19,
+    20, 21, 30, 35, 8, 9, 20, 21, 23, 26, 27, 30, 31, 35, 38, 8, 9, 18, 20, 21,
+    23, 25, 26, 27, 31, 33, 35, 36, 38, 39, 47, 8, 9, 18, 25, 26, 27, 31, 36,
+    38, 17, 25, 26, 32, 36, 17, 25, 26, 32, 36, 6, 7, 19, 30, 37, 7, 19, 20,
+    30, 37, 19, 20, 23, 30, 8, 9, 18, 20, 23, 31, 8, 9, 18, 20, 23, 26, 27, 28,
+    31, 34, 35, 38, 39, 47, 8, 9, 18, 23, 25, 26, 31, 38, 9, 10, 11, 17, 18,
+    25, 26, 28, 31, 32, 34, 36, 10, 17, 25, 26, 32, 6, 7, 19, 20, 22, 30, 37,
+    19, 20, 22, 23, 37, 8, 9, 19, 20, 22, 23, 37, 20, 23, 8, 9, 18, 20, 23, 26,
+    28, 31, 34, 11, 18, 24, 26, 28, 31, 34, 10, 11, 17, 18, 24, 25, 26, 28, 31,
+    32, 34, 10, 11, 17, 18, 24, 25, 26, 28, 32, 13, 19, 22, 22, 22, 23, 12, 14,
+    18, 20, 22, 23, 9, 11, 12, 14, 18, 20, 23, 24, 26, 28, 31, 34, 11, 12, 14,
+    18, 23, 24, 28, 31, 34, 10, 11, 18, 24, 28, 34, 10, 11, 15, 17, 18, 24, 28,
+    32, 13, 22, 41, 42, 13, 22, 12, 14, 22, 23, 12, 14, 18, 22, 23, 34, 11, 12,
+    14, 18, 23, 24, 28, 34, 11, 12, 14, 18, 23, 24, 28, 34, 11, 15, 24, 28, 10,
+    11, 15, 24, 28, 1, 21, 44, 51, 53, 62, 1, 2, 16, 21, 27, 29, 30, 33, 35,
+    44, 45, 51, 52, 53, 61, 62, 69, 2, 16, 21, 27, 29, 33, 35, 44, 45, 52, 53,
+    62, 16, 27, 29, 33, 45, 52, 16, 27, 29, 33, 45, 52, 3, 4, 16, 27, 29, 33,
+    36, 45, 50, 52, 57, 59, 2, 3, 4, 5, 16, 25, 27, 29, 33, 36, 40, 45, 50, 52,
+    57, 59, 4, 5, 25, 27, 33, 36, 40, 50, 57, 59, 1, 6, 19, 21, 30, 35, 37, 44,
+    46, 51, 53, 61, 62, 69, 1, 16, 21, 27, 29, 30, 35, 44, 51, 53, 61, 62, 16,
+    21, 27, 29, 30, 33, 35, 45, 53, 16, 21, 27, 29, 33, 35, 45, 52, 27, 29, 33,
+    25, 27, 29, 33, 36, 45, 50, 4, 25, 26, 27, 29, 33, 36, 40, 50, 56, 57, 59,
+    4, 5, 25, 26, 33, 36, 40, 50, 56, 57, 59, 6, 19, 21, 30, 37, 46, 53, 61,
+    21, 30, 35, 37, 53, 20, 21, 27, 30, 35, 16, 20, 21, 27, 30, 33, 35, 38, 39,
+    47, 26, 27, 33, 35, 38, 25, 26, 27, 31, 33, 35, 36, 38, 39, 40, 47, 50, 56,
+    59, 25, 26, 33, 36, 40, 50, 25, 26, 32, 36, 40, 50, 56, 19, 21, 30, 37, 46,
+    53, 19, 20, 21, 30, 37, 19, 20, 21, 23, 30, 35, 37, 38, 47, 20, 21, 27, 30,
+    31, 35, 38, 39, 47, 20, 21, 23, 26, 27, 31, 33, 35, 36, 38, 39, 47, 25, 26,
+    27, 31, 33, 36, 38, 39, 47, 17, 25, 26, 31, 32, 36, 39, 40, 17, 25, 26, 32,
+    36, 40, 19, 22, 30, 37, 46, 19, 20, 22, 23, 30, 35, 37, 46, 19, 20, 21, 22,
+    23, 30, 35, 37, 38, 47, 8, 18, 20, 21, 23, 26, 30, 31, 34, 35, 37, 38, 39,
+    47, 54, 18, 20, 23, 26, 31, 34, 35, 38, 39, 47, 18, 25, 26, 31, 36, 38, 39,
+    17, 18, 25, 26, 28, 31, 32, 34, 36, 38, 39, 40, 56, 17, 25, 26, 32, 36, 40,
+    7, 19, 20, 22, 30, 37, 41, 42, 46, 60, 19, 20, 22, 23, 30, 37, 46, 60, 19,
+    20, 22, 23, 30, 35, 37, 38, 47, 60, 20, 23, 31, 38, 39, 18, 20, 23, 26, 28,
+    31, 34, 38, 39, 47, 54, 18, 23, 24, 26, 28, 31, 32, 34, 38, 39, 54, 17, 18,
+    24, 25, 26, 28, 31, 32, 34, 39, 48, 49, 17, 24, 25, 26, 28, 32, 34, 48, 49,
+    19, 22, 37, 41, 42, 60, 22, 37, 20, 22, 23, 37, 60, 18, 20, 22, 23, 31, 34,
+    54, 55, 18, 23, 24, 28, 31, 34, 54, 55, 18, 24, 28, 31, 34, 24, 28, 34, 24,
+    28, 32, 34, 43, 48, 49, 13, 22, 41, 42, 60, 22, 23, 41, 42, 60, 14, 22, 23,
+    34, 41, 42, 54, 55, 58, 60, 65, 12, 14, 18, 22, 23, 24, 28, 31, 34, 54, 55,
+    58, 60, 12, 14, 18, 23, 24, 28, 31, 34, 43, 54, 55, 58, 12, 18, 24, 28, 34,
+    43, 48, 54, 55, 58, 24, 28, 34, 43, 48, 15, 24, 28, 34, 43, 48, 49, 44, 51,
+    53, 62, 69, 21, 29, 30, 44, 45, 51, 52, 53, 61, 62, 69, 16, 21, 27, 29, 33,
+    35, 44, 45, 51, 52, 53, 61, 62, 69, 27, 29, 33, 45, 52, 27, 29, 33, 45, 52,
+    27, 29, 33, 36, 45, 50, 52, 57, 59, 33, 36, 50, 52, 57, 59, 36, 50, 57, 59,
+    30, 44, 51, 53, 61, 62, 69, 21, 30, 35, 44, 51, 53, 61, 62, 69, 16, 21, 27,
+    29, 30, 33, 35, 37, 38, 44, 45, 47, 51, 52, 53, 61, 62, 69, 75, 76, 21, 27,
+    29, 33, 35, 45, 47, 52, 61, 27, 29, 33, 45, 52, 27, 29, 33, 36, 45, 50, 52,
+    57, 59, 25, 33, 36, 40, 50, 56, 57, 59, 25, 36, 40, 50, 56, 57, 59, 30, 37,
+    46, 53, 61, 62, 21, 30, 35, 37, 46, 53, 61, 62, 69, 21, 27, 30, 33, 35, 37,
+    38, 47, 53, 61, 62, 27, 33, 35, 38, 39, 47, 26, 27, 33, 35, 36, 38, 39, 47,
+    59, 25, 26, 27, 33, 35, 36, 38, 39, 40, 47, 50, 56, 59, 25, 36, 40, 50, 56,
+    59, 25, 36, 40, 50, 56, 59, 30, 37, 46, 53, 61, 30, 35, 37, 46, 53, 61, 20,
+    30, 35, 37, 38, 47, 61, 35, 38, 39, 47, 26, 31, 35, 38, 39, 47, 25, 26, 27,
+    31, 32, 33, 35, 36, 38, 39, 40, 47, 56, 59, 25, 26, 31, 32, 36, 39, 40, 56,
+    25, 32, 36, 40, 56, 30, 37, 46, 30, 37, 46, 20, 23, 30, 31, 35, 37, 38, 39,
+    46, 47, 54, 60, 61, 20, 23, 30, 31, 35, 38, 39, 47, 54, 26, 31, 35, 38, 39,
+    47, 54, 26, 31, 32, 34, 36, 38, 39, 47, 54, 56, 63, 25, 26, 28, 31, 32, 34,
+    36, 38, 39, 40, 48, 49, 56, 63, 25, 32, 40, 56, 22, 30, 37, 41, 46, 60, 70,
+    20, 22, 30, 37, 46, 60, 19, 20, 22, 23, 30, 31, 34, 35, 37, 38, 39, 46, 47,
+    54, 55, 60, 72, 73, 20, 22, 23, 26, 31, 34, 35, 37, 38, 39, 47, 54, 55, 58,
+    60, 63, 72, 73, 23, 26, 28, 31, 34, 38, 39, 47, 54, 55, 63, 24, 26, 28, 31,
+    32, 34, 38, 39, 47, 48, 54, 55, 63, 24, 25, 26, 28, 31, 32, 34, 38, 39, 40,
+    43, 48, 49, 54, 56, 63, 64, 67, 68, 74, 24, 28, 32, 48, 49, 56, 64, 67, 22,
+    37, 41, 42, 46, 60, 65, 22, 23, 37, 41, 42, 60, 65, 20, 22, 23, 31, 34, 37,
+    41, 42, 47, 54, 55, 58, 60, 65, 73, 20, 22, 23, 31, 34, 38, 39, 47, 54, 55,
+    58, 60, 63, 65, 73, 23, 28, 31, 34, 54, 55, 58, 63, 24, 28, 31, 34, 54, 55,
+    24, 28, 31, 32, 34, 43, 48, 49, 54, 55, 58, 63, 64, 66, 67, 68, 24, 28, 32,
+    43, 48, 49, 64, 41, 42, 60, 65, 22, 41, 42, 60, 65, 22, 23, 34, 37, 41, 42,
+    54, 55, 58, 60, 65, 73, 22, 23, 34, 54, 55, 58, 60, 65, 28, 34, 43, 54, 55,
+    58, 24, 28, 34, 43, 48, 54, 55, 58, 24, 28, 34, 43, 48, 49, 58, 64, 24, 28,
+    34, 43, 48, 49, 64, 66, 67, 68, 44, 51, 53, 62, 69, 44, 51, 53, 61, 62, 69,
+    29, 33, 44, 45, 51, 52, 53, 61, 62, 69, 75, 76, 85, 29, 33, 45, 52, 75, 33,
+    45, 52, 75, 29, 33, 45, 50, 52, 57, 59, 75, 50, 57, 59, 50, 57, 59, 44, 51,
+    53, 61, 62, 69, 44, 51, 53, 61, 62, 69, 30, 33, 35, 45, 52, 53, 61, 62, 69,
+    75, 76, 85, 27, 29, 33, 35, 38, 45, 47, 52, 59, 61, 62, 69, 75, 76, 85, 27,
+    29, 33, 35, 36, 45, 47, 52, 57, 59, 71, 75, 33, 36, 45, 50, 52, 57, 59, 71,
+    75, 36, 50, 57, 59, 71, 36, 50, 57, 59, 71, 46, 53, 61, 62, 69, 53, 61, 62,
+    69, 30, 35, 37, 38, 47, 53, 61, 62, 69, 76, 77, 27, 30, 33, 35, 38, 39, 45,
+    47, 52, 61, 62, 72, 75, 76, 77, 84, 26, 27, 31, 33, 35, 36, 38, 39, 45, 47,
+    50, 52, 56, 59, 63, 71, 72, 75, 76, 84, 27, 33, 35, 36, 38, 39, 40, 47, 50,
+    52, 56, 57, 59, 71, 72, 75, 82, 84, 33, 36, 40, 50, 56, 59, 71, 36, 40, 50,
+    56, 59, 71, 30, 37, 46, 53, 61, 70, 78, 30, 35, 37, 46, 53, 61, 62, 70, 76,
+    77, 78, 30, 35, 37, 38, 39, 46, 47, 53, 61, 62, 70, 72, 73, 76, 77, 78, 35,
+    38, 39, 47, 61, 72, 76, 31, 33, 35, 36, 38, 39, 47, 63, 72, 26, 31, 32, 33,
+    35, 36, 38, 39, 40, 47, 50, 54, 56, 59, 63, 71, 72, 82, 84, 36, 40, 56, 71,
+    32, 36, 40, 56, 71, 30, 37, 46, 60, 61, 70, 30, 35, 37, 46, 53, 60, 61, 70,
+    73, 77, 78, 83, 23, 30, 31, 35, 37, 38, 39, 46, 47, 53, 54, 60, 61, 63, 70,
+    72, 73, 76, 77, 78, 79, 83, 31, 35, 38, 39, 47, 54, 63, 72, 73, 31, 35, 38,
+    39, 47, 54, 63, 72, 73, 26, 31, 32, 34, 36, 38, 39, 40, 47, 54, 56, 63, 67,
+    71, 72, 74, 79, 31, 32, 34, 36, 38, 39, 40, 48, 49, 54, 56, 63, 67, 71, 72,
+    74, 32, 36, 40, 48, 49, 56, 63, 64, 67, 71, 74, 82, 87, 30, 37, 41, 42, 46,
+    60, 65, 70, 77, 83, 37, 46, 60, 70, 73, 77, 35, 37, 38, 39, 47, 54, 55, 60,
+    65, 70, 72, 73, 77, 79, 83, 31, 34, 38, 39, 47, 54, 55, 60, 63, 72, 73, 79,
+    31, 34, 38, 39, 47, 54, 63, 72, 31, 34, 38, 39, 47, 48, 54, 55, 63, 64, 67,
+    72, 74, 26, 28, 31, 32, 34, 38, 39, 40, 43, 48, 49, 54, 56, 63, 64, 66, 67,
+    68, 72, 74, 80, 81, 87, 32, 48, 49, 56, 64, 66, 67, 68, 74, 37, 41, 42, 60,
+    65, 60, 65, 54, 55, 60, 65, 73, 31, 34, 54, 55, 58, 60, 63, 65, 72, 73, 79,
+    34, 54, 55, 58, 63, 73, 28, 31, 34, 39, 43, 48, 49, 54, 55, 58, 63, 64, 66,
+    67, 68, 72, 74, 79, 80, 34, 43, 48, 49, 54, 55, 58, 63, 64, 66, 67, 68, 74,
+    80, 43, 48, 49, 64, 66, 67, 68, 41, 42, 60, 65, 41, 42, 60, 65, 41, 42, 54,
+    55, 58, 60, 65, 73, 54, 55, 58, 60, 65, 73, 55, 58, 34, 43, 48, 54, 55, 58,
+    64, 66, 67, 68, 74, 34, 43, 48, 49, 55, 58, 64, 66, 67, 68, 74, 43, 48, 49,
+    64, 66, 67, 68, 44, 51, 53, 62, 69, 85, 44, 51, 53, 62, 69, 85, 44, 45, 51,
+    52, 53, 61, 62, 69, 75, 76, 85, 45, 52, 62, 75, 85, 45, 52, 59, 75, 33, 45,
+    50, 52, 57, 59, 71, 75, 112, 50, 57, 59, 71, 50, 57, 59, 71, 111, 44, 51,
+    53, 61, 62, 69, 78, 85, 53, 61, 62, 69, 85, 45, 52, 53, 61, 62, 69, 75, 76,
+    78, 85, 33, 45, 52, 61, 62, 69, 75, 76, 84, 85, 112, 33, 45, 52, 57, 59,
+    71, 75, 76, 84, 33, 45, 50, 52, 56, 57, 59, 71, 75, 82, 84, 50, 57, 59, 71,
+    36, 40, 50, 56, 57, 59, 71, 82, 46, 53, 61, 62, 69, 70, 77, 78, 53, 61, 62,
+    69, 76, 78, 35, 47, 53, 61, 62, 69, 75, 76, 77, 78, 85, 35, 38, 47, 61, 62,
+    72, 75, 76, 77, 84, 94, 33, 35, 36, 38, 39, 45, 47, 50, 52, 56, 59, 63, 71,
+    72, 75, 76, 77, 82, 84, 91, 94, 105, 112, 115, 33, 36, 38, 39, 40, 47, 50,
+    56, 59, 71, 72, 75, 82, 84, 50, 56, 59, 71, 82, 40, 50, 56, 59, 71, 82, 46,
+    53, 61, 70, 77, 78, 83, 37, 46, 53, 61, 62, 70, 76, 77, 78, 83, 35, 37, 47,
+    53, 61, 62, 70, 72, 73, 76, 77, 78, 83, 84, 91, 94, 105, 35, 38, 39, 47,
+    54, 61, 63, 72, 73, 76, 77, 79, 84, 88, 91, 94, 99, 105, 116, 38, 39, 47,
+    63, 71, 72, 76, 79, 84, 91, 94, 36, 38, 39, 40, 47, 50, 54, 56, 59, 63, 71,
+    72, 74, 76, 79, 82, 84, 87, 88, 91, 92, 94, 115, 40, 56, 59, 63, 71, 72,
+    82, 87, 92, 36, 40, 50, 56, 59, 71, 82, 87, 92, 46, 70, 77, 78, 83, 37, 46,
+    60, 61, 70, 73, 76, 77, 78, 83, 35, 37, 47, 54, 60, 61, 70, 72, 73, 76, 77,
+    78, 79, 83, 88, 91, 94, 99, 38, 39, 47, 54, 63, 72, 73, 76, 77, 79, 84, 88,
+    91, 94, 99, 47, 54, 63, 72, 73, 79, 84, 38, 39, 47, 54, 56, 63, 67, 71, 72,
+    74, 79, 81, 82, 84, 87, 88, 32, 36, 38, 39, 40, 48, 49, 54, 56, 63, 64, 67,
+    68, 71, 72, 74, 79, 80, 81, 82, 84, 86, 87, 88, 92, 115, 120, 32, 36, 40,
+    48, 49, 56, 63, 64, 67, 68, 71, 74, 80, 81, 82, 86, 87, 92, 37, 46, 60, 70,
+    77, 78, 83, 119, 37, 46, 60, 70, 73, 77, 78, 83, 47, 54, 60, 72, 73, 77,
+    79, 83, 88, 91, 99, 54, 63, 72, 73, 79, 88, 39, 47, 54, 55, 63, 72, 73, 74,
+    79, 88, 91, 54, 63, 67, 72, 74, 79, 80, 81, 48, 49, 63, 64, 66, 67, 68, 74,
+    80, 81, 86, 87, 48, 49, 56, 64, 66, 67, 68, 74, 80, 81, 86, 87, 41, 42, 60,
+    65, 70, 83, 122, 60, 65, 73, 83, 54, 55, 60, 65, 73, 77, 79, 83, 88, 99,
+    54, 55, 58, 60, 63, 72, 73, 79, 88, 95, 34, 54, 55, 58, 63, 72, 73, 74, 79,
+    80, 88, 91, 93, 95, 100, 43, 48, 54, 55, 58, 63, 64, 66, 67, 68, 72, 73,
+    74, 79, 80, 81, 86, 87, 88, 93, 95, 100, 48, 49, 63, 64, 66, 67, 68, 74,
+    80, 81, 86, 48, 49, 64, 66, 67, 68, 74, 80, 81, 86, 41, 42, 60, 65, 60, 65,
+    55, 58, 60, 65, 73, 54, 55, 58, 60, 63, 65, 73, 79, 88, 93, 95, 54, 55, 58,
+    73, 74, 79, 88, 93, 95, 34, 43, 48, 54, 55, 58, 63, 64, 66, 67, 68, 74, 79,
+    80, 81, 86, 88, 93, 95, 100, 101, 43, 48, 49, 55, 58, 64, 66, 67, 68, 74,
+    80, 81, 86, 89, 90, 64, 66, 67, 68, 80, 44, 51, 53, 61, 62, 69, 85, 110,
+    113, 62, 69, 85, 62, 69, 75, 85, 75, 85, 112, 75, 112, 50, 52, 57, 59, 71,
+    75, 112, 50, 52, 57, 59, 71, 75, 82, 111, 112, 115, 50, 57, 59, 71, 111,
+    51, 53, 61, 62, 69, 78, 85, 110, 113, 114, 53, 61, 62, 69, 76, 78, 85, 110,
+    113, 114, 61, 62, 69, 75, 76, 78, 85, 114, 62, 75, 76, 84, 85, 112, 114,
+    75, 76, 84, 112, 50, 52, 56, 57, 59, 71, 75, 76, 82, 84, 94, 112, 115, 50,
+    56, 57, 59, 71, 75, 82, 84, 111, 112, 115, 50, 56, 57, 59, 71, 82, 92, 111,
+    115, 53, 61, 62, 69, 70, 77, 78, 85, 113, 114, 53, 61, 62, 69, 70, 76, 77,
+    78, 85, 113, 114, 116, 61, 62, 76, 77, 78, 114, 75, 76, 84, 94, 105, 114,
+    116, 71, 72, 75, 76, 82, 84, 91, 94, 105, 112, 115, 56, 59, 71, 72, 75, 82,
+    84, 92, 94, 105, 112, 115, 59, 71, 82, 92, 115, 50, 56, 59, 71, 82, 92,
+    115, 61, 70, 77, 78, 83, 117, 61, 70, 76, 77, 78, 83, 114, 116, 61, 76, 77,
+    78, 91, 94, 99, 105, 114, 116, 72, 76, 77, 84, 91, 94, 99, 105, 114, 116,
+    118, 72, 76, 84, 91, 94, 105, 56, 63, 71, 72, 82, 84, 87, 91, 92, 94, 105,
+    115, 71, 82, 87, 92, 115, 56, 71, 82, 87, 92, 70, 77, 78, 83, 117, 119, 70,
+    77, 78, 83, 99, 114, 116, 73, 76, 77, 78, 83, 91, 94, 99, 105, 114, 116,
+    118, 63, 72, 73, 76, 77, 79, 84, 88, 91, 94, 99, 105, 114, 116, 118, 63,
+    72, 73, 79, 84, 88, 91, 94, 99, 105, 118, 54, 56, 63, 67, 71, 72, 73, 74,
+    79, 80, 81, 82, 84, 87, 88, 91, 92, 94, 105, 115, 118, 120, 121, 56, 63,
+    67, 71, 72, 74, 80, 81, 82, 84, 87, 92, 115, 120, 121, 56, 67, 71, 74, 80,
+    81, 82, 87, 92, 120, 121, 60, 70, 77, 83, 117, 119, 122, 60, 70, 73, 77,
+    83, 99, 119, 60, 72, 73, 77, 79, 83, 88, 91, 94, 99, 105, 116, 118, 72, 73,
+    77, 79, 88, 91, 94, 95, 99, 105, 118, 63, 72, 73, 79, 88, 91, 118, 54, 63,
+    64, 67, 68, 72, 73, 74, 79, 80, 81, 82, 84, 86, 87, 88, 91, 93, 94, 95,
+    100, 118, 120, 121, 123, 124, 125, 126, 63, 64, 67, 68, 74, 80, 81, 86, 87,
+    92, 100, 120, 121, 123, 64, 66, 67, 68, 74, 80, 81, 82, 86, 87, 90, 92,
+    106, 120, 121, 127, 60, 65, 70, 77, 83, 117, 119, 122, 136, 60, 65, 70, 73,
+    77, 83, 99, 117, 119, 122, 136, 60, 65, 73, 77, 79, 83, 88, 91, 95, 99,
+    118, 54, 55, 58, 63, 72, 73, 79, 88, 91, 93, 95, 99, 118, 124, 54, 55, 58,
+    63, 72, 73, 74, 79, 88, 91, 93, 95, 99, 100, 118, 120, 123, 124, 125, 126,
+    54, 55, 58, 63, 64, 66, 67, 68, 72, 73, 74, 79, 80, 81, 86, 87, 88, 93, 95,
+    100, 101, 106, 107, 108, 109, 120, 121, 123, 124, 125, 126, 127, 128, 129,
+    132, 133, 64, 66, 67, 68, 74, 80, 81, 86, 87, 90, 93, 100, 101, 106, 107,
+    121, 123, 126, 127, 64, 66, 67, 68, 74, 80, 81, 86, 87, 89, 90, 96, 97, 98,
+    100, 101, 102, 103, 104, 106, 107, 108, 109, 120, 121, 123, 126, 127, 128,
+    129, 130, 131, 132, 133, 134, 135, 137, 138, 139, 41, 42, 60, 65, 83, 119,
+    122, 136, 60, 65, 73, 83, 122, 136, 55, 58, 60, 65, 73, 79, 83, 88, 95, 99,
+    122, 136, 54, 55, 58, 60, 65, 73, 79, 88, 93, 95, 99, 100, 123, 124, 125,
+    55, 58, 73, 74, 79, 80, 88, 93, 95, 100, 123, 124, 125, 126, 128, 133, 55,
+    58, 64, 66, 67, 68, 74, 79, 80, 81, 86, 88, 93, 95, 97, 100, 101, 106, 107,
+    108, 109, 120, 121, 123, 124, 125, 126, 127, 128, 129, 132, 133, 137, 64,
+    66, 67, 68, 74, 80, 81, 86, 89, 90, 93, 96, 97, 98, 100, 101, 102, 103,
+    104, 106, 107, 108, 109, 121, 123, 124, 125, 126, 127, 128, 129, 130, 131,
+    132, 133, 134, 135, 137, 138, 139, 64, 66, 67, 68, 74, 80, 81, 86, 89, 90,
+    96, 97, 98, 100, 101, 102, 103, 104, 106, 107, 108, 109, 121, 123, 126,
+    127, 128, 129, 130, 131, 132, 133, 134, 135, 137, 138, 139, 69, 85, 110,
+    113, 69, 85, 110, 75, 85, 112, 75, 85, 112, 75, 112, 75, 112, 57, 59, 71,
+    75, 111, 112, 115, 111, 69, 78, 85, 110, 113, 114, 62, 69, 76, 78, 85, 110,
+    113, 114, 62, 69, 75, 76, 78, 85, 112, 113, 114, 116, 75, 76, 84, 85, 94,
+    105, 112, 114, 115, 116, 75, 76, 84, 112, 115, 71, 75, 82, 84, 112, 115,
+    50, 57, 59, 71, 75, 82, 84, 92, 111, 112, 115, 59, 71, 82, 92, 111, 115,
+    78, 113, 114, 117, 69, 70, 76, 77, 78, 85, 105, 113, 114, 116, 117, 76, 77,
+    78, 85, 94, 105, 114, 116, 72, 75, 76, 77, 84, 85, 91, 94, 105, 112, 114,
+    115, 116, 118, 72, 75, 76, 82, 84, 91, 94, 105, 112, 114, 115, 116, 71, 82,
+    84, 94, 112, 115, 71, 82, 84, 92, 112, 115, 71, 82, 87, 92, 111, 115, 70,
+    77, 78, 83, 113, 114, 116, 117, 119, 70, 76, 77, 78, 83, 99, 105, 113, 114,
+    116, 117, 119, 76, 77, 78, 91, 94, 99, 105, 114, 116, 118, 72, 76, 77, 84,
+    91, 94, 99, 105, 114, 116, 118, 72, 76, 84, 91, 94, 105, 115, 118, 72, 82,
+    84, 94, 115, 71, 82, 84, 87, 92, 115, 71, 82, 87, 92, 70, 77, 78, 83, 117,
+    119, 70, 76, 77, 78, 83, 91, 99, 105, 114, 116, 117, 118, 119, 73, 76, 77,
+    78, 83, 88, 91, 94, 99, 105, 114, 116, 118, 72, 77, 79, 84, 88, 91, 94, 99,
+    105, 114, 116, 118, 72, 79, 84, 88, 91, 94, 99, 105, 115, 118, 120, 63, 71,
+    72, 74, 79, 80, 81, 82, 84, 87, 88, 91, 92, 94, 99, 100, 105, 115, 118,
+    120, 121, 123, 124, 74, 80, 81, 82, 84, 87, 92, 115, 120, 121, 81, 82, 87,
+    92, 70, 77, 83, 117, 119, 122, 70, 77, 83, 99, 116, 117, 119, 122, 73, 77,
+    83, 88, 91, 94, 99, 105, 116, 118, 72, 73, 79, 88, 91, 94, 95, 99, 105,
+    116, 118, 72, 73, 74, 79, 88, 91, 93, 94, 95, 99, 100, 105, 118, 120, 121,
+    123, 124, 125, 72, 74, 79, 80, 81, 84, 86, 87, 88, 91, 93, 94, 95, 100,
+    106, 118, 120, 121, 123, 124, 125, 126, 127, 128, 67, 74, 80, 81, 82, 86,
+    87, 90, 92, 93, 100, 106, 120, 121, 123, 124, 125, 126, 127, 128, 129, 64,
+    67, 74, 80, 81, 82, 86, 87, 90, 92, 96, 100, 101, 102, 104, 106, 107, 109,
+    120, 121, 123, 125, 126, 127, 128, 129, 130, 131, 132, 83, 119, 122, 136,
+    60, 65, 70, 73, 77, 83, 88, 91, 99, 116, 117, 118, 119, 122, 136, 65, 73,
+    77, 79, 83, 88, 91, 95, 99, 105, 116, 118, 119, 122, 73, 79, 88, 91, 93,
+    95, 99, 100, 118, 123, 124, 125, 73, 79, 88, 91, 93, 95, 99, 100, 118, 120,
+    121, 123, 124, 125, 126, 74, 79, 80, 81, 86, 88, 93, 95, 100, 101, 106,
+    108, 120, 121, 123, 124, 125, 126, 127, 128, 129, 132, 133, 67, 74, 80, 81,
+    86, 87, 89, 90, 93, 96, 97, 98, 100, 101, 102, 103, 104, 106, 107, 108,
+    109, 120, 121, 123, 124, 125, 126, 127, 128, 129, 130, 131, 132, 133, 134,
+    135, 137, 138, 139, 64, 66, 67, 68, 74, 80, 81, 86, 87, 89, 90, 96, 97, 98,
+    100, 101, 102, 103, 104, 106, 107, 108, 109, 120, 121, 123, 124, 125, 126,
+    127, 128, 129, 130, 131, 132, 133, 134, 135, 137, 138, 139, 65, 122, 136,
+    60, 65, 73, 83, 99, 119, 122, 136, 60, 65, 73, 79, 83, 88, 91, 93, 95, 99,
+    118, 122, 124, 136, 79, 88, 93, 95, 100, 124, 93, 95, 100, 123, 124, 125,
+    80, 86, 93, 95, 100, 101, 106, 108, 121, 123, 124, 125, 126, 127, 128, 129,
+    132, 133, 137, 80, 81, 86, 89, 90, 93, 96, 97, 98, 100, 101, 102, 103, 104,
+    106, 107, 108, 109, 121, 123, 124, 125, 126, 127, 128, 129, 130, 131, 132,
+    133, 134, 135, 137, 138, 139, 80, 81, 86, 89, 90, 96, 97, 98, 101, 102,
+    103, 104, 106, 107, 108, 109, 126, 127, 128, 129, 130, 131, 132, 133, 134,
+    135, 137, 138, 139,
+};
+
+/* The candidates of cell i of the OKLab grid are entries offsets[i] to
+ * offsets[i + 1] - 1 of the candidates, which are indices in the value
+ * table. */
+static const uint16_t cpar_nearest_oklab_offsets[513] = {
+    0, 7, 13, 18, 22, 26, 27, 28, 30, 36, 42, 46, 50, 53, 54, 55, 56, 62, 68,
+    72, 76, 77, 78, 79, 80, 86, 92, 97, 100, 101, 102, 103, 104, 111, 117, 122,
+    126, 127, 128, 129, 130, 139, 147, 152, 157, 159, 160, 161, 163, 174, 184,
+    190, 195, 198, 200, 203, 206, 218, 230, 241, 250, 257, 262, 266, 269, 274,
+    279, 286, 295, 309, 327, 342, 354, 360, 364, 372, 381, 393, 410, 426, 439,
+    445, 450, 457, 465, 477, 492, 508, 529, 534, 539, 545, 552, 564, 579, 597,
+    612, 619, 625, 632, 642, 655, 673, 692, 705, 715, 724, 734, 747, 762, 777,
+    788, 797, 809, 818, 829, 842, 857, 872, 883, 891, 904, 915, 927, 942, 960,
+    973, 982, 990, 996, 1003, 1014, 1034, 1049, 1059, 1066, 1075, 1081, 1087,
+    1094, 1107, 1120, 1132, 1140, 1148, 1154, 1160, 1167, 1177, 1189, 1199,
+    1212, 1226, 1234, 1242, 1249, 1256, 1270, 1285, 1302, 1318, 1329, 1339,
+    1348, 1358, 1376, 1392, 1402, 1412, 1425, 1435, 1443, 1454, 1470, 1480,
+    1486, 1492, 1506, 1517, 1524, 1535, 1549, 1556, 1561, 1567, 1581, 1590,
+    1599, 1613, 1629, 1641, 1649, 1656, 1664, 1680, 1712, 1740, 1757, 1766,
+    1773, 1780, 1785, 1801, 1830, 1856, 1874, 1885, 1890, 1897, 1902, 1915,
+    1937, 1959, 1973, 1989, 1999, 2010, 2015, 2031, 2048, 2066, 2082, 2103,
+    2123, 2145, 2159, 2177, 2191, 2207, 2239, 2255, 2265, 2280, 2298, 2315,
+    2324, 2335, 2361, 2375, 2384, 2399, 2414, 2427, 2436, 2443, 2458, 2470,
+    2480, 2491, 2501, 2511, 2520, 2528, 2545, 2559, 2570, 2583, 2598, 2616,
+    2640, 2663, 2678, 2691, 2702, 2711, 2722, 2737, 2759, 2776, 2792, 2806,
+    2814, 2823, 2832, 2841, 2858, 2874, 2888, 2907, 2925, 2936, 2945, 2953,
+    2964, 2983, 3000, 3029, 3051, 3065, 3079, 3093, 3108, 3139, 3178, 3211,
+    3239, 3272, 3282, 3292, 3307, 3343, 3390, 3419, 3444, 3471, 3481, 3493,
+    3506, 3524, 3538, 3556, 3571, 3590, 3602, 3614, 3629, 3640, 3651, 3662,
+    3673, 3688, 3701, 3716, 3739, 3761, 3780, 3799, 3820, 3836, 3845, 3855,
+    3877, 3902, 3918, 3935, 3949, 3970, 3978, 3987, 4005, 4040, 4065, 4103,
+    4137, 4183, 4195, 4204, 4216, 4245, 4292, 4342, 4379, 4403, 4419, 4438,
+    4464, 4512, 4542, 4571, 4593, 4615, 4631, 4648, 4668, 4687, 4714, 4749,
+    4774, 4799, 4812, 4825, 4840, 4851, 4870, 4894, 4909, 4924, 4932, 4939,
+    4947, 4962, 4975, 4992, 5008, 5019, 5035, 5052, 5069, 5090, 5110, 5134,
+    5153, 5168, 5185, 5199, 5216, 5241, 5259, 5291, 5328, 5347, 5363, 5382,
+    5403, 5424, 5466, 5536, 5606, 5635, 5667, 5696, 5722, 5748, 5781, 5839,
+    5890, 5925, 5973, 6017, 6058, 6102, 6144, 6202, 6240, 6259, 6281, 6300,
+    6323, 6342, 6381, 6425, 6455, 6482, 6496, 6505, 6517, 6530, 6565, 6607,
+    6638, 6668, 6677, 6685, 6693, 6705, 6725, 6753, 6785, 6815, 6840, 6857,
+    6871, 6885, 6900, 6919, 6934, 6945, 6981, 7016, 7048, 7076, 7115, 7141,
+    7167, 7180, 7231, 7284, 7334, 7383, 7433, 7494, 7549, 7577, 7629, 7680,
+    7727, 7773, 7817, 7865, 7915, 7950, 8004, 8055, 8103, 8148, 8194, 8240,
+    8289, 8340, 8399, 8455, 8508, 8560, 8613, 8665, 8721, 8775, 8821, 8873,
+    8931, 8991, 9047, 9106, 9169, 9232, 9265, 9307, 9358, 9419, 9478, 9538,
+    9605, 9673,
+};
+
+static const uint8_t cpar_nearest_oklab_candidates[9673] = {
+    1, 2, 3, 4, 5, 16, 29, 1, 2, 3, 4, 16, 29, 1, 2, 3, 4, 16, 1, 2, 3, 16, 1,
+    2, 3, 16, 1, 1, 1, 6, 1, 2, 3, 4, 16, 29, 1, 2, 3, 4, 16, 29, 1, 2, 3, 16,
+    1, 2, 3, 16, 1, 2, 16, 1, 1, 1, 1, 2, 3, 4, 16, 29, 1, 2, 3, 4, 16, 29, 1,
+    2, 3, 16, 1, 2, 3, 16, 1, 1, 1, 1, 1, 2, 3, 4, 16, 29, 1, 2, 3, 4, 16, 29,
+    1, 2, 3, 16, 29, 1, 2, 16, 1, 1, 1, 1, 1, 2, 3, 4, 16, 27, 29, 1, 2, 3, 4,
+    16, 29, 1, 2, 3, 16, 29, 1, 2, 3, 16, 1, 1, 1, 1, 1, 2, 3, 4, 16, 27, 29,
+    33, 45, 1, 2, 3, 4, 16, 27, 29, 45, 1, 2, 3, 16, 29, 1, 2, 3, 16, 29, 1,
+    16, 1, 1, 1, 44, 1, 2, 3, 4, 5, 16, 27, 29, 33, 45, 52, 1, 2, 3, 4, 16, 27,
+    29, 33, 45, 52, 1, 2, 3, 16, 29, 45, 1, 2, 3, 16, 29, 1, 16, 29, 1, 44, 1,
+    44, 51, 1, 44, 51, 1, 2, 3, 4, 5, 16, 27, 29, 33, 45, 52, 57, 1, 2, 3, 4,
+    16, 27, 29, 33, 44, 45, 51, 52, 1, 2, 3, 16, 27, 29, 33, 44, 45, 51, 52, 1,
+    2, 3, 16, 29, 44, 45, 51, 52, 1, 2, 16, 29, 44, 45, 51, 1, 16, 29, 44, 51,
+    1, 29, 44, 51, 1, 44, 51, 2, 3, 4, 5, 16, 2, 3, 4, 5, 16, 1, 2, 3, 4, 16,
+    21, 27, 1, 2, 3, 4, 6, 16, 21, 27, 29, 1, 2, 3, 4, 6, 7, 8, 16, 19, 21, 27,
+    29, 30, 35, 1, 2, 3, 4, 6, 7, 8, 9, 16, 19, 20, 21, 27, 29, 30, 35, 44, 53,
+    1, 2, 3, 6, 7, 8, 16, 19, 20, 21, 27, 30, 35, 44, 53, 1, 6, 7, 8, 16, 19,
+    20, 21, 30, 35, 44, 53, 2, 3, 4, 5, 16, 29, 2, 3, 4, 16, 1, 2, 3, 4, 16,
+    21, 27, 29, 1, 2, 3, 4, 6, 16, 21, 27, 29, 1, 2, 3, 4, 6, 16, 21, 27, 29,
+    30, 33, 44, 1, 2, 3, 6, 7, 8, 16, 19, 21, 27, 29, 30, 33, 35, 44, 51, 53,
+    1, 2, 3, 6, 7, 8, 16, 19, 21, 27, 29, 30, 35, 44, 51, 53, 1, 6, 7, 8, 16,
+    19, 20, 21, 30, 35, 44, 51, 53, 2, 3, 4, 5, 16, 29, 2, 3, 4, 16, 29, 1, 2,
+    3, 4, 16, 27, 29, 1, 2, 3, 4, 16, 21, 27, 29, 1, 2, 3, 4, 6, 16, 21, 27,
+    29, 33, 44, 51, 1, 2, 3, 6, 7, 16, 21, 27, 29, 30, 33, 35, 44, 51, 53, 1,
+    2, 3, 6, 7, 16, 21, 27, 29, 30, 35, 44, 51, 53, 61, 62, 1, 2, 3, 6, 7, 8,
+    16, 19, 20, 21, 27, 29, 30, 35, 44, 46, 51, 53, 61, 62, 69, 2, 3, 4, 16,
+    29, 2, 3, 4, 16, 29, 2, 3, 4, 16, 27, 29, 1, 2, 3, 16, 21, 27, 29, 1, 2, 3,
+    6, 16, 21, 27, 29, 33, 44, 45, 51, 1, 2, 3, 6, 16, 21, 27, 29, 30, 33, 44,
+    45, 51, 53, 62, 1, 2, 3, 6, 7, 16, 21, 27, 29, 30, 35, 44, 45, 51, 53, 61,
+    62, 69, 1, 6, 7, 16, 21, 27, 29, 30, 35, 44, 51, 53, 61, 62, 69, 2, 3, 4,
+    5, 16, 27, 29, 2, 3, 4, 16, 27, 29, 1, 2, 3, 4, 16, 27, 29, 1, 2, 3, 16,
+    21, 27, 29, 33, 44, 45, 1, 2, 3, 16, 21, 27, 29, 33, 44, 45, 51, 52, 53, 1,
+    2, 3, 6, 16, 21, 27, 29, 30, 33, 35, 44, 45, 51, 52, 53, 62, 69, 1, 2, 3,
+    6, 16, 21, 27, 29, 30, 33, 35, 44, 45, 51, 52, 53, 61, 62, 69, 1, 6, 16,
+    21, 29, 30, 44, 45, 51, 53, 61, 62, 69, 2, 3, 4, 5, 16, 27, 29, 33, 45, 52,
+    2, 3, 4, 16, 27, 29, 33, 45, 52, 1, 2, 3, 4, 16, 27, 29, 33, 45, 52, 1, 2,
+    3, 4, 16, 21, 27, 29, 33, 44, 45, 51, 52, 1, 2, 3, 16, 21, 27, 29, 33, 44,
+    45, 51, 52, 53, 62, 69, 1, 2, 3, 16, 21, 27, 29, 33, 44, 45, 51, 52, 53,
+    62, 69, 1, 16, 21, 27, 29, 44, 45, 51, 53, 62, 69, 1, 6, 21, 44, 51, 53,
+    61, 62, 69, 2, 3, 4, 5, 16, 27, 29, 33, 45, 50, 52, 57, 2, 3, 4, 16, 27,
+    29, 33, 45, 52, 1, 2, 3, 4, 16, 27, 29, 33, 44, 45, 52, 1, 2, 3, 16, 21,
+    27, 29, 33, 44, 45, 51, 52, 62, 1, 2, 3, 16, 21, 27, 29, 33, 44, 45, 51,
+    52, 53, 62, 69, 1, 2, 3, 16, 21, 27, 29, 33, 44, 45, 51, 52, 53, 62, 69, 1,
+    16, 21, 29, 44, 45, 51, 52, 53, 62, 69, 1, 21, 44, 51, 53, 61, 62, 69, 2,
+    3, 4, 5, 16, 27, 29, 33, 45, 50, 52, 57, 59, 2, 3, 4, 16, 27, 29, 33, 45,
+    50, 52, 57, 1, 2, 3, 16, 27, 29, 33, 44, 45, 51, 52, 57, 1, 2, 3, 16, 21,
+    27, 29, 33, 44, 45, 51, 52, 57, 62, 69, 1, 2, 3, 16, 21, 27, 29, 33, 44,
+    45, 51, 52, 53, 57, 61, 62, 69, 75, 1, 16, 21, 27, 29, 33, 44, 45, 51, 52,
+    53, 62, 69, 1, 29, 44, 45, 51, 52, 53, 62, 69, 1, 44, 45, 51, 53, 61, 62,
+    69, 2, 3, 4, 5, 16, 27, 2, 3, 4, 5, 16, 21, 27, 2, 3, 4, 5, 6, 8, 9, 16,
+    21, 25, 27, 2, 3, 4, 5, 6, 7, 8, 9, 16, 19, 20, 21, 25, 26, 27, 29, 30, 33,
+    35, 38, 2, 3, 4, 6, 7, 8, 9, 16, 19, 20, 21, 26, 27, 30, 35, 6, 7, 8, 9,
+    16, 19, 20, 21, 30, 35, 6, 7, 8, 19, 20, 21, 30, 6, 7, 8, 19, 20, 21, 30,
+    37, 46, 2, 3, 4, 5, 16, 27, 2, 3, 4, 5, 16, 27, 2, 3, 4, 5, 16, 21, 27, 2,
+    3, 4, 6, 8, 9, 16, 21, 27, 29, 30, 33, 35, 2, 3, 6, 7, 8, 9, 16, 19, 20,
+    21, 27, 30, 35, 6, 7, 8, 9, 16, 19, 20, 21, 27, 30, 35, 53, 6, 7, 8, 19,
+    20, 21, 30, 35, 6, 7, 19, 20, 21, 30, 46, 53, 2, 3, 4, 5, 16, 27, 2, 3, 4,
+    5, 16, 27, 2, 3, 4, 16, 21, 27, 29, 2, 3, 4, 6, 16, 21, 27, 29, 33, 35, 2,
+    3, 6, 8, 16, 21, 27, 29, 30, 33, 35, 53, 6, 7, 8, 16, 21, 27, 30, 35, 44,
+    53, 6, 7, 8, 19, 20, 21, 30, 35, 44, 46, 51, 53, 61, 6, 7, 19, 20, 21, 30,
+    35, 37, 44, 46, 51, 53, 61, 62, 2, 3, 4, 5, 16, 27, 29, 33, 2, 3, 4, 5, 16,
+    27, 29, 33, 2, 3, 4, 16, 27, 29, 33, 2, 3, 16, 21, 27, 29, 33, 2, 3, 6, 16,
+    21, 27, 29, 30, 33, 35, 44, 45, 51, 53, 6, 7, 8, 16, 21, 27, 29, 30, 33,
+    35, 44, 51, 53, 61, 62, 6, 7, 8, 16, 19, 20, 21, 27, 30, 35, 44, 46, 51,
+    53, 61, 62, 69, 6, 7, 8, 19, 20, 21, 30, 35, 37, 44, 46, 51, 53, 61, 62,
+    69, 2, 3, 4, 5, 16, 27, 29, 33, 45, 50, 57, 2, 3, 4, 5, 16, 27, 29, 33, 45,
+    52, 2, 3, 4, 16, 27, 29, 33, 45, 52, 2, 3, 16, 21, 27, 29, 33, 44, 45, 52,
+    2, 3, 6, 16, 21, 27, 29, 30, 33, 35, 44, 45, 51, 52, 53, 61, 62, 69, 6, 16,
+    21, 27, 29, 30, 33, 35, 44, 45, 51, 52, 53, 61, 62, 69, 6, 21, 30, 35, 44,
+    51, 53, 61, 62, 69, 6, 21, 30, 35, 44, 51, 53, 61, 62, 69, 2, 3, 4, 5, 16,
+    27, 29, 33, 45, 50, 52, 57, 59, 2, 3, 4, 16, 27, 29, 33, 45, 52, 57, 2, 3,
+    16, 27, 29, 33, 45, 52, 2, 3, 16, 21, 27, 29, 33, 44, 45, 51, 52, 2, 3, 16,
+    21, 27, 29, 33, 35, 44, 45, 51, 52, 53, 61, 62, 69, 21, 27, 44, 45, 51, 52,
+    53, 61, 62, 69, 21, 44, 51, 53, 62, 69, 44, 51, 53, 61, 62, 69, 2, 3, 4, 5,
+    16, 27, 29, 33, 36, 45, 50, 52, 57, 59, 2, 3, 16, 27, 29, 33, 45, 50, 52,
+    57, 59, 16, 27, 29, 33, 45, 52, 57, 16, 27, 29, 33, 44, 45, 51, 52, 57, 59,
+    62, 16, 21, 27, 29, 33, 44, 45, 51, 52, 53, 61, 62, 69, 75, 44, 45, 51, 52,
+    53, 62, 69, 44, 51, 53, 62, 69, 44, 51, 53, 61, 62, 69, 2, 3, 4, 5, 16, 27,
+    29, 33, 36, 45, 50, 52, 57, 59, 16, 27, 29, 33, 45, 50, 52, 57, 59, 27, 29,
+    33, 45, 50, 52, 57, 59, 75, 16, 27, 29, 33, 44, 45, 50, 51, 52, 57, 59, 62,
+    69, 75, 16, 27, 29, 33, 44, 45, 51, 52, 53, 57, 59, 61, 62, 69, 75, 85, 29,
+    33, 44, 45, 51, 52, 53, 61, 62, 69, 75, 85, 44, 45, 51, 52, 53, 62, 69, 85,
+    44, 51, 53, 61, 62, 69, 85, 2, 3, 4, 5, 16, 17, 25, 26, 2, 3, 4, 5, 8, 9,
+    16, 17, 21, 25, 26, 27, 32, 36, 38, 40, 2, 3, 4, 5, 6, 7, 8, 9, 10, 16, 17,
+    18, 19, 20, 21, 23, 25, 26, 27, 29, 30, 31, 32, 33, 35, 36, 37, 38, 39, 40,
+    47, 56, 2, 3, 4, 5, 6, 7, 8, 9, 16, 17, 18, 19, 20, 21, 23, 25, 26, 27, 30,
+    31, 32, 35, 36, 37, 38, 39, 46, 47, 6, 7, 8, 9, 19, 20, 21, 23, 26, 30, 31,
+    35, 37, 38, 39, 46, 47, 6, 7, 8, 9, 19, 20, 21, 30, 37, 6, 7, 8, 19, 20,
+    30, 37, 6, 7, 19, 20, 30, 37, 46, 2, 3, 4, 5, 25, 2, 3, 4, 5, 8, 9, 16, 17,
+    21, 25, 26, 27, 32, 33, 36, 40, 2, 3, 4, 5, 6, 7, 8, 9, 16, 17, 18, 19, 20,
+    21, 25, 26, 27, 29, 30, 31, 32, 33, 35, 36, 38, 39, 40, 47, 56, 2, 3, 4, 6,
+    7, 8, 9, 16, 17, 18, 19, 20, 21, 25, 26, 27, 30, 31, 32, 33, 35, 36, 37,
+    38, 39, 47, 6, 7, 8, 9, 16, 19, 20, 21, 26, 27, 30, 31, 35, 37, 38, 39, 46,
+    47, 6, 7, 8, 9, 19, 20, 21, 30, 35, 37, 46, 6, 7, 19, 20, 30, 6, 7, 19, 20,
+    30, 37, 46, 2, 3, 4, 5, 25, 2, 3, 4, 5, 16, 17, 25, 26, 27, 29, 33, 36, 40,
+    2, 3, 4, 5, 8, 9, 16, 17, 21, 25, 26, 27, 29, 32, 33, 35, 36, 38, 39, 40,
+    47, 56, 2, 3, 4, 6, 8, 9, 16, 20, 21, 25, 26, 27, 29, 30, 31, 33, 35, 36,
+    38, 39, 40, 47, 6, 7, 8, 9, 19, 20, 21, 26, 27, 30, 35, 38, 39, 47, 6, 7,
+    8, 9, 19, 20, 21, 30, 35, 37, 38, 39, 46, 47, 53, 61, 6, 7, 8, 19, 20, 21,
+    30, 35, 37, 46, 6, 7, 19, 20, 21, 30, 35, 37, 46, 53, 61, 3, 4, 5, 25, 36,
+    2, 3, 4, 5, 16, 25, 26, 27, 29, 33, 36, 40, 50, 56, 57, 59, 2, 3, 4, 5, 8,
+    16, 21, 25, 26, 27, 29, 33, 35, 36, 38, 40, 50, 2, 3, 8, 9, 16, 21, 25, 26,
+    27, 29, 30, 33, 35, 36, 38, 39, 40, 47, 6, 8, 9, 20, 21, 26, 27, 30, 33,
+    35, 36, 38, 39, 47, 53, 61, 6, 7, 8, 9, 19, 20, 21, 26, 27, 30, 35, 37, 38,
+    39, 44, 46, 47, 51, 53, 61, 62, 6, 7, 8, 9, 19, 20, 21, 30, 35, 37, 38, 44,
+    46, 47, 51, 53, 61, 62, 69, 70, 6, 7, 8, 9, 19, 20, 21, 30, 35, 37, 44, 46,
+    47, 51, 53, 61, 62, 69, 70, 76, 77, 78, 2, 3, 4, 5, 16, 25, 27, 29, 33, 36,
+    40, 50, 57, 59, 2, 3, 4, 5, 16, 25, 26, 27, 29, 33, 36, 40, 45, 50, 52, 56,
+    57, 59, 3, 4, 16, 25, 27, 29, 33, 36, 40, 45, 50, 52, 57, 59, 16, 21, 25,
+    26, 27, 29, 33, 35, 36, 38, 45, 47, 50, 52, 57, 59, 6, 8, 9, 16, 20, 21,
+    25, 26, 27, 29, 30, 33, 35, 36, 38, 39, 44, 45, 46, 47, 51, 52, 53, 56, 59,
+    61, 62, 69, 71, 75, 76, 85, 8, 21, 27, 30, 35, 38, 39, 44, 46, 47, 51, 53,
+    61, 62, 69, 76, 21, 30, 35, 44, 46, 51, 53, 61, 62, 69, 6, 30, 35, 37, 44,
+    46, 51, 53, 61, 62, 69, 70, 76, 78, 85, 2, 3, 4, 5, 16, 25, 27, 29, 33, 36,
+    40, 45, 50, 52, 56, 57, 59, 71, 3, 4, 5, 16, 25, 27, 29, 33, 36, 40, 45,
+    50, 52, 56, 57, 59, 71, 27, 29, 33, 36, 45, 50, 52, 57, 59, 27, 29, 33, 35,
+    36, 45, 50, 52, 57, 59, 75, 16, 21, 27, 29, 30, 33, 35, 36, 38, 39, 44, 45,
+    47, 51, 52, 53, 56, 57, 59, 61, 62, 69, 71, 75, 76, 85, 21, 35, 44, 45, 47,
+    51, 52, 53, 61, 62, 69, 75, 76, 85, 35, 44, 51, 53, 61, 62, 69, 76, 85, 30,
+    35, 44, 46, 51, 53, 61, 62, 69, 70, 76, 78, 85, 110, 113, 4, 5, 25, 27, 29,
+    33, 36, 40, 45, 50, 52, 56, 57, 59, 71, 27, 29, 33, 36, 40, 45, 50, 52, 56,
+    57, 59, 71, 75, 29, 33, 36, 45, 50, 52, 57, 59, 75, 29, 33, 45, 52, 57, 59,
+    75, 27, 29, 33, 44, 45, 51, 52, 53, 59, 61, 62, 69, 75, 76, 85, 44, 45, 51,
+    52, 53, 61, 62, 69, 75, 76, 85, 110, 44, 51, 53, 61, 62, 69, 75, 76, 85,
+    110, 44, 51, 53, 61, 62, 69, 76, 78, 85, 110, 113, 29, 33, 36, 40, 45, 50,
+    52, 57, 59, 71, 29, 33, 36, 45, 50, 52, 57, 59, 71, 75, 29, 33, 45, 50, 52,
+    57, 59, 71, 75, 29, 33, 45, 50, 52, 57, 59, 75, 29, 33, 44, 45, 51, 52, 53,
+    57, 59, 61, 62, 69, 71, 75, 76, 85, 112, 44, 45, 51, 52, 53, 61, 62, 69,
+    75, 76, 85, 110, 112, 113, 44, 51, 53, 61, 62, 69, 75, 76, 85, 110, 113,
+    44, 51, 53, 61, 62, 69, 75, 76, 78, 85, 110, 113, 114, 4, 5, 8, 9, 10, 11,
+    17, 18, 25, 26, 27, 31, 32, 36, 40, 4, 5, 8, 9, 10, 11, 17, 18, 25, 26, 27,
+    28, 31, 32, 36, 38, 39, 40, 4, 5, 8, 9, 10, 11, 17, 18, 20, 21, 23, 25, 26,
+    27, 28, 31, 32, 34, 35, 36, 38, 39, 40, 47, 6, 7, 8, 9, 10, 11, 17, 18, 19,
+    20, 21, 23, 25, 26, 28, 30, 31, 32, 34, 35, 38, 39, 47, 6, 7, 8, 9, 11, 18,
+    19, 20, 23, 26, 30, 31, 37, 38, 39, 6, 7, 8, 9, 18, 19, 20, 22, 23, 30, 31,
+    37, 46, 6, 7, 8, 9, 18, 19, 20, 22, 23, 30, 37, 6, 7, 19, 20, 22, 23, 30,
+    37, 46, 4, 5, 10, 17, 25, 26, 27, 32, 36, 40, 56, 4, 5, 8, 9, 10, 17, 18,
+    25, 26, 27, 31, 32, 36, 39, 40, 4, 5, 8, 9, 10, 11, 17, 18, 20, 21, 25, 26,
+    27, 31, 32, 35, 36, 38, 39, 40, 47, 56, 8, 9, 10, 17, 18, 20, 21, 23, 25,
+    26, 30, 31, 32, 35, 38, 39, 47, 6, 7, 8, 9, 18, 19, 20, 23, 26, 30, 31, 35,
+    37, 38, 39, 47, 6, 7, 8, 9, 18, 19, 20, 23, 30, 31, 37, 38, 39, 46, 6, 7,
+    19, 20, 23, 30, 37, 46, 6, 7, 19, 20, 22, 23, 30, 37, 46, 4, 5, 17, 25, 26,
+    32, 36, 40, 56, 4, 5, 17, 25, 26, 32, 36, 40, 56, 8, 9, 10, 17, 18, 25, 26,
+    27, 31, 32, 35, 36, 38, 39, 40, 47, 56, 8, 9, 17, 18, 20, 21, 25, 26, 27,
+    31, 32, 35, 36, 38, 39, 47, 8, 9, 18, 19, 20, 21, 23, 26, 30, 31, 35, 38,
+    39, 47, 6, 7, 8, 9, 18, 19, 20, 21, 23, 26, 30, 31, 35, 37, 38, 39, 46, 47,
+    70, 6, 7, 8, 9, 18, 19, 20, 23, 30, 31, 35, 37, 38, 39, 46, 47, 70, 77, 6,
+    7, 19, 20, 23, 30, 37, 46, 53, 70, 77, 4, 5, 17, 25, 32, 36, 40, 50, 56, 5,
+    17, 25, 26, 32, 36, 40, 56, 17, 25, 26, 27, 32, 33, 36, 38, 39, 40, 56, 8,
+    9, 17, 18, 21, 25, 26, 27, 31, 32, 33, 35, 36, 38, 39, 40, 47, 56, 72, 8,
+    9, 18, 20, 21, 26, 30, 31, 32, 35, 38, 39, 47, 53, 56, 61, 72, 6, 7, 8, 9,
+    18, 19, 20, 21, 23, 26, 30, 31, 35, 37, 38, 39, 46, 47, 53, 54, 61, 62, 63,
+    70, 72, 76, 77, 78, 84, 6, 7, 8, 9, 19, 20, 23, 30, 31, 35, 37, 38, 39, 46,
+    47, 53, 61, 70, 72, 76, 77, 78, 6, 7, 19, 20, 23, 30, 37, 46, 53, 61, 70,
+    77, 78, 83, 4, 5, 17, 25, 27, 32, 33, 36, 40, 50, 56, 57, 59, 71, 5, 17,
+    25, 26, 27, 32, 33, 36, 40, 50, 56, 57, 59, 71, 17, 25, 26, 27, 32, 33, 36,
+    38, 39, 40, 50, 56, 57, 59, 71, 8, 9, 17, 21, 25, 26, 27, 31, 32, 33, 35,
+    36, 38, 39, 40, 45, 47, 50, 52, 56, 57, 59, 61, 62, 63, 71, 72, 75, 76, 82,
+    84, 8, 9, 20, 21, 25, 26, 27, 30, 31, 32, 33, 35, 36, 38, 39, 40, 45, 46,
+    47, 51, 52, 53, 56, 59, 61, 62, 63, 69, 70, 71, 72, 75, 76, 77, 78, 82, 84,
+    94, 105, 8, 9, 20, 21, 26, 30, 31, 35, 37, 38, 39, 44, 46, 47, 51, 53, 61,
+    62, 63, 69, 70, 72, 76, 77, 78, 84, 85, 91, 94, 105, 113, 114, 116, 30, 31,
+    35, 37, 38, 39, 46, 47, 51, 53, 61, 62, 69, 70, 72, 76, 77, 78, 83, 84, 85,
+    91, 94, 105, 113, 114, 116, 117, 6, 7, 19, 20, 30, 35, 37, 44, 46, 47, 51,
+    53, 61, 62, 69, 70, 72, 73, 76, 77, 78, 83, 84, 85, 91, 94, 99, 105, 110,
+    113, 114, 116, 117, 5, 25, 33, 36, 40, 50, 56, 57, 59, 71, 25, 33, 36, 40,
+    50, 52, 56, 57, 59, 71, 25, 27, 32, 33, 36, 40, 45, 50, 52, 56, 57, 59, 71,
+    75, 82, 17, 25, 26, 27, 31, 32, 33, 35, 36, 38, 39, 40, 45, 47, 50, 52, 53,
+    56, 57, 59, 61, 62, 63, 69, 71, 72, 75, 76, 82, 84, 85, 92, 94, 111, 112,
+    115, 21, 26, 27, 30, 31, 32, 33, 35, 36, 38, 39, 40, 44, 45, 47, 50, 51,
+    52, 53, 56, 57, 59, 61, 62, 63, 69, 70, 71, 72, 75, 76, 77, 78, 82, 84, 85,
+    87, 91, 92, 94, 105, 110, 112, 113, 114, 115, 116, 35, 38, 39, 44, 47, 51,
+    52, 53, 61, 62, 69, 70, 72, 75, 76, 77, 78, 82, 84, 85, 91, 94, 105, 110,
+    112, 113, 114, 115, 116, 35, 44, 46, 47, 51, 53, 61, 62, 69, 70, 72, 75,
+    76, 77, 78, 84, 85, 91, 94, 105, 110, 113, 114, 116, 117, 30, 35, 44, 46,
+    47, 51, 53, 61, 62, 69, 70, 72, 76, 77, 78, 83, 84, 85, 91, 94, 99, 105,
+    110, 113, 114, 116, 117, 33, 36, 40, 50, 52, 56, 57, 59, 71, 111, 33, 36,
+    40, 45, 50, 52, 56, 57, 59, 71, 82, 111, 33, 36, 40, 45, 50, 52, 56, 57,
+    59, 71, 75, 82, 111, 33, 36, 40, 45, 50, 52, 56, 57, 59, 62, 71, 75, 76,
+    82, 84, 111, 112, 115, 45, 52, 61, 62, 69, 71, 75, 76, 82, 84, 85, 94, 112,
+    115, 51, 53, 61, 62, 69, 75, 76, 77, 78, 84, 85, 94, 105, 110, 112, 113,
+    114, 115, 51, 53, 61, 62, 69, 76, 77, 78, 84, 85, 94, 110, 112, 113, 114,
+    44, 51, 53, 61, 62, 69, 70, 76, 77, 78, 84, 85, 94, 105, 110, 113, 114,
+    116, 117, 33, 36, 40, 45, 50, 52, 56, 57, 59, 71, 82, 111, 33, 40, 45, 50,
+    52, 56, 57, 59, 71, 75, 82, 111, 33, 45, 50, 52, 56, 57, 59, 71, 75, 82,
+    84, 92, 111, 112, 115, 45, 52, 57, 59, 71, 75, 82, 84, 111, 112, 115, 45,
+    52, 62, 69, 71, 75, 76, 82, 84, 85, 112, 62, 69, 75, 76, 84, 85, 110, 112,
+    113, 114, 115, 62, 69, 75, 76, 78, 84, 85, 110, 112, 113, 114, 51, 53, 61,
+    62, 69, 76, 78, 85, 94, 105, 110, 112, 113, 114, 116, 5, 9, 10, 11, 17, 18,
+    25, 26, 28, 32, 40, 48, 49, 8, 9, 10, 11, 15, 17, 18, 24, 25, 26, 28, 31,
+    32, 48, 49, 8, 9, 10, 11, 15, 17, 18, 20, 23, 24, 25, 26, 28, 31, 32, 34,
+    38, 39, 48, 49, 54, 64, 67, 8, 9, 10, 11, 15, 17, 18, 20, 23, 24, 26, 28,
+    31, 32, 34, 38, 39, 48, 49, 54, 64, 67, 8, 9, 10, 11, 12, 18, 19, 20, 22,
+    23, 24, 26, 28, 31, 34, 37, 48, 49, 54, 7, 8, 9, 11, 12, 14, 18, 19, 20,
+    22, 23, 24, 28, 31, 34, 37, 54, 55, 60, 7, 9, 11, 12, 13, 14, 18, 19, 20,
+    22, 23, 24, 28, 31, 34, 37, 41, 46, 54, 55, 60, 7, 12, 13, 14, 19, 20, 22,
+    23, 34, 37, 41, 42, 46, 54, 55, 60, 5, 10, 17, 25, 26, 32, 36, 40, 49, 10,
+    11, 17, 25, 26, 28, 32, 40, 48, 49, 8, 9, 10, 11, 17, 18, 24, 25, 26, 28,
+    31, 32, 34, 38, 39, 40, 47, 48, 49, 63, 64, 67, 8, 9, 10, 11, 17, 18, 20,
+    23, 24, 25, 26, 28, 31, 32, 34, 38, 39, 47, 48, 49, 54, 63, 64, 67, 74, 8,
+    9, 10, 11, 18, 20, 23, 24, 26, 28, 31, 34, 39, 48, 49, 54, 8, 9, 11, 18,
+    19, 20, 22, 23, 24, 28, 31, 34, 37, 46, 54, 60, 73, 7, 18, 19, 20, 22, 23,
+    28, 31, 34, 37, 46, 54, 60, 73, 7, 12, 13, 14, 19, 20, 22, 23, 34, 37, 41,
+    42, 46, 54, 55, 60, 70, 73, 79, 83, 88, 10, 17, 25, 26, 32, 36, 40, 56, 10,
+    17, 25, 26, 32, 36, 40, 49, 56, 9, 10, 11, 17, 18, 25, 26, 28, 31, 32, 36,
+    38, 39, 40, 48, 49, 56, 67, 8, 9, 10, 11, 17, 18, 20, 23, 24, 25, 26, 28,
+    31, 32, 34, 35, 36, 38, 39, 40, 47, 48, 49, 54, 56, 63, 64, 67, 68, 72, 74,
+    79, 80, 81, 87, 8, 9, 10, 11, 18, 20, 23, 24, 26, 28, 31, 32, 34, 38, 39,
+    47, 48, 49, 54, 63, 67, 72, 73, 74, 79, 7, 8, 9, 11, 18, 19, 20, 22, 23,
+    24, 26, 28, 31, 34, 35, 37, 38, 39, 46, 47, 48, 49, 54, 55, 60, 63, 64, 67,
+    70, 72, 73, 74, 77, 79, 81, 83, 88, 99, 7, 8, 9, 11, 18, 19, 20, 22, 23,
+    24, 28, 30, 31, 34, 37, 38, 39, 46, 47, 54, 55, 60, 63, 70, 72, 73, 74, 77,
+    79, 83, 88, 91, 99, 119, 7, 9, 12, 13, 14, 18, 19, 20, 22, 23, 24, 28, 30,
+    31, 34, 37, 38, 39, 41, 42, 46, 47, 54, 55, 58, 60, 61, 63, 65, 70, 72, 73,
+    74, 77, 78, 79, 83, 88, 91, 95, 99, 116, 117, 118, 119, 122, 5, 10, 17, 25,
+    26, 32, 36, 40, 50, 56, 59, 71, 10, 17, 25, 26, 32, 36, 40, 49, 56, 10, 17,
+    25, 26, 32, 36, 38, 39, 40, 48, 49, 56, 8, 9, 10, 11, 17, 18, 25, 26, 28,
+    31, 32, 34, 35, 36, 38, 39, 40, 47, 48, 49, 54, 56, 63, 64, 67, 72, 74, 81,
+    87, 8, 9, 10, 11, 17, 18, 20, 23, 24, 26, 28, 31, 32, 34, 35, 37, 38, 39,
+    46, 47, 48, 49, 54, 56, 63, 64, 67, 68, 70, 72, 73, 74, 76, 77, 79, 80, 81,
+    84, 87, 88, 91, 94, 99, 105, 118, 120, 121, 8, 9, 11, 18, 19, 20, 23, 24,
+    26, 28, 31, 34, 35, 37, 38, 39, 46, 47, 48, 49, 54, 60, 61, 63, 64, 67, 68,
+    70, 72, 73, 74, 76, 77, 78, 79, 80, 81, 83, 84, 87, 88, 91, 94, 99, 105,
+    116, 117, 118, 119, 120, 9, 18, 19, 20, 23, 28, 31, 34, 35, 37, 38, 39, 46,
+    47, 54, 60, 61, 63, 70, 72, 73, 74, 76, 77, 78, 79, 81, 83, 88, 91, 94, 99,
+    105, 116, 117, 118, 119, 19, 20, 23, 34, 37, 46, 54, 60, 61, 70, 72, 73,
+    77, 78, 79, 83, 88, 91, 99, 105, 116, 117, 118, 119, 5, 10, 17, 25, 26, 32,
+    36, 40, 50, 56, 57, 59, 71, 82, 87, 92, 10, 17, 25, 26, 32, 36, 39, 40, 48,
+    49, 50, 56, 57, 59, 67, 71, 82, 87, 92, 10, 17, 25, 26, 31, 32, 36, 38, 39,
+    40, 47, 48, 49, 50, 56, 59, 63, 67, 71, 72, 74, 81, 82, 84, 87, 92, 8, 9,
+    10, 11, 17, 18, 25, 26, 28, 31, 32, 34, 35, 36, 38, 39, 40, 47, 48, 49, 50,
+    54, 56, 59, 63, 64, 67, 68, 71, 72, 74, 75, 76, 79, 80, 81, 82, 84, 87, 88,
+    91, 92, 94, 105, 115, 118, 120, 121, 26, 31, 32, 38, 39, 47, 48, 49, 54,
+    56, 63, 67, 71, 72, 73, 74, 76, 77, 79, 81, 82, 84, 87, 88, 91, 92, 94,
+    105, 118, 120, 31, 38, 39, 46, 47, 54, 63, 67, 70, 72, 73, 74, 76, 77, 78,
+    79, 81, 83, 84, 87, 88, 91, 94, 99, 105, 114, 116, 117, 118, 46, 47, 63,
+    70, 72, 73, 76, 77, 78, 79, 83, 84, 88, 91, 94, 99, 105, 114, 116, 117,
+    118, 119, 37, 46, 61, 70, 72, 73, 76, 77, 78, 79, 83, 88, 91, 94, 99, 105,
+    113, 114, 116, 117, 118, 119, 5, 17, 25, 26, 32, 36, 40, 50, 56, 57, 59,
+    71, 82, 87, 92, 111, 17, 25, 26, 32, 36, 40, 50, 56, 57, 59, 71, 75, 82,
+    87, 92, 111, 115, 25, 26, 32, 36, 38, 39, 40, 50, 56, 57, 59, 71, 75, 81,
+    82, 84, 87, 92, 111, 115, 32, 36, 38, 39, 40, 47, 56, 59, 63, 71, 72, 75,
+    81, 82, 84, 87, 92, 94, 115, 38, 39, 47, 56, 63, 71, 72, 74, 75, 76, 77,
+    79, 81, 82, 84, 85, 87, 88, 91, 92, 94, 105, 114, 115, 116, 118, 120, 38,
+    39, 47, 61, 63, 70, 72, 73, 74, 75, 76, 77, 78, 79, 81, 82, 83, 84, 85, 87,
+    88, 91, 92, 94, 99, 105, 110, 113, 114, 115, 116, 117, 118, 119, 120, 61,
+    63, 70, 72, 73, 76, 77, 78, 79, 83, 84, 85, 88, 91, 94, 99, 105, 110, 113,
+    114, 115, 116, 117, 118, 119, 46, 61, 69, 70, 72, 73, 76, 77, 78, 79, 83,
+    84, 85, 88, 91, 94, 99, 105, 110, 113, 114, 116, 117, 118, 119, 25, 32, 36,
+    40, 50, 56, 57, 59, 71, 82, 87, 92, 111, 36, 40, 50, 56, 57, 59, 71, 75,
+    82, 87, 92, 111, 115, 36, 40, 50, 56, 57, 59, 71, 75, 82, 84, 87, 92, 111,
+    112, 115, 56, 59, 71, 75, 82, 84, 87, 92, 111, 112, 115, 56, 71, 72, 75,
+    76, 82, 84, 85, 87, 91, 92, 94, 105, 112, 114, 115, 116, 118, 120, 61, 72,
+    75, 76, 77, 78, 82, 84, 85, 87, 91, 92, 94, 99, 105, 110, 112, 113, 114,
+    115, 116, 117, 118, 120, 76, 77, 78, 84, 85, 91, 94, 99, 105, 110, 113,
+    114, 116, 117, 118, 76, 77, 78, 85, 91, 94, 99, 105, 110, 113, 114, 116,
+    117, 118, 119, 40, 50, 57, 59, 71, 82, 92, 111, 50, 57, 59, 71, 82, 92,
+    111, 59, 71, 75, 82, 92, 111, 112, 115, 56, 57, 59, 71, 75, 76, 82, 84, 85,
+    87, 92, 94, 111, 112, 115, 71, 75, 76, 82, 84, 85, 92, 94, 105, 111, 112,
+    114, 115, 75, 76, 78, 82, 84, 85, 91, 92, 94, 105, 110, 112, 113, 114, 115,
+    116, 118, 75, 76, 78, 84, 85, 91, 94, 105, 110, 112, 113, 114, 115, 116,
+    117, 118, 76, 78, 85, 94, 105, 110, 113, 114, 116, 117, 118, 10, 11, 15,
+    17, 18, 24, 25, 26, 28, 32, 48, 49, 64, 66, 67, 68, 10, 11, 15, 17, 18, 24,
+    28, 31, 32, 34, 43, 48, 49, 64, 66, 67, 68, 10, 11, 15, 17, 18, 24, 28, 31,
+    32, 34, 43, 48, 49, 64, 66, 67, 68, 10, 11, 12, 15, 17, 18, 23, 24, 28, 31,
+    34, 43, 48, 49, 54, 55, 58, 64, 66, 67, 68, 10, 11, 12, 14, 15, 18, 22, 23,
+    24, 28, 34, 43, 48, 49, 54, 55, 58, 64, 66, 68, 11, 12, 13, 14, 15, 18, 22,
+    23, 24, 28, 31, 34, 41, 42, 43, 48, 54, 55, 58, 60, 64, 65, 66, 68, 11, 12,
+    13, 14, 15, 18, 22, 23, 24, 28, 34, 41, 42, 43, 54, 55, 58, 60, 65, 12, 13,
+    14, 22, 23, 34, 41, 42, 43, 54, 55, 58, 60, 65, 136, 10, 11, 15, 17, 18,
+    24, 25, 26, 28, 32, 40, 48, 49, 64, 66, 67, 68, 10, 11, 15, 17, 18, 24, 28,
+    32, 48, 49, 64, 66, 67, 68, 10, 11, 15, 17, 18, 24, 28, 31, 32, 34, 43, 48,
+    49, 64, 66, 67, 68, 10, 11, 15, 17, 18, 23, 24, 28, 31, 32, 34, 43, 48, 49,
+    54, 63, 64, 66, 67, 68, 74, 80, 86, 89, 90, 10, 11, 12, 15, 18, 23, 24, 28,
+    34, 43, 48, 49, 54, 55, 58, 64, 66, 68, 11, 12, 14, 15, 18, 22, 23, 24, 28,
+    31, 34, 41, 42, 43, 48, 49, 54, 55, 58, 60, 63, 64, 65, 66, 67, 68, 73, 74,
+    80, 86, 93, 95, 11, 12, 13, 14, 15, 18, 22, 23, 24, 28, 34, 41, 42, 43, 54,
+    55, 58, 60, 63, 64, 65, 66, 68, 73, 74, 79, 80, 83, 86, 88, 93, 95, 100,
+    122, 124, 125, 136, 12, 13, 14, 22, 23, 34, 41, 42, 43, 54, 55, 58, 60, 65,
+    73, 93, 95, 122, 136, 10, 11, 15, 17, 25, 26, 28, 32, 40, 48, 49, 56, 64,
+    67, 68, 87, 10, 11, 15, 17, 18, 24, 28, 32, 40, 48, 49, 56, 64, 66, 67, 68,
+    81, 87, 90, 10, 11, 15, 17, 18, 24, 28, 31, 32, 48, 49, 63, 64, 66, 67, 68,
+    74, 80, 81, 86, 90, 10, 11, 15, 18, 24, 28, 32, 34, 43, 48, 49, 63, 64, 66,
+    67, 68, 74, 80, 81, 86, 90, 10, 11, 15, 18, 23, 24, 28, 31, 34, 43, 48, 49,
+    54, 55, 58, 63, 64, 66, 67, 68, 73, 74, 79, 80, 81, 86, 88, 89, 90, 93,
+    100, 101, 102, 106, 107, 123, 124, 125, 126, 127, 128, 129, 10, 11, 12, 14,
+    15, 18, 22, 23, 24, 28, 31, 34, 43, 48, 49, 54, 55, 58, 60, 63, 64, 65, 66,
+    67, 68, 72, 73, 74, 79, 80, 81, 83, 86, 88, 89, 90, 91, 93, 95, 96, 97, 98,
+    99, 100, 101, 102, 103, 104, 106, 107, 108, 109, 120, 121, 122, 123, 124,
+    125, 126, 127, 128, 129, 130, 131, 132, 133, 134, 135, 137, 138, 11, 12,
+    13, 14, 15, 18, 22, 23, 24, 28, 31, 34, 41, 42, 43, 48, 54, 55, 58, 60, 63,
+    64, 65, 66, 67, 68, 70, 72, 73, 74, 77, 79, 80, 81, 83, 86, 88, 89, 90, 91,
+    93, 95, 96, 97, 99, 100, 101, 102, 106, 107, 108, 109, 118, 119, 121, 122,
+    123, 124, 125, 126, 127, 128, 129, 130, 131, 132, 133, 134, 136, 137, 12,
+    14, 22, 23, 34, 41, 42, 43, 54, 55, 58, 60, 65, 70, 73, 79, 83, 88, 93, 95,
+    99, 100, 119, 122, 123, 124, 125, 126, 136, 10, 11, 15, 17, 18, 24, 25, 26,
+    28, 31, 32, 36, 39, 40, 48, 49, 50, 56, 63, 64, 66, 67, 68, 71, 74, 80, 81,
+    82, 86, 87, 90, 92, 10, 11, 15, 17, 18, 24, 25, 26, 28, 31, 32, 40, 48, 49,
+    56, 63, 64, 66, 67, 68, 71, 74, 80, 81, 82, 86, 87, 90, 92, 10, 11, 15, 17,
+    18, 24, 28, 31, 32, 48, 49, 56, 63, 64, 66, 67, 68, 74, 80, 81, 82, 86, 87,
+    90, 92, 121, 10, 11, 18, 24, 28, 31, 32, 34, 48, 49, 54, 63, 64, 66, 67,
+    68, 72, 74, 80, 81, 86, 87, 90, 120, 121, 127, 10, 11, 28, 34, 48, 49, 54,
+    63, 64, 66, 67, 68, 72, 74, 79, 80, 81, 86, 87, 88, 90, 93, 100, 106, 107,
+    120, 121, 123, 124, 125, 126, 127, 128, 11, 18, 24, 28, 31, 34, 43, 48, 49,
+    54, 55, 58, 60, 63, 64, 66, 67, 68, 72, 73, 74, 77, 79, 80, 81, 83, 86, 87,
+    88, 89, 90, 91, 93, 95, 96, 99, 100, 101, 102, 106, 107, 108, 109, 118,
+    119, 120, 121, 123, 124, 125, 126, 127, 128, 129, 130, 131, 132, 133, 23,
+    34, 43, 54, 55, 58, 60, 63, 64, 66, 67, 68, 70, 72, 73, 74, 77, 79, 80, 81,
+    83, 86, 88, 90, 91, 93, 94, 95, 99, 100, 101, 106, 107, 108, 109, 116, 117,
+    118, 119, 120, 121, 122, 123, 124, 125, 126, 127, 128, 129, 132, 133, 23,
+    34, 54, 55, 58, 60, 65, 70, 72, 73, 77, 79, 83, 88, 91, 93, 95, 99, 100,
+    105, 106, 108, 116, 117, 118, 119, 122, 123, 124, 125, 126, 128, 129, 133,
+    136, 10, 11, 15, 17, 18, 25, 26, 28, 31, 32, 36, 38, 39, 40, 48, 49, 50,
+    56, 57, 59, 63, 64, 66, 67, 68, 71, 72, 74, 80, 81, 82, 84, 86, 87, 89, 90,
+    92, 96, 98, 102, 104, 111, 115, 120, 121, 127, 130, 135, 10, 11, 17, 25,
+    26, 28, 31, 32, 36, 39, 40, 48, 49, 56, 59, 63, 64, 66, 67, 68, 71, 72, 74,
+    80, 81, 82, 84, 86, 87, 89, 90, 92, 96, 98, 102, 104, 107, 111, 115, 120,
+    121, 127, 130, 135, 10, 11, 17, 28, 31, 32, 39, 40, 48, 49, 56, 63, 64, 66,
+    67, 68, 71, 72, 74, 80, 81, 82, 84, 86, 87, 89, 90, 92, 96, 98, 102, 104,
+    106, 107, 115, 120, 121, 127, 130, 131, 135, 10, 31, 32, 48, 49, 56, 63,
+    64, 66, 67, 68, 72, 74, 79, 80, 81, 82, 84, 86, 87, 89, 90, 91, 92, 94, 96,
+    100, 101, 102, 104, 106, 107, 109, 115, 120, 121, 123, 126, 127, 128, 129,
+    130, 131, 135, 48, 49, 54, 63, 64, 66, 67, 68, 72, 73, 74, 79, 80, 81, 82,
+    84, 86, 87, 88, 90, 91, 92, 93, 94, 100, 101, 102, 105, 106, 107, 109, 118,
+    120, 121, 123, 124, 125, 126, 127, 128, 129, 130, 48, 49, 54, 63, 64, 66,
+    67, 68, 70, 72, 73, 74, 77, 79, 80, 81, 83, 84, 86, 87, 88, 89, 90, 91, 93,
+    94, 95, 96, 99, 100, 101, 102, 104, 105, 106, 107, 108, 109, 114, 116, 117,
+    118, 119, 120, 121, 123, 124, 125, 126, 127, 128, 129, 130, 131, 132, 133,
+    134, 135, 54, 63, 70, 72, 73, 74, 77, 79, 80, 81, 83, 86, 88, 91, 93, 94,
+    95, 99, 100, 101, 105, 106, 107, 114, 116, 117, 118, 119, 120, 121, 122,
+    123, 124, 125, 126, 127, 128, 129, 73, 77, 79, 83, 88, 91, 93, 95, 99, 100,
+    105, 116, 117, 118, 119, 122, 123, 124, 125, 10, 17, 25, 32, 36, 40, 48,
+    49, 50, 56, 57, 59, 64, 67, 71, 81, 82, 87, 90, 92, 111, 115, 10, 17, 32,
+    40, 48, 49, 56, 64, 67, 71, 81, 82, 87, 90, 92, 111, 115, 120, 121, 32, 40,
+    48, 49, 56, 63, 64, 67, 71, 72, 74, 80, 81, 82, 84, 86, 87, 90, 92, 111,
+    115, 120, 121, 63, 67, 71, 72, 74, 80, 81, 82, 84, 86, 87, 90, 91, 92, 94,
+    115, 120, 121, 127, 63, 64, 67, 72, 74, 77, 79, 80, 81, 82, 84, 86, 87, 88,
+    90, 91, 92, 94, 99, 100, 102, 105, 106, 107, 114, 115, 116, 118, 120, 121,
+    123, 124, 125, 126, 127, 128, 129, 130, 131, 63, 67, 72, 73, 74, 77, 78,
+    79, 80, 81, 82, 83, 84, 86, 87, 88, 90, 91, 92, 93, 94, 95, 99, 100, 105,
+    106, 107, 113, 114, 115, 116, 117, 118, 119, 120, 121, 123, 124, 125, 126,
+    127, 128, 129, 130, 72, 73, 74, 77, 79, 80, 81, 83, 84, 88, 91, 94, 99,
+    100, 105, 113, 114, 115, 116, 117, 118, 119, 120, 121, 123, 124, 125, 126,
+    127, 128, 70, 73, 77, 78, 79, 83, 88, 91, 93, 94, 95, 99, 100, 105, 113,
+    114, 116, 117, 118, 119, 120, 121, 122, 123, 124, 125, 126, 17, 32, 36, 40,
+    50, 56, 57, 59, 71, 82, 87, 92, 111, 115, 32, 40, 56, 71, 82, 87, 92, 111,
+    115, 56, 71, 81, 82, 84, 87, 92, 111, 112, 115, 120, 121, 71, 81, 82, 84,
+    87, 92, 94, 105, 111, 112, 115, 120, 121, 63, 71, 72, 74, 76, 77, 79, 80,
+    81, 82, 84, 86, 87, 88, 90, 91, 92, 94, 99, 100, 105, 111, 112, 113, 114,
+    115, 116, 117, 118, 120, 121, 123, 124, 126, 127, 63, 72, 74, 76, 77, 78,
+    79, 80, 81, 82, 83, 84, 86, 87, 88, 90, 91, 92, 94, 99, 100, 105, 106, 110,
+    112, 113, 114, 115, 116, 117, 118, 119, 120, 121, 123, 124, 125, 126, 127,
+    128, 129, 130, 72, 76, 77, 78, 79, 81, 83, 84, 87, 88, 91, 94, 99, 100,
+    105, 110, 112, 113, 114, 115, 116, 117, 118, 119, 120, 121, 123, 124, 125,
+    126, 127, 70, 72, 73, 76, 77, 78, 79, 83, 84, 88, 91, 94, 99, 100, 105,
+    110, 113, 114, 115, 116, 117, 118, 119, 120, 121, 122, 123, 124, 125, 126,
+    40, 56, 59, 71, 82, 87, 92, 111, 115, 56, 71, 82, 87, 92, 111, 112, 115,
+    71, 82, 84, 87, 92, 111, 112, 115, 71, 82, 84, 87, 92, 94, 105, 111, 112,
+    115, 120, 121, 71, 72, 76, 82, 84, 87, 91, 92, 94, 105, 110, 111, 112, 113,
+    114, 115, 116, 118, 120, 121, 72, 76, 77, 78, 81, 82, 84, 85, 87, 88, 91,
+    92, 94, 99, 105, 110, 111, 112, 113, 114, 115, 116, 117, 118, 119, 120,
+    121, 123, 72, 76, 77, 78, 79, 81, 82, 83, 84, 85, 87, 88, 91, 92, 94, 99,
+    105, 110, 112, 113, 114, 115, 116, 117, 118, 119, 120, 121, 123, 124, 126,
+    127, 70, 72, 76, 77, 78, 79, 83, 84, 85, 88, 91, 94, 99, 100, 105, 110,
+    112, 113, 114, 115, 116, 117, 118, 119, 120, 121, 123, 124, 125, 126, 10,
+    11, 15, 17, 18, 24, 28, 32, 34, 43, 48, 49, 64, 66, 67, 68, 86, 89, 90, 96,
+    98, 102, 103, 104, 139, 10, 11, 15, 24, 28, 34, 43, 48, 49, 64, 66, 67, 68,
+    89, 90, 96, 98, 10, 11, 15, 24, 28, 34, 43, 48, 49, 64, 66, 67, 68, 89, 10,
+    11, 12, 15, 24, 28, 34, 43, 48, 49, 64, 66, 68, 89, 11, 12, 14, 15, 24, 28,
+    34, 43, 48, 49, 55, 58, 64, 66, 68, 11, 12, 13, 14, 15, 24, 28, 34, 41, 42,
+    43, 55, 58, 60, 64, 65, 66, 68, 89, 12, 13, 14, 15, 22, 24, 34, 41, 42, 43,
+    55, 58, 60, 65, 136, 12, 13, 14, 41, 42, 43, 55, 58, 60, 65, 136, 10, 11,
+    15, 17, 24, 28, 32, 34, 43, 48, 49, 64, 66, 67, 68, 74, 80, 81, 86, 87, 89,
+    90, 96, 97, 98, 102, 103, 104, 107, 109, 130, 131, 134, 135, 138, 139, 10,
+    11, 15, 17, 24, 28, 32, 34, 43, 48, 49, 64, 66, 67, 68, 74, 80, 81, 86, 89,
+    90, 96, 97, 98, 102, 103, 104, 107, 109, 130, 131, 134, 135, 138, 139, 10,
+    11, 15, 24, 28, 34, 43, 48, 49, 64, 66, 67, 68, 74, 80, 81, 86, 89, 90, 96,
+    97, 98, 102, 103, 104, 107, 130, 131, 134, 135, 138, 139, 10, 11, 15, 24,
+    28, 34, 43, 48, 49, 64, 66, 67, 68, 80, 86, 89, 90, 96, 97, 98, 101, 102,
+    103, 104, 134, 135, 138, 139, 11, 12, 14, 15, 24, 28, 34, 43, 48, 49, 55,
+    58, 64, 66, 67, 68, 80, 86, 89, 90, 93, 96, 97, 98, 101, 102, 103, 104,
+    107, 108, 109, 131, 132, 133, 134, 135, 137, 138, 139, 12, 14, 15, 24, 28,
+    34, 43, 48, 55, 58, 64, 66, 68, 89, 93, 95, 96, 97, 98, 101, 103, 108, 132,
+    133, 137, 138, 12, 13, 14, 15, 24, 34, 41, 42, 43, 55, 58, 60, 65, 66, 68,
+    89, 93, 95, 97, 101, 108, 122, 132, 133, 136, 137, 12, 13, 14, 41, 42, 55,
+    58, 60, 65, 93, 95, 122, 136, 10, 11, 15, 17, 18, 24, 28, 32, 34, 40, 43,
+    48, 49, 56, 63, 64, 66, 67, 68, 74, 80, 81, 86, 87, 89, 90, 92, 96, 97, 98,
+    101, 102, 103, 104, 106, 107, 108, 109, 120, 121, 127, 128, 129, 130, 131,
+    132, 134, 135, 137, 138, 139, 10, 11, 15, 17, 18, 24, 28, 32, 34, 43, 48,
+    49, 63, 64, 66, 67, 68, 74, 80, 81, 86, 87, 89, 90, 92, 96, 97, 98, 100,
+    101, 102, 103, 104, 106, 107, 108, 109, 120, 121, 123, 126, 127, 128, 129,
+    130, 131, 132, 133, 134, 135, 137, 138, 139, 10, 11, 15, 24, 28, 34, 43,
+    48, 49, 63, 64, 66, 67, 68, 74, 80, 81, 86, 87, 89, 90, 96, 97, 98, 100,
+    101, 102, 103, 104, 106, 107, 108, 109, 120, 121, 123, 125, 126, 127, 128,
+    129, 130, 131, 132, 133, 134, 135, 137, 138, 139, 10, 11, 15, 24, 28, 34,
+    43, 48, 49, 64, 66, 67, 68, 74, 80, 81, 86, 89, 90, 93, 96, 97, 98, 100,
+    101, 102, 103, 104, 106, 107, 108, 109, 121, 123, 124, 125, 126, 127, 128,
+    129, 130, 131, 132, 133, 134, 135, 137, 138, 139, 11, 15, 24, 28, 34, 43,
+    48, 49, 55, 58, 64, 66, 67, 68, 74, 80, 81, 86, 89, 90, 93, 95, 96, 97, 98,
+    100, 101, 102, 103, 104, 106, 107, 108, 109, 123, 124, 125, 126, 127, 128,
+    129, 130, 131, 132, 133, 134, 135, 137, 138, 139, 11, 12, 14, 15, 24, 28,
+    34, 43, 48, 49, 54, 55, 58, 60, 64, 65, 66, 67, 68, 73, 74, 79, 80, 81, 86,
+    88, 89, 90, 93, 95, 96, 97, 98, 100, 101, 102, 103, 104, 106, 107, 108,
+    109, 121, 122, 123, 124, 125, 126, 127, 128, 129, 130, 131, 132, 133, 134,
+    135, 136, 137, 138, 139, 12, 14, 15, 24, 34, 41, 42, 43, 55, 58, 60, 64,
+    65, 66, 68, 73, 74, 79, 80, 86, 88, 89, 90, 93, 95, 96, 97, 98, 100, 101,
+    102, 103, 104, 106, 107, 108, 109, 122, 123, 124, 125, 126, 127, 128, 129,
+    130, 131, 132, 133, 134, 135, 136, 137, 138, 139, 12, 14, 41, 42, 43, 55,
+    58, 60, 65, 73, 88, 93, 95, 100, 101, 106, 108, 122, 123, 124, 125, 126,
+    128, 129, 132, 133, 136, 137, 10, 11, 15, 17, 24, 28, 32, 34, 40, 43, 48,
+    49, 56, 63, 64, 66, 67, 68, 74, 80, 81, 82, 86, 87, 89, 90, 92, 96, 97, 98,
+    101, 102, 103, 104, 106, 107, 108, 109, 120, 121, 126, 127, 128, 129, 130,
+    131, 132, 134, 135, 137, 138, 139, 10, 11, 15, 17, 24, 28, 32, 34, 43, 48,
+    49, 63, 64, 66, 67, 68, 74, 80, 81, 82, 86, 87, 89, 90, 92, 96, 97, 98,
+    101, 102, 103, 104, 106, 107, 108, 109, 120, 121, 123, 126, 127, 128, 129,
+    130, 131, 132, 134, 135, 137, 138, 139, 10, 11, 15, 24, 28, 43, 48, 49, 64,
+    66, 67, 68, 74, 80, 81, 86, 87, 89, 90, 92, 96, 97, 98, 101, 102, 103, 104,
+    106, 107, 108, 109, 120, 121, 123, 126, 127, 128, 129, 130, 131, 132, 133,
+    134, 135, 137, 138, 139, 15, 24, 28, 43, 48, 49, 64, 66, 67, 68, 74, 80,
+    81, 86, 87, 89, 90, 96, 97, 98, 100, 101, 102, 103, 104, 106, 107, 108,
+    109, 120, 121, 123, 125, 126, 127, 128, 129, 130, 131, 132, 133, 134, 135,
+    137, 138, 139, 43, 48, 49, 64, 66, 67, 68, 74, 80, 81, 86, 89, 90, 93, 96,
+    97, 98, 100, 101, 102, 103, 104, 106, 107, 108, 109, 120, 121, 123, 124,
+    125, 126, 127, 128, 129, 130, 131, 132, 133, 134, 135, 137, 138, 139, 43,
+    48, 55, 58, 64, 66, 67, 68, 74, 79, 80, 81, 86, 88, 89, 90, 93, 95, 96, 97,
+    98, 100, 101, 102, 103, 104, 106, 107, 108, 109, 120, 121, 123, 124, 125,
+    126, 127, 128, 129, 130, 131, 132, 133, 134, 135, 137, 138, 139, 43, 55,
+    58, 64, 66, 68, 74, 79, 80, 81, 86, 88, 89, 90, 93, 95, 96, 97, 98, 99,
+    100, 101, 102, 103, 104, 106, 107, 108, 109, 119, 120, 121, 122, 123, 124,
+    125, 126, 127, 128, 129, 130, 131, 132, 133, 134, 135, 136, 137, 138, 139,
+    55, 58, 60, 65, 73, 79, 83, 88, 93, 95, 97, 99, 100, 101, 106, 107, 108,
+    109, 118, 119, 122, 123, 124, 125, 126, 127, 128, 129, 131, 132, 133, 134,
+    136, 137, 138, 10, 11, 15, 17, 24, 28, 32, 40, 48, 49, 56, 63, 64, 66, 67,
+    68, 71, 74, 80, 81, 82, 86, 87, 89, 90, 92, 96, 97, 98, 101, 102, 103, 104,
+    106, 107, 108, 109, 111, 115, 120, 121, 123, 126, 127, 128, 129, 130, 131,
+    132, 134, 135, 137, 138, 139, 10, 11, 15, 17, 24, 28, 32, 48, 49, 63, 64,
+    66, 67, 68, 74, 80, 81, 82, 86, 87, 89, 90, 92, 96, 97, 98, 101, 102, 103,
+    104, 106, 107, 108, 109, 115, 120, 121, 123, 126, 127, 128, 129, 130, 131,
+    132, 133, 134, 135, 137, 138, 139, 10, 15, 28, 48, 49, 63, 64, 66, 67, 68,
+    74, 80, 81, 82, 86, 87, 89, 90, 92, 96, 97, 98, 100, 101, 102, 103, 104,
+    106, 107, 108, 109, 120, 121, 123, 125, 126, 127, 128, 129, 130, 131, 132,
+    133, 134, 135, 137, 138, 139, 48, 49, 64, 66, 67, 68, 74, 80, 81, 86, 87,
+    89, 90, 92, 93, 96, 97, 98, 100, 101, 102, 103, 104, 106, 107, 108, 109,
+    120, 121, 123, 124, 125, 126, 127, 128, 129, 130, 131, 132, 133, 134, 135,
+    137, 138, 139, 48, 49, 64, 66, 67, 68, 74, 79, 80, 81, 86, 87, 88, 89, 90,
+    93, 96, 97, 98, 100, 101, 102, 103, 104, 106, 107, 108, 109, 120, 121, 123,
+    124, 125, 126, 127, 128, 129, 130, 131, 132, 133, 134, 135, 137, 138, 139,
+    64, 66, 67, 68, 74, 79, 80, 81, 86, 88, 89, 90, 93, 95, 96, 97, 98, 99,
+    100, 101, 102, 103, 104, 106, 107, 108, 109, 118, 120, 121, 123, 124, 125,
+    126, 127, 128, 129, 130, 131, 132, 133, 134, 135, 137, 138, 139, 64, 66,
+    68, 73, 74, 79, 80, 81, 86, 88, 89, 90, 93, 95, 96, 97, 98, 99, 100, 101,
+    102, 103, 104, 106, 107, 108, 109, 118, 119, 120, 121, 122, 123, 124, 125,
+    126, 127, 128, 129, 130, 131, 132, 133, 134, 135, 136, 137, 138, 139, 55,
+    58, 60, 73, 74, 79, 80, 83, 86, 88, 89, 91, 93, 95, 96, 97, 98, 99, 100,
+    101, 102, 103, 104, 106, 107, 108, 109, 116, 117, 118, 119, 120, 121, 122,
+    123, 124, 125, 126, 127, 128, 129, 130, 131, 132, 133, 134, 135, 136, 137,
+    138, 139, 10, 11, 15, 17, 24, 28, 32, 40, 48, 49, 56, 63, 64, 66, 67, 68,
+    71, 72, 74, 80, 81, 82, 84, 86, 87, 89, 90, 92, 96, 97, 98, 100, 101, 102,
+    103, 104, 106, 107, 108, 109, 111, 115, 120, 121, 123, 125, 126, 127, 128,
+    129, 130, 131, 132, 133, 134, 135, 137, 138, 139, 10, 17, 28, 32, 48, 49,
+    56, 63, 64, 66, 67, 68, 71, 74, 79, 80, 81, 82, 84, 86, 87, 89, 90, 92, 96,
+    97, 98, 100, 101, 102, 103, 104, 106, 107, 108, 109, 111, 115, 120, 121,
+    123, 124, 125, 126, 127, 128, 129, 130, 131, 132, 133, 134, 135, 137, 138,
+    139, 10, 48, 49, 63, 64, 66, 67, 68, 74, 79, 80, 81, 82, 86, 87, 88, 89,
+    90, 92, 93, 96, 97, 98, 100, 101, 102, 103, 104, 106, 107, 108, 109, 111,
+    115, 118, 120, 121, 123, 124, 125, 126, 127, 128, 129, 130, 131, 132, 133,
+    134, 135, 137, 138, 139, 48, 49, 63, 64, 66, 67, 68, 74, 79, 80, 81, 82,
+    86, 87, 88, 89, 90, 91, 92, 93, 96, 97, 98, 100, 101, 102, 103, 104, 106,
+    107, 108, 109, 115, 118, 120, 121, 123, 124, 125, 126, 127, 128, 129, 130,
+    131, 132, 133, 134, 135, 137, 138, 139, 48, 49, 64, 66, 67, 68, 74, 79, 80,
+    81, 86, 87, 88, 89, 90, 91, 92, 93, 95, 96, 97, 98, 99, 100, 101, 102, 103,
+    104, 105, 106, 107, 108, 109, 115, 118, 120, 121, 123, 124, 125, 126, 127,
+    128, 129, 130, 131, 132, 133, 134, 135, 137, 138, 139, 64, 66, 67, 68, 74,
+    79, 80, 81, 86, 87, 88, 89, 90, 91, 93, 95, 96, 97, 98, 99, 100, 101, 102,
+    103, 104, 105, 106, 107, 108, 109, 116, 117, 118, 119, 120, 121, 123, 124,
+    125, 126, 127, 128, 129, 130, 131, 132, 133, 134, 135, 137, 138, 139, 64,
+    67, 68, 73, 74, 79, 80, 81, 83, 86, 87, 88, 89, 90, 91, 93, 94, 95, 96, 97,
+    98, 99, 100, 101, 102, 103, 104, 105, 106, 107, 108, 109, 116, 117, 118,
+    119, 120, 121, 122, 123, 124, 125, 126, 127, 128, 129, 130, 131, 132, 133,
+    134, 135, 136, 137, 138, 139, 73, 74, 77, 79, 80, 81, 83, 86, 88, 89, 90,
+    91, 93, 94, 95, 96, 97, 98, 99, 100, 101, 102, 103, 104, 105, 106, 107,
+    108, 109, 114, 116, 117, 118, 119, 120, 121, 122, 123, 124, 125, 126, 127,
+    128, 129, 130, 131, 132, 133, 134, 135, 136, 137, 138, 139, 10, 17, 32, 40,
+    48, 49, 56, 63, 64, 66, 67, 68, 71, 74, 80, 81, 82, 84, 86, 87, 89, 90, 92,
+    96, 97, 98, 101, 102, 103, 104, 106, 107, 109, 111, 115, 120, 121, 127,
+    129, 130, 131, 132, 134, 135, 138, 139, 10, 32, 48, 49, 56, 63, 64, 66, 67,
+    68, 71, 74, 80, 81, 82, 84, 86, 87, 89, 90, 92, 94, 96, 97, 98, 100, 101,
+    102, 103, 104, 106, 107, 108, 109, 111, 112, 115, 120, 121, 123, 126, 127,
+    128, 129, 130, 131, 132, 134, 135, 137, 138, 139, 48, 49, 63, 64, 66, 67,
+    68, 71, 72, 74, 79, 80, 81, 82, 84, 86, 87, 88, 89, 90, 91, 92, 94, 96, 97,
+    98, 100, 101, 102, 103, 104, 105, 106, 107, 108, 109, 111, 112, 115, 118,
+    120, 121, 123, 124, 125, 126, 127, 128, 129, 130, 131, 132, 133, 134, 135,
+    137, 138, 139, 48, 49, 63, 64, 66, 67, 68, 72, 74, 79, 80, 81, 82, 84, 86,
+    87, 88, 89, 90, 91, 92, 93, 94, 96, 97, 98, 99, 100, 101, 102, 103, 104,
+    105, 106, 107, 108, 109, 111, 112, 115, 116, 118, 120, 121, 123, 124, 125,
+    126, 127, 128, 129, 130, 131, 132, 133, 134, 135, 137, 138, 139, 64, 67,
+    68, 74, 79, 80, 81, 82, 84, 86, 87, 88, 89, 90, 91, 92, 93, 94, 95, 96, 97,
+    98, 99, 100, 101, 102, 103, 104, 105, 106, 107, 108, 109, 115, 116, 117,
+    118, 119, 120, 121, 123, 124, 125, 126, 127, 128, 129, 130, 131, 132, 133,
+    134, 135, 137, 138, 139, 64, 67, 68, 74, 79, 80, 81, 82, 83, 84, 86, 87,
+    88, 89, 90, 91, 92, 93, 94, 95, 96, 97, 98, 99, 100, 101, 102, 103, 104,
+    105, 106, 107, 108, 109, 114, 115, 116, 117, 118, 119, 120, 121, 122, 123,
+    124, 125, 126, 127, 128, 129, 130, 131, 132, 133, 134, 135, 137, 138, 139,
+    63, 64, 67, 68, 72, 73, 74, 77, 79, 80, 81, 83, 84, 86, 87, 88, 89, 90, 91,
+    92, 93, 94, 95, 96, 97, 98, 99, 100, 101, 102, 103, 104, 105, 106, 107,
+    108, 109, 113, 114, 115, 116, 117, 118, 119, 120, 121, 122, 123, 124, 125,
+    126, 127, 128, 129, 130, 131, 132, 133, 134, 135, 137, 138, 139, 63, 67,
+    72, 73, 74, 77, 78, 79, 80, 81, 83, 84, 86, 87, 88, 89, 90, 91, 93, 94, 95,
+    96, 97, 98, 99, 100, 101, 102, 103, 104, 105, 106, 107, 108, 109, 110, 113,
+    114, 115, 116, 117, 118, 119, 120, 121, 122, 123, 124, 125, 126, 127, 128,
+    129, 130, 131, 132, 133, 134, 135, 136, 137, 138, 139, 32, 40, 48, 49, 56,
+    64, 67, 71, 74, 80, 81, 82, 84, 86, 87, 90, 92, 96, 98, 102, 104, 107, 111,
+    112, 115, 120, 121, 127, 130, 131, 134, 135, 139, 48, 49, 56, 64, 67, 68,
+    71, 74, 80, 81, 82, 84, 86, 87, 89, 90, 92, 94, 96, 98, 102, 103, 104, 105,
+    106, 107, 109, 111, 112, 115, 120, 121, 123, 126, 127, 129, 130, 131, 134,
+    135, 138, 139, 49, 64, 67, 68, 71, 72, 74, 80, 81, 82, 84, 86, 87, 89, 90,
+    91, 92, 94, 96, 97, 98, 100, 101, 102, 103, 104, 105, 106, 107, 109, 111,
+    112, 115, 118, 120, 121, 123, 124, 125, 126, 127, 128, 129, 130, 131, 132,
+    134, 135, 137, 138, 139, 49, 63, 64, 67, 68, 71, 72, 74, 79, 80, 81, 82,
+    84, 86, 87, 88, 89, 90, 91, 92, 93, 94, 96, 97, 98, 99, 100, 101, 102, 103,
+    104, 105, 106, 107, 108, 109, 111, 112, 114, 115, 116, 117, 118, 120, 121,
+    123, 124, 125, 126, 127, 128, 129, 130, 131, 132, 133, 134, 135, 137, 138,
+    139, 64, 67, 72, 74, 79, 80, 81, 82, 84, 86, 87, 88, 89, 90, 91, 92, 93,
+    94, 96, 97, 98, 99, 100, 101, 102, 103, 104, 105, 106, 107, 108, 109, 111,
+    112, 113, 114, 115, 116, 117, 118, 119, 120, 121, 123, 124, 125, 126, 127,
+    128, 129, 130, 131, 132, 133, 134, 135, 137, 138, 139, 67, 72, 74, 79, 80,
+    81, 82, 83, 84, 86, 87, 88, 89, 90, 91, 92, 93, 94, 95, 96, 97, 98, 99,
+    100, 101, 102, 103, 104, 105, 106, 107, 108, 109, 111, 112, 113, 114, 115,
+    116, 117, 118, 119, 120, 121, 123, 124, 125, 126, 127, 128, 129, 130, 131,
+    132, 133, 134, 135, 137, 138, 139, 63, 64, 67, 72, 73, 74, 76, 77, 78, 79,
+    80, 81, 82, 83, 84, 86, 87, 88, 89, 90, 91, 92, 93, 94, 95, 96, 97, 98, 99,
+    100, 101, 102, 103, 104, 105, 106, 107, 108, 109, 110, 112, 113, 114, 115,
+    116, 117, 118, 119, 120, 121, 122, 123, 124, 125, 126, 127, 128, 129, 130,
+    131, 132, 133, 134, 135, 137, 138, 139, 63, 67, 70, 72, 73, 74, 76, 77, 78,
+    79, 80, 81, 82, 83, 84, 86, 87, 88, 89, 90, 91, 92, 93, 94, 95, 96, 97, 98,
+    99, 100, 101, 102, 103, 104, 105, 106, 107, 108, 109, 110, 112, 113, 114,
+    115, 116, 117, 118, 119, 120, 121, 122, 123, 124, 125, 126, 127, 128, 129,
+    130, 131, 132, 133, 134, 135, 136, 137, 138, 139,
+};
+
+/* See CPAR_SRGB_TO_LINEAR_FLOATS. */
+#ifdef __cplusplus
+static const float (&cpar_srgb_to_linear_float)[256] =
+    cpar::detail::srgb_to_linear;
+#else
+static const float cpar_srgb_to_linear_float[256] = {
+    CPAR_SRGB_TO_LINEAR_FLOATS};
+#endif
+
+/* END GENERATED NEAREST TABLES */
+
+/*
+ * The colour space conversions promise the same bits from the scalar and
+ * SIMD code, which only holds if the compiler doesn't fuse multiplies and
+ * adds differently in each, as GCC does by default in GNU modes when FMA is
+ * available. These turn fusing off for the code between them.
+ */
+#if defined(__clang__)
+#define CPAR_FP_CONTRACT_OFF _Pragma("STDC FP_CONTRACT OFF")
+#define CPAR_FP_CONTRACT_RESTORE _Pragma("STDC FP_CONTRACT DEFAULT")
+#elif defined(__GNUC__)
+#define CPAR_FP_CONTRACT_OFF                                                   \
+  _Pragma("GCC push_options") _Pragma("GCC optimize(\"fp-contract=off\")")
+#define CPAR_FP_CONTRACT_RESTORE _Pragma("GCC pop_options")
+#else
+#define CPAR_FP_CONTRACT_OFF
+#define CPAR_FP_CONTRACT_RESTORE
+#endif
+
+CPAR_FP_CONTRACT_OFF
+
+/*
+ * The cube root of @a x for x >= 0, to about single precision, from an
+ * estimate made by dividing the exponent by 3 and two Halley iterations.
+ */
+static float cpar_cbrtf(float x)
+{
+  float y;
+  uint32_t i;
+
+  if (x <= 0.0f)
+    return 0.0f;
+  memcpy(&i, &x, sizeof(i));
+  i = i / 3 + 0x2A5137A0u;
+  memcpy(&y, &i, sizeof(y));
+  y = y * (y * y * y + 2.0f * x) / (2.0f * y * y * y + x);
+  y = y * (y * y * y + 2.0f * x) / (2.0f * y * y * y + x);
+  return y;
+}
+
+/* Converts the RGB components of @a value to OKLab. */
+static void cpar_oklab_from_rgb(uint32_t value, float lab[3])
+{
+  float r = cpar_srgb_to_linear_float[CPAR_COLOR_RED(value)];
+  float g = cpar_srgb_to_linear_float[CPAR_COLOR_GREEN(value)];
+  float b = cpar_srgb_to_linear_float[CPAR_COLOR_BLUE(value)];
+  float l = cpar_cbrtf(0.4122214708f * r + 0.5363325363f * g +
+                       0.0514459929f * b);
+  float m = cpar_cbrtf(0.2119034982f * r + 0.6806995451f * g +
+                       0.1073969566f * b);
+  float s = cpar_cbrtf(0.0883024619f * r + 0.2817188376f * g +
+                       0.6299787005f * b);
+
+  lab[0] = 0.2104542553f * l + 0.7936177850f * m - 0.0040720468f * s;
+  lab[1] = 1.9779984951f * l - 2.4285922050f * m + 0.4505937099f * s;
+  lab[2] = 0.0259040371f * l + 0.7827717662f * m - 0.8086757660f * s;
+}
+
+CPAR_FP_CONTRACT_RESTORE
+
+/* The cell of the OKLab grid along axis @a k, clamped to the grid. */
+static unsigned cpar_oklab_cell(const float lab[3], int k)
+{
+  float x = (lab[k] - cpar_oklab_grid_min[k]) * cpar_oklab_grid_scale[k];
+  if (x <= 0.0f)
+    return 0;
+  if (x >= CPAR_NEAREST_GRID - 1)
+    return CPAR_NEAREST_GRID - 1;
+  return (unsigned)x;
+}
+
+/*
+ * Returns the index in the value table of the nearest opaque named colour
+ * to @a value, or CPAR_N_COLOR_VALUES if @a metric is not valid. The
+ * candidates of each cell are in ascending order, so keeping the first of
+ * equally near ones picks the smallest value.
+ */
+static size_t cpar_nearest_index(uint32_t value, enum cpar_metric metric)
+{
+  size_t best = CPAR_N_COLOR_VALUES;
+  size_t i;
+
+  if (metric == CPAR_METRIC_RGB) {
+    int r = CPAR_COLOR_RED(value);
+    int g = CPAR_COLOR_GREEN(value);
+    int b = CPAR_COLOR_BLUE(value);
+    unsigned cell = (unsigned)(r >> 5) << 6 | (unsigned)(g >> 5) << 3 |
+                    (unsigned)(b >> 5);
+    int32_t best_d = INT32_MAX;
+    for (i = cpar_nearest_rgb_offsets[cell];
+         i < cpar_nearest_rgb_offsets[cell + 1];
+         i++) {
+      size_t c = cpar_nearest_rgb_candidates[i];
+      uint32_t v = cpar_color_value_table[c];
+      int32_t dr = r - CPAR_COLOR_RED(v);
+      int32_t dg = g - CPAR_COLOR_GREEN(v);
+      int32_t db = b - CPAR_COLOR_BLUE(v);
+      int32_t d = dr * dr + dg * dg + db * db;
+      if (d < best_d) {
+        best_d = d;
+        best = c;
+      }
+    }
+  } else if (metric == CPAR_METRIC_OKLAB) {
+    float lab[3];
+    unsigned cell;
+    float best_d = 0.0f;
+    cpar_oklab_from_rgb(value, lab);
+    cell = cpar_oklab_cell(lab, 0) << 6 | cpar_oklab_cell(lab, 1) << 3 |
+           cpar_oklab_cell(lab, 2);
+    for (i = cpar_nearest_oklab_offsets[cell];
+         i < cpar_nearest_oklab_offsets[cell + 1];
+         i++) {
+      size_t c = cpar_nearest_oklab_candidates[i];
+      float dl = lab[0] - cpar_color_value_oklab[c][0];
+      float da = lab[1] - cpar_color_value_oklab[c][1];
+      float db = lab[2] - cpar_color_value_oklab[c][2];
+      float d = dl * dl + da * da + db * db;
+      if (best == CPAR_N_COLOR_VALUES || d < best_d) {
+        best_d = d;
+        best = c;
+      }
+    }
+  }
+  return best;
+}
+
+const char *cpar_nearest_color_name(uint32_t value, enum cpar_metric metric)
+{
+  size_t i = cpar_nearest_index(value, metric);
+  if (i == CPAR_N_COLOR_VALUES)
+    return NULL;
+  return cpar_color_names + cpar_color_name_offsets[cpar_color_value_names[i]];
+}
+
+void cpar_nearest_named_colors(const uint32_t *values,
+                               size_t n,
+                               enum cpar_metric metric,
+                               uint32_t *nearest)
+{
+  uint32_t last = 0;
+  uint32_t last_nearest = 0;
+  size_t i;
+
+  if (metric != CPAR_METRIC_RGB && metric != CPAR_METRIC_OKLAB)
+    return;
+  for (i = 0; i < n; i++) {
+    /* the alpha doesn't matter, and the first colour is always searched */
+    uint32_t value = values[i] | 0xFF;
+    if (i == 0 || value != last) {
+      last = value;
+      last_nearest = cpar_color_value_table[cpar_nearest_index(value, metric)];
+    }
+    nearest[i] = last_nearest;
+  }
+}
+
+enum cpar_status cpar_color_parse(const char *color_str, uint32_t *result)
+{
+  if (!color_str)
+    return CPAR_STATUS_INVALID_PARAMETER;
+  return cpar_color_parse_n(color_str, strlen(color_str), result);
+}
+
+/*
+ * Colour name registries. A registry is a single allocation holding the
+ * header below followed by its arrays, laid out like the built-in table: a
+ * block of the folded names, each followed by a NUL, their offsets, their
+ * values, and a perfect hash built the same way as tools/gen_color_tables.py
+ * builds the built-in one. Registries can hold far more names, so the hash
+ * is 64-bit FNV-1a, which makes collisions between different names unlikely
+ * even for millions of them. It's seeded so that a build which fails can be
+ * retried with another seed, and has some spare slots, which keeps the
+ * build quick for many names. Empty slots hold CPAR_NAMES_EMPTY.
+ */
+#define CPAR_NAMES_EMPTY UINT32_MAX
+#define CPAR_NAMES_MAX_DISPLACEMENT (UINT32_C(1) << 20)
+#define CPAR_NAMES_MAX_SEEDS 32
+
+struct cpar_names {
+  uint32_t n_names;
+  uint32_t n_buckets;
+  uint32_t n_slots;
+  uint32_t seed;
+  uint32_t blob_size;
+  uint32_t *displacements;
+  uint32_t *slots;
+  uint32_t *offsets;
+  uint32_t *values;
+  /* The indices of the names ordered by value, then by index. */
+  uint32_t *by_value;
+  char *blob;
+  /* The file the arrays are in, if the registry was loaded from one. */
+  void *file;
+  size_t file_size;
+  int file_mapped;
+};
+
+/* Maps @a x to the range [0, @a n) without a division. */
+static uint32_t cpar_names_reduce(uint32_t x, uint32_t n)
+{
+  return (uint32_t)(((uint64_t)x * n) >> 32);
+}
+
+/* The MurmurHash3 64-bit finalizer. */
+static uint64_t cpar_mix64(uint64_t h)
+{
+  h ^= h >> 33;
+  h *= UINT64_C(0xFF51AFD7ED558CCD);
+  h ^= h >> 33;
+  h *= UINT64_C(0xC4CEB9FE1A85EC53);
+  h ^= h >> 33;
+  return h;
+}
+
+static uint32_t cpar_names_bucket(const struct cpar_names *names, uint64_t h)
+{
+  return (uint32_t)h % names->n_buckets;
+}
+
+static uint32_t
+cpar_names_slot(const struct cpar_names *names, uint64_t h, uint32_t d)
+{
+  return cpar_names_reduce((uint32_t)(cpar_mix64(h ^ d) >> 32),
+                           names->n_slots);
+}
+
+/*
+ * Hashes the name from @a p up to @a end, ignoring whitespace and case, and
+ * stores its folded length in @a len.
+ */
+static uint64_t cpar_names_hash(const struct cpar_names *names,
+                                const char *p,
+                                const char *end,
+                                size_t *len)
+{
+  uint64_t h = UINT64_C(0xCBF29CE484222325) ^ cpar_mix64(names->seed);
+  size_t n = 0;
+
+  for (; p < end; p++) {
+    if (!cpar_is_space(*p)) {
+      h = (h ^ (uint8_t)cpar_to_lower(*p)) * UINT64_C(0x100000001B3);
+      n++;
+    }
+  }
+
+  *len = n;
+  return h;
+}
+
+/*
+ * Looks up the name from @a p up to @a end in a registry, which costs one
+ * hash and one comparison.
+ */
+static int cpar_names_find(const struct cpar_names *names,
+                           const char *p,
+                           const char *end,
+                           uint32_t *result)
+{
+  size_t len = 0;
+  uint64_t h = cpar_names_hash(names, p, end, &len);
+  uint32_t d = names->displacements[cpar_names_bucket(names, h)];
+  uint32_t index = names->slots[cpar_names_slot(names, h, d)];
+  const char *name = NULL;
+  uint32_t start = 0;
+  uint32_t stop = 0;
+
+  // the checks of the offsets only matter for a corrupted image
+  if (index >= names->n_names)
+    return 0;
+  start = names->offsets[index];
+  stop = names->offsets[index + 1];
+  if (stop <= start || stop > names->blob_size || stop - start - 1 != len)
+    return 0;
+
+  name = names->blob + start;
+  for (; p < end; p++) {
+    if (!cpar_is_space(*p) && *name++ != cpar_to_lower(*p))
+      return 0;
+  }
+
+  if (result)
+    *result = names->values[index];
+  return 1;
+}
+
+/*
+ * Gets the folded length of a name for a registry, or zero if it isn't a
+ * name the parser would look up.
+ */
+static size_t cpar_names_check(const char *str, size_t len)
+{
+  const char *p = cpar_skip_space(str, str + len);
+  size_t n = 0;
+
+  if (p == str + len || *p == '#')
+    return 0;
+  for (; p < str + len; p++) {
+    if (*p == '\0' || *p == '(')
+      return 0;
+    n += !cpar_is_space(*p);
+  }
+  return n;
+}
+
+/* Working memory for building the perfect hash of a registry. */
+struct cpar_names_build {
+  uint64_t *hashes;
+  /* The names of bucket b are members[bucket_start[b]...]. */
+  uint32_t *bucket_start;
+  uint32_t *members;
+  /* The buckets, largest first. */
+  uint32_t *order;
+  uint32_t *positions;
+  /* The first name which repeats an earlier one. */
+  uint32_t repeated;
+};
+
+/*
+ * Checks whether the @a size names of a bucket starting at @a first all get
+ * free and distinct slots with the displacement @a d, which are stored in
+ * build->positions.
+ */
+static int cpar_names_fit(const struct cpar_names *names,
+                          struct cpar_names_build *build,
+                          uint32_t first,
+                          uint32_t size,
+                          uint32_t d)
+{
+  for (uint32_t i = 0; i < size; i++) {
+    uint32_t slot =
+        cpar_names_slot(names, build->hashes[build->members[first + i]], d);
+    if (names->slots[slot] != CPAR_NAMES_EMPTY)
+      return 0;
+    for (uint32_t j = 0; j < i; j++) {
+      if (build->positions[j] == slot)
+        return 0;
+    }
+    build->positions[i] = slot;
+  }
+  return 1;
+}
+
+/*
+ * Tries to build the perfect hash with the registry's seed. Returns
+ * CPAR_STATUS_OK, CPAR_STATUS_DUPLICATE_NAME with build->repeated set, or
+ * CPAR_STATUS_NO_PERFECT_HASH if another seed should be tried.
+ */
+static enum cpar_status cpar_names_place(struct cpar_names *names,
+                                         struct cpar_names_build *build)
+{
+  uint32_t n_names = names->n_names;
+  uint32_t n_buckets = names->n_buckets;
+  uint32_t max_size = 0;
+  uint32_t i = 0;
+  uint32_t j = 0;
+  uint32_t k = 0;
+  int collided = 0;
+
+  for (i = 0; i <= n_buckets; i++)
+    build->bucket_start[i] = 0;
+  for (i = 0; i < n_names; i++) {
+    const char *name = names->blob + names->offsets[i];
+    size_t len = 0;
+    build->hashes[i] = cpar_names_hash(
+        names, name, name + strlen(name), &len);
+    build->bucket_start[cpar_names_bucket(names, build->hashes[i]) + 1]++;
+  }
+  for (i = 0; i < n_buckets; i++) {
+    if (build->bucket_start[i + 1] > max_size)
+      max_size = build->bucket_start[i + 1];
+    build->bucket_start[i + 1] += build->bucket_start[i];
+  }
+
+  // positions is free for now, so it counts the members placed so far
+  for (i = 0; i < n_buckets; i++)
+    build->positions[i] = build->bucket_start[i];
+  for (i = 0; i < n_names; i++) {
+    uint32_t b = cpar_names_bucket(names, build->hashes[i]);
+    build->members[build->positions[b]++] = i;
+  }
+
+  // the same hash twice is either a repeated name or needs another seed,
+  // and the members of a bucket are in order so a is the later name
+  build->repeated = n_names;
+  for (i = 0; i < n_buckets; i++) {
+    for (j = build->bucket_start[i]; j < build->bucket_start[i + 1]; j++) {
+      for (k = build->bucket_start[i]; k < j; k++) {
+        uint32_t a = build->members[j];
+        uint32_t b = build->members[k];
+        if (build->hashes[a] != build->hashes[b])
+          continue;
+        if (strcmp(names->blob + names->offsets[a],
+                   names->blob + names->offsets[b]) != 0)
+          collided = 1;
+        else if (a < build->repeated)
+          build->repeated = a;
+      }
+    }
+  }
+  if (build->repeated < n_names)
+    return CPAR_STATUS_DUPLICATE_NAME;
+  if (collided)
+    return CPAR_STATUS_NO_PERFECT_HASH;
+
+  // order the buckets by size, largest first, with a counting sort
+  for (i = 0; i <= max_size; i++)
+    build->positions[i] = 0;
+  for (i = 0; i < n_buckets; i++)
+    build->positions[build->bucket_start[i + 1] - build->bucket_start[i]]++;
+  for (i = max_size + 1, k = 0; i-- > 0;) {
+    uint32_t count = build->positions[i];
+    build->positions[i] = k;
+    k += count;
+  }
+  for (i = 0; i < n_buckets; i++) {
+    uint32_t size = build->bucket_start[i + 1] - build->bucket_start[i];
+    build->order[build->positions[size]++] = i;
+  }
+
+  for (i = 0; i < n_buckets; i++)
+    names->displacements[i] = 0;
+  for (i = 0; i < names->n_slots; i++)
+    names->slots[i] = CPAR_NAMES_EMPTY;
+
+  for (i = 0; i < n_buckets; i++) {
+    uint32_t b = build->order[i];
+    uint32_t first = build->bucket_start[b];
+    uint32_t size = build->bucket_start[b + 1] - first;
+    uint32_t d = 0;
+
+    if (size == 0)
+      break; // the rest are empty too
+
+    while (d < CPAR_NAMES_MAX_DISPLACEMENT &&
+           !cpar_names_fit(names, build, first, size, d))
+      d++;
+    if (d == CPAR_NAMES_MAX_DISPLACEMENT)
+      return CPAR_STATUS_NO_PERFECT_HASH;
+
+    names->displacements[b] = d;
+    for (j = 0; j < size; j++)
+      names->slots[build->positions[j]] = build->members[first + j];
+  }
+
+  return CPAR_STATUS_OK;
+}
+
+static int cpar_names_compare(const void *a, const void *b)
+{
+  uint64_t x = *(const uint64_t *)a;
+  uint64_t y = *(const uint64_t *)b;
+  return (x > y) - (x < y);
+}
+
+enum cpar_status cpar_names_new(const struct cpar_string *strs,
+                                const uint32_t *values,
+                                size_t n_strs,
+                                struct cpar_names **names,
+                                size_t *repeated)
+{
+  struct cpar_names *table = NULL;
+  struct cpar_names_build build;
+  enum cpar_status status = CPAR_STATUS_NO_PERFECT_HASH;
+  size_t blob_size = 0;
+  size_t n_buckets = n_strs / 4 + 1;
+  size_t n_slots = n_strs + n_strs / 8 + 1;
+  size_t n_work = 4 * n_strs + 2 * n_buckets + 2;
+  void *work = NULL;
+  uint64_t *keys = NULL;
+  char *name = NULL;
+
+  if (!names)
+    return CPAR_STATUS_INVALID_PARAMETER;
+  *names = NULL;
+  if ((n_strs > 0 && (!strs || !values)) || n_strs >= CPAR_NAMES_MAX)
+    return CPAR_STATUS_INVALID_PARAMETER;
+
+  for (size_t i = 0; i < n_strs; i++) {
+    size_t len = strs[i].str ? cpar_names_check(strs[i].str, strs[i].len) : 0;
+    if (len == 0)
+      return CPAR_STATUS_INVALID_PARAMETER;
+    blob_size += len + 1;
+  }
+  if (blob_size > UINT32_MAX)
+    return CPAR_STATUS_INVALID_PARAMETER;
+
+  table = (struct cpar_names *)CPAR_MALLOC(
+      sizeof(struct cpar_names) +
+      sizeof(uint32_t) * (n_buckets + n_slots + 3 * n_strs + 1) + blob_size);
+  // the same memory holds the keys for sorting by value afterwards
+  work = CPAR_MALLOC(sizeof(uint32_t) * n_work);
+  if (!table || !work) {
+    CPAR_FREE(table);
+    CPAR_FREE(work);
+    return CPAR_STATUS_NO_MEMORY;
+  }
+
+  table->n_names = (uint32_t)n_strs;
+  table->n_buckets = (uint32_t)n_buckets;
+  table->n_slots = (uint32_t)n_slots;
+  table->blob_size = (uint32_t)blob_size;
+  table->file = NULL;
+  table->file_size = 0;
+  table->file_mapped = 0;
+  table->displacements = (uint32_t *)(table + 1);
+  table->slots = table->displacements + n_buckets;
+  table->offsets = table->slots + n_slots;
+  table->values = table->offsets + n_strs + 1;
+  table->by_value = table->values + n_strs;
+  table->blob = (char *)(table->by_value + n_strs);
+
+  name = table->blob;
+  for (size_t i = 0; i < n_strs; i++) {
+    table->offsets[i] = (uint32_t)(name - table->blob);
+    table->values[i] = values[i];
+    for (size_t j = 0; j < strs[i].len; j++) {
+      if (!cpar_is_space(strs[i].str[j]))
+        *name++ = cpar_to_lower(strs[i].str[j]);
+    }
+    *name++ = '\0';
+  }
+  table->offsets[n_strs] = (uint32_t)(name - table->blob);
+
+  build.hashes = (uint64_t *)work;
+  build.bucket_start = (uint32_t *)(build.hashes + n_strs);
+  build.members = build.bucket_start + n_buckets + 1;
+  build.order = build.members + n_strs;
+  build.positions = build.order + n_buckets;
+
+  for (uint32_t seed = 0;
+       seed < CPAR_NAMES_MAX_SEEDS && status == CPAR_STATUS_NO_PERFECT_HASH;
+       seed++) {
+    table->seed = seed;
+    status = cpar_names_place(table, &build);
+  }
+  if (status != CPAR_STATUS_OK) {
+    if (status == CPAR_STATUS_DUPLICATE_NAME && repeated)
+      *repeated = build.repeated;
+    CPAR_FREE(table);
+    CPAR_FREE(work);
+    return status;
+  }
+
+  keys = (uint64_t *)work;
+  for (size_t i = 0; i < n_strs; i++)
+    keys[i] = (uint64_t)table->values[i] << 32 | i;
+  qsort(keys, n_strs, sizeof(keys[0]), cpar_names_compare);
+  for (size_t i = 0; i < n_strs; i++)
+    table->by_value[i] = (uint32_t)keys[i];
+
+  CPAR_FREE(work);
+  *names = table;
+  return CPAR_STATUS_OK;
+}
+
+uint32_t cpar_names_count(const struct cpar_names *names)
+{
+  return names ? names->n_names : 0;
+}
+
+/*
+ * The value of the @a i th name in order of value. The order could be out
+ * of range in a corrupted image, which gives a value that sorts last.
+ */
+static uint32_t cpar_names_value_at(const struct cpar_names *names, size_t i)
+{
+  uint32_t index = names->by_value[i];
+  return index < names->n_names ? names->values[index] : UINT32_MAX;
+}
+
+const char *cpar_names_lookup(const struct cpar_names *names, uint32_t value)
+{
+  size_t lo = 0;
+  size_t hi = names ? names->n_names : 0;
+
+  while (lo < hi) {
+    size_t mid = lo + (hi - lo) / 2;
+    if (cpar_names_value_at(names, mid) < value)
+      lo = mid + 1;
+    else
+      hi = mid;
+  }
+
+  // the checks only matter for a corrupted image, see cpar_names_value_at()
+  if (names && lo < names->n_names && names->by_value[lo] < names->n_names &&
+      cpar_names_value_at(names, lo) == value) {
+    uint32_t offset = names->offsets[names->by_value[lo]];
+    if (offset < names->blob_size)
+      return names->blob + offset;
+  }
+  return cpar_lookup_color_name(value);
+}
+
+/*
+ * The binary images of registries. The header is followed by the arrays in
+ * the same order as a registry built by cpar_names_new() has them, so both
+ * writing and loading an image are a matter of pointing at them. A change
+ * to the header, the arrays or the hash needs a new version.
+ */
+#define CPAR_NAMES_MAGIC "cparname"
+#define CPAR_NAMES_BYTE_ORDER UINT32_C(0x01020304)
+
+struct cpar_names_header {
+  char magic[8];
+  uint32_t version;
+  uint32_t byte_order;
+  uint32_t n_names;
+  uint32_t n_buckets;
+  uint32_t n_slots;
+  uint32_t seed;
+  uint32_t blob_size;
+  uint32_t reserved;
+  uint64_t image_size;
+};
+
+/* The number of uint32_t in the arrays of a registry, before the blob. */
+static size_t cpar_names_n_words(uint32_t n_names,
+                                 uint32_t n_buckets,
+                                 uint32_t n_slots)
+{
+  return (size_t)n_buckets + n_slots + 3 * (size_t)n_names + 1;
+}
+
+size_t cpar_names_serialize(const struct cpar_names *names,
+                            void *buffer,
+                            size_t buffer_size)
+{
+  struct cpar_names_header header;
+  size_t n_words = 0;
+  size_t size = 0;
+  unsigned char *out = (unsigned char *)buffer;
+
+  if (!names)
+    return 0;
+
+  n_words = cpar_names_n_words(names->n_names, names->n_buckets,
+                               names->n_slots);
+  size = sizeof(header) + sizeof(uint32_t) * n_words + names->blob_size;
+  if (!buffer || buffer_size < size)
+    return size;
+
+  memset(&header, 0, sizeof(header));
+  memcpy(header.magic, CPAR_NAMES_MAGIC, sizeof(header.magic));
+  header.version = CPAR_NAMES_IMAGE_VERSION;
+  header.byte_order = CPAR_NAMES_BYTE_ORDER;
+  header.n_names = names->n_names;
+  header.n_buckets = names->n_buckets;
+  header.n_slots = names->n_slots;
+  header.seed = names->seed;
+  header.blob_size = names->blob_size;
+  header.image_size = size;
+
+  // the arrays of a loaded registry are contiguous too
+  memcpy(out, &header, sizeof(header));
+  out += sizeof(header);
+  memcpy(out, names->displacements, sizeof(uint32_t) * n_words);
+  out += sizeof(uint32_t) * n_words;
+  if (names->blob_size > 0)
+    memcpy(out, names->blob, names->blob_size);
+  return size;
+}
+
+enum cpar_status cpar_names_from_image(const void *image,
+                                       size_t image_size,
+                                       struct cpar_names **names)
+{
+  struct cpar_names_header header;
+  struct cpar_names *table = NULL;
+  const unsigned char *p = (const unsigned char *)image;
+  size_t n_words = 0;
+
+  if (!names)
+    return CPAR_STATUS_INVALID_PARAMETER;
+  *names = NULL;
+  if (!image || image_size < sizeof(header) ||
+      (uintptr_t)image % sizeof(uint32_t) != 0)
+    return CPAR_STATUS_INVALID_PARAMETER;
+
+  memcpy(&header, image, sizeof(header));
+  if (memcmp(header.magic, CPAR_NAMES_MAGIC, sizeof(header.magic)) != 0 ||
+      header.version != CPAR_NAMES_IMAGE_VERSION ||
+      header.byte_order != CPAR_NAMES_BYTE_ORDER ||
+      header.n_names >= CPAR_NAMES_MAX ||
+      header.n_buckets != header.n_names / 4 + 1 ||
+      header.n_slots != header.n_names + header.n_names / 8 + 1 ||
+      header.image_size != image_size)
+    return CPAR_STATUS_INVALID_PARAMETER;
+
+  // each name is at least one character and a NUL, and the last ends there
+  n_words =
+      cpar_names_n_words(header.n_names, header.n_buckets, header.n_slots);
+  if (header.blob_size < 2 * (size_t)header.n_names ||
+      image_size != sizeof(header) + sizeof(uint32_t) * n_words +
+                        header.blob_size ||
+      (header.blob_size > 0 && p[image_size - 1] != '\0'))
+    return CPAR_STATUS_INVALID_PARAMETER;
+
+  table = (struct cpar_names *)CPAR_MALLOC(sizeof(struct cpar_names));
+  if (!table)
+    return CPAR_STATUS_NO_MEMORY;
+
+  table->n_names = header.n_names;
+  table->n_buckets = header.n_buckets;
+  table->n_slots = header.n_slots;
+  table->seed = header.seed;
+  table->blob_size = header.blob_size;
+  table->displacements = (uint32_t *)(p + sizeof(header));
+  table->slots = table->displacements + table->n_buckets;
+  table->offsets = table->slots + table->n_slots;
+  table->values = table->offsets + table->n_names + 1;
+  table->by_value = table->values + table->n_names;
+  table->blob = (char *)(table->by_value + table->n_names);
+  table->file = NULL;
+  table->file_size = 0;
+  table->file_mapped = 0;
+  *names = table;
+  return CPAR_STATUS_OK;
+}
+
+/*
+ * Reads or maps the whole of the file at @a path into memory, returning
+ * NULL on failure. *mapped says which, for cpar_names_free_file().
+ */
+static void *cpar_names_read_file(const char *path, size_t *size, int *mapped)
+{
+#ifdef CPAR_HAVE_MMAP
+  struct stat st;
+  void *data = NULL;
+  int fd = open(path, O_RDONLY);
+
+  if (fd < 0)
+    return NULL;
+  if (fstat(fd, &st) != 0 || st.st_size <= 0 ||
+      (uint64_t)st.st_size > SIZE_MAX) {
+    close(fd);
+    return NULL;
+  }
+  data = mmap(NULL, (size_t)st.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+  close(fd);
+  if (data == MAP_FAILED)
+    return NULL;
+  *size = (size_t)st.st_size;
+  *mapped = 1;
+  return data;
+#else
+  FILE *fp = fopen(path, "rb");
+  unsigned char *data = NULL;
+  long len = 0;
+
+  if (!fp)
+    return NULL;
+  if (fseek(fp, 0, SEEK_END) != 0 || (len = ftell(fp)) <= 0 ||
+      fseek(fp, 0, SEEK_SET) != 0 ||
+      !(data = (unsigned char *)CPAR_MALLOC((size_t)len)) ||
+      fread(data, 1, (size_t)len, fp) != (size_t)len) {
+    CPAR_FREE(data);
+    fclose(fp);
+    return NULL;
+  }
+  fclose(fp);
+  *size = (size_t)len;
+  *mapped = 0;
+  return data;
+#endif
+}
+
+static void cpar_names_free_file(void *data, size_t size, int mapped)
+{
+#ifdef CPAR_HAVE_MMAP
+  if (mapped) {
+    munmap(data, size);
+    return;
+  }
+#endif
+  (void)size;
+  (void)mapped;
+  CPAR_FREE(data);
+}
+
+enum cpar_status cpar_names_map(const char *path, struct cpar_names **names)
+{
+  void *data = NULL;
+  size_t size = 0;
+  int mapped = 0;
+  enum cpar_status status = CPAR_STATUS_OK;
+
+  if (!names)
+    return CPAR_STATUS_INVALID_PARAMETER;
+  *names = NULL;
+  if (!path)
+    return CPAR_STATUS_INVALID_PARAMETER;
+
+  if (!(data = cpar_names_read_file(path, &size, &mapped)))
+    return CPAR_STATUS_IO_ERROR;
+  if ((status = cpar_names_from_image(data, size, names)) != CPAR_STATUS_OK) {
+    cpar_names_free_file(data, size, mapped);
+    return status;
+  }
+
+  (*names)->file = data;
+  (*names)->file_size = size;
+  (*names)->file_mapped = mapped;
+  return CPAR_STATUS_OK;
+}
+
+void cpar_names_free(struct cpar_names *names)
+{
+  if (!names)
+    return;
+  if (names->file)
+    cpar_names_free_file(names->file, names->file_size, names->file_mapped);
+  CPAR_FREE(names);
+}
+
+/*
+ * Parse statistics. The first threads to parse each get their own copy of
+ * the counters, which only they write, so they can be updated without any
+ * locked instructions. Later threads share the last copy and use atomic
+ * adds. Without CPAR_ENABLE_STATS the hooks expand to nothing.
+ */
+#ifdef CPAR_ENABLE_STATS
+
+#if defined(__cplusplus)
+#define CPAR_THREAD_LOCAL thread_local
+#elif defined(__STDC_VERSION__) && __STDC_VERSION__ >= 201112L
+#define CPAR_THREAD_LOCAL _Thread_local
+#else
+#define CPAR_THREAD_LOCAL __thread
+#endif
+
+#define CPAR_STATS_SHARDS 64
+
+struct cpar_stats_shard {
+  struct cpar_stats stats;
+} __attribute__((aligned(64)));
+
+static struct cpar_stats_shard cpar_stats_shards[CPAR_STATS_SHARDS];
+static unsigned cpar_stats_next_shard;
+static CPAR_THREAD_LOCAL struct cpar_stats *cpar_stats_shard;
+static CPAR_THREAD_LOCAL int cpar_stats_shared;
+
+static struct cpar_stats *cpar_stats_get(void)
+{
+  if (!cpar_stats_shard) {
+    unsigned i =
+        __atomic_fetch_add(&cpar_stats_next_shard, 1, __ATOMIC_RELAXED);
+    if (i >= CPAR_STATS_SHARDS - 1) {
+      i = CPAR_STATS_SHARDS - 1;
+      cpar_stats_shared = 1;
+    }
+    cpar_stats_shard = &cpar_stats_shards[i].stats;
+  }
+  return cpar_stats_shard;
+}
+
+static void cpar_stats_add(uint64_t *counter)
+{
+  if (cpar_stats_shared) {
+    __atomic_fetch_add(counter, 1, __ATOMIC_RELAXED);
+  } else {
+    __atomic_store_n(
+        counter, __atomic_load_n(counter, __ATOMIC_RELAXED) + 1,
+        __ATOMIC_RELAXED);
+  }
+}
+
+#define CPAR_STATS_SYNTAX(s) cpar_stats_add(&cpar_stats_get()->syntax[(s)])
+
+// adds the counters to the sums, or sets them to zero
+static void
+cpar_stats_sum(uint64_t *sum, uint64_t *counters, size_t n, int reset)
+{
+  for (size_t i = 0; i < n; i++) {
+    if (reset)
+      __atomic_store_n(&counters[i], 0, __ATOMIC_RELAXED);
+    else
+      sum[i] += __atomic_load_n(&counters[i], __ATOMIC_RELAXED);
+  }
+}
+
+#if defined(CPAR_ENABLE_STATS_CYCLES) && \
+    (defined(__x86_64__) || defined(__i386__))
+#include <x86intrin.h>
+#define CPAR_STATS_TICKS() ((uint64_t)__rdtsc())
+#elif defined(CPAR_ENABLE_STATS_CYCLES) && defined(__aarch64__)
+static uint64_t cpar_stats_ticks(void)
+{
+  uint64_t ticks;
+  __asm__ __volatile__("mrs %0, cntvct_el0" : "=r"(ticks));
+  return ticks;
+}
+#define CPAR_STATS_TICKS() cpar_stats_ticks()
+#endif
+
+#else
+#define CPAR_STATS_SYNTAX(s) ((void)0)
+#endif // CPAR_ENABLE_STATS
+
+static int cpar_stats_collect(struct cpar_stats *stats, int reset)
+{
+#ifdef CPAR_ENABLE_STATS
+  for (size_t i = 0; i < CPAR_STATS_SHARDS; i++) {
+    struct cpar_stats *shard = &cpar_stats_shards[i].stats;
+    cpar_stats_sum(&stats->calls, &shard->calls, 1, reset);
+    cpar_stats_sum(stats->syntax, shard->syntax, CPAR_SYNTAX_COUNT, reset);
+    cpar_stats_sum(stats->status, shard->status, CPAR_STATUS_COUNT, reset);
+    cpar_stats_sum(
+        stats->cycles, shard->cycles, CPAR_STATS_CYCLE_BUCKETS, reset);
+  }
+  return 1;
+#else
+  (void)stats;
+  (void)reset;
+  return 0;
+#endif
+}
+
+int cpar_stats_snapshot(struct cpar_stats *stats)
+{
+  if (!stats)
+    return 0;
+  memset(stats, 0, sizeof(*stats));
+  return cpar_stats_collect(stats, 0);
+}
+
+void cpar_stats_reset(void)
+{
+  struct cpar_stats unused;
+  cpar_stats_collect(&unused, 1);
+}
+
+/*
+ * Everything is done in one forward pass over the string, skipping
+ * whitespace and folding case along the way, so there is no working copy
+ * and no limit on the length. The first character picks the syntax, so hex
+ * colours and most names never look at the colour functions.
+ */
+static enum cpar_status cpar_parse_n(const struct cpar_names *names,
+                                     const char *color_str,
+                                     size_t color_str_len,
+                                     uint32_t *result)
+{
+  const char *p = color_str;
+  const char *end = NULL;
+  enum cpar_function func = CPAR_FUNCTION_RGB;
+  int n_comp = 0;
+  int n_found = 0;
+  struct cpar_span comp[4];
+
+  if (!color_str || color_str_len == 0)
+    return CPAR_STATUS_INVALID_PARAMETER;
+
+  // hex colours without any whitespace can be decoded directly
+  if (color_str[0] == '#' &&
+      cpar_hex_decode(color_str + 1, color_str_len - 1, result) ==
+          CPAR_STATUS_OK) {
+    CPAR_STATS_SYNTAX(CPAR_SYNTAX_HEX);
+    return CPAR_STATUS_OK;
+  }
+
+  if (memchr(color_str, '\0', color_str_len))
+    return CPAR_STATUS_SYNTAX_ERROR;
+
+  end = color_str + color_str_len;
+  p = cpar_skip_space(p, end);
+  while (end > p && cpar_is_space(end[-1]))
+    end--;
+
+  switch (p < end ? cpar_to_lower(*p) : '\0') {
+    // parse html colors like #fff, #ffffff, #ffffffff
+    case '#':
+      CPAR_STATS_SYNTAX(CPAR_SYNTAX_HEX);
+      return cpar_hex_decode_spaced(p + 1, end, result);
+
+    // parse rgb(1,2,3), rgba(1,2,50%,0.1) and rgb(1 2 3 / 10%) colours
+    case 'r':
+      if (cpar_match_word(&p, end, "rgb("))
+        n_comp = 3;
+      else if (cpar_match_word(&p, end, "rgba("))
+        n_comp = 4;
+      break;
+
+    // parse hsl(), hsla() and hwb() colours
+    case 'h':
+      func = CPAR_FUNCTION_HSL;
+      if (cpar_match_word(&p, end, "hsl("))
+        n_comp = 3;
+      else if (cpar_match_word(&p, end, "hsla("))
+        n_comp = 4;
+      else if (cpar_match_word(&p, end, "hwb(")) {
+        func = CPAR_FUNCTION_HWB;
+        n_comp = 3;
+      }
+      break;
+  }
+
+  // parse as colour name as a last resort, trying the registry first
+  if (n_comp == 0) {
+    CPAR_STATS_SYNTAX(CPAR_SYNTAX_NAME);
+    if (names && cpar_names_find(names, p, end, result))
+      return CPAR_STATUS_OK;
+    return cpar_color_from_name(p, end, result);
+  }
+
+  // the cpar_syntax values are in the same order as the functions
+  CPAR_STATS_SYNTAX(CPAR_SYNTAX_RGB + 2 * func + (n_comp == 4));
+
+  if (p == end || end[-1] != ')')
+    return CPAR_STATUS_SYNTAX_ERROR;
+  end--;
+
+  // commas mean the legacy syntax, which hwb() doesn't have
+  if (memchr(p, ',', (size_t)(end - p))) {
+    if (func == CPAR_FUNCTION_HWB)
+      return CPAR_STATUS_SYNTAX_ERROR;
+    n_found = cpar_split_comma(p, end, n_comp, comp);
+  } else if ((n_found = n_comp = cpar_split_space(p, end, comp)) == 0) {
+    return CPAR_STATUS_SYNTAX_ERROR;
+  }
+
+  return cpar_parse_function(func, comp, n_found, n_comp, result);
+}
+
+/* Parses and updates the statistics, if enabled. */
+static enum cpar_status cpar_parse_counted(const struct cpar_names *names,
+                                           const char *color_str,
+                                           size_t color_str_len,
+                                           uint32_t *result)
+{
+#ifdef CPAR_ENABLE_STATS
+  struct cpar_stats *stats = cpar_stats_get();
+  enum cpar_status status = CPAR_STATUS_OK;
+#ifdef CPAR_STATS_TICKS
+  uint64_t start = CPAR_STATS_TICKS();
+  uint64_t ticks = 0;
+  int bucket = 0;
+#endif
+
+  status = cpar_parse_n(names, color_str, color_str_len, result);
+
+#ifdef CPAR_STATS_TICKS
+  ticks = CPAR_STATS_TICKS() - start;
+  bucket = ticks ? 63 - __builtin_clzll(ticks) : 0;
+  if (bucket >= CPAR_STATS_CYCLE_BUCKETS)
+    bucket = CPAR_STATS_CYCLE_BUCKETS - 1;
+  cpar_stats_add(&stats->cycles[bucket]);
+#endif
+  cpar_stats_add(&stats->calls);
+  cpar_stats_add(&stats->status[status]);
+  return status;
+#else
+  return cpar_parse_n(names, color_str, color_str_len, result);
+#endif
+}
+
+enum cpar_status cpar_color_parse_n(const char *color_str,
+                                    size_t color_str_len,
+                                    uint32_t *result)
+{
+  return cpar_parse_counted(NULL, color_str, color_str_len, result);
+}
+
+enum cpar_status cpar_names_parse(const struct cpar_names *names,
+                                  const char *color_str,
+                                  size_t color_str_len,
+                                  uint32_t *result)
+{
+  return cpar_parse_counted(names, color_str, color_str_len, result);
+}
+
+size_t cpar_color_parse_batch(const struct cpar_string *strs,
+                              size_t n_strs,
+                              uint32_t *results,
+                              enum cpar_status *statuses)
+{
+  size_t n_ok = 0;
+
+  if (!strs)
+    return 0;
+
+  for (size_t i = 0; i < n_strs; i++) {
+    enum cpar_status status = cpar_color_parse_n(
+        strs[i].str, strs[i].len, results ? &results[i] : NULL);
+    if (statuses)
+      statuses[i] = status;
+    if (status == CPAR_STATUS_OK)
+      n_ok++;
+  }
+
+  return n_ok;
+}
+
+struct cpar_parallel_batch {
+  const struct cpar_string *strs;
+  size_t n_strs;
+  uint32_t *results;
+  enum cpar_status *statuses;
+  size_t chunk;
+  size_t n_ok[CPAR_PARALLEL_MAX_TASKS];
+};
+
+static void cpar_parse_batch_task(void *arg, size_t index)
+{
+  struct cpar_parallel_batch *batch = (struct cpar_parallel_batch *)arg;
+  size_t start = index * batch->chunk;
+  size_t n = batch->n_strs - start;
+
+  if (n > batch->chunk)
+    n = batch->chunk;
+  batch->n_ok[index] = cpar_color_parse_batch(
+      batch->strs + start,
+      n,
+      batch->results ? batch->results + start : NULL,
+      batch->statuses ? batch->statuses + start : NULL);
+}
+
+size_t cpar_color_parse_batch_parallel(const struct cpar_string *strs,
+                                       size_t n_strs,
+                                       uint32_t *results,
+                                       enum cpar_status *statuses,
+                                       const struct cpar_executor *executor)
+{
+  struct cpar_parallel_batch batch;
+  size_t n_tasks = 0;
+  size_t n_ok = 0;
+
+  if (!strs)
+    return 0;
+  if (!executor || !executor->run || n_strs <= CPAR_PARALLEL_CHUNK)
+    return cpar_color_parse_batch(strs, n_strs, results, statuses);
+
+  /*
+   * Chunks are a multiple of 16 strings, which is 64 bytes of results, so
+   * tasks only write to the same cache line of the outputs where two chunks
+   * meet, and not at all if the outputs are 64-byte aligned.
+   */
+  batch.chunk = (n_strs + CPAR_PARALLEL_MAX_TASKS - 1) /
+                CPAR_PARALLEL_MAX_TASKS;
+  if (batch.chunk < CPAR_PARALLEL_CHUNK)
+    batch.chunk = CPAR_PARALLEL_CHUNK;
+  batch.chunk = (batch.chunk + 15) & ~(size_t)15;
+  n_tasks = (n_strs + batch.chunk - 1) / batch.chunk;
+
+  batch.strs = strs;
+  batch.n_strs = n_strs;
+  batch.results = results;
+  batch.statuses = statuses;
+  executor->run(executor->user_data, cpar_parse_batch_task, &batch, n_tasks);
+
+  for (size_t i = 0; i < n_tasks; i++)
+    n_ok += batch.n_ok[i];
+  return n_ok;
+}
+
+/* The number of slots checked for a string before giving up. */
+#define CPAR_CACHE_PROBES 4
+
+/* The alignment of the entries, so that each one is a single cache line. */
+#define CPAR_CACHE_LINE 64
+
+/*
+ * Sized so that each entry fills a 64-byte cache line. An entry with a
+ * zero length is empty.
+ */
+struct cpar_cache_entry {
+  uint32_t hash;
+  uint32_t value;
+  uint8_t len;
+  uint8_t status;
+  char key[CPAR_CACHE_KEY_MAX];
+};
+
+struct cpar_cache {
+  size_t mask;
+  struct cpar_cache_stats stats;
+  struct cpar_cache_entry *entries;
+};
+
+struct cpar_cache *cpar_cache_new(size_t n_entries)
+{
+  size_t n = CPAR_CACHE_PROBES;
+  struct cpar_cache *cache = NULL;
+
+  while (n < n_entries && n <= (SIZE_MAX >> 1))
+    n <<= 1;
+  if (n > (SIZE_MAX - sizeof(*cache) - (CPAR_CACHE_LINE - 1)) /
+              sizeof(struct cpar_cache_entry))
+    return NULL;
+
+  cache = (struct cpar_cache *)CPAR_MALLOC(sizeof(*cache) +
+                                           (CPAR_CACHE_LINE - 1) +
+                                           n * sizeof(struct cpar_cache_entry));
+  if (!cache)
+    return NULL;
+
+  // the entries follow the header in the same allocation, rounded up to
+  // the next cache line since CPAR_MALLOC() only promises max_align_t
+  cache->mask = n - 1;
+  cache->entries = (struct cpar_cache_entry *)(
+      ((uintptr_t)(cache + 1) + (CPAR_CACHE_LINE - 1)) &
+      ~(uintptr_t)(CPAR_CACHE_LINE - 1));
+  cpar_cache_clear(cache);
+  return cache;
+}
+
+void cpar_cache_free(struct cpar_cache *cache) { CPAR_FREE(cache); }
+
+void cpar_cache_clear(struct cpar_cache *cache)
+{
+  if (!cache)
+    return;
+  memset(&cache->stats, 0, sizeof(cache->stats));
+  for (size_t i = 0; i <= cache->mask; i++)
+    cache->entries[i].len = 0;
+}
+
+enum cpar_status cpar_cache_parse(struct cpar_cache *cache,
+                                  const char *color_str,
+                                  size_t color_str_len,
+                                  uint32_t *result)
+{
+  uint32_t h = CPAR_HASH_INIT;
+  uint32_t value = 0;
+  struct cpar_cache_entry *victim = NULL;
+  enum cpar_status status = CPAR_STATUS_OK;
+
+  if (!cache)
+    return CPAR_STATUS_INVALID_PARAMETER;
+
+  if (!color_str || color_str_len == 0 ||
+      color_str_len > CPAR_CACHE_KEY_MAX) {
+    cache->stats.misses++;
+    return cpar_color_parse_n(color_str, color_str_len, result);
+  }
+
+  for (size_t i = 0; i < color_str_len; i++)
+    h = cpar_hash_byte(h, (uint8_t)color_str[i]);
+
+  for (size_t probe = 0; probe < CPAR_CACHE_PROBES; probe++) {
+    struct cpar_cache_entry *entry =
+        &cache->entries[(h + probe) & cache->mask];
+    if (entry->len == 0) {
+      victim = entry;
+      break;
+    } else if (entry->hash == h && entry->len == color_str_len &&
+               memcmp(entry->key, color_str, color_str_len) == 0) {
+      cache->stats.hits++;
+      if (entry->status == CPAR_STATUS_OK && result)
+        *result = entry->value;
+      return (enum cpar_status)entry->status;
+    }
+  }
+
+  // all of the probed slots are in use, so replace the first one
+  if (!victim)
+    victim = &cache->entries[h & cache->mask];
+
+  cache->stats.misses++;
+  status = cpar_color_parse_n(color_str, color_str_len, &value);
+
+  victim->hash = h;
+  victim->value = value;
+  victim->len = (uint8_t)color_str_len;
+  victim->status = (uint8_t)status;
+  memcpy(victim->key, color_str, color_str_len);
+
+  if (status == CPAR_STATUS_OK && result)
+    *result = value;
+  return status;
+}
+
+void cpar_cache_get_stats(const struct cpar_cache *cache,
+                          struct cpar_cache_stats *stats)
+{
+  if (cache && stats)
+    *stats = cache->stats;
+}
+
+/* The usual size of the arena blocks. */
+#define CPAR_ARENA_BLOCK_SIZE 4096
+
+/* The block's data follows the header in the same allocation. */
+struct cpar_arena_block {
+  struct cpar_arena_block *next;
+};
+
+void cpar_arena_init(struct cpar_arena *arena,
+                     void *buffer,
+                     size_t buffer_size)
+{
+  if (!arena)
+    return;
+  arena->buffer = (unsigned char *)buffer;
+  arena->buffer_size = buffer ? buffer_size : 0;
+  arena->next = arena->buffer;
+  arena->end = arena->buffer + arena->buffer_size;
+  arena->blocks = NULL;
+}
+
+void *cpar_arena_alloc(struct cpar_arena *arena, size_t size, size_t align)
+{
+  struct cpar_arena_block *block = NULL;
+  size_t room = 0;
+  size_t pad = 0;
+  size_t block_size = 0;
+  unsigned char *data = NULL;
+  unsigned char *block_end = NULL;
+
+  if (!arena || align == 0 || (align & (align - 1)) != 0)
+    return NULL;
+
+  if (arena->next) {
+    room = (size_t)(arena->end - arena->next);
+    pad = (size_t)(0 - (uintptr_t)arena->next) & (align - 1);
+    if (room >= pad && room - pad >= size) {
+      data = arena->next + pad;
+      arena->next = data + size;
+      return data;
+    }
+  }
+
+  if (size > SIZE_MAX - sizeof(*block) - align)
+    return NULL;
+  block_size = size + align - 1 > CPAR_ARENA_BLOCK_SIZE ? size + align - 1
+                                                        : CPAR_ARENA_BLOCK_SIZE;
+  block = (struct cpar_arena_block *)CPAR_MALLOC(sizeof(*block) + block_size);
+  if (!block)
+    return NULL;
+  block->next = arena->blocks;
+  arena->blocks = block;
+  data = (unsigned char *)(block + 1);
+  data += (size_t)(0 - (uintptr_t)data) & (align - 1);
+  block_end = (unsigned char *)(block + 1) + block_size;
+
+  // keep filling the current block if it has more room than the new one
+  if ((size_t)(block_end - (data + size)) >= room) {
+    arena->next = data + size;
+    arena->end = block_end;
+  }
+  return data;
+}
+
+/*
+ * Gives back the end of the most recent allocation from @a arena, at @a p
+ * with @a size bytes, so that only @a new_size bytes of it are used. Does
+ * nothing if it's not the most recent allocation.
+ */
+static void cpar_arena_shrink(struct cpar_arena *arena,
+                              void *p,
+                              size_t size,
+                              size_t new_size)
+{
+  if ((unsigned char *)p + size == arena->next)
+    arena->next = (unsigned char *)p + new_size;
+}
+
+void cpar_arena_clear(struct cpar_arena *arena)
+{
+  if (!arena)
+    return;
+  cpar_arena_release(arena);
+  cpar_arena_init(arena, arena->buffer, arena->buffer_size);
+}
+
+void cpar_arena_release(struct cpar_arena *arena)
+{
+  struct cpar_arena_block *block = NULL;
+
+  if (!arena)
+    return;
+
+  block = arena->blocks;
+  while (block) {
+    struct cpar_arena_block *next = block->next;
+    CPAR_FREE(block);
+    block = next;
+  }
+  arena->blocks = NULL;
+  arena->next = arena->end = NULL;
+}
+
+/* The shortest colour string, for example `red` or `#fff`. */
+#define CPAR_MIN_COLOR_LEN 3
+
+enum cpar_status cpar_color_parse_list(struct cpar_arena *arena,
+                                       const char *list_str,
+                                       size_t list_str_len,
+                                       uint32_t **values,
+                                       size_t *n_values,
+                                       size_t *error_offset)
+{
+  const char *p = list_str;
+  const char *end = list_str + list_str_len;
+  uint32_t *out = NULL;
+  size_t n = 0;
+  size_t max_n = 0;
+  enum cpar_status status = CPAR_STATUS_OK;
+
+  if (!arena || (!list_str && list_str_len > 0) || !values || !n_values)
+    return CPAR_STATUS_INVALID_PARAMETER;
+
+  /*
+   * Each colour which parses takes up at least CPAR_MIN_COLOR_LEN
+   * characters and a separator, which bounds how many there can be, so
+   * that the colours can be stored in one go and the rest given back.
+   */
+  max_n = list_str_len / (CPAR_MIN_COLOR_LEN + 1) + 1;
+  out = (uint32_t *)cpar_arena_alloc(
+      arena, max_n * sizeof(uint32_t), sizeof(uint32_t));
+  if (!out) {
+    *values = NULL;
+    *n_values = 0;
+    if (error_offset)
+      *error_offset = 0;
+    return CPAR_STATUS_NO_MEMORY;
+  }
+
+  while (p < end && cpar_is_space(*p))
+    p++;
+  while (p < end) {
+    const char *start = p;
+    int depth = 0;
+
+    // find the end of the entry, skipping over anything in parentheses
+    for (; p < end; p++) {
+      if (*p == '(')
+        depth++;
+      else if (*p == ')' && depth > 0)
+        depth--;
+      else if (depth == 0 && (*p == ',' || cpar_is_space(*p)))
+        break;
+    }
+    // an empty entry, or (which can't happen) more colours than the bound
+    if (p == start || n == max_n)
+      status = CPAR_STATUS_SYNTAX_ERROR;
+    else
+      status = cpar_color_parse_n(start, (size_t)(p - start), &out[n]);
+    if (status != CPAR_STATUS_OK) {
+      p = start;
+      break;
+    }
+    n++;
+
+    // the separator is whitespace, at most one comma, and whitespace
+    while (p < end && cpar_is_space(*p))
+      p++;
+    if (p < end && *p == ',') {
+      const char *comma = p++;
+      while (p < end && cpar_is_space(*p))
+        p++;
+      if (p == end) {
+        p = comma;
+        status = CPAR_STATUS_SYNTAX_ERROR;
+        break;
+      }
+    }
+  }
+
+  cpar_arena_shrink(arena, out, max_n * sizeof(uint32_t), n * sizeof(uint32_t));
+  *values = out;
+  *n_values = n;
+  if (error_offset)
+    *error_offset = (size_t)(p - list_str);
+  return status;
+}
+
+/* The most atoms a table can hold, small enough that sizes can't overflow
+ * even with a 32-bit size_t. */
+#define CPAR_ATOMS_MAX (UINT32_C(1) << 26)
+
+struct cpar_atom {
+  const char *str;
+  uint32_t len;
+  uint32_t hash;
+  uint32_t value;
+};
+
+struct cpar_atoms {
+  struct cpar_atom *atoms;
+  uint32_t n_atoms;
+  uint32_t atoms_capacity;
+  /* Open-addressed index of atom IDs plus one, where zero is empty. */
+  uint32_t *index;
+  uint32_t index_mask;
+  struct cpar_arena strings;
+};
+
+static uint32_t cpar_hash_string(const char *str, size_t len)
+{
+  uint32_t h = CPAR_HASH_INIT;
+  for (size_t i = 0; i < len; i++)
+    h = cpar_hash_byte(h, (uint8_t)str[i]);
+  return h;
+}
+
+/* Copies a string into the arena, zero-terminated. */
+static const char *
+cpar_atoms_copy(struct cpar_atoms *atoms, const char *str, size_t len)
+{
+  char *copy = (char *)cpar_arena_alloc(&atoms->strings, len + 1, 1);
+  if (!copy)
+    return NULL;
+  memcpy(copy, str, len);
+  copy[len] = '\0';
+  return copy;
+}
+
+static void cpar_atoms_index_insert(struct cpar_atoms *atoms, uint32_t id)
+{
+  uint32_t i = atoms->atoms[id].hash & atoms->index_mask;
+  while (atoms->index[i] != 0)
+    i = (i + 1) & atoms->index_mask;
+  atoms->index[i] = id + 1;
+}
+
+/* Makes sure there's room for one more atom, keeping the index half empty. */
+static int cpar_atoms_reserve(struct cpar_atoms *atoms)
+{
+  if (atoms->n_atoms >= CPAR_ATOMS_MAX)
+    return 0;
+
+  if (atoms->n_atoms == atoms->atoms_capacity) {
+    uint32_t capacity = atoms->atoms_capacity ? atoms->atoms_capacity * 2
+                                              : 256;
+    struct cpar_atom *grown = (struct cpar_atom *)CPAR_MALLOC(
+        capacity * sizeof(struct cpar_atom));
+    if (!grown)
+      return 0;
+    if (atoms->atoms) {
+      memcpy(grown, atoms->atoms, atoms->n_atoms * sizeof(struct cpar_atom));
+      CPAR_FREE(atoms->atoms);
+    }
+    atoms->atoms = grown;
+    atoms->atoms_capacity = capacity;
+  }
+
+  if (!atoms->index || (atoms->n_atoms + 1) * 2 > atoms->index_mask + 1) {
+    uint32_t size = atoms->index ? (atoms->index_mask + 1) * 2 : 512;
+    uint32_t *grown = (uint32_t *)CPAR_MALLOC(size * sizeof(uint32_t));
+    if (!grown)
+      return 0;
+    memset(grown, 0, size * sizeof(uint32_t));
+    CPAR_FREE(atoms->index);
+    atoms->index = grown;
+    atoms->index_mask = size - 1;
+    for (uint32_t id = 0; id < atoms->n_atoms; id++)
+      cpar_atoms_index_insert(atoms, id);
+  }
+
+  return 1;
+}
+
+static void cpar_atoms_add(struct cpar_atoms *atoms,
+                           const char *str,
+                           size_t len,
+                           uint32_t hash,
+                           uint32_t value)
+{
+  struct cpar_atom *atom = &atoms->atoms[atoms->n_atoms];
+  atom->str = str;
+  atom->len = (uint32_t)len;
+  atom->hash = hash;
+  atom->value = value;
+  cpar_atoms_index_insert(atoms, atoms->n_atoms++);
+}
+
+struct cpar_atoms *cpar_atoms_new(void)
+{
+  struct cpar_atoms *atoms =
+      (struct cpar_atoms *)CPAR_MALLOC(sizeof(struct cpar_atoms));
+  if (!atoms)
+    return NULL;
+  memset(atoms, 0, sizeof(*atoms));
+  cpar_arena_init(&atoms->strings, NULL, 0);
+
+  // the names are static, so they're used in place rather than copied
+  for (uint32_t i = 0; i < CPAR_N_COLOR_NAMES; i++) {
+    const char *name = cpar_color_names + cpar_color_name_offsets[i];
+    size_t len =
+        cpar_color_name_offsets[i + 1] - cpar_color_name_offsets[i] - 1;
+    if (!cpar_atoms_reserve(atoms)) {
+      cpar_atoms_free(atoms);
+      return NULL;
+    }
+    cpar_atoms_add(atoms,
+                   name,
+                   len,
+                   cpar_hash_string(name, len),
+                   cpar_color_name_values[i]);
+  }
+
+  return atoms;
+}
+
+void cpar_atoms_free(struct cpar_atoms *atoms)
+{
+  if (!atoms)
+    return;
+
+  cpar_arena_release(&atoms->strings);
+  CPAR_FREE(atoms->index);
+  CPAR_FREE(atoms->atoms);
+  CPAR_FREE(atoms);
+}
+
+enum cpar_status cpar_atoms_intern(struct cpar_atoms *atoms,
+                                   const char *color_str,
+                                   size_t color_str_len,
+                                   uint32_t *id)
+{
+  uint32_t h = 0;
+  uint32_t i = 0;
+  uint32_t value = 0;
+  const char *copy = NULL;
+  enum cpar_status status = CPAR_STATUS_OK;
+
+  if (!atoms || !color_str || color_str_len == 0 ||
+      color_str_len > UINT32_MAX) {
+    return CPAR_STATUS_INVALID_PARAMETER;
+  }
+
+  h = cpar_hash_string(color_str, color_str_len);
+  for (i = h & atoms->index_mask; atoms->index[i] != 0;
+       i = (i + 1) & atoms->index_mask) {
+    const struct cpar_atom *atom = &atoms->atoms[atoms->index[i] - 1];
+    if (atom->hash == h && atom->len == color_str_len &&
+        memcmp(atom->str, color_str, color_str_len) == 0) {
+      if (id)
+        *id = atoms->index[i] - 1;
+      return CPAR_STATUS_OK;
+    }
+  }
+
+  if ((status = cpar_color_parse_n(color_str, color_str_len, &value)) !=
+      CPAR_STATUS_OK) {
+    return status;
+  }
+
+  if (!cpar_atoms_reserve(atoms) ||
+      !(copy = cpar_atoms_copy(atoms, color_str, color_str_len))) {
+    return CPAR_STATUS_NO_MEMORY;
+  }
+
+  if (id)
+    *id = atoms->n_atoms;
+  cpar_atoms_add(atoms, copy, color_str_len, h, value);
+  return CPAR_STATUS_OK;
+}
+
+uint32_t cpar_atoms_count(const struct cpar_atoms *atoms)
+{
+  return atoms ? atoms->n_atoms : 0;
+}
+
+uint32_t cpar_atoms_value(const struct cpar_atoms *atoms, uint32_t id)
+{
+  if (!atoms || id >= atoms->n_atoms)
+    return 0;
+  return atoms->atoms[id].value;
+}
+
+const char *
+cpar_atoms_string(const struct cpar_atoms *atoms, uint32_t id, size_t *len)
+{
+  if (!atoms || id >= atoms->n_atoms)
+    return NULL;
+  if (len)
+    *len = atoms->atoms[id].len;
+  return atoms->atoms[id].str;
+}
+
+/*
+ * SIMD kernels for cpar_color_parse_hex8_batch(). Each decodes up to 64
+ * records and returns a bitmask of the invalid ones. The kernels only use
+ * instruction sets the CPU is checked for at runtime so the rest of the
+ * code can be built for a baseline target. Define CPAR_NO_SIMD to build
+ * only the portable kernel.
+ */
+#if !defined(CPAR_NO_SIMD) && defined(__GNUC__) &&                        \
+    (defined(__x86_64__) || defined(__i386__))
+#define CPAR_HAVE_X86_SIMD 1
+#include <immintrin.h>
+#elif !defined(CPAR_NO_SIMD) && defined(__aarch64__) &&                   \
+    defined(__ARM_NEON) && !defined(__ARM_BIG_ENDIAN)
+#define CPAR_HAVE_NEON 1
+#include <arm_neon.h>
+#endif
+
+typedef uint64_t (*cpar_hex8_kernel)(const char *strs,
+                                     size_t stride,
+                                     size_t n_strs,
+                                     uint32_t *results);
+
+static uint64_t cpar_hex8_decode_portable(const char *strs,
+                                          size_t stride,
+                                          size_t n_strs,
+                                          uint32_t *results)
+{
+  uint64_t invalid = 0;
+  for (size_t i = 0; i < n_strs; i++) {
+    const char *rec = strs + i * stride;
+    if (rec[0] != '#' ||
+        cpar_hex_decode(rec + 1, 8, &results[i]) != CPAR_STATUS_OK) {
+      invalid |= (uint64_t)1 << i;
+    }
+  }
+  return invalid;
+}
+
+#ifdef CPAR_HAVE_X86_SIMD
+
+/*
+ * Converts hex digits to their values, setting each byte of @a valid to 0xFF
+ * if the corresponding byte of @a v was a hex digit or else to zero.
+ */
+__attribute__((target("ssse3"))) static inline __m128i
+cpar_hex_nibbles_ssse3(__m128i v, __m128i *valid)
+{
+  __m128i d = _mm_sub_epi8(v, _mm_set1_epi8('0'));
+  __m128i l = _mm_sub_epi8(_mm_or_si128(v, _mm_set1_epi8(0x20)),
+                           _mm_set1_epi8('a'));
+  __m128i is_digit = _mm_cmpeq_epi8(_mm_min_epu8(d, _mm_set1_epi8(9)), d);
+  __m128i is_alpha = _mm_cmpeq_epi8(_mm_min_epu8(l, _mm_set1_epi8(5)), l);
+  *valid = _mm_or_si128(is_digit, is_alpha);
+  return _mm_or_si128(
+      _mm_and_si128(is_digit, d),
+      _mm_and_si128(is_alpha, _mm_add_epi8(l, _mm_set1_epi8(10))));
+}
+
+__attribute__((target("avx2"))) static inline __m256i
+cpar_hex_nibbles_avx2(__m256i v, __m256i *valid)
+{
+  __m256i d = _mm256_sub_epi8(v, _mm256_set1_epi8('0'));
+  __m256i l = _mm256_sub_epi8(_mm256_or_si256(v, _mm256_set1_epi8(0x20)),
+                              _mm256_set1_epi8('a'));
+  __m256i is_digit =
+      _mm256_cmpeq_epi8(_mm256_min_epu8(d, _mm256_set1_epi8(9)), d);
+  __m256i is_alpha =
+      _mm256_cmpeq_epi8(_mm256_min_epu8(l, _mm256_set1_epi8(5)), l);
+  *valid = _mm256_or_si256(is_digit, is_alpha);
+  return _mm256_or_si256(
+      _mm256_and_si256(is_digit, d),
+      _mm256_and_si256(is_alpha, _mm256_add_epi8(l, _mm256_set1_epi8(10))));
+}
+
+static uint64_t cpar_hex8_load(const char *rec)
+{
+  uint64_t digits;
+  memcpy(&digits, rec + 1, sizeof(digits));
+  return digits;
+}
+
+__attribute__((target("ssse3"))) static uint64_t
+cpar_hex8_decode_ssse3(const char *strs,
+                       size_t stride,
+                       size_t n_strs,
+                       uint32_t *results)
+{
+  // pairs of nibbles become (high * 16 + low) in 16-bit lanes, then the low
+  // byte of each lane is gathered in reverse so each uint32_t is r,g,b,a
+  const __m128i weights = _mm_set1_epi16(0x0110);
+  const __m128i order =
+      _mm_setr_epi8(6, 4, 2, 0, 14, 12, 10, 8, -1, -1, -1, -1, -1, -1, -1, -1);
+  uint64_t invalid = 0;
+  size_t i = 0;
+
+  for (; i + 2 <= n_strs; i += 2) {
+    const char *rec0 = strs + i * stride;
+    const char *rec1 = rec0 + stride;
+    __m128i v = _mm_set_epi64x((long long)cpar_hex8_load(rec1),
+                               (long long)cpar_hex8_load(rec0));
+    __m128i nib, valid;
+    uint32_t bad;
+
+    nib = cpar_hex_nibbles_ssse3(v, &valid);
+    bad = ~(uint32_t)_mm_movemask_epi8(valid);
+    invalid |= (uint64_t)((bad & 0xFF) != 0 || rec0[0] != '#') << i;
+    invalid |= (uint64_t)((bad & 0xFF00) != 0 || rec1[0] != '#') << (i + 1);
+
+    v = _mm_shuffle_epi8(_mm_maddubs_epi16(nib, weights), order);
+    _mm_storel_epi64((__m128i *)&results[i], v);
+  }
+  if (i == n_strs)
+    return invalid; // a full block, and shifting by 64 is undefined
+
+  return invalid |
+         (cpar_hex8_decode_portable(strs + i * stride,
+                                    stride,
+                                    n_strs - i,
+                                    results + i)
+          << i);
+}
+
+__attribute__((target("avx2"))) static uint64_t
+cpar_hex8_decode_avx2(const char *strs,
+                      size_t stride,
+                      size_t n_strs,
+                      uint32_t *results)
+{
+  const __m256i weights = _mm256_set1_epi16(0x0110);
+  const __m256i order = _mm256_setr_epi8(6, 4, 2, 0, 14, 12, 10, 8, //
+                                         -1, -1, -1, -1, -1, -1, -1, -1,
+                                         6, 4, 2, 0, 14, 12, 10, 8, //
+                                         -1, -1, -1, -1, -1, -1, -1, -1);
+  uint64_t invalid = 0;
+  size_t i = 0;
+
+  for (; i + 4 <= n_strs; i += 4) {
+    const char *rec = strs + i * stride;
+    __m256i v = _mm256_set_epi64x((long long)cpar_hex8_load(rec + 3 * stride),
+                                  (long long)cpar_hex8_load(rec + 2 * stride),
+                                  (long long)cpar_hex8_load(rec + stride),
+                                  (long long)cpar_hex8_load(rec));
+    __m256i nib, valid;
+    uint32_t bad;
+
+    nib = cpar_hex_nibbles_avx2(v, &valid);
+    bad = ~(uint32_t)_mm256_movemask_epi8(valid);
+    for (size_t j = 0; j < 4; j++) {
+      invalid |= (uint64_t)(((bad >> (j * 8)) & 0xFF) != 0 ||
+                            rec[j * stride] != '#')
+                 << (i + j);
+    }
+
+    v = _mm256_permute4x64_epi64(
+        _mm256_shuffle_epi8(_mm256_maddubs_epi16(nib, weights), order),
+        _MM_SHUFFLE(3, 1, 2, 0));
+    _mm_storeu_si128((__m128i *)&results[i], _mm256_castsi256_si128(v));
+  }
+  if (i == n_strs)
+    return invalid; // a full block, and shifting by 64 is undefined
+
+  return invalid |
+         (cpar_hex8_decode_portable(strs + i * stride,
+                                    stride,
+                                    n_strs - i,
+                                    results + i)
+          << i);
+}
+
+#endif // CPAR_HAVE_X86_SIMD
+
+#ifdef CPAR_HAVE_NEON
+
+static uint64_t cpar_hex8_decode_neon(const char *strs,
+                                      size_t stride,
+                                      size_t n_strs,
+                                      uint32_t *results)
+{
+  uint64_t invalid = 0;
+  size_t i = 0;
+
+  for (; i + 2 <= n_strs; i += 2) {
+    const char *rec0 = strs + i * stride;
+    const char *rec1 = rec0 + stride;
+    uint8x16_t v = vcombine_u8(vld1_u8((const uint8_t *)rec0 + 1),
+                               vld1_u8((const uint8_t *)rec1 + 1));
+    uint8x16_t d = vsubq_u8(v, vdupq_n_u8('0'));
+    uint8x16_t l = vsubq_u8(vorrq_u8(v, vdupq_n_u8(0x20)), vdupq_n_u8('a'));
+    uint8x16_t is_digit = vcleq_u8(d, vdupq_n_u8(9));
+    uint8x16_t is_alpha = vcleq_u8(l, vdupq_n_u8(5));
+    uint8x16_t nib = vbslq_u8(is_digit, d, vaddq_u8(l, vdupq_n_u8(10)));
+    uint64x2_t valid = vreinterpretq_u64_u8(vorrq_u8(is_digit, is_alpha));
+    uint8x16_t bytes;
+
+    invalid |= (uint64_t)(vgetq_lane_u64(valid, 0) != UINT64_MAX ||
+                          rec0[0] != '#')
+               << i;
+    invalid |= (uint64_t)(vgetq_lane_u64(valid, 1) != UINT64_MAX ||
+                          rec1[0] != '#')
+               << (i + 1);
+
+    bytes = vorrq_u8(vshlq_n_u8(vuzp1q_u8(nib, nib), 4), vuzp2q_u8(nib, nib));
+    vst1_u8((uint8_t *)&results[i], vrev32_u8(vget_low_u8(bytes)));
+  }
+  if (i == n_strs)
+    return invalid; // a full block, and shifting by 64 is undefined
+
+  return invalid |
+         (cpar_hex8_decode_portable(strs + i * stride,
+                                    stride,
+                                    n_strs - i,
+                                    results + i)
+          << i);
+}
+
+#endif // CPAR_HAVE_NEON
+
+static cpar_hex8_kernel cpar_select_hex8_kernel(void)
+{
+#if defined(CPAR_HAVE_X86_SIMD)
+  if (__builtin_cpu_supports("avx2"))
+    return cpar_hex8_decode_avx2;
+  if (__builtin_cpu_supports("ssse3"))
+    return cpar_hex8_decode_ssse3;
+#elif defined(CPAR_HAVE_NEON)
+  return cpar_hex8_decode_neon;
+#endif
+  return cpar_hex8_decode_portable;
+}
+
+size_t cpar_color_parse_hex8_batch(const char *strs,
+                                   size_t stride,
+                                   size_t n_strs,
+                                   uint32_t *results,
+                                   uint64_t *invalid)
+{
+  cpar_hex8_kernel kernel = NULL;
+  size_t n_invalid = 0;
+
+  if (!strs || !results || stride < 9)
+    return n_strs;
+
+  kernel = cpar_select_hex8_kernel();
+
+  for (size_t i = 0; i < n_strs; i += 64) {
+    size_t n_block = (n_strs - i < 64) ? n_strs - i : 64;
+    uint64_t mask = kernel(strs + i * stride, stride, n_block, results + i);
+    if (invalid)
+      invalid[i / 64] = mask;
+    while (mask) {
+      mask &= mask - 1;
+      n_invalid++;
+    }
+  }
+
+  return n_invalid;
+}
+
+/* BEGIN GENERATED PIXEL TABLES: do not edit, see tools/gen_color_tables.py */
+
+/* Each 8-bit sRGB-encoded value converted to linear light. */
+static const uint8_t cpar_srgb_to_linear_table[256] = {
+    0, 0, 0, 0, 0, 0, 0, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 2, 2, 2, 2, 2, 2, 2,
+    2, 3, 3, 3, 3, 3, 3, 4, 4, 4, 4, 4, 5, 5, 5, 5, 6, 6, 6, 6, 7, 7, 7, 8, 8,
+    8, 8, 9, 9, 9, 10, 10, 10, 11, 11, 12, 12, 12, 13, 13, 13, 14, 14, 15, 15,
+    16, 16, 17, 17, 17, 18, 18, 19, 19, 20, 20, 21, 22, 22, 23, 23, 24, 24, 25,
+    25, 26, 27, 27, 28, 29, 29, 30, 30, 31, 32, 32, 33, 34, 35, 35, 36, 37, 37,
+    38, 39, 40, 41, 41, 42, 43, 44, 45, 45, 46, 47, 48, 49, 50, 51, 51, 52, 53,
+    54, 55, 56, 57, 58, 59, 60, 61, 62, 63, 64, 65, 66, 67, 68, 69, 70, 71, 72,
+    73, 74, 76, 77, 78, 79, 80, 81, 82, 84, 85, 86, 87, 88, 90, 91, 92, 93, 95,
+    96, 97, 99, 100, 101, 103, 104, 105, 107, 108, 109, 111, 112, 114, 115,
+    116, 118, 119, 121, 122, 124, 125, 127, 128, 130, 131, 133, 134, 136, 138,
+    139, 141, 142, 144, 146, 147, 149, 151, 152, 154, 156, 157, 159, 161, 163,
+    164, 166, 168, 170, 171, 173, 175, 177, 179, 181, 183, 184, 186, 188, 190,
+    192, 194, 196, 198, 200, 202, 204, 206, 208, 210, 212, 214, 216, 218, 220,
+    222, 224, 226, 229, 231, 233, 235, 237, 239, 242, 244, 246, 248, 250, 253,
+    255,
+};
+
+/* Each 8-bit linear value converted to the sRGB encoding. */
+static const uint8_t cpar_linear_to_srgb_table[256] = {
+    0, 13, 22, 28, 34, 38, 42, 46, 50, 53, 56, 59, 61, 64, 66, 69, 71, 73, 75,
+    77, 79, 81, 83, 85, 86, 88, 90, 92, 93, 95, 96, 98, 99, 101, 102, 104, 105,
+    106, 108, 109, 110, 112, 113, 114, 115, 117, 118, 119, 120, 121, 122, 124,
+    125, 126, 127, 128, 129, 130, 131, 132, 133, 134, 135, 136, 137, 138, 139,
+    140, 141, 142, 143, 144, 145, 146, 147, 148, 148, 149, 150, 151, 152, 153,
+    154, 155, 155, 156, 157, 158, 159, 159, 160, 161, 162, 163, 163, 164, 165,
+    166, 167, 167, 168, 169, 170, 170, 171, 172, 173, 173, 174, 175, 175, 176,
+    177, 178, 178, 179, 180, 180, 181, 182, 182, 183, 184, 185, 185, 186, 187,
+    187, 188, 189, 189, 190, 190, 191, 192, 192, 193, 194, 194, 195, 196, 196,
+    197, 197, 198, 199, 199, 200, 200, 201, 202, 202, 203, 203, 204, 205, 205,
+    206, 206, 207, 208, 208, 209, 209, 210, 210, 211, 212, 212, 213, 213, 214,
+    214, 215, 215, 216, 216, 217, 218, 218, 219, 219, 220, 220, 221, 221, 222,
+    222, 223, 223, 224, 224, 225, 226, 226, 227, 227, 228, 228, 229, 229, 230,
+    230, 231, 231, 232, 232, 233, 233, 234, 234, 235, 235, 236, 236, 237, 237,
+    238, 238, 238, 239, 239, 240, 240, 241, 241, 242, 242, 243, 243, 244, 244,
+    245, 245, 246, 246, 246, 247, 247, 248, 248, 249, 249, 250, 250, 251, 251,
+    251, 252, 252, 253, 253, 254, 254, 255, 255,
+};
+
+/* Multipliers which divide by each alpha value, see cpar_unpremultiply(). */
+static const uint32_t cpar_unpremultiply_table[256] = {
+    0, 16777216, 8388608, 5592406, 4194304, 3355444, 2796203, 2396746, 2097152,
+    1864136, 1677722, 1525202, 1398102, 1290556, 1198373, 1118482, 1048576,
+    986896, 932068, 883012, 838861, 798916, 762601, 729445, 699051, 671089,
+    645278, 621379, 599187, 578525, 559241, 541201, 524288, 508401, 493448,
+    479350, 466034, 453439, 441506, 430186, 419431, 409201, 399458, 390168,
+    381301, 372828, 364723, 356963, 349526, 342393, 335545, 328966, 322639,
+    316552, 310690, 305041, 299594, 294338, 289263, 284360, 279621, 275037,
+    270601, 266306, 262144, 258112, 254201, 250407, 246724, 243149, 239675,
+    236299, 233017, 229825, 226720, 223697, 220753, 217886, 215093, 212370,
+    209716, 207127, 204601, 202136, 199729, 197380, 195084, 192842, 190651,
+    188509, 186414, 184366, 182362, 180401, 178482, 176603, 174763, 172961,
+    171197, 169467, 167773, 166112, 164483, 162886, 161320, 159784, 158276,
+    156797, 155345, 153920, 152521, 151147, 149797, 148471, 147169, 145889,
+    144632, 143396, 142180, 140986, 139811, 138655, 137519, 136401, 135301,
+    134218, 133153, 132105, 131072, 130056, 129056, 128071, 127101, 126145,
+    125204, 124276, 123362, 122462, 121575, 120700, 119838, 118988, 118150,
+    117324, 116509, 115705, 114913, 114131, 113360, 112599, 111849, 111108,
+    110377, 109656, 108943, 108241, 107547, 106862, 106185, 105518, 104858,
+    104207, 103564, 102928, 102301, 101681, 101068, 100463, 99865, 99274,
+    98690, 98113, 97542, 96979, 96421, 95870, 95326, 94787, 94255, 93728,
+    93207, 92692, 92183, 91679, 91181, 90688, 90201, 89718, 89241, 88769,
+    88302, 87839, 87382, 86929, 86481, 86038, 85599, 85164, 84734, 84308,
+    83887, 83469, 83056, 82647, 82242, 81841, 81443, 81050, 80660, 80274,
+    79892, 79513, 79138, 78767, 78399, 78034, 77673, 77315, 76960, 76609,
+    76261, 75916, 75574, 75235, 74899, 74566, 74236, 73909, 73585, 73263,
+    72945, 72629, 72316, 72006, 71698, 71393, 71090, 70790, 70493, 70198,
+    69906, 69616, 69328, 69043, 68760, 68479, 68201, 67924, 67651, 67379,
+    67109, 66842, 66577, 66314, 66053, 65794,
+};
+
+/* See CPAR_SRGB_MIDPOINT_FLOATS and CPAR_LINEAR_BUCKET_VALUES. */
+#define CPAR_LINEAR_BUCKETS 4096
+#ifdef __cplusplus
+static const float (&cpar_srgb_midpoints)[255] = cpar::detail::srgb_midpoints;
+static const uint8_t (&cpar_linear_bucket_table)[CPAR_LINEAR_BUCKETS + 3] =
+    cpar::detail::linear_buckets;
+#else
+static const float cpar_srgb_midpoints[255] = {CPAR_SRGB_MIDPOINT_FLOATS};
+static const uint8_t cpar_linear_bucket_table[CPAR_LINEAR_BUCKETS + 3] = {
+    CPAR_LINEAR_BUCKET_VALUES};
+#undef CPAR_SRGB_TO_LINEAR_FLOATS
+#undef CPAR_SRGB_MIDPOINT_FLOATS
+#undef CPAR_LINEAR_BUCKET_VALUES
+#endif
+
+/* The weighted relative luminance of each 8-bit red, green and blue value,
+ * scaled by CPAR_LUMINANCE_SCALE. */
+#define CPAR_LUMINANCE_SCALE 10485760
+static const uint32_t cpar_luminance_table[3][256] = {
+    {
+        0, 677, 1353, 2030, 2707, 3383, 4060, 4737, 5413, 6090, 6766, 7460,
+        8196, 8972, 9790, 10649, 11551, 12496, 13484, 14517, 15595, 16717,
+        17886, 19101, 20362, 21671, 23028, 24433, 25887, 27390, 28943, 30546,
+        32199, 33904, 35660, 37468, 39329, 41242, 43209, 45229, 47303, 49432,
+        51615, 53854, 56148, 58499, 60906, 63369, 65890, 68469, 71105, 73800,
+        76553, 79365, 82237, 85168, 88159, 91211, 94324, 97497, 100732, 104029,
+        107388, 110809, 114294, 117841, 121451, 125126, 128864, 132667, 136534,
+        140467, 144464, 148527, 152657, 156852, 161114, 165442, 169838, 174301,
+        178832, 183431, 188098, 192833, 197637, 202511, 207454, 212466, 217549,
+        222701, 227925, 233219, 238584, 244020, 249528, 255108, 260760, 266484,
+        272281, 278150, 284093, 290110, 296200, 302364, 308602, 314914, 321302,
+        327764, 334301, 340914, 347603, 354367, 361208, 368125, 375118, 382189,
+        389337, 396562, 403864, 411245, 418704, 426241, 433856, 441551, 449324,
+        457176, 465108, 473120, 481212, 489384, 497636, 505969, 514382, 522877,
+        531453, 540111, 548850, 557671, 566574, 575560, 584628, 593779, 603013,
+        612331, 621731, 631216, 640784, 650436, 660173, 669994, 679900, 689891,
+        699966, 710128, 720374, 730707, 741125, 751630, 762220, 772898, 783662,
+        794513, 805451, 816477, 827590, 838791, 850080, 861457, 872922, 884476,
+        896118, 907849, 919670, 931580, 943579, 955668, 967847, 980116, 992475,
+        1004924, 1017465, 1030096, 1042818, 1055631, 1068535, 1081531, 1094619,
+        1107799, 1121071, 1134435, 1147892, 1161441, 1175083, 1188818, 1202647,
+        1216569, 1230584, 1244693, 1258896, 1273193, 1287584, 1302070, 1316650,
+        1331326, 1346096, 1360961, 1375922, 1390978, 1406130, 1421377, 1436721,
+        1452161, 1467697, 1483330, 1499059, 1514885, 1530809, 1546829, 1562947,
+        1579163, 1595476, 1611887, 1628396, 1645003, 1661709, 1678513, 1695416,
+        1712418, 1729519, 1746719, 1764019, 1781418, 1798917, 1816515, 1834214,
+        1852013, 1869912, 1887911, 1906012, 1924213, 1942515, 1960918, 1979423,
+        1998029, 2016736, 2035546, 2054457, 2073471, 2092586, 2111804, 2131125,
+        2150549, 2170075, 2189704, 2209437, 2229273,
+    },
+    {
+        0, 2276, 4553, 6829, 9105, 11381, 13658, 15934, 18210, 20486, 22763,
+        25097, 27572, 30183, 32933, 35824, 38858, 42037, 45363, 48837, 52461,
+        56238, 60169, 64256, 68500, 72903, 77468, 82194, 87085, 92141, 97365,
+        102758, 108320, 114055, 119963, 126045, 132304, 138741, 145356, 152152,
+        159130, 166291, 173637, 181168, 188887, 196794, 204891, 213179, 221659,
+        230333, 239202, 248266, 257528, 266989, 276649, 286510, 296574, 306840,
+        317311, 327987, 338870, 349961, 361261, 372770, 384491, 396424, 408570,
+        420931, 433507, 446300, 459310, 472538, 485987, 499656, 513546, 527660,
+        541997, 556558, 571346, 586360, 601602, 617072, 632772, 648703, 664865,
+        681260, 697888, 714750, 731848, 749182, 766753, 784562, 802611, 820899,
+        839428, 858198, 877212, 896468, 915969, 935716, 955708, 975948, 996435,
+        1017171, 1038156, 1059392, 1080879, 1102619, 1124611, 1146857, 1169357,
+        1192113, 1215126, 1238395, 1261922, 1285708, 1309753, 1334059, 1358626,
+        1383455, 1408546, 1433901, 1459520, 1485404, 1511554, 1537971, 1564655,
+        1591607, 1618828, 1646318, 1674079, 1702111, 1730416, 1758992, 1787842,
+        1816967, 1846366, 1876041, 1905992, 1936221, 1966727, 1997511, 2028575,
+        2059919, 2091544, 2123450, 2155638, 2188109, 2220864, 2253903, 2287227,
+        2320836, 2354732, 2388915, 2423385, 2458144, 2493192, 2528530, 2564158,
+        2600078, 2636289, 2672793, 2709590, 2746680, 2784066, 2821746, 2859722,
+        2897995, 2936565, 2975432, 3014598, 3054064, 3093828, 3133894, 3174260,
+        3214928, 3255899, 3297172, 3338749, 3380630, 3422816, 3465307, 3508105,
+        3551209, 3594621, 3638341, 3682369, 3726707, 3771355, 3816312, 3861582,
+        3907162, 3953055, 3999261, 4045781, 4092615, 4139763, 4187227, 4235006,
+        4283102, 4331516, 4380247, 4429296, 4478664, 4528352, 4578360, 4628688,
+        4679338, 4730310, 4781604, 4833221, 4885162, 4937426, 4990016, 5042931,
+        5096171, 5149739, 5203633, 5257854, 5312404, 5367283, 5422491, 5478029,
+        5533897, 5590096, 5646627, 5703489, 5760685, 5818213, 5876075, 5934272,
+        5992804, 6051670, 6110873, 6170412, 6230289, 6290502, 6351054, 6411945,
+        6473175, 6534744, 6596654, 6658904, 6721496, 6784430, 6847706, 6911325,
+        6975288, 7039594, 7104245, 7169241, 7234583, 7300271, 7366305, 7432686,
+        7499415,
+    },
+    {
+        0, 230, 460, 689, 919, 1149, 1379, 1609, 1838, 2068, 2298, 2534, 2783,
+        3047, 3325, 3616, 3923, 4244, 4579, 4930, 5296, 5677, 6074, 6487, 6915,
+        7360, 7820, 8298, 8791, 9302, 9829, 10373, 10935, 11514, 12110, 12724,
+        13356, 14006, 14674, 15360, 16064, 16787, 17529, 18289, 19068, 19866,
+        20684, 21521, 22377, 23252, 24148, 25063, 25998, 26953, 27928, 28923,
+        29939, 30976, 32033, 33111, 34209, 35329, 36470, 37631, 38815, 40019,
+        41245, 42493, 43763, 45054, 46368, 47703, 49061, 50441, 51843, 53268,
+        54715, 56185, 57678, 59193, 60732, 62294, 63879, 65487, 67119, 68774,
+        70452, 72155, 73881, 75631, 77404, 79202, 81024, 82870, 84741, 86636,
+        88555, 90499, 92468, 94461, 96479, 98523, 100591, 102684, 104803,
+        106946, 109116, 111310, 113530, 115776, 118048, 120345, 122668, 125017,
+        127392, 129793, 132221, 134674, 137154, 139661, 142194, 144753, 147340,
+        149953, 152593, 155259, 157953, 160674, 163422, 166197, 169000, 171829,
+        174687, 177572, 180484, 183424, 186392, 189388, 192411, 195463, 198543,
+        201650, 204786, 207950, 211143, 214364, 217613, 220891, 224198, 227533,
+        230897, 234290, 237712, 241163, 244643, 248152, 251690, 255257, 258854,
+        262480, 266135, 269821, 273535, 277280, 281054, 284857, 288691, 292555,
+        296449, 300372, 304326, 308310, 312324, 316369, 320444, 324550, 328686,
+        332852, 337049, 341277, 345536, 349825, 354146, 358497, 362880, 367293,
+        371738, 376214, 380721, 385260, 389830, 394431, 399064, 403729, 408425,
+        413153, 417912, 422704, 427527, 432383, 437270, 442189, 447141, 452125,
+        457141, 462189, 467270, 472383, 477528, 482707, 487917, 493161, 498437,
+        503746, 509088, 514462, 519870, 525311, 530785, 536291, 541831, 547405,
+        553011, 558651, 564325, 570031, 575772, 581546, 587353, 593194, 599069,
+        604978, 610921, 616897, 622908, 628953, 635031, 641144, 647291, 653472,
+        659688, 665937, 672222, 678540, 684894, 691281, 697704, 704161, 710653,
+        717179, 723741, 730337, 736968, 743634, 750336, 757072,
+    },
+};
+
+/* END GENERATED PIXEL TABLES */
+
+/*
+ * The shift in a colour value of the channel which each pixel format stores
+ * in each byte, in memory order.
+ */
+static const uint8_t cpar_pixel_shifts[4][4] = {
+    {24, 16, 8, 0}, // CPAR_PIXEL_RGBA8
+    {8, 16, 24, 0}, // CPAR_PIXEL_BGRA8
+    {0, 24, 16, 8}, // CPAR_PIXEL_ARGB8
+    {0, 8, 16, 24}, // CPAR_PIXEL_ABGR8
+};
+
+/*
+ * SIMD kernels for the pixel conversions. The byte shuffles rearrange the
+ * bytes of each 32-bit element so that byte k of the result is byte
+ * order[k] of the input, which only makes sense on little-endian CPUs, as
+ * all of those with CPAR_HAVE_X86_SIMD or CPAR_HAVE_NEON are. Each kernel
+ * converts a multiple of its width and returns how many elements it did,
+ * leaving the rest to the portable code.
+ */
+#ifdef CPAR_HAVE_X86_SIMD
+
+__attribute__((target("ssse3"))) static __m128i
+cpar_shuffle_mask_ssse3(const uint8_t order[4])
+{
+  char mask[16];
+  for (size_t j = 0; j < 16; j++)
+    mask[j] = (char)((j & ~(size_t)3) + order[j & 3]);
+  return _mm_loadu_si128((const __m128i *)mask);
+}
+
+__attribute__((target("ssse3"))) static size_t
+cpar_shuffle_bytes_ssse3(uint32_t *data, size_t n, const uint8_t order[4])
+{
+  const __m128i mask = cpar_shuffle_mask_ssse3(order);
+  size_t i = 0;
+
+  for (; i + 4 <= n; i += 4) {
+    __m128i v = _mm_loadu_si128((const __m128i *)&data[i]);
+    _mm_storeu_si128((__m128i *)&data[i], _mm_shuffle_epi8(v, mask));
+  }
+  return i;
+}
+
+__attribute__((target("avx2"))) static size_t
+cpar_shuffle_bytes_avx2(uint32_t *data, size_t n, const uint8_t order[4])
+{
+  const __m256i mask =
+      _mm256_broadcastsi128_si256(cpar_shuffle_mask_ssse3(order));
+  size_t i = 0;
+
+  for (; i + 8 <= n; i += 8) {
+    __m256i v = _mm256_loadu_si256((const __m256i *)&data[i]);
+    _mm256_storeu_si256((__m256i *)&data[i], _mm256_shuffle_epi8(v, mask));
+  }
+  return i;
+}
+
+/*
+ * Premultiplies 16-bit channels, with each colour in 4 lanes starting with
+ * its alpha. The multiplier for the alpha lane itself is 255, which leaves
+ * it unchanged.
+ */
+__attribute__((target("avx2"))) static inline __m256i
+cpar_premultiply_lanes_avx2(__m256i x)
+{
+  __m256i a = _mm256_shufflehi_epi16(_mm256_shufflelo_epi16(x, 0), 0);
+  __m256i t;
+
+  a = _mm256_blend_epi16(a, _mm256_set1_epi16(255), 0x11);
+  t = _mm256_add_epi16(_mm256_mullo_epi16(x, a), _mm256_set1_epi16(128));
+  return _mm256_srli_epi16(_mm256_add_epi16(t, _mm256_srli_epi16(t, 8)), 8);
+}
+
+__attribute__((target("avx2"))) static size_t
+cpar_premultiply_avx2(uint32_t *colors, size_t n)
+{
+  const __m256i zero = _mm256_setzero_si256();
+  size_t i = 0;
+
+  for (; i + 8 <= n; i += 8) {
+    __m256i v = _mm256_loadu_si256((const __m256i *)&colors[i]);
+    __m256i lo = cpar_premultiply_lanes_avx2(_mm256_unpacklo_epi8(v, zero));
+    __m256i hi = cpar_premultiply_lanes_avx2(_mm256_unpackhi_epi8(v, zero));
+    _mm256_storeu_si256((__m256i *)&colors[i], _mm256_packus_epi16(lo, hi));
+  }
+  return i;
+}
+
+/*
+ * Divides the channel at @a shift in each colour of @a v by its alpha,
+ * like cpar_unpremultiply(). The numerators and alphas are exact as floats
+ * and a quotient which isn't an integer is at least 1/255 from the next
+ * one, far more than the division's rounding error, so truncating gives
+ * the same result as integer division.
+ */
+__attribute__((target("avx2"))) static inline __m256i
+cpar_unpremultiply_channel_avx2(__m256i v, __m256i a, __m256 a_float, int shift)
+{
+  __m256i c = _mm256_and_si256(_mm256_srlv_epi32(v, _mm256_set1_epi32(shift)),
+                               _mm256_set1_epi32(0xFF));
+  __m256i num = _mm256_add_epi32(_mm256_mullo_epi32(c, _mm256_set1_epi32(255)),
+                                 _mm256_srli_epi32(a, 1));
+  __m256i q = _mm256_cvttps_epi32(
+      _mm256_div_ps(_mm256_cvtepi32_ps(num), a_float));
+  return _mm256_sllv_epi32(_mm256_min_epu32(q, _mm256_set1_epi32(255)),
+                           _mm256_set1_epi32(shift));
+}
+
+__attribute__((target("avx2"))) static size_t
+cpar_unpremultiply_avx2(uint32_t *colors, size_t n)
+{
+  const __m256i alpha_mask = _mm256_set1_epi32(0xFF);
+  size_t i = 0;
+
+  for (; i + 8 <= n; i += 8) {
+    __m256i v = _mm256_loadu_si256((const __m256i *)&colors[i]);
+    __m256i a = _mm256_and_si256(v, alpha_mask);
+    // zero alphas are divided by one instead, and the result cleared
+    __m256 a_float = _mm256_max_ps(_mm256_cvtepi32_ps(a), _mm256_set1_ps(1));
+    __m256i rgb = _mm256_or_si256(
+        _mm256_or_si256(cpar_unpremultiply_channel_avx2(v, a, a_float, 24),
+                        cpar_unpremultiply_channel_avx2(v, a, a_float, 16)),
+        cpar_unpremultiply_channel_avx2(v, a, a_float, 8));
+    rgb = _mm256_andnot_si256(_mm256_cmpeq_epi32(a, _mm256_setzero_si256()),
+                              rgb);
+    _mm256_storeu_si256((__m256i *)&colors[i], _mm256_or_si256(rgb, a));
+  }
+  return i;
+}
+
+#endif // CPAR_HAVE_X86_SIMD
+
+#ifdef CPAR_HAVE_NEON
+
+static size_t
+cpar_shuffle_bytes_neon(uint32_t *data, size_t n, const uint8_t order[4])
+{
+  uint8_t indices[16];
+  uint8x16_t mask;
+  size_t i = 0;
+
+  for (size_t j = 0; j < 16; j++)
+    indices[j] = (uint8_t)((j & ~(size_t)3) + order[j & 3]);
+  mask = vld1q_u8(indices);
+
+  for (; i + 4 <= n; i += 4) {
+    uint8x16_t v = vld1q_u8((const uint8_t *)&data[i]);
+    vst1q_u8((uint8_t *)&data[i], vqtbl1q_u8(v, mask));
+  }
+  return i;
+}
+
+#endif // CPAR_HAVE_NEON
+
+#if defined(CPAR_HAVE_X86_SIMD) || defined(CPAR_HAVE_NEON)
+static size_t
+cpar_shuffle_bytes(uint32_t *data, size_t n, const uint8_t order[4])
+{
+#if defined(CPAR_HAVE_X86_SIMD)
+  if (__builtin_cpu_supports("avx2"))
+    return cpar_shuffle_bytes_avx2(data, n, order);
+  if (__builtin_cpu_supports("ssse3"))
+    return cpar_shuffle_bytes_ssse3(data, n, order);
+  return 0;
+#else
+  return cpar_shuffle_bytes_neon(data, n, order);
+#endif
+}
+#endif
+
+void cpar_pixels_from_colors(uint32_t *data,
+                             size_t n,
+                             enum cpar_pixel_format format)
+{
+  const uint8_t *shifts = NULL;
+  size_t i = 0;
+
+  if (!data || (unsigned)format > CPAR_PIXEL_ABGR8)
+    return;
+  shifts = cpar_pixel_shifts[format];
+
+#if defined(CPAR_HAVE_X86_SIMD) || defined(CPAR_HAVE_NEON)
+  {
+    // on a little-endian CPU, the channel with shift s is in byte s / 8
+    uint8_t order[4];
+    for (size_t k = 0; k < 4; k++)
+      order[k] = (uint8_t)(shifts[k] / 8);
+    i = cpar_shuffle_bytes(data, n, order);
+  }
+#endif
+
+  for (; i < n; i++) {
+    uint32_t value = data[i];
+    uint8_t *px = (uint8_t *)&data[i];
+    px[0] = (uint8_t)(value >> shifts[0]);
+    px[1] = (uint8_t)(value >> shifts[1]);
+    px[2] = (uint8_t)(value >> shifts[2]);
+    px[3] = (uint8_t)(value >> shifts[3]);
+  }
+}
+
+void cpar_pixels_to_colors(uint32_t *data,
+                           size_t n,
+                           enum cpar_pixel_format format)
+{
+  const uint8_t *shifts = NULL;
+  size_t i = 0;
+
+  if (!data || (unsigned)format > CPAR_PIXEL_ABGR8)
+    return;
+  shifts = cpar_pixel_shifts[format];
+
+#if defined(CPAR_HAVE_X86_SIMD) || defined(CPAR_HAVE_NEON)
+  {
+    uint8_t order[4];
+    for (size_t k = 0; k < 4; k++)
+      order[shifts[k] / 8] = (uint8_t)k;
+    i = cpar_shuffle_bytes(data, n, order);
+  }
+#endif
+
+  for (; i < n; i++) {
+    const uint8_t *px = (const uint8_t *)&data[i];
+    data[i] = ((uint32_t)px[0] << shifts[0]) | ((uint32_t)px[1] << shifts[1]) |
+              ((uint32_t)px[2] << shifts[2]) | ((uint32_t)px[3] << shifts[3]);
   }
-  errno = eno;
-  if (result)
-    *result = (uint8_t)value;
-  return CPAR_STATUS_OK;
 }
 
-static enum cpar_status cpar_parse_component_rgb(char *str, uint8_t *out)
+/* Exactly rounded c * a / 255, without a division. */
+static uint32_t cpar_mul_div255(uint32_t c, uint32_t a)
 {
-  int percent = 0;
-  size_t str_len = strlen(str);
-  char *ep = NULL;
-  long val = 0;
+  uint32_t t = c * a + 128;
+  return (t + (t >> 8)) >> 8;
+}
 
-  if (str[str_len - 1] == '%') {
-    percent = 1;
-    str[--str_len] = '\0';
+void cpar_colors_premultiply(uint32_t *colors, size_t n)
+{
+  size_t i = 0;
+
+  if (!colors)
+    return;
+
+#if defined(CPAR_HAVE_X86_SIMD)
+  if (__builtin_cpu_supports("avx2"))
+    i = cpar_premultiply_avx2(colors, n);
+#endif
+
+  for (; i < n; i++) {
+    uint32_t value = colors[i];
+    uint32_t a = CPAR_COLOR_ALPHA(value);
+    colors[i] = CPAR_COLOR_MAKE(cpar_mul_div255(CPAR_COLOR_RED(value), a),
+                                cpar_mul_div255(CPAR_COLOR_GREEN(value), a),
+                                cpar_mul_div255(CPAR_COLOR_BLUE(value), a),
+                                a);
   }
+}
 
-  errno = 0;
-  val = strtol(str, &ep, 10);
+/*
+ * Exactly rounded c * 255 / a, clamped to 255. The numerator is less than
+ * 65536, so multiplying by the table entry for a and shifting right by 24
+ * divides it exactly.
+ */
+static uint32_t cpar_unpremultiply(uint32_t c, uint32_t a)
+{
+  uint64_t x = (uint64_t)(c * 255 + a / 2) * cpar_unpremultiply_table[a];
+  uint32_t q = (uint32_t)(x >> 24);
+  return q > 255 ? 255 : q;
+}
 
-  if (errno != 0 || *ep != '\0') {
-    return CPAR_STATUS_INVALID_NUMBER;
-  } else if (val < 0 || val > 255) {
-    return CPAR_STATUS_NUMBER_RANGE;
+void cpar_colors_unpremultiply(uint32_t *colors, size_t n)
+{
+  size_t i = 0;
+
+  if (!colors)
+    return;
+
+#if defined(CPAR_HAVE_X86_SIMD)
+  if (__builtin_cpu_supports("avx2"))
+    i = cpar_unpremultiply_avx2(colors, n);
+#endif
+
+  for (; i < n; i++) {
+    uint32_t value = colors[i];
+    uint32_t a = CPAR_COLOR_ALPHA(value);
+    colors[i] = CPAR_COLOR_MAKE(cpar_unpremultiply(CPAR_COLOR_RED(value), a),
+                                cpar_unpremultiply(CPAR_COLOR_GREEN(value), a),
+                                cpar_unpremultiply(CPAR_COLOR_BLUE(value), a),
+                                a);
+  }
+}
+
+static void
+cpar_colors_apply_table(uint32_t *colors, size_t n, const uint8_t table[256])
+{
+  if (!colors)
+    return;
+
+  for (size_t i = 0; i < n; i++) {
+    uint32_t value = colors[i];
+    colors[i] = CPAR_COLOR_MAKE(table[CPAR_COLOR_RED(value)],
+                                table[CPAR_COLOR_GREEN(value)],
+                                table[CPAR_COLOR_BLUE(value)],
+                                CPAR_COLOR_ALPHA(value));
+  }
+}
+
+void cpar_colors_srgb_to_linear(uint32_t *colors, size_t n)
+{
+  cpar_colors_apply_table(colors, n, cpar_srgb_to_linear_table);
+}
+
+void cpar_colors_linear_to_srgb(uint32_t *colors, size_t n)
+{
+  cpar_colors_apply_table(colors, n, cpar_linear_to_srgb_table);
+}
+
+CPAR_FP_CONTRACT_OFF
+
+/*
+ * Colour space conversions. The sRGB encoding of a linear value is the
+ * number of midpoints between 8-bit values which are at most the value, so
+ * it's found exactly from the entry for its bucket, plus one if the value
+ * is at least the next midpoint, without evaluating the transfer function.
+ */
+
+static uint32_t cpar_linear_to_srgb8(float x)
+{
+  uint32_t b;
+
+  if (!(x > 0.0f))
+    return 0;
+  if (x >= 1.0f)
+    return 255;
+  b = cpar_linear_bucket_table[(int)(x * CPAR_LINEAR_BUCKETS)];
+  return b + (b < 255 && x >= cpar_srgb_midpoints[b]);
+}
+
+static float cpar_clamp_unit(float x)
+{
+  x = x > 0.0f ? x : 0.0f;
+  return x < 1.0f ? x : 1.0f;
+}
+
+/* An 8-bit value from @a x in [0, 1], rounded and clamped. */
+static uint32_t cpar_unit_to_8bit(float x)
+{
+  return (uint32_t)(cpar_clamp_unit(x) * 255.0f + 0.5f);
+}
+
+/*
+ * The hue in degrees of the RGB components @a r, @a g and @a b, whose
+ * largest is @a max and range is @a d. This and the other HSL and HSV
+ * helpers must match the constexpr ones in cpar::detail exactly.
+ */
+static float cpar_hue(int r, int g, int b, int max, int d)
+{
+  // selecting the operands rather than branching avoids mispredictions
+  int num = max == r ? g - b : max == g ? b - r : r - g;
+  float sector = max == r ? 0.0f : max == g ? 2.0f : 4.0f;
+  float h;
+
+  if (d == 0)
+    return 0.0f;
+  h = ((float)num / (float)d + sector) * 60.0f;
+  return h < 0.0f ? h + 360.0f : h;
+}
+
+/* Reduces a hue to [0, 360], treating NaNs and huge values as 0. */
+static float cpar_wrap_hue(float h)
+{
+  if (h >= 0.0f && h < 360.0f)
+    return h;
+  if (!(h > -1e9f && h < 1e9f))
+    return 0.0f;
+  h -= 360.0f * (float)(int64_t)(h / 360.0f);
+  return h < 0.0f ? h + 360.0f : h;
+}
+
+/*
+ * Channel @a n of an HSL colour, as in the CSS Color specification, with
+ * the hue @a h in units of 30 degrees.
+ */
+static float cpar_hsl_channel(float n, float h, float s, float l)
+{
+  float k = n + h;
+  float a = s * (l < 1.0f - l ? l : 1.0f - l);
+  float t;
+
+  if (k >= 12.0f)
+    k -= 12.0f;
+  t = k - 3.0f < 9.0f - k ? k - 3.0f : 9.0f - k;
+  t = t < 1.0f ? t : 1.0f;
+  t = t > -1.0f ? t : -1.0f;
+  return l - a * t;
+}
+
+/* Likewise for HSV, with the hue in units of 60 degrees. */
+static float cpar_hsv_channel(float n, float h, float s, float v)
+{
+  float k = n + h;
+  float t;
+
+  if (k >= 6.0f)
+    k -= 6.0f;
+  t = k < 4.0f - k ? k : 4.0f - k;
+  t = t < 1.0f ? t : 1.0f;
+  t = t > 0.0f ? t : 0.0f;
+  return v - v * s * t;
+}
+
+static inline void
+cpar_color_to_space(uint32_t value, enum cpar_color_space space, float out[4])
+{
+  int r = CPAR_COLOR_RED(value);
+  int g = CPAR_COLOR_GREEN(value);
+  int b = CPAR_COLOR_BLUE(value);
+  int max = r > g ? (r > b ? r : b) : (g > b ? g : b);
+  int min = r < g ? (r < b ? r : b) : (g < b ? g : b);
+  int d = max - min;
+  int sum = max + min;
+
+  switch (space) {
+  case CPAR_SPACE_LINEAR_SRGB:
+    out[0] = cpar_srgb_to_linear_float[r];
+    out[1] = cpar_srgb_to_linear_float[g];
+    out[2] = cpar_srgb_to_linear_float[b];
+    break;
+  case CPAR_SPACE_HSL:
+    out[0] = cpar_hue(r, g, b, max, d);
+    out[1] = d == 0 ? 0.0f
+                    : (float)d / (float)(255 - (sum > 255 ? sum - 255
+                                                          : 255 - sum));
+    out[2] = (float)sum / 510.0f;
+    break;
+  case CPAR_SPACE_HSV:
+    out[0] = cpar_hue(r, g, b, max, d);
+    out[1] = max == 0 ? 0.0f : (float)d / (float)max;
+    out[2] = (float)max / 255.0f;
+    break;
+  case CPAR_SPACE_OKLAB:
+    cpar_oklab_from_rgb(value, out);
+    break;
   }
+  out[3] = (float)CPAR_COLOR_ALPHA(value) * (1.0f / 255.0f);
+}
 
-  if (out) {
-    if (percent) {
-      *out = (uint8_t)(((float)val / 100.0) * 255.0);
+static inline uint32_t
+cpar_color_from_space(const float in[4], enum cpar_color_space space)
+{
+  float rgb[3] = {0.0f, 0.0f, 0.0f};
+  float h, s, x;
+  float l, m;
+
+  switch (space) {
+  case CPAR_SPACE_LINEAR_SRGB:
+    return CPAR_COLOR_MAKE(cpar_linear_to_srgb8(in[0]),
+                           cpar_linear_to_srgb8(in[1]),
+                           cpar_linear_to_srgb8(in[2]),
+                           cpar_unit_to_8bit(in[3]));
+  case CPAR_SPACE_HSL:
+  case CPAR_SPACE_HSV:
+    h = cpar_wrap_hue(in[0]);
+    s = cpar_clamp_unit(in[1]);
+    x = cpar_clamp_unit(in[2]);
+    if (space == CPAR_SPACE_HSL) {
+      h /= 30.0f;
+      rgb[0] = cpar_hsl_channel(0.0f, h, s, x);
+      rgb[1] = cpar_hsl_channel(8.0f, h, s, x);
+      rgb[2] = cpar_hsl_channel(4.0f, h, s, x);
     } else {
-      *out = (uint8_t)val;
+      h /= 60.0f;
+      rgb[0] = cpar_hsv_channel(5.0f, h, s, x);
+      rgb[1] = cpar_hsv_channel(3.0f, h, s, x);
+      rgb[2] = cpar_hsv_channel(1.0f, h, s, x);
     }
+    return CPAR_COLOR_MAKE(cpar_unit_to_8bit(rgb[0]),
+                           cpar_unit_to_8bit(rgb[1]),
+                           cpar_unit_to_8bit(rgb[2]),
+                           cpar_unit_to_8bit(in[3]));
+  case CPAR_SPACE_OKLAB:
+    l = in[0] + 0.3963377774f * in[1] + 0.2158037573f * in[2];
+    m = in[0] - 0.1055613458f * in[1] - 0.0638541728f * in[2];
+    s = in[0] - 0.0894841775f * in[1] - 1.2914855480f * in[2];
+    l = l * l * l;
+    m = m * m * m;
+    s = s * s * s;
+    rgb[0] = 4.0767416621f * l - 3.3077115913f * m + 0.2309699292f * s;
+    rgb[1] = -1.2684380046f * l + 2.6097574011f * m - 0.3413193965f * s;
+    rgb[2] = -0.0041960863f * l - 0.7034186147f * m + 1.7076147010f * s;
+    return CPAR_COLOR_MAKE(cpar_linear_to_srgb8(rgb[0]),
+                           cpar_linear_to_srgb8(rgb[1]),
+                           cpar_linear_to_srgb8(rgb[2]),
+                           cpar_unit_to_8bit(in[3]));
   }
+  return 0;
+}
 
-  return CPAR_STATUS_OK;
+#ifdef CPAR_HAVE_X86_SIMD
+
+/*
+ * AVX2 kernels for linear light and OKLab, with the red, green, blue and
+ * alpha of 8 colours in 4 vectors. They do the same operations in the same
+ * order as the scalar code, so give exactly the same results.
+ */
+
+/* Transposes the 4x4 block in each half of @a v. */
+__attribute__((target("avx2"))) static inline void
+cpar_transpose4_avx2(__m256 v[4])
+{
+  __m256 t0 = _mm256_unpacklo_ps(v[0], v[1]);
+  __m256 t1 = _mm256_unpackhi_ps(v[0], v[1]);
+  __m256 t2 = _mm256_unpacklo_ps(v[2], v[3]);
+  __m256 t3 = _mm256_unpackhi_ps(v[2], v[3]);
+
+  v[0] = _mm256_castpd_ps(
+      _mm256_unpacklo_pd(_mm256_castps_pd(t0), _mm256_castps_pd(t2)));
+  v[1] = _mm256_castpd_ps(
+      _mm256_unpackhi_pd(_mm256_castps_pd(t0), _mm256_castps_pd(t2)));
+  v[2] = _mm256_castpd_ps(
+      _mm256_unpacklo_pd(_mm256_castps_pd(t1), _mm256_castps_pd(t3)));
+  v[3] = _mm256_castpd_ps(
+      _mm256_unpackhi_pd(_mm256_castps_pd(t1), _mm256_castps_pd(t3)));
 }
 
-static enum cpar_status cpar_parse_component_a(char *str, uint8_t *out)
+/* Loads 8 colours of 4 floats, one channel per vector. */
+__attribute__((target("avx2"))) static inline void
+cpar_load_channels_avx2(const float *in, __m256 v[4])
 {
-  int e = errno;
-  char *ep = NULL;
-  float val = 0.0f;
+  __m256 c01 = _mm256_loadu_ps(in);
+  __m256 c23 = _mm256_loadu_ps(in + 8);
+  __m256 c45 = _mm256_loadu_ps(in + 16);
+  __m256 c67 = _mm256_loadu_ps(in + 24);
 
-  errno = 0;
-  val = strtof(str, &ep);
+  // each half holds the colours that end up in the same half
+  v[0] = _mm256_permute2f128_ps(c01, c45, 0x20);
+  v[1] = _mm256_permute2f128_ps(c01, c45, 0x31);
+  v[2] = _mm256_permute2f128_ps(c23, c67, 0x20);
+  v[3] = _mm256_permute2f128_ps(c23, c67, 0x31);
+  cpar_transpose4_avx2(v);
+}
 
-  if (errno != 0 || *ep != '\0') {
-    return CPAR_STATUS_INVALID_NUMBER;
-  } else if (val < 0.0f || val > 1.0f) {
-    return CPAR_STATUS_NUMBER_RANGE;
+/* Stores one channel per vector as 8 colours of 4 floats. */
+__attribute__((target("avx2"))) static inline void
+cpar_store_channels_avx2(float *out, __m256 v[4])
+{
+  cpar_transpose4_avx2(v);
+  _mm256_storeu_ps(out, _mm256_permute2f128_ps(v[0], v[1], 0x20));
+  _mm256_storeu_ps(out + 8, _mm256_permute2f128_ps(v[2], v[3], 0x20));
+  _mm256_storeu_ps(out + 16, _mm256_permute2f128_ps(v[0], v[1], 0x31));
+  _mm256_storeu_ps(out + 24, _mm256_permute2f128_ps(v[2], v[3], 0x31));
+}
+
+/* @a a * x + @a b * y + @a c * z, in that order. */
+__attribute__((target("avx2"))) static inline __m256
+cpar_dot3_avx2(float a, __m256 x, float b, __m256 y, float c, __m256 z)
+{
+  return _mm256_add_ps(
+      _mm256_add_ps(_mm256_mul_ps(_mm256_set1_ps(a), x),
+                    _mm256_mul_ps(_mm256_set1_ps(b), y)),
+      _mm256_mul_ps(_mm256_set1_ps(c), z));
+}
+
+/* Like cpar_cbrtf(), dividing the bits by 3 with a multiply. */
+__attribute__((target("avx2"))) static inline __m256 cpar_cbrt_avx2(__m256 x)
+{
+  const __m256i third = _mm256_set1_epi32((int)0xAAAAAAABu);
+  const __m256 two = _mm256_set1_ps(2.0f);
+  __m256i i = _mm256_castps_si256(x);
+  __m256i even = _mm256_srli_epi64(_mm256_mul_epu32(i, third), 33);
+  __m256i odd = _mm256_srli_epi64(
+      _mm256_mul_epu32(_mm256_srli_epi64(i, 32), third), 33);
+  __m256 y = _mm256_castsi256_ps(_mm256_add_epi32(
+      _mm256_blend_epi32(even, _mm256_slli_epi64(odd, 32), 0xAA),
+      _mm256_set1_epi32(0x2A5137A0)));
+
+  for (int k = 0; k < 2; k++) {
+    __m256 y3 = _mm256_mul_ps(_mm256_mul_ps(y, y), y);
+    __m256 y3_2 = _mm256_mul_ps(_mm256_mul_ps(_mm256_mul_ps(two, y), y), y);
+    y = _mm256_div_ps(
+        _mm256_mul_ps(y, _mm256_add_ps(y3, _mm256_mul_ps(two, x))),
+        _mm256_add_ps(y3_2, x));
   }
+  return _mm256_andnot_ps(
+      _mm256_cmp_ps(x, _mm256_setzero_ps(), _CMP_LE_OQ), y);
+}
 
-  errno = e;
+__attribute__((target("avx2"))) static size_t
+cpar_colors_to_space_avx2(const uint32_t *colors,
+                          size_t n,
+                          enum cpar_color_space space,
+                          float *out)
+{
+  const __m256i mask = _mm256_set1_epi32(0xFF);
+  size_t i = 0;
 
-  if (out)
-    *out = val * 255.0f;
+  for (; i + 8 <= n; i += 8) {
+    __m256i v = _mm256_loadu_si256((const __m256i *)&colors[i]);
+    __m256 c[4];
+    c[0] = _mm256_i32gather_ps(
+        cpar_srgb_to_linear_float, _mm256_srli_epi32(v, 24), 4);
+    c[1] = _mm256_i32gather_ps(cpar_srgb_to_linear_float,
+                               _mm256_and_si256(_mm256_srli_epi32(v, 16), mask),
+                               4);
+    c[2] = _mm256_i32gather_ps(cpar_srgb_to_linear_float,
+                               _mm256_and_si256(_mm256_srli_epi32(v, 8), mask),
+                               4);
+    c[3] = _mm256_mul_ps(_mm256_cvtepi32_ps(_mm256_and_si256(v, mask)),
+                         _mm256_set1_ps(1.0f / 255.0f));
+    if (space == CPAR_SPACE_OKLAB) {
+      __m256 l = cpar_cbrt_avx2(cpar_dot3_avx2(
+          0.4122214708f, c[0], 0.5363325363f, c[1], 0.0514459929f, c[2]));
+      __m256 m = cpar_cbrt_avx2(cpar_dot3_avx2(
+          0.2119034982f, c[0], 0.6806995451f, c[1], 0.1073969566f, c[2]));
+      __m256 s = cpar_cbrt_avx2(cpar_dot3_avx2(
+          0.0883024619f, c[0], 0.2817188376f, c[1], 0.6299787005f, c[2]));
+      c[0] = _mm256_sub_ps(
+          _mm256_add_ps(_mm256_mul_ps(_mm256_set1_ps(0.2104542553f), l),
+                        _mm256_mul_ps(_mm256_set1_ps(0.7936177850f), m)),
+          _mm256_mul_ps(_mm256_set1_ps(0.0040720468f), s));
+      c[1] = _mm256_add_ps(
+          _mm256_sub_ps(_mm256_mul_ps(_mm256_set1_ps(1.9779984951f), l),
+                        _mm256_mul_ps(_mm256_set1_ps(2.4285922050f), m)),
+          _mm256_mul_ps(_mm256_set1_ps(0.4505937099f), s));
+      c[2] = _mm256_sub_ps(
+          _mm256_add_ps(_mm256_mul_ps(_mm256_set1_ps(0.0259040371f), l),
+                        _mm256_mul_ps(_mm256_set1_ps(0.7827717662f), m)),
+          _mm256_mul_ps(_mm256_set1_ps(0.8086757660f), s));
+    }
+    cpar_store_channels_avx2(&out[4 * i], c);
+  }
+  return i;
+}
 
-  return CPAR_STATUS_OK;
+/* Like cpar_linear_to_srgb8(), reading 4 bytes of the bucket table. */
+__attribute__((target("avx2"))) static inline __m256i
+cpar_linear_to_srgb8_avx2(__m256 x)
+{
+  const __m256i n_midpoints = _mm256_set1_epi32(255);
+  __m256i bucket, b, up;
+  __m256 mid;
+
+  // the maximum gives 0 for NaNs
+  x = _mm256_min_ps(_mm256_max_ps(x, _mm256_setzero_ps()),
+                    _mm256_set1_ps(1.0f));
+  bucket = _mm256_cvttps_epi32(
+      _mm256_mul_ps(x, _mm256_set1_ps((float)CPAR_LINEAR_BUCKETS)));
+  bucket = _mm256_min_epi32(bucket, _mm256_set1_epi32(CPAR_LINEAR_BUCKETS - 1));
+  b = _mm256_and_si256(
+      _mm256_i32gather_epi32(
+          (const int *)(const void *)cpar_linear_bucket_table, bucket, 1),
+      _mm256_set1_epi32(0xFF));
+  mid = _mm256_i32gather_ps(
+      cpar_srgb_midpoints, _mm256_min_epi32(b, _mm256_set1_epi32(254)), 4);
+  up = _mm256_and_si256(_mm256_castps_si256(_mm256_cmp_ps(x, mid, _CMP_GE_OQ)),
+                        _mm256_cmpgt_epi32(n_midpoints, b));
+  return _mm256_sub_epi32(b, up);
 }
 
-static enum cpar_status cpar_parse_comma_components(char *str,
-                                                    int n_comp,
-                                                    uint8_t *rout,
-                                                    uint8_t *gout,
-                                                    uint8_t *bout,
-                                                    uint8_t *aout)
+__attribute__((target("avx2"))) static size_t
+cpar_colors_from_space_avx2(const float *in,
+                            size_t n,
+                            enum cpar_color_space space,
+                            uint32_t *colors)
 {
-  int i = 0;
-  char *tok = strtok(str, ",");
-  enum cpar_status status = CPAR_STATUS_OK;
+  size_t i = 0;
 
-  while (tok && i < n_comp) {
-    if (i == 0) { // R
-      if ((status = cpar_parse_component_rgb(tok, rout)) != CPAR_STATUS_OK)
-        return status;
-    } else if (i == 1) { // G
-      if ((status = cpar_parse_component_rgb(tok, gout)) != CPAR_STATUS_OK)
-        return status;
-    } else if (i == 2) { // B
-      if ((status = cpar_parse_component_rgb(tok, bout)) != CPAR_STATUS_OK)
-        return status;
-    } else if (i == 3) { // A
-      if ((status = cpar_parse_component_a(tok, aout)) != CPAR_STATUS_OK)
-        return status;
+  for (; i + 8 <= n; i += 8) {
+    __m256 c[4];
+    __m256 a;
+    __m256i rgba;
+    cpar_load_channels_avx2(&in[4 * i], c);
+    if (space == CPAR_SPACE_OKLAB) {
+      __m256 l = cpar_dot3_avx2(1.0f, c[0], 0.3963377774f, c[1],
+                                0.2158037573f, c[2]);
+      __m256 m = _mm256_sub_ps(
+          c[0], _mm256_mul_ps(_mm256_set1_ps(0.1055613458f), c[1]));
+      __m256 s = _mm256_sub_ps(
+          c[0], _mm256_mul_ps(_mm256_set1_ps(0.0894841775f), c[1]));
+      m = _mm256_sub_ps(m, _mm256_mul_ps(_mm256_set1_ps(0.0638541728f), c[2]));
+      s = _mm256_sub_ps(s, _mm256_mul_ps(_mm256_set1_ps(1.2914855480f), c[2]));
+      l = _mm256_mul_ps(_mm256_mul_ps(l, l), l);
+      m = _mm256_mul_ps(_mm256_mul_ps(m, m), m);
+      s = _mm256_mul_ps(_mm256_mul_ps(s, s), s);
+      c[0] = _mm256_add_ps(
+          _mm256_sub_ps(_mm256_mul_ps(_mm256_set1_ps(4.0767416621f), l),
+                        _mm256_mul_ps(_mm256_set1_ps(3.3077115913f), m)),
+          _mm256_mul_ps(_mm256_set1_ps(0.2309699292f), s));
+      c[1] = _mm256_sub_ps(
+          _mm256_add_ps(_mm256_mul_ps(_mm256_set1_ps(-1.2684380046f), l),
+                        _mm256_mul_ps(_mm256_set1_ps(2.6097574011f), m)),
+          _mm256_mul_ps(_mm256_set1_ps(0.3413193965f), s));
+      c[2] = _mm256_add_ps(
+          _mm256_sub_ps(_mm256_mul_ps(_mm256_set1_ps(-0.0041960863f), l),
+                        _mm256_mul_ps(_mm256_set1_ps(0.7034186147f), m)),
+          _mm256_mul_ps(_mm256_set1_ps(1.7076147010f), s));
     }
-    i++;
-    tok = strtok(NULL, ",");
+    a = _mm256_min_ps(_mm256_max_ps(c[3], _mm256_setzero_ps()),
+                      _mm256_set1_ps(1.0f));
+    rgba = _mm256_or_si256(
+        _mm256_or_si256(_mm256_slli_epi32(cpar_linear_to_srgb8_avx2(c[0]), 24),
+                        _mm256_slli_epi32(cpar_linear_to_srgb8_avx2(c[1]), 16)),
+        _mm256_or_si256(
+            _mm256_slli_epi32(cpar_linear_to_srgb8_avx2(c[2]), 8),
+            _mm256_cvttps_epi32(_mm256_add_ps(
+                _mm256_mul_ps(a, _mm256_set1_ps(255.0f)),
+                _mm256_set1_ps(0.5f)))));
+    _mm256_storeu_si256((__m256i *)&colors[i], rgba);
   }
+  return i;
+}
 
-  if (i != n_comp)
-    return CPAR_STATUS_SYNTAX_ERROR;
+#endif // CPAR_HAVE_X86_SIMD
 
-  return CPAR_STATUS_OK;
+void cpar_colors_to_space(const uint32_t *colors,
+                          size_t n,
+                          enum cpar_color_space space,
+                          float *out)
+{
+  size_t i = 0;
+
+  if (!colors || !out || (unsigned)space > CPAR_SPACE_OKLAB)
+    return;
+
+#if defined(CPAR_HAVE_X86_SIMD)
+  if ((space == CPAR_SPACE_LINEAR_SRGB || space == CPAR_SPACE_OKLAB) &&
+      __builtin_cpu_supports("avx2"))
+    i = cpar_colors_to_space_avx2(colors, n, space, out);
+#endif
+
+  // a loop for each space, so each inlines its own conversion
+  switch (space) {
+  case CPAR_SPACE_LINEAR_SRGB:
+    for (; i < n; i++)
+      cpar_color_to_space(colors[i], CPAR_SPACE_LINEAR_SRGB, &out[4 * i]);
+    break;
+  case CPAR_SPACE_HSL:
+    for (; i < n; i++)
+      cpar_color_to_space(colors[i], CPAR_SPACE_HSL, &out[4 * i]);
+    break;
+  case CPAR_SPACE_HSV:
+    for (; i < n; i++)
+      cpar_color_to_space(colors[i], CPAR_SPACE_HSV, &out[4 * i]);
+    break;
+  case CPAR_SPACE_OKLAB:
+    for (; i < n; i++)
+      cpar_color_to_space(colors[i], CPAR_SPACE_OKLAB, &out[4 * i]);
+    break;
+  }
 }
 
-static const struct cpar_color_name_info {
-  const char *name;
-  uint32_t value;
-} cpar_color_name_table[] = {
-    {"black", CPAR_COLOR_MAKE(0, 0, 0, 255)},
-    {"silver", CPAR_COLOR_MAKE(192, 192, 192, 255)},
-    {"gray", CPAR_COLOR_MAKE(128, 128, 128, 255)},
-    {"white", CPAR_COLOR_MAKE(255, 255, 255, 255)},
-    {"maroon", CPAR_COLOR_MAKE(128, 0, 0, 255)},
-    {"red", CPAR_COLOR_MAKE(255, 0, 0, 255)},
-    {"purple", CPAR_COLOR_MAKE(128, 0, 128, 255)},
-    {"fuchsia", CPAR_COLOR_MAKE(255, 0, 255, 255)},
-    {"green", CPAR_COLOR_MAKE(0, 128, 0, 255)},
-    {"lime", CPAR_COLOR_MAKE(0, 255, 0, 255)},
-    {"olive", CPAR_COLOR_MAKE(128, 128, 0, 255)},
-    {"yellow", CPAR_COLOR_MAKE(255, 255, 0, 255)},
-    {"navy", CPAR_COLOR_MAKE(0, 0, 128, 255)},
-    {"blue", CPAR_COLOR_MAKE(0, 0, 255, 255)},
-    {"teal", CPAR_COLOR_MAKE(0, 128, 128, 255)},
-    {"aqua", CPAR_COLOR_MAKE(0, 255, 255, 255)},
-    {"aliceblue", CPAR_COLOR_MAKE(240, 248, 255, 255)},
-    {"antiquewhite", CPAR_COLOR_MAKE(250, 235, 215, 255)},
-    {"aqua", CPAR_COLOR_MAKE(0, 255, 255, 255)},
-    {"aquamarine", CPAR_COLOR_MAKE(127, 255, 212, 255)},
-    {"azure", CPAR_COLOR_MAKE(240, 255, 255, 255)},
-    {"beige", CPAR_COLOR_MAKE(245, 245, 220, 255)},
-    {"bisque", CPAR_COLOR_MAKE(255, 228, 196, 255)},
-    {"black", CPAR_COLOR_MAKE(0, 0, 0, 255)},
-    {"blanchedalmond", CPAR_COLOR_MAKE(255, 235, 205, 255)},
-    {"blue", CPAR_COLOR_MAKE(0, 0, 255, 255)},
-    {"blueviolet", CPAR_COLOR_MAKE(138, 43, 226, 255)},
-    {"brown", CPAR_COLOR_MAKE(165, 42, 42, 255)},
-    {"burlywood", CPAR_COLOR_MAKE(222, 184, 135, 255)},
-    {"cadetblue", CPAR_COLOR_MAKE(95, 158, 160, 255)},
-    {"chartreuse", CPAR_COLOR_MAKE(127, 255, 0, 255)},
-    {"chocolate", CPAR_COLOR_MAKE(210, 105, 30, 255)},
-    {"coral", CPAR_COLOR_MAKE(255, 127, 80, 255)},
-    {"cornflowerblue", CPAR_COLOR_MAKE(100, 149, 237, 255)},
-    {"cornsilk", CPAR_COLOR_MAKE(255, 248, 220, 255)},
-    {"crimson", CPAR_COLOR_MAKE(220, 20, 60, 255)},
-    {"cyan", CPAR_COLOR_MAKE(0, 255, 255, 255)},
-    {"darkblue", CPAR_COLOR_MAKE(0, 0, 139, 255)},
-    {"darkcyan", CPAR_COLOR_MAKE(0, 139, 139, 255)},
-    {"darkgoldenrod", CPAR_COLOR_MAKE(184, 134, 11, 255)},
-    {"darkgray", CPAR_COLOR_MAKE(169, 169, 169, 255)},
-    {"darkgreen", CPAR_COLOR_MAKE(0, 100, 0, 255)},
-    {"darkgrey", CPAR_COLOR_MAKE(169, 169, 169, 255)},
-    {"darkkhaki", CPAR_COLOR_MAKE(189, 183, 107, 255)},
-    {"darkmagenta", CPAR_COLOR_MAKE(139, 0, 139, 255)},
-    {"darkolivegreen", CPAR_COLOR_MAKE(85, 107, 47, 255)},
-    {"darkorange", CPAR_COLOR_MAKE(255, 140, 0, 255)},
-    {"darkorchid", CPAR_COLOR_MAKE(153, 50, 204, 255)},
-    {"darkred", CPAR_COLOR_MAKE(139, 0, 0, 255)},
-    {"darksalmon", CPAR_COLOR_MAKE(233, 150, 122, 255)},
-    {"darkseagreen", CPAR_COLOR_MAKE(143, 188, 143, 255)},
-    {"darkslateblue", CPAR_COLOR_MAKE(72, 61, 139, 255)},
-    {"darkslategray", CPAR_COLOR_MAKE(47, 79, 79, 255)},
-    {"darkslategrey", CPAR_COLOR_MAKE(47, 79, 79, 255)},
-    {"darkturquoise", CPAR_COLOR_MAKE(0, 206, 209, 255)},
-    {"darkviolet", CPAR_COLOR_MAKE(148, 0, 211, 255)},
-    {"deeppink", CPAR_COLOR_MAKE(255, 20, 147, 255)},
-    {"deepskyblue", CPAR_COLOR_MAKE(0, 191, 255, 255)},
-    {"dimgray", CPAR_COLOR_MAKE(105, 105, 105, 255)},
-    {"dimgrey", CPAR_COLOR_MAKE(105, 105, 105, 255)},
-    {"dodgerblue", CPAR_COLOR_MAKE(30, 144, 255, 255)},
-    {"firebrick", CPAR_COLOR_MAKE(178, 34, 34, 255)},
-    {"floralwhite", CPAR_COLOR_MAKE(255, 250, 240, 255)},
-    {"forestgreen", CPAR_COLOR_MAKE(34, 139, 34, 255)},
-    {"fuchsia", CPAR_COLOR_MAKE(255, 0, 255, 255)},
-    {"gainsboro", CPAR_COLOR_MAKE(220, 220, 220, 255)},
-    {"ghostwhite", CPAR_COLOR_MAKE(248, 248, 255, 255)},
-    {"gold", CPAR_COLOR_MAKE(255, 215, 0, 255)},
-    {"goldenrod", CPAR_COLOR_MAKE(218, 165, 32, 255)},
-    {"gray", CPAR_COLOR_MAKE(128, 128, 128, 255)},
-    {"green", CPAR_COLOR_MAKE(0, 128, 0, 255)},
-    {"greenyellow", CPAR_COLOR_MAKE(173, 255, 47, 255)},
-    {"grey", CPAR_COLOR_MAKE(128, 128, 128, 255)},
-    {"honeydew", CPAR_COLOR_MAKE(240, 255, 240, 255)},
-    {"hotpink", CPAR_COLOR_MAKE(255, 105, 180, 255)},
-    {"indianred", CPAR_COLOR_MAKE(205, 92, 92, 255)},
-    {"indigo", CPAR_COLOR_MAKE(75, 0, 130, 255)},
-    {"ivory", CPAR_COLOR_MAKE(255, 255, 240, 255)},
-    {"khaki", CPAR_COLOR_MAKE(240, 230, 140, 255)},
-    {"lavender", CPAR_COLOR_MAKE(230, 230, 250, 255)},
-    {"lavenderblush", CPAR_COLOR_MAKE(255, 240, 245, 255)},
-    {"lawngreen", CPAR_COLOR_MAKE(124, 252, 0, 255)},
-    {"lemonchiffon", CPAR_COLOR_MAKE(255, 250, 205, 255)},
-    {"lightblue", CPAR_COLOR_MAKE(173, 216, 230, 255)},
-    {"lightcoral", CPAR_COLOR_MAKE(240, 128, 128, 255)},
-    {"lightcyan", CPAR_COLOR_MAKE(224, 255, 255, 255)},
-    {"lightgoldenrodyellow", CPAR_COLOR_MAKE(250, 250, 210, 255)},
-    {"lightgray", CPAR_COLOR_MAKE(211, 211, 211, 255)},
-    {"lightgreen", CPAR_COLOR_MAKE(144, 238, 144, 255)},
-    {"lightgrey", CPAR_COLOR_MAKE(211, 211, 211, 255)},
-    {"lightpink", CPAR_COLOR_MAKE(255, 182, 193, 255)},
-    {"lightsalmon", CPAR_COLOR_MAKE(255, 160, 122, 255)},
-    {"lightseagreen", CPAR_COLOR_MAKE(32, 178, 170, 255)},
-    {"lightskyblue", CPAR_COLOR_MAKE(135, 206, 250, 255)},
-    {"lightslategray", CPAR_COLOR_MAKE(119, 136, 153, 255)},
-    {"lightslategrey", CPAR_COLOR_MAKE(119, 136, 153, 255)},
-    {"lightsteelblue", CPAR_COLOR_MAKE(176, 196, 222, 255)},
-    {"lightyellow", CPAR_COLOR_MAKE(255, 255, 224, 255)},
-    {"lime", CPAR_COLOR_MAKE(0, 255, 0, 255)},
-    {"limegreen", CPAR_COLOR_MAKE(50, 205, 50, 255)},
-    {"linen", CPAR_COLOR_MAKE(250, 240, 230, 255)},
-    {"magenta", CPAR_COLOR_MAKE(255, 0, 255, 255)},
-    {"maroon", CPAR_COLOR_MAKE(128, 0, 0, 255)},
-    {"mediumaquamarine", CPAR_COLOR_MAKE(102, 205, 170, 255)},
-    {"mediumblue", CPAR_COLOR_MAKE(0, 0, 205, 255)},
-    {"mediumorchid", CPAR_COLOR_MAKE(186, 85, 211, 255)},
-    {"mediumpurple", CPAR_COLOR_MAKE(147, 112, 219, 255)},
-    {"mediumseagreen", CPAR_COLOR_MAKE(60, 179, 113, 255)},
-    {"mediumslateblue", CPAR_COLOR_MAKE(123, 104, 238, 255)},
-    {"mediumspringgreen", CPAR_COLOR_MAKE(0, 250, 154, 255)},
-    {"mediumturquoise", CPAR_COLOR_MAKE(72, 209, 204, 255)},
-    {"mediumvioletred", CPAR_COLOR_MAKE(199, 21, 133, 255)},
-    {"midnightblue", CPAR_COLOR_MAKE(25, 25, 112, 255)},
-    {"mintcream", CPAR_COLOR_MAKE(245, 255, 250, 255)},
-    {"mistyrose", CPAR_COLOR_MAKE(255, 228, 225, 255)},
-    {"moccasin", CPAR_COLOR_MAKE(255, 228, 181, 255)},
-    {"navajowhite", CPAR_COLOR_MAKE(255, 222, 173, 255)},
-    {"navy", CPAR_COLOR_MAKE(0, 0, 128, 255)},
-    {"oldlace", CPAR_COLOR_MAKE(253, 245, 230, 255)},
-    {"olive", CPAR_COLOR_MAKE(128, 128, 0, 255)},
-    {"olivedrab", CPAR_COLOR_MAKE(107, 142, 35, 255)},
-    {"orange", CPAR_COLOR_MAKE(255, 165, 0, 255)},
-    {"orangered", CPAR_COLOR_MAKE(255, 69, 0, 255)},
-    {"orchid", CPAR_COLOR_MAKE(218, 112, 214, 255)},
-    {"palegoldenrod", CPAR_COLOR_MAKE(238, 232, 170, 255)},
-    {"palegreen", CPAR_COLOR_MAKE(152, 251, 152, 255)},
-    {"paleturquoise", CPAR_COLOR_MAKE(175, 238, 238, 255)},
-    {"palevioletred", CPAR_COLOR_MAKE(219, 112, 147, 255)},
-    {"papayawhip", CPAR_COLOR_MAKE(255, 239, 213, 255)},
-    {"peachpuff", CPAR_COLOR_MAKE(255, 218, 185, 255)},
-    {"peru", CPAR_COLOR_MAKE(205, 133, 63, 255)},
-    {"pink", CPAR_COLOR_MAKE(255, 192, 203, 255)},
-    {"plum", CPAR_COLOR_MAKE(221, 160, 221, 255)},
-    {"powderblue", CPAR_COLOR_MAKE(176, 224, 230, 255)},
-    {"purple", CPAR_COLOR_MAKE(128, 0, 128, 255)},
-    {"red", CPAR_COLOR_MAKE(255, 0, 0, 255)},
-    {"rosybrown", CPAR_COLOR_MAKE(188, 143, 143, 255)},
-    {"royalblue", CPAR_COLOR_MAKE(65, 105, 225, 255)},
-    {"saddlebrown", CPAR_COLOR_MAKE(139, 69, 19, 255)},
-    {"salmon", CPAR_COLOR_MAKE(250, 128, 114, 255)},
-    {"sandybrown", CPAR_COLOR_MAKE(244, 164, 96, 255)},
-    {"seagreen", CPAR_COLOR_MAKE(46, 139, 87, 255)},
-    {"seashell", CPAR_COLOR_MAKE(255, 245, 238, 255)},
-    {"sienna", CPAR_COLOR_MAKE(160, 82, 45, 255)},
-    {"silver", CPAR_COLOR_MAKE(192, 192, 192, 255)},
-    {"skyblue", CPAR_COLOR_MAKE(135, 206, 235, 255)},
-    {"slateblue", CPAR_COLOR_MAKE(106, 90, 205, 255)},
-    {"slategray", CPAR_COLOR_MAKE(112, 128, 144, 255)},
-    {"slategrey", CPAR_COLOR_MAKE(112, 128, 144, 255)},
-    {"snow", CPAR_COLOR_MAKE(255, 250, 250, 255)},
-    {"springgreen", CPAR_COLOR_MAKE(0, 255, 127, 255)},
-    {"steelblue", CPAR_COLOR_MAKE(70, 130, 180, 255)},
-    {"tan", CPAR_COLOR_MAKE(210, 180, 140, 255)},
-    {"teal", CPAR_COLOR_MAKE(0, 128, 128, 255)},
-    {"thistle", CPAR_COLOR_MAKE(216, 191, 216, 255)},
-    {"tomato", CPAR_COLOR_MAKE(255, 99, 71, 255)},
-    {"turquoise", CPAR_COLOR_MAKE(64, 224, 208, 255)},
-    {"violet", CPAR_COLOR_MAKE(238, 130, 238, 255)},
-    {"wheat", CPAR_COLOR_MAKE(245, 222, 179, 255)},
-    {"white", CPAR_COLOR_MAKE(255, 255, 255, 255)},
-    {"whitesmoke", CPAR_COLOR_MAKE(245, 245, 245, 255)},
-    {"yellow", CPAR_COLOR_MAKE(255, 255, 0, 255)},
-    {"yellowgreen", CPAR_COLOR_MAKE(154, 205, 50, 255)},
-};
-
-static const size_t cpar_n_color_name_table =
-    sizeof(cpar_color_name_table) / sizeof(cpar_color_name_table[0]);
-
-static int cpar_strcasecmp(const char *s1, const char *s2)
-{
-  assert(s1);
-  assert(s2);
-  while (*s1 && *s2) {
-    int r = tolower(*s1) - tolower(*s2);
-    if (r != 0)
-      return r;
-    s1++;
-    s2++;
-  }
-  return tolower(*s1) - tolower(*s2);
-}
-
-static int cpar_color_name_info_compare_name_info(const void *p1,
-                                                  const void *p2)
-{
-  return cpar_strcasecmp((const char *)p1,
-                         ((const struct cpar_color_name_info *)p2)->name);
-}
-
-static enum cpar_status cpar_color_from_name(const char *color_str,
-                                             uint32_t *result)
+void cpar_colors_from_space(const float *in,
+                            size_t n,
+                            enum cpar_color_space space,
+                            uint32_t *colors)
 {
-  if (!color_str)
-    return CPAR_STATUS_INVALID_PARAMETER;
-  const struct cpar_color_name_info *info =
-      (const struct cpar_color_name_info *)bsearch(
-          color_str,
-          cpar_color_name_table,
-          cpar_n_color_name_table,
-          sizeof(struct cpar_color_name_info),
-          cpar_color_name_info_compare_name_info);
-  if (!info)
-    return CPAR_STATUS_NO_COLOR_NAME;
-  if (result)
-    *result = info->value;
-  return CPAR_STATUS_OK;
+  size_t i = 0;
+
+  if (!in || !colors || (unsigned)space > CPAR_SPACE_OKLAB)
+    return;
+
+#if defined(CPAR_HAVE_X86_SIMD)
+  if ((space == CPAR_SPACE_LINEAR_SRGB || space == CPAR_SPACE_OKLAB) &&
+      __builtin_cpu_supports("avx2"))
+    i = cpar_colors_from_space_avx2(in, n, space, colors);
+#endif
+
+  switch (space) {
+  case CPAR_SPACE_LINEAR_SRGB:
+    for (; i < n; i++)
+      colors[i] = cpar_color_from_space(&in[4 * i], CPAR_SPACE_LINEAR_SRGB);
+    break;
+  case CPAR_SPACE_HSL:
+    for (; i < n; i++)
+      colors[i] = cpar_color_from_space(&in[4 * i], CPAR_SPACE_HSL);
+    break;
+  case CPAR_SPACE_HSV:
+    for (; i < n; i++)
+      colors[i] = cpar_color_from_space(&in[4 * i], CPAR_SPACE_HSV);
+    break;
+  case CPAR_SPACE_OKLAB:
+    for (; i < n; i++)
+      colors[i] = cpar_color_from_space(&in[4 * i], CPAR_SPACE_OKLAB);
+    break;
+  }
+}
+
+CPAR_FP_CONTRACT_RESTORE
+
+/*
+ * WCAG contrast. Luminances are in fixed point, where the 0.05 added to
+ * each is exact, so a ratio of hi / lo meets a threshold of num / den
+ * exactly when den * hi >= num * lo.
+ */
+
+#define CPAR_LUMINANCE_OFFSET (CPAR_LUMINANCE_SCALE / 20)
+
+static const uint32_t cpar_contrast_thresholds[3][2] = {
+    {3, 1}, // CPAR_CONTRAST_AA_LARGE
+    {9, 2}, // CPAR_CONTRAST_AA
+    {7, 1}, // CPAR_CONTRAST_AAA
+};
+
+/* The luminance of @a value plus the offset, in fixed point. */
+static uint32_t cpar_luminance(uint32_t value)
+{
+  return cpar_luminance_table[0][CPAR_COLOR_RED(value)] +
+         cpar_luminance_table[1][CPAR_COLOR_GREEN(value)] +
+         cpar_luminance_table[2][CPAR_COLOR_BLUE(value)] +
+         CPAR_LUMINANCE_OFFSET;
 }
 
-static int cpar_color_name_info_compare_value(const void *p1, const void *p2)
+float cpar_relative_luminance(uint32_t value)
 {
-  return (long)p1 - ((const struct cpar_color_name_info *)p2)->value;
+  return (float)(cpar_luminance(value) - CPAR_LUMINANCE_OFFSET) /
+         (float)CPAR_LUMINANCE_SCALE;
 }
 
-const char *cpar_lookup_color_name(uint32_t value)
+float cpar_contrast_ratio(uint32_t fg, uint32_t bg)
 {
-  const struct cpar_color_name_info *info =
-      (const struct cpar_color_name_info *)bsearch(
-          (void *)((long)value),
-          cpar_color_name_table,
-          cpar_n_color_name_table,
-          sizeof(struct cpar_color_name_info),
-          cpar_color_name_info_compare_value);
-  if (!info)
-    return NULL;
-  return info->name;
+  uint32_t a = cpar_luminance(fg);
+  uint32_t b = cpar_luminance(bg);
+  return a > b ? (float)a / (float)b : (float)b / (float)a;
 }
 
-enum cpar_status cpar_color_parse(const char *color_str, uint32_t *result)
+#ifdef CPAR_HAVE_X86_SIMD
+
+/* Like cpar_luminance(), for 8 colours. */
+__attribute__((target("avx2"))) static inline __m256i
+cpar_luminance_avx2(__m256i v)
 {
-  size_t color_str_len = 0;
-  size_t buffer_len = 0;
-  char buffer[CPAR_COLOR_PARSE_BUFFER_LEN] = {0};
-  char *start = &buffer[0];
-  uint8_t r = 0, g = 0, b = 0, a = 255;
-  enum cpar_status status = CPAR_STATUS_OK;
+  const __m256i mask = _mm256_set1_epi32(0xFF);
+  const int *r = (const int *)(const void *)cpar_luminance_table[0];
+  const int *g = (const int *)(const void *)cpar_luminance_table[1];
+  const int *b = (const int *)(const void *)cpar_luminance_table[2];
+  __m256i y = _mm256_i32gather_epi32(r, _mm256_srli_epi32(v, 24), 4);
 
-  if (!color_str || !*color_str)
-    return CPAR_STATUS_INVALID_PARAMETER;
+  y = _mm256_add_epi32(
+      y,
+      _mm256_i32gather_epi32(
+          g, _mm256_and_si256(_mm256_srli_epi32(v, 16), mask), 4));
+  y = _mm256_add_epi32(
+      y,
+      _mm256_i32gather_epi32(
+          b, _mm256_and_si256(_mm256_srli_epi32(v, 8), mask), 4));
+  return _mm256_add_epi32(y, _mm256_set1_epi32(CPAR_LUMINANCE_OFFSET));
+}
 
-  color_str_len = strlen(color_str);
-  if (color_str_len >= CPAR_COLOR_PARSE_BUFFER_LEN)
-    return CPAR_STATUS_TOO_BIG;
-
-  // copy non-whitespace as lower-case to a local buffer we can modify
-  for (size_t i = 0; i < color_str_len; i++) {
-    if (!isspace(color_str[i]))
-      buffer[buffer_len++] = tolower(color_str[i]);
-  }
-
-  // ensure zero-terminated
-  buffer[buffer_len] = '\0';
-
-  // parse html colors like #fff, #ffffff, #ffffffff
-  if (*start == '#') {
-    size_t hex_len = buffer_len - 1;
-    char rr[3] = {0}, gg[3] = {0}, bb[3] = {0}, aa[3] = {0};
-
-    start++; // skip #
-
-    if (hex_len == 3) {
-      rr[0] = *start, rr[1] = *start++;
-      gg[0] = *start, gg[1] = *start++;
-      bb[0] = *start, bb[1] = *start++;
-      aa[0] = 'f', aa[1] = 'f';
-    } else if (hex_len == 6) {
-      rr[0] = *start++, rr[1] = *start++;
-      gg[0] = *start++, gg[1] = *start++;
-      bb[0] = *start++, bb[1] = *start++;
-      aa[0] = 'f', aa[1] = 'f';
-    } else if (hex_len == 8) {
-      rr[0] = *start++, rr[1] = *start++;
-      gg[0] = *start++, gg[1] = *start++;
-      bb[0] = *start++, bb[1] = *start++;
-      aa[0] = *start++, aa[1] = *start++;
-    } else {
-      return CPAR_STATUS_SYNTAX_ERROR;
-    }
+__attribute__((target("avx2"))) static size_t
+cpar_contrast_ratios_avx2(const uint32_t *fg,
+                          const uint32_t *bg,
+                          size_t n,
+                          float *ratios)
+{
+  size_t i = 0;
 
-    if ((status = cpar_hex_byte_to_int(rr, &r)) != CPAR_STATUS_OK ||
-        (status = cpar_hex_byte_to_int(gg, &g)) != CPAR_STATUS_OK ||
-        (status = cpar_hex_byte_to_int(bb, &b)) != CPAR_STATUS_OK ||
-        (status = cpar_hex_byte_to_int(aa, &a)) != CPAR_STATUS_OK) {
-      return status;
-    }
+  for (; i + 8 <= n; i += 8) {
+    __m256i a = cpar_luminance_avx2(
+        _mm256_loadu_si256((const __m256i *)&fg[i]));
+    __m256i b = cpar_luminance_avx2(
+        _mm256_loadu_si256((const __m256i *)&bg[i]));
+    _mm256_storeu_ps(
+        &ratios[i],
+        _mm256_div_ps(_mm256_cvtepi32_ps(_mm256_max_epu32(a, b)),
+                      _mm256_cvtepi32_ps(_mm256_min_epu32(a, b))));
+  }
+  return i;
+}
 
-    if (result)
-      *result = CPAR_COLOR_MAKE(r, g, b, a);
+/*
+ * Sets the bits of the pairs which pass in whole words of @a pass, which
+ * must be clear, adding them up in @a n_pass. The products fit in 31 bits,
+ * so signed comparisons work.
+ */
+__attribute__((target("avx2"))) static size_t
+cpar_contrast_check_avx2(const uint32_t *fg,
+                         const uint32_t *bg,
+                         size_t n,
+                         const uint32_t threshold[2],
+                         uint64_t *pass,
+                         size_t *n_pass)
+{
+  const __m256i num = _mm256_set1_epi32((int)threshold[0]);
+  const __m256i den = _mm256_set1_epi32((int)threshold[1]);
+  const __m256i one = _mm256_set1_epi32(1);
+  size_t i = 0;
 
-    return CPAR_STATUS_OK;
+  for (; i + 8 <= n; i += 8) {
+    __m256i a = cpar_luminance_avx2(
+        _mm256_loadu_si256((const __m256i *)&fg[i]));
+    __m256i b = cpar_luminance_avx2(
+        _mm256_loadu_si256((const __m256i *)&bg[i]));
+    __m256i hi = _mm256_mullo_epi32(den, _mm256_max_epu32(a, b));
+    __m256i lo = _mm256_mullo_epi32(num, _mm256_min_epu32(a, b));
+    // hi >= lo is hi + 1 > lo
+    __m256i ok = _mm256_cmpgt_epi32(_mm256_add_epi32(hi, one), lo);
+    uint32_t bits = (uint32_t)_mm256_movemask_ps(_mm256_castsi256_ps(ok));
+    pass[i / 64] |= (uint64_t)bits << (i % 64);
+    *n_pass += (size_t)__builtin_popcount(bits);
   }
+  return i;
+}
 
-  // parse rgb(1,2,3) colours
-  else if (strstr(start, "rgb(") == start) {
-    start += 4;
-    buffer_len -= 4;
-    if (start[--buffer_len] != ')')
-      return CPAR_STATUS_SYNTAX_ERROR;
-    start[buffer_len] = '\0';
-    if ((status = cpar_parse_comma_components(start, 3, &r, &g, &b, &a)) !=
-        CPAR_STATUS_OK) {
-      return status;
+#endif // CPAR_HAVE_X86_SIMD
+
+void cpar_contrast_ratios(const uint32_t *fg,
+                          const uint32_t *bg,
+                          size_t n,
+                          float *ratios)
+{
+  size_t i = 0;
+
+  if (!fg || !bg || !ratios)
+    return;
+
+#if defined(CPAR_HAVE_X86_SIMD)
+  if (__builtin_cpu_supports("avx2"))
+    i = cpar_contrast_ratios_avx2(fg, bg, n, ratios);
+#endif
+
+  for (; i < n; i++)
+    ratios[i] = cpar_contrast_ratio(fg[i], bg[i]);
+}
+
+size_t cpar_contrast_check(const uint32_t *fg,
+                           const uint32_t *bg,
+                           size_t n,
+                           enum cpar_contrast_level level,
+                           uint64_t *pass)
+{
+  const uint32_t *threshold = NULL;
+  size_t n_pass = 0;
+  size_t i = 0;
+
+  if (!fg || !bg || !pass || (unsigned)level > CPAR_CONTRAST_AAA)
+    return 0;
+  threshold = cpar_contrast_thresholds[level];
+  memset(pass, 0, sizeof(*pass) * ((n + 63) / 64));
+
+#if defined(CPAR_HAVE_X86_SIMD)
+  if (__builtin_cpu_supports("avx2"))
+    i = cpar_contrast_check_avx2(fg, bg, n, threshold, pass, &n_pass);
+#endif
+
+  for (; i < n; i++) {
+    uint32_t a = cpar_luminance(fg[i]);
+    uint32_t b = cpar_luminance(bg[i]);
+    uint32_t hi = a > b ? a : b;
+    uint32_t lo = a > b ? b : a;
+    if (threshold[1] * hi >= threshold[0] * lo) {
+      pass[i / 64] |= (uint64_t)1 << (i % 64);
+      n_pass++;
     }
+  }
+  return n_pass;
+}
 
-    if (result)
-      *result = CPAR_COLOR_MAKE(r, g, b, a);
+enum {
+  CPAR_SCANNER_NORMAL,
+  CPAR_SCANNER_HEX,
+  CPAR_SCANNER_WORD,
+  CPAR_SCANNER_FUNCTION,
+  CPAR_SCANNER_SKIP,
+  // up to the closing ')' of url() or of a function too long to be a colour
+  CPAR_SCANNER_SKIP_ARGS,
+};
 
-    return CPAR_STATUS_OK;
+static int cpar_is_alpha(unsigned char c)
+{
+  return (unsigned char)((c | 0x20) - 'a') < 26;
+}
+
+// characters that can make up a CSS identifier, including non-ASCII
+static int cpar_is_ident(unsigned char c)
+{
+  return cpar_is_alpha(c) || (unsigned char)(c - '0') < 10 || c == '-' ||
+         c == '_' || c >= 0x80;
+}
+
+// whether the token so far is @a word, ignoring case
+static int cpar_scanner_token_is(const struct cpar_scanner *scanner,
+                                 const char *word)
+{
+  size_t i = 0;
+  for (; i < scanner->token_len && word[i]; i++) {
+    if ((scanner->token[i] | 0x20) != word[i])
+      return 0;
   }
+  return i == scanner->token_len && word[i] == '\0';
+}
 
-  // parse rgba(1,2,50%,0.1) colours
-  else if (strstr(start, "rgba(") == start) {
-    start += 5;
-    buffer_len -= 5;
-    if (start[--buffer_len] != ')')
-      return CPAR_STATUS_SYNTAX_ERROR;
-    start[buffer_len] = '\0';
-    if ((status = cpar_parse_comma_components(start, 4, &r, &g, &b, &a)) !=
-        CPAR_STATUS_OK) {
-      return status;
+static int cpar_scanner_is_function(const struct cpar_scanner *scanner)
+{
+  return cpar_scanner_token_is(scanner, "rgb") ||
+         cpar_scanner_token_is(scanner, "rgba") ||
+         cpar_scanner_token_is(scanner, "hsl") ||
+         cpar_scanner_token_is(scanner, "hsla") ||
+         cpar_scanner_token_is(scanner, "hwb");
+}
+
+static int cpar_scanner_append(struct cpar_scanner *scanner, char c)
+{
+  if (scanner->token_len == CPAR_SCANNER_TOKEN_MAX)
+    return 0;
+  scanner->token[scanner->token_len++] = c;
+  return 1;
+}
+
+static int cpar_scanner_emit(struct cpar_scanner *scanner,
+                             struct cpar_token *token)
+{
+  uint32_t value = 0;
+  scanner->state = CPAR_SCANNER_NORMAL;
+  if (cpar_color_parse_n(scanner->token, scanner->token_len, &value) !=
+      CPAR_STATUS_OK) {
+    return 0;
+  }
+  if (token) {
+    token->offset = scanner->token_offset;
+    token->length = scanner->token_len;
+    token->value = value;
+  }
+  return 1;
+}
+
+void cpar_scanner_init(struct cpar_scanner *scanner)
+{
+  memset(scanner, 0, sizeof(*scanner));
+  scanner->state = CPAR_SCANNER_NORMAL;
+}
+
+void cpar_scanner_feed(struct cpar_scanner *scanner,
+                       const char *chunk,
+                       size_t chunk_len)
+{
+  scanner->input = chunk;
+  scanner->input_len = chunk ? chunk_len : 0;
+  scanner->input_pos = 0;
+}
+
+void cpar_scanner_end(struct cpar_scanner *scanner)
+{
+  scanner->at_end = 1;
+}
+
+/*
+ * Scans the chunk up to @a end, returning 1 when a colour is found. A
+ * token which reaches @a end is kept for the next call.
+ */
+static int
+cpar_scanner_scan(struct cpar_scanner *scanner, struct cpar_token *token,
+                  size_t end)
+{
+  while (scanner->input_pos < end) {
+    unsigned char c = (unsigned char)scanner->input[scanner->input_pos];
+
+    switch (scanner->state) {
+      case CPAR_SCANNER_NORMAL:
+        if (c == '#' || cpar_is_alpha(c)) {
+          scanner->state =
+              (c == '#') ? CPAR_SCANNER_HEX : CPAR_SCANNER_WORD;
+          scanner->token_offset = scanner->offset;
+          scanner->token[0] = (char)c;
+          scanner->token_len = 1;
+        } else if (cpar_is_ident(c)) {
+          scanner->state = CPAR_SCANNER_SKIP;
+        }
+        break;
+
+      case CPAR_SCANNER_HEX:
+      case CPAR_SCANNER_WORD:
+        if (cpar_is_ident(c)) {
+          if (!cpar_scanner_append(scanner, (char)c))
+            scanner->state = CPAR_SCANNER_SKIP;
+          break;
+        } else if (c == '(' && scanner->state == CPAR_SCANNER_WORD) {
+          if (cpar_scanner_is_function(scanner) &&
+              cpar_scanner_append(scanner, (char)c)) {
+            scanner->state = CPAR_SCANNER_FUNCTION;
+          } else if (cpar_scanner_token_is(scanner, "url")) {
+            // like a CSS tokenizer, treat the contents of url() as opaque
+            scanner->state = CPAR_SCANNER_SKIP_ARGS;
+          } else {
+            scanner->state = CPAR_SCANNER_NORMAL;
+          }
+          break;
+        }
+        // the token ended before this character, which is scanned again
+        if (cpar_scanner_emit(scanner, token))
+          return 1;
+        continue;
+
+      case CPAR_SCANNER_FUNCTION:
+        if (!cpar_scanner_append(scanner, (char)c)) {
+          // the words in its arguments aren't colour names either
+          scanner->state =
+              (c == ')') ? CPAR_SCANNER_NORMAL : CPAR_SCANNER_SKIP_ARGS;
+        } else if (c == ')') {
+          scanner->input_pos++;
+          scanner->offset++;
+          if (cpar_scanner_emit(scanner, token))
+            return 1;
+          continue;
+        }
+        break;
+
+      case CPAR_SCANNER_SKIP:
+        if (!cpar_is_ident(c)) {
+          scanner->state = CPAR_SCANNER_NORMAL;
+          continue;
+        }
+        break;
+
+      case CPAR_SCANNER_SKIP_ARGS:
+        if (c == ')')
+          scanner->state = CPAR_SCANNER_NORMAL;
+        break;
     }
 
-    if (result)
-      *result = CPAR_COLOR_MAKE(r, g, b, a);
+    scanner->input_pos++;
+    scanner->offset++;
+  }
 
-    return CPAR_STATUS_OK;
+  return 0;
+}
+
+/* Reports a token which the end of the input ends, after the last chunk. */
+static int cpar_scanner_finish(struct cpar_scanner *scanner,
+                               struct cpar_token *token)
+{
+  int state = scanner->state;
+  scanner->state = CPAR_SCANNER_NORMAL;
+  if (state == CPAR_SCANNER_HEX || state == CPAR_SCANNER_WORD)
+    return cpar_scanner_emit(scanner, token);
+  return 0;
+}
+
+int cpar_scanner_next(struct cpar_scanner *scanner, struct cpar_token *token)
+{
+  if (cpar_scanner_scan(scanner, token, scanner->input_len))
+    return 1;
+  return scanner->at_end && cpar_scanner_finish(scanner, token);
+}
+
+enum cpar_scan_result cpar_scanner_poll(struct cpar_scanner *scanner,
+                                        size_t budget,
+                                        struct cpar_token *token)
+{
+  size_t end = scanner->input_len;
+
+  if (budget > 0 && budget < end - scanner->input_pos)
+    end = scanner->input_pos + budget;
+  if (cpar_scanner_scan(scanner, token, end))
+    return CPAR_SCAN_COLOR;
+  if (scanner->input_pos < scanner->input_len)
+    return CPAR_SCAN_YIELD;
+  if (!scanner->at_end)
+    return CPAR_SCAN_NEED_INPUT;
+  return cpar_scanner_finish(scanner, token) ? CPAR_SCAN_COLOR
+                                             : CPAR_SCAN_END;
+}
+
+// each byte's two hex digits, so a byte is encoded with a single lookup
+static const char cpar_hex_pairs[] =
+    "000102030405060708090a0b0c0d0e0f"
+    "101112131415161718191a1b1c1d1e1f"
+    "202122232425262728292a2b2c2d2e2f"
+    "303132333435363738393a3b3c3d3e3f"
+    "404142434445464748494a4b4c4d4e4f"
+    "505152535455565758595a5b5c5d5e5f"
+    "606162636465666768696a6b6c6d6e6f"
+    "707172737475767778797a7b7c7d7e7f"
+    "808182838485868788898a8b8c8d8e8f"
+    "909192939495969798999a9b9c9d9e9f"
+    "a0a1a2a3a4a5a6a7a8a9aaabacadaeaf"
+    "b0b1b2b3b4b5b6b7b8b9babbbcbdbebf"
+    "c0c1c2c3c4c5c6c7c8c9cacbcccdcecf"
+    "d0d1d2d3d4d5d6d7d8d9dadbdcdddedf"
+    "e0e1e2e3e4e5e6e7e8e9eaebecedeeef"
+    "f0f1f2f3f4f5f6f7f8f9fafbfcfdfeff";
+
+static char *cpar_format_hex_byte(char *out, uint8_t byte)
+{
+  out[0] = cpar_hex_pairs[byte * 2];
+  out[1] = cpar_hex_pairs[byte * 2 + 1];
+  return out + 2;
+}
+
+static char *cpar_format_decimal_byte(char *out, uint8_t byte)
+{
+  if (byte >= 100)
+    *out++ = (char)('0' + byte / 100);
+  if (byte >= 10)
+    *out++ = (char)('0' + byte / 10 % 10);
+  *out++ = (char)('0' + byte % 10);
+  return out;
+}
+
+/*
+ * Formats an alpha component as the shortest decimal fraction that parses
+ * back to the same value. Three digits are always enough since 1/1000 is
+ * less than half of 1/255.
+ */
+static char *cpar_format_alpha(char *out, uint8_t alpha)
+{
+  uint32_t scale = 10;
+  uint32_t digits = 0;
+  int n_digits = 1;
+
+  if (alpha == 0 || alpha == 255) {
+    *out++ = (alpha == 0) ? '0' : '1';
+    return out;
   }
 
-  // parse as colour name as a last resort
-  else {
-    uint32_t value = 0;
-    if ((status = cpar_color_from_name(buffer, &value)) != CPAR_STATUS_OK)
-      return status;
-    if (result)
-      *result = value;
-    return CPAR_STATUS_OK;
+  for (;; n_digits++, scale *= 10) {
+    // the parser rounds, so the nearest fraction works if it's within half
+    // a step of alpha / 255
+    digits = (2 * (uint32_t)alpha * scale + 255) / 510;
+    if (n_digits == 3 ||
+        (2 * digits * 255 >= (2 * (uint32_t)alpha - 1) * scale &&
+         2 * digits * 255 < (2 * (uint32_t)alpha + 1) * scale)) {
+      break;
+    }
+  }
+
+  *out++ = '0';
+  *out++ = '.';
+  for (int i = n_digits - 1; i >= 0; i--) {
+    out[i] = (char)('0' + digits % 10);
+    digits /= 10;
+  }
+  return out + n_digits;
+}
+
+/*
+ * Writes the formatted colour to @a out which must have room for
+ * CPAR_FORMAT_MAX characters, returning the length.
+ */
+static size_t cpar_format_into(uint32_t value,
+                               enum cpar_format format,
+                               char *out)
+{
+  char *p = out;
+  uint8_t r = CPAR_COLOR_RED(value), g = CPAR_COLOR_GREEN(value),
+          b = CPAR_COLOR_BLUE(value), a = CPAR_COLOR_ALPHA(value);
+
+  switch (format) {
+    case CPAR_FORMAT_SHORTEST: {
+      const char *name = cpar_lookup_color_name(value);
+      size_t name_len = name ? strlen(name) : SIZE_MAX;
+      if (a == 255 && r % 17 == 0 && g % 17 == 0 && b % 17 == 0 &&
+          name_len > 3) {
+        *p++ = '#';
+        *p++ = cpar_hex_pairs[r * 2];
+        *p++ = cpar_hex_pairs[g * 2];
+        *p++ = cpar_hex_pairs[b * 2];
+        break;
+      } else if (name_len < ((a == 255) ? 7u : 9u)) {
+        memcpy(p, name, name_len);
+        p += name_len;
+        break;
+      }
+    }
+      // fall through
+    case CPAR_FORMAT_HEX:
+    case CPAR_FORMAT_HEX_ALPHA:
+      *p++ = '#';
+      p = cpar_format_hex_byte(p, r);
+      p = cpar_format_hex_byte(p, g);
+      p = cpar_format_hex_byte(p, b);
+      if (a != 255 || format == CPAR_FORMAT_HEX_ALPHA)
+        p = cpar_format_hex_byte(p, a);
+      break;
+
+    case CPAR_FORMAT_RGB:
+      if (a == 255) {
+        memcpy(p, "rgb(", 4);
+        p += 4;
+      } else {
+        memcpy(p, "rgba(", 5);
+        p += 5;
+      }
+      p = cpar_format_decimal_byte(p, r);
+      *p++ = ',';
+      p = cpar_format_decimal_byte(p, g);
+      *p++ = ',';
+      p = cpar_format_decimal_byte(p, b);
+      if (a != 255) {
+        *p++ = ',';
+        p = cpar_format_alpha(p, a);
+      }
+      *p++ = ')';
+      break;
   }
 
-  return CPAR_STATUS_SYNTAX_ERROR;
+  *p = '\0';
+  return (size_t)(p - out);
+}
+
+size_t cpar_color_format(uint32_t value,
+                         enum cpar_format format,
+                         char *buf,
+                         size_t buf_len)
+{
+  char tmp[CPAR_FORMAT_MAX];
+  size_t len = 0;
+
+  if (buf && buf_len >= CPAR_FORMAT_MAX)
+    return cpar_format_into(value, format, buf);
+
+  len = cpar_format_into(value, format, tmp);
+  if (buf && buf_len > 0) {
+    size_t n = (len < buf_len) ? len : buf_len - 1;
+    memcpy(buf, tmp, n);
+    buf[n] = '\0';
+  }
+  return len;
 }
 
 #endif // CPAR_IMPLEMENTATION
@@ -0,0 +1,511 @@
+/*
+ * Differential checks of the optimized parsing paths against the frozen
+ * reference parser in reference.h, shared by the tests and the fuzz target.
+ *
+ * Each check returns a description of the first mismatch it finds, or an
+ * empty string. Valid input must give exactly the same colour, and invalid
+ * input exactly the same status code.
+ */
+
+#ifndef CPAR_TESTS_DIFFERENTIAL_H
+#define CPAR_TESTS_DIFFERENTIAL_H 1
+
+#include "cpar.h"
+#include "reference.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace differential
+{
+
+  // makes the input printable in a mismatch description
+  inline std::string quote(std::string_view str)
+  {
+    std::string out = "\"";
+    for (unsigned char c : str) {
+      if (c >= ' ' && c < 0x7f && c != '"' && c != '\\') {
+        out += static_cast<char>(c);
+      } else {
+        char buf[8];
+        std::snprintf(buf, sizeof(buf), "\\x%02x", c);
+        out += buf;
+      }
+    }
+    return out + "\"";
+  }
+
+  inline std::string mismatch(const char *path,
+                              std::string_view input,
+                              cpar_status status,
+                              uint32_t value,
+                              cpar_status expected_status,
+                              uint32_t expected_value)
+  {
+    char buf[160];
+    std::snprintf(buf,
+                  sizeof(buf),
+                  "%s: got status %d value %08x, reference gives %d %08x: ",
+                  path,
+                  static_cast<int>(status),
+                  static_cast<unsigned>(value),
+                  static_cast<int>(expected_status),
+                  static_cast<unsigned>(expected_value));
+    return buf + quote(input);
+  }
+
+  inline bool same(cpar_status status,
+                   uint32_t value,
+                   cpar_status expected_status,
+                   uint32_t expected_value)
+  {
+    return status == expected_status &&
+           (status != CPAR_STATUS_OK || value == expected_value);
+  }
+
+  inline bool is_hex8_record(std::string_view str)
+  {
+    if (str.size() != 9 || str[0] != '#')
+      return false;
+    for (char c : str.substr(1)) {
+      if (reference::hex_value(c) < 0)
+        return false;
+    }
+    return true;
+  }
+
+  class checker
+  {
+  public:
+    // checks every single-string path
+    std::string check(std::string_view input)
+    {
+      uint32_t expected = 0;
+      cpar_status expected_status = reference::parse(input, expected);
+      std::string found;
+
+      // parse(value) must give the same status and value as the reference
+      auto expect = [&](const char *path, auto &&parse) {
+        uint32_t value = 0;
+        cpar_status status = parse(value);
+        if (found.empty() &&
+            !same(status, value, expected_status, expected)) {
+          found =
+              mismatch(path, input, status, value, expected_status, expected);
+        }
+      };
+
+      expect("cpar_color_parse_n", [&](uint32_t &value) {
+        return cpar_color_parse_n(input.data(), input.size(), &value);
+      });
+      // only the status matters here
+      expect("cpar_color_parse_n without result", [&](uint32_t &value) {
+        value = expected;
+        return cpar_color_parse_n(input.data(), input.size(), NULL);
+      });
+      if (input.find('\0') == std::string_view::npos) {
+        std::string terminated{input};
+        expect("cpar_color_parse", [&](uint32_t &value) {
+          return cpar_color_parse(terminated.c_str(), &value);
+        });
+      }
+      expect("constexpr parser", [&](uint32_t &value) {
+        return cpar::detail::parse(input, value);
+      });
+      for (const char *path :
+           {"cpar_cache_parse miss", "cpar_cache_parse hit"}) {
+        expect(path, [&](uint32_t &value) {
+          return cpar_cache_parse(
+              m_cache.get(), input.data(), input.size(), &value);
+        });
+      }
+
+      // keep the atom table from growing without limit while fuzzing
+      if (m_atoms.size() > 100000)
+        m_atoms = cpar::atoms{};
+      expect("cpar_atoms_intern", [&](uint32_t &value) {
+        uint32_t id = 0;
+        cpar_status status = m_atoms.intern(input, id);
+        value = m_atoms.value(id).value;
+        return status;
+      });
+      if (!found.empty())
+        return found;
+
+      if (input.size() == 9) {
+        uint32_t value = 0;
+        uint64_t invalid = 0;
+        cpar_color_parse_hex8_batch(input.data(), 9, 1, &value, &invalid);
+        if (invalid == 0 && !same(CPAR_STATUS_OK,
+                                  value,
+                                  expected_status,
+                                  expected)) {
+          return mismatch("cpar_color_parse_hex8_batch",
+                          input,
+                          CPAR_STATUS_OK,
+                          value,
+                          expected_status,
+                          expected);
+        } else if (invalid != 0 && is_hex8_record(input)) {
+          return mismatch("cpar_color_parse_hex8_batch",
+                          input,
+                          CPAR_STATUS_INVALID_NUMBER,
+                          0,
+                          expected_status,
+                          expected);
+        }
+      }
+
+      return {};
+    }
+
+    // checks the paths which parse many strings at once
+    std::string check_batch(std::vector<std::string> const &inputs)
+    {
+      const size_t n = inputs.size();
+      std::vector<cpar_string> strs;
+      std::vector<uint32_t> expected(n, 0);
+      std::vector<cpar_status> expected_statuses(n);
+      size_t expected_ok = 0;
+      std::string hex8;
+      std::vector<size_t> hex8_inputs;
+
+      for (size_t i = 0; i < n; i++) {
+        strs.push_back({inputs[i].data(), inputs[i].size()});
+        expected_statuses[i] = reference::parse(inputs[i], expected[i]);
+        expected_ok += expected_statuses[i] == CPAR_STATUS_OK;
+        if (inputs[i].size() == 9) {
+          hex8 += inputs[i];
+          hex8_inputs.push_back(i);
+        }
+      }
+
+      cpar_executor executor = m_pool.executor();
+      for (int parallel = 0; parallel < 2; parallel++) {
+        const char *path = parallel ? "cpar_color_parse_batch_parallel"
+                                    : "cpar_color_parse_batch";
+        std::vector<uint32_t> results(n, 0);
+        std::vector<cpar_status> statuses(n);
+        size_t n_ok = parallel ? cpar_color_parse_batch_parallel(
+                                     strs.data(),
+                                     n,
+                                     results.data(),
+                                     statuses.data(),
+                                     &executor)
+                               : cpar_color_parse_batch(
+                                     strs.data(),
+                                     n,
+                                     results.data(),
+                                     statuses.data());
+        for (size_t i = 0; i < n; i++) {
+          if (!same(statuses[i],
+                    results[i],
+                    expected_statuses[i],
+                    expected[i])) {
+            return mismatch(path,
+                            inputs[i],
+                            statuses[i],
+                            results[i],
+                            expected_statuses[i],
+                            expected[i]);
+          }
+        }
+        if (n_ok != expected_ok)
+          return std::string{path} + ": wrong number of colours parsed";
+      }
+
+      const size_t n_hex8 = hex8_inputs.size();
+      std::vector<uint32_t> results(n_hex8, 0);
+      std::vector<uint64_t> invalid((n_hex8 + 63) / 64, 0);
+      cpar_color_parse_hex8_batch(
+          hex8.data(), 9, n_hex8, results.data(), invalid.data());
+      for (size_t j = 0; j < n_hex8; j++) {
+        size_t i = hex8_inputs[j];
+        bool bad = (invalid[j / 64] >> (j % 64)) & 1;
+        if ((!bad && !same(CPAR_STATUS_OK,
+                           results[j],
+                           expected_statuses[i],
+                           expected[i])) ||
+            (bad && is_hex8_record(inputs[i]))) {
+          return mismatch("cpar_color_parse_hex8_batch",
+                          inputs[i],
+                          bad ? CPAR_STATUS_INVALID_NUMBER : CPAR_STATUS_OK,
+                          results[j],
+                          expected_statuses[i],
+                          expected[i]);
+        }
+      }
+
+      return {};
+    }
+
+  private:
+    cpar::cache m_cache{64};
+    cpar::atoms m_atoms;
+    cpar::thread_pool m_pool{4};
+  };
+
+  /*
+   * Checks the SIMD pixel kernels against scalar formulas, using the bytes
+   * of @a data as colours. The sizes vary so that the portable tails get
+   * checked too.
+   */
+  inline std::string check_pixels(const uint8_t *data, size_t size)
+  {
+    static const char *const formats[] = {"rgba", "bgra", "argb", "abgr"};
+    const size_t n = size / 4;
+    std::vector<uint32_t> colors(n);
+    for (size_t i = 0; i < n; i++) {
+      colors[i] = static_cast<uint32_t>(data[4 * i]) << 24 |
+                  static_cast<uint32_t>(data[4 * i + 1]) << 16 |
+                  static_cast<uint32_t>(data[4 * i + 2]) << 8 | data[4 * i + 3];
+    }
+
+    auto channel = [](uint32_t c, char name) -> uint32_t {
+      switch (name) {
+        case 'r':
+          return CPAR_COLOR_RED(c);
+        case 'g':
+          return CPAR_COLOR_GREEN(c);
+        case 'b':
+          return CPAR_COLOR_BLUE(c);
+        default:
+          return CPAR_COLOR_ALPHA(c);
+      }
+    };
+
+    for (int f = 0; f < 4; f++) {
+      std::vector<uint32_t> pixels = colors;
+      cpar_pixels_from_colors(
+          pixels.data(), n, static_cast<cpar_pixel_format>(f));
+      for (size_t i = 0; i < n; i++) {
+        const uint8_t *px = reinterpret_cast<const uint8_t *>(&pixels[i]);
+        for (int k = 0; k < 4; k++) {
+          if (px[k] != channel(colors[i], formats[f][k]))
+            return std::string{"cpar_pixels_from_colors: "} + formats[f];
+        }
+      }
+      cpar_pixels_to_colors(
+          pixels.data(), n, static_cast<cpar_pixel_format>(f));
+      if (pixels != colors)
+        return std::string{"cpar_pixels_to_colors: "} + formats[f];
+    }
+
+    std::vector<uint32_t> premultiplied = colors;
+    cpar_colors_premultiply(premultiplied.data(), n);
+    std::vector<uint32_t> unpremultiplied = colors;
+    cpar_colors_unpremultiply(unpremultiplied.data(), n);
+    for (size_t i = 0; i < n; i++) {
+      uint32_t a = CPAR_COLOR_ALPHA(colors[i]);
+      uint32_t pre[3];
+      uint32_t unpre[3];
+      for (int k = 0; k < 3; k++) {
+        uint32_t c = channel(colors[i], "rgb"[k]);
+        pre[k] = (c * a + 127) / 255;
+        unpre[k] = a ? std::min<uint32_t>(255, (c * 255 + a / 2) / a) : 0;
+      }
+      if (premultiplied[i] != CPAR_COLOR_MAKE(pre[0], pre[1], pre[2], a))
+        return "cpar_colors_premultiply";
+      if (unpremultiplied[i] !=
+          CPAR_COLOR_MAKE(unpre[0], unpre[1], unpre[2], a)) {
+        return "cpar_colors_unpremultiply";
+      }
+    }
+
+    return {};
+  }
+
+  /*
+   * Generates @a n inputs by mutating a list of interesting colour strings,
+   * deterministically for a given @a seed.
+   */
+  inline std::vector<std::string> generate(size_t n, uint32_t seed)
+  {
+    static const char *const seeds[] = {
+        "#f0c",
+        "#ff00cc",
+        "#FF00CC80",
+        " # f f 0 0 c c ",
+        "#ff00zz",
+        "#12345",
+        "rgb(255, 0, 204)",
+        "rgb(100%, 0%, 80%)",
+        "rgba(255, 0, 204, 0.5)",
+        "rgba(1,2,3,50%)",
+        "rgb(255 0 204 / 50%)",
+        "rgb(1 2 3/4)",
+        "r g b ( 1 , 2 , 3 )",
+        "rgb(1e2, 2.5e1%, +0)",
+        "rgba(0, 0, 0, 0.0019608)",
+        "hsl(312, 100%, 40%)",
+        "hsla(312deg, 100%, 40%, .5)",
+        "hsl(0.5turn 50% 50% / 10%)",
+        "hsl(3.14rad 20 80)",
+        "hsl(-400grad, 1%, 99%)",
+        "hwb(312 0% 20%)",
+        "hwb(120 60% 60%)",
+        "red",
+        "LightGoldenrodYellow",
+        "light goldenrod yellow",
+        "transparent",
+        "notacolour",
+        "",
+    };
+    static const char alphabet[] = "0123456789abcdefABCDEF#(),/%.+-eE \t"
+                                   "ghlnrstuwxyzRGBHSLW";
+
+    uint32_t state = seed * 2654435761u + 1;
+    auto next = [&state](uint32_t bound) {
+      state ^= state << 13;
+      state ^= state >> 17;
+      state ^= state << 5;
+      return state % bound;
+    };
+    const uint32_t n_seeds = sizeof(seeds) / sizeof(seeds[0]);
+
+    std::vector<std::string> inputs;
+    for (size_t i = 0; i < n; i++) {
+      std::string str;
+      if (i % 8 == 7) {
+        // long hex colours, which the SIMD and SWAR paths handle
+        str = "#";
+        for (int k = 0; k < 8; k++)
+          str += "0123456789abcdefABCDEF"[next(22)];
+        if (next(4) == 0)
+          str[1 + next(8)] = alphabet[next(sizeof(alphabet) - 1)];
+      } else {
+        str = seeds[next(n_seeds)];
+      }
+
+      for (uint32_t m = next(5); m > 0; m--) {
+        size_t pos = str.empty() ? 0 : next(static_cast<uint32_t>(str.size()));
+        char c = next(64) == 0 ? '\0' : alphabet[next(sizeof(alphabet) - 1)];
+        switch (next(5)) {
+          case 0:
+            if (!str.empty())
+              str[pos] = c;
+            break;
+          case 1:
+            str.insert(pos, 1, c);
+            break;
+          case 2:
+            if (!str.empty())
+              str.erase(pos, 1);
+            break;
+          case 3:
+            str.insert(pos, str.substr(pos, next(4)));
+            break;
+          default:
+            str = str.substr(0, pos) + seeds[next(n_seeds)];
+            break;
+        }
+      }
+      inputs.push_back(str);
+    }
+    return inputs;
+  }
+
+  /*
+   * Times each path over @a inputs and reports its throughput, so that
+   * fuzzing doubles as a quick performance check.
+   */
+  inline void report_throughput(std::vector<std::string> const &inputs,
+                                std::FILE *out)
+  {
+    using clock = std::chrono::steady_clock;
+    std::vector<cpar_string> strs;
+    std::string hex8;
+    size_t n_bytes = 0;
+    for (auto const &input : inputs) {
+      strs.push_back({input.data(), input.size()});
+      n_bytes += input.size();
+      if (is_hex8_record(input))
+        hex8 += input;
+    }
+    std::vector<uint32_t> results(inputs.size());
+    std::vector<cpar_status> statuses(inputs.size());
+    std::vector<uint64_t> invalid(inputs.size() / 64 + 1);
+    cpar::cache cache{64};
+    cpar::thread_pool pool;
+    cpar_executor executor = pool.executor();
+    uint32_t sink = 0;
+
+    // runs the path over all the inputs until enough time has passed
+    auto time = [&](const char *path, size_t items, size_t bytes, auto &&fn) {
+      size_t passes = 0;
+      auto start = clock::now();
+      std::chrono::duration<double> elapsed{};
+      do {
+        fn();
+        passes++;
+        elapsed = clock::now() - start;
+      } while (elapsed.count() < 0.05);
+      double per_second = static_cast<double>(passes) / elapsed.count();
+      std::fprintf(out,
+                   "%-32s %10.2f M items/s %10.1f MB/s\n",
+                   path,
+                   static_cast<double>(items) * per_second / 1e6,
+                   static_cast<double>(bytes) * per_second / 1e6);
+    };
+
+    time("reference::parse", inputs.size(), n_bytes, [&] {
+      for (auto const &input : inputs)
+        sink += reference::parse(input, results[0]);
+    });
+    time("cpar_color_parse_n", inputs.size(), n_bytes, [&] {
+      for (auto const &input : inputs)
+        sink += cpar_color_parse_n(input.data(), input.size(), &results[0]);
+    });
+    time("constexpr parser", inputs.size(), n_bytes, [&] {
+      for (auto const &input : inputs)
+        sink += cpar::detail::parse(input, results[0]);
+    });
+    time("cpar_cache_parse", inputs.size(), n_bytes, [&] {
+      for (auto const &input : inputs) {
+        sink += cpar_cache_parse(
+            cache.get(), input.data(), input.size(), &results[0]);
+      }
+    });
+    time("cpar_color_parse_batch", inputs.size(), n_bytes, [&] {
+      sink += static_cast<uint32_t>(cpar_color_parse_batch(
+          strs.data(), strs.size(), results.data(), statuses.data()));
+    });
+    time("cpar_color_parse_batch_parallel", inputs.size(), n_bytes, [&] {
+      sink += static_cast<uint32_t>(
+          cpar_color_parse_batch_parallel(strs.data(),
+                                          strs.size(),
+                                          results.data(),
+                                          statuses.data(),
+                                          &executor));
+    });
+    time("cpar_color_parse_hex8_batch", hex8.size() / 9, hex8.size(), [&] {
+      sink += static_cast<uint32_t>(cpar_color_parse_hex8_batch(
+          hex8.data(), 9, hex8.size() / 9, results.data(), invalid.data()));
+    });
+
+    std::vector<uint32_t> pixels(1 << 16);
+    for (size_t i = 0; i < pixels.size(); i++)
+      pixels[i] = static_cast<uint32_t>(i * 2654435761u);
+    const size_t pixel_bytes = pixels.size() * 4;
+    time("cpar_pixels_from_colors", pixels.size(), pixel_bytes, [&] {
+      cpar_pixels_from_colors(pixels.data(), pixels.size(), CPAR_PIXEL_BGRA8);
+    });
+    time("cpar_colors_premultiply", pixels.size(), pixel_bytes, [&] {
+      cpar_colors_premultiply(pixels.data(), pixels.size());
+    });
+    time("cpar_colors_unpremultiply", pixels.size(), pixel_bytes, [&] {
+      cpar_colors_unpremultiply(pixels.data(), pixels.size());
+    });
+
+    // keeps the loops from being optimized away
+    if (sink == 0xdeadbeef)
+      std::fprintf(out, "\n");
+  }
+
+} // namespace differential
+
+#endif // CPAR_TESTS_DIFFERENTIAL_H
@@ -0,0 +1,119 @@
+/*
+ * Fuzz target comparing the optimized parsing paths against the reference
+ * parser in reference.h.
+ *
+ * Built with -DCPAR_LIBFUZZER and -fsanitize=fuzzer this is a libFuzzer
+ * target (`make tests/fuzz-libfuzzer`). Otherwise it is a standalone driver
+ * that checks each file named on the command line, or stdin when there are
+ * none, which is what AFL expects; and with `-n COUNT [-s SEED]` it checks
+ * COUNT generated inputs and reports the throughput of each path
+ * (`make fuzz`). Any mismatch is printed and aborts the process.
+ */
+
+#define CPAR_IMPLEMENTATION
+#include "differential.h"
+
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <string>
+#include <string_view>
+#include <vector>
+
+static void expect_none(std::string const &mismatch)
+{
+  if (!mismatch.empty()) {
+    std::fprintf(stderr, "mismatch: %s\n", mismatch.c_str());
+    std::abort();
+  }
+}
+
+extern "C" int LLVMFuzzerTestOneInput(const uint8_t *data, size_t size)
+{
+  static differential::checker checker;
+  std::string_view input(reinterpret_cast<const char *>(data), size);
+
+  expect_none(checker.check(input));
+  expect_none(differential::check_pixels(data, size));
+
+  // each line is also a batch element
+  std::vector<std::string> lines;
+  for (size_t start = 0; start <= input.size();) {
+    size_t end = input.find('\n', start);
+    if (end == std::string_view::npos)
+      end = input.size();
+    lines.emplace_back(input.substr(start, end - start));
+    start = end + 1;
+  }
+  expect_none(checker.check_batch(lines));
+  return 0;
+}
+
+#ifndef CPAR_LIBFUZZER
+
+static int check_stream(FILE *fp)
+{
+  std::string input;
+  char buf[4096];
+  size_t n;
+  while ((n = std::fread(buf, 1, sizeof(buf), fp)) > 0)
+    input.append(buf, n);
+  if (std::ferror(fp))
+    return 1;
+  return LLVMFuzzerTestOneInput(
+      reinterpret_cast<const uint8_t *>(input.data()), input.size());
+}
+
+static int check_generated(size_t count, uint32_t seed)
+{
+  differential::checker checker;
+  std::vector<std::string> inputs = differential::generate(count, seed);
+  size_t n_bad = 0;
+  for (std::string const &input : inputs) {
+    std::string mismatch = checker.check(input);
+    if (!mismatch.empty() && n_bad++ < 10)
+      std::fprintf(stderr, "mismatch: %s\n", mismatch.c_str());
+  }
+  std::string mismatch = checker.check_batch(inputs);
+  if (!mismatch.empty()) {
+    std::fprintf(stderr, "mismatch: %s\n", mismatch.c_str());
+    n_bad++;
+  }
+  std::printf("%zu inputs, seed %u, %zu mismatches\n",
+              inputs.size(),
+              static_cast<unsigned>(seed),
+              n_bad);
+  differential::report_throughput(inputs, stdout);
+  return n_bad != 0;
+}
+
+int main(int argc, char **argv)
+{
+  if (argc > 1 && std::strcmp(argv[1], "-n") == 0) {
+    if (argc != 3 && !(argc == 5 && std::strcmp(argv[3], "-s") == 0)) {
+      std::fprintf(stderr, "usage: %s -n COUNT [-s SEED]\n", argv[0]);
+      return 2;
+    }
+    size_t count = std::strtoul(argv[2], nullptr, 10);
+    uint32_t seed = argc == 5 ? std::strtoul(argv[4], nullptr, 10) : 1;
+    return check_generated(count, seed);
+  }
+
+  if (argc == 1)
+    return check_stream(stdin);
+  for (int i = 1; i < argc; i++) {
+    FILE *fp = std::fopen(argv[i], "rb");
+    if (fp == nullptr) {
+      std::perror(argv[i]);
+      return 1;
+    }
+    int result = check_stream(fp);
+    std::fclose(fp);
+    if (result != 0)
+      return result;
+  }
+  return 0;
+}
+
+#endif // CPAR_LIBFUZZER
@@ -0,0 +1,491 @@
+/*
+ * A frozen reference implementation of cpar_color_parse_n(), used by the
+ * differential tests and the fuzz target to check the optimized paths.
+ *
+ * It is written to be obviously correct rather than fast: it works on
+ * copies of the string, splits it into pieces before looking at any of them,
+ * parses numbers exactly with arbitrary precision, and looks names up with
+ * a linear search. Don't optimize it or share code with cpar.h. If the
+ * accepted syntax changes on purpose, change this to match in the same
+ * commit.
+ */
+
+#ifndef CPAR_TESTS_REFERENCE_H
+#define CPAR_TESTS_REFERENCE_H 1
+
+#include "cpar.h"
+
+#include <algorithm>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace reference
+{
+
+  inline bool is_space(char c)
+  {
+    return c == ' ' || c == '\t' || c == '\n' || c == '\v' || c == '\f' ||
+           c == '\r';
+  }
+
+  inline bool is_digit(char c) { return c >= '0' && c <= '9'; }
+
+  inline char to_lower(char c)
+  {
+    return (c >= 'A' && c <= 'Z') ? static_cast<char>(c - 'A' + 'a') : c;
+  }
+
+  inline std::string trim(std::string_view str)
+  {
+    size_t start = 0;
+    size_t end = str.size();
+    while (start < end && is_space(str[start]))
+      start++;
+    while (end > start && is_space(str[end - 1]))
+      end--;
+    return std::string{str.substr(start, end - start)};
+  }
+
+  inline std::string lower(std::string str)
+  {
+    for (char &c : str)
+      c = to_lower(c);
+    return str;
+  }
+
+  // removes all whitespace, optionally folding to lower case
+  inline std::string compact(std::string_view str, bool fold = false)
+  {
+    std::string out;
+    for (char c : str) {
+      if (!is_space(c))
+        out += fold ? to_lower(c) : c;
+    }
+    return out;
+  }
+
+  inline int hex_value(char c)
+  {
+    if (is_digit(c))
+      return c - '0';
+    else if (c >= 'a' && c <= 'f')
+      return c - 'a' + 10;
+    else if (c >= 'A' && c <= 'F')
+      return c - 'A' + 10;
+    return -1;
+  }
+
+  inline cpar_status parse_hex(std::string_view str, uint32_t &value)
+  {
+    std::string digits = compact(str);
+    if (digits.size() != 3 && digits.size() != 6 && digits.size() != 8)
+      return CPAR_STATUS_SYNTAX_ERROR;
+
+    std::vector<uint32_t> bytes;
+    for (size_t i = 0; i < digits.size(); i += digits.size() == 3 ? 1 : 2) {
+      int hi = hex_value(digits[i]);
+      int lo = hex_value(digits[digits.size() == 3 ? i : i + 1]);
+      if (hi < 0 || lo < 0)
+        return CPAR_STATUS_INVALID_NUMBER;
+      bytes.push_back(static_cast<uint32_t>(hi * 16 + lo));
+    }
+    if (bytes.size() == 3)
+      bytes.push_back(255);
+
+    value = CPAR_COLOR_MAKE(bytes[0], bytes[1], bytes[2], bytes[3]);
+    return CPAR_STATUS_OK;
+  }
+
+  inline cpar_status parse_name(std::string_view str, uint32_t &value)
+  {
+    struct entry {
+      const char *name;
+      uint32_t value;
+    };
+    static const entry names[] = {
+#define REFERENCE_NAME(name, r, g, b, a) {name, CPAR_COLOR_MAKE(r, g, b, a)},
+        CPAR_COLOR_NAME_LIST(REFERENCE_NAME)
+#undef REFERENCE_NAME
+    };
+
+    std::string name = compact(str, true);
+    for (auto const &e : names) {
+      if (name == e.name) {
+        value = e.value;
+        return CPAR_STATUS_OK;
+      }
+    }
+    return CPAR_STATUS_NO_COLOR_NAME;
+  }
+
+  /*
+   * Parses a decimal number, with whitespace already removed, and returns
+   * its magnitude times 10^9, rounded down and clamped to 10^15, with the
+   * sign applied. Arbitrarily long mantissas and exponents are exact.
+   */
+  inline cpar_status parse_fixed(std::string_view str, int64_t &out)
+  {
+    size_t i = 0;
+    bool negative = false;
+    std::string digits; // without the decimal point
+    long long point = 0; // digits before the decimal point
+    bool seen_point = false;
+
+    if (i < str.size() && (str[i] == '+' || str[i] == '-'))
+      negative = str[i++] == '-';
+    for (; i < str.size(); i++) {
+      if (is_digit(str[i])) {
+        digits += str[i];
+        point += !seen_point;
+      } else if (str[i] == '.' && !seen_point) {
+        seen_point = true;
+      } else {
+        break;
+      }
+    }
+    if (digits.empty())
+      return CPAR_STATUS_INVALID_NUMBER;
+
+    if (i < str.size() && (str[i] == 'e' || str[i] == 'E')) {
+      bool exp_negative = false;
+      long long exp = 0;
+      i++;
+      if (i < str.size() && (str[i] == '+' || str[i] == '-'))
+        exp_negative = str[i++] == '-';
+      if (i == str.size())
+        return CPAR_STATUS_INVALID_NUMBER;
+      for (; i < str.size(); i++) {
+        if (!is_digit(str[i]))
+          return CPAR_STATUS_INVALID_NUMBER;
+        // anything this big clamps or rounds to zero anyway
+        if (exp < 1000000)
+          exp = exp * 10 + (str[i] - '0');
+      }
+      point += exp_negative ? -exp : exp;
+    }
+    if (i != str.size())
+      return CPAR_STATUS_INVALID_NUMBER;
+
+    size_t zeros = digits.find_first_not_of('0');
+    if (zeros == std::string::npos) {
+      out = 0;
+      return CPAR_STATUS_OK;
+    }
+    digits.erase(0, zeros);
+    point -= static_cast<long long>(zeros);
+
+    // the integer part of the value times 10^9, which has point + 9 digits
+    const int64_t clamp = INT64_C(1000000000000000);
+    int64_t magnitude = clamp;
+    if (point + 9 <= 16) {
+      magnitude = 0;
+      for (long long k = 0; k < point + 9; k++) {
+        size_t j = static_cast<size_t>(k);
+        magnitude = magnitude * 10 + (j < digits.size() ? digits[j] - '0' : 0);
+      }
+      magnitude = std::min(magnitude, clamp);
+    }
+
+    out = negative ? -magnitude : magnitude;
+    return CPAR_STATUS_OK;
+  }
+
+  // strips a trailing `%`, after any whitespace
+  inline bool strip_percent(std::string &str)
+  {
+    str = trim(str);
+    if (str.empty() || str.back() != '%')
+      return false;
+    str.pop_back();
+    return true;
+  }
+
+  inline cpar_status parse_rgb(std::string str, uint8_t &out)
+  {
+    int64_t fixed = 0;
+    if (strip_percent(str)) {
+      if (cpar_status status = parse_fixed(compact(str), fixed);
+          status != CPAR_STATUS_OK) {
+        return status;
+      }
+      if (fixed < 0 || fixed > INT64_C(100000000000))
+        return CPAR_STATUS_NUMBER_RANGE;
+      // fixed / 10^9 percent of 255, rounded half up
+      out = static_cast<uint8_t>((fixed * 255 + INT64_C(50000000000)) /
+                                 INT64_C(100000000000));
+      return CPAR_STATUS_OK;
+    }
+
+    str = compact(str);
+    size_t i = (!str.empty() && (str[0] == '+' || str[0] == '-')) ? 1 : 0;
+    bool negative = i == 1 && str[0] == '-';
+    if (i == str.size())
+      return CPAR_STATUS_INVALID_NUMBER;
+    unsigned long long value = 0;
+    for (; i < str.size(); i++) {
+      if (!is_digit(str[i]))
+        return CPAR_STATUS_INVALID_NUMBER;
+      value = value > 1000 ? value : value * 10 + (str[i] - '0');
+    }
+    if (value > 255 || (negative && value != 0))
+      return CPAR_STATUS_NUMBER_RANGE;
+    out = static_cast<uint8_t>(value);
+    return CPAR_STATUS_OK;
+  }
+
+  inline cpar_status parse_alpha(std::string str, uint8_t &out)
+  {
+    int64_t fixed = 0;
+    bool percent = strip_percent(str);
+    if (cpar_status status = parse_fixed(compact(str), fixed);
+        status != CPAR_STATUS_OK) {
+      return status;
+    }
+    if (percent)
+      fixed /= 100;
+    if (fixed < 0 || fixed > 1000000000)
+      return CPAR_STATUS_NUMBER_RANGE;
+    out = static_cast<uint8_t>((fixed * 255 + 500000000) / 1000000000);
+    return CPAR_STATUS_OK;
+  }
+
+  // a percentage in units of 0.01%
+  inline cpar_status parse_percent(std::string str, int64_t &out)
+  {
+    int64_t fixed = 0;
+    strip_percent(str);
+    if (cpar_status status = parse_fixed(compact(str), fixed);
+        status != CPAR_STATUS_OK) {
+      return status;
+    }
+    if (fixed < 0 || fixed > INT64_C(100000000000))
+      return CPAR_STATUS_NUMBER_RANGE;
+    out = (fixed + 5000000) / 10000000;
+    return CPAR_STATUS_OK;
+  }
+
+  // a hue in millidegrees, from 0 up to 360000
+  inline cpar_status parse_hue(std::string str, int64_t &out)
+  {
+    static const struct {
+      const char *unit;
+      int64_t turn;
+    } units[] = {
+        {"deg", INT64_C(360000000000)},
+        {"grad", INT64_C(400000000000)},
+        {"rad", INT64_C(6283185307)},
+        {"turn", INT64_C(1000000000)},
+    };
+    int64_t turn = INT64_C(360000000000);
+    int64_t fixed = 0;
+
+    str = trim(str);
+    for (auto const &u : units) {
+      std::string_view unit{u.unit};
+      if (str.size() >= unit.size() &&
+          lower(str.substr(str.size() - unit.size())) == unit) {
+        str.resize(str.size() - unit.size());
+        turn = u.turn;
+        break;
+      }
+    }
+
+    if (cpar_status status = parse_fixed(compact(str), fixed);
+        status != CPAR_STATUS_OK) {
+      return status;
+    }
+    fixed = ((fixed % turn) + turn) % turn;
+    out = fixed * 360000 / turn;
+    return CPAR_STATUS_OK;
+  }
+
+  /*
+   * The CSS Color 4 conversions, in exact integer arithmetic with hues in
+   * twelfths of a turn: each channel is lightness minus chroma times a
+   * clamped triangle wave of the hue.
+   */
+  inline int64_t triangle(int64_t hue, int n)
+  {
+    const int64_t twelfth = 30000;
+    int64_t k = (n * twelfth + hue) % 360000;
+    int64_t t = std::min(k - 3 * twelfth, 9 * twelfth - k);
+    return std::max(-twelfth, std::min(t, twelfth));
+  }
+
+  inline uint8_t round_div(int64_t num, int64_t den)
+  {
+    return static_cast<uint8_t>((2 * num + den) / (2 * den));
+  }
+
+  inline void hsl(int64_t h, int64_t s, int64_t l, uint8_t (&rgb)[3])
+  {
+    const int n[3] = {0, 8, 4};
+    int64_t chroma = s * std::min(l, 10000 - l);
+    for (int i = 0; i < 3; i++) {
+      int64_t v = l * 10000 * 30000 - chroma * triangle(h, n[i]);
+      rgb[i] = round_div(255 * v, INT64_C(10000) * 10000 * 30000);
+    }
+  }
+
+  inline void hwb(int64_t h, int64_t w, int64_t b, uint8_t (&rgb)[3])
+  {
+    const int n[3] = {0, 8, 4};
+    if (w + b >= 10000) {
+      rgb[0] = rgb[1] = rgb[2] = round_div(255 * w, w + b);
+      return;
+    }
+    for (int i = 0; i < 3; i++) {
+      // the HSL value at 100% saturation and 50% lightness, then mixed
+      int64_t pure = 30000 - triangle(h, n[i]);
+      int64_t v = pure * (10000 - w - b) + 60000 * w;
+      rgb[i] = round_div(255 * v, INT64_C(60000) * 10000);
+    }
+  }
+
+  // the comma-separated components, without the empty ones
+  inline std::vector<std::string> split_comma(std::string_view body)
+  {
+    std::vector<std::string> parts;
+    size_t start = 0;
+    for (;;) {
+      size_t comma = body.find(',', start);
+      std::string part{body.substr(start, comma - start)};
+      if (!trim(part).empty())
+        parts.push_back(part);
+      if (comma == std::string_view::npos)
+        break;
+      start = comma + 1;
+    }
+    return parts;
+  }
+
+  // the space-separated components, or nothing if the syntax is wrong
+  inline std::vector<std::string> split_space(std::string_view body)
+  {
+    std::vector<std::string> words;
+    std::string word;
+    for (char c : body) {
+      if (is_space(c) || c == '/') {
+        if (!word.empty())
+          words.push_back(word);
+        word.clear();
+        if (c == '/')
+          words.push_back("/");
+      } else {
+        word += c;
+      }
+    }
+    if (!word.empty())
+      words.push_back(word);
+
+    if (words.size() == 3 && words[0] != "/" && words[1] != "/" &&
+        words[2] != "/") {
+      return words;
+    } else if (words.size() == 5 && words[3] == "/" && words[0] != "/" &&
+               words[1] != "/" && words[2] != "/" && words[4] != "/") {
+      return {words[0], words[1], words[2], words[4]};
+    }
+    return {};
+  }
+
+  // the index in str just past `word`, ignoring whitespace and case, or 0
+  inline size_t match_word(std::string_view str, std::string_view word)
+  {
+    size_t i = 0;
+    for (char c : word) {
+      while (i < str.size() && is_space(str[i]))
+        i++;
+      if (i == str.size() || to_lower(str[i]) != c)
+        return 0;
+      i++;
+    }
+    return i;
+  }
+
+  inline cpar_status parse(std::string_view input, uint32_t &value)
+  {
+    if (input.data() == nullptr || input.empty())
+      return CPAR_STATUS_INVALID_PARAMETER;
+    if (input.find('\0') != std::string_view::npos)
+      return CPAR_STATUS_SYNTAX_ERROR;
+
+    std::string str = trim(input);
+    if (!str.empty() && str[0] == '#')
+      return parse_hex(std::string_view{str}.substr(1), value);
+
+    static const struct {
+      const char *word;
+      char func;
+      size_t n_comp;
+    } functions[] = {
+        {"rgb(", 'r', 3},
+        {"rgba(", 'r', 4},
+        {"hsl(", 'h', 3},
+        {"hsla(", 'h', 4},
+        {"hwb(", 'w', 3},
+    };
+    char func = 0;
+    size_t n_comp = 0;
+    size_t start = 0;
+    for (auto const &f : functions) {
+      if ((start = match_word(str, f.word)) != 0) {
+        func = f.func;
+        n_comp = f.n_comp;
+        break;
+      }
+    }
+    if (!func)
+      return parse_name(str, value);
+
+    if (start == str.size() || str.back() != ')')
+      return CPAR_STATUS_SYNTAX_ERROR;
+    std::string_view body =
+        std::string_view{str}.substr(start, str.size() - 1 - start);
+
+    std::vector<std::string> comp;
+    if (body.find(',') != std::string_view::npos) {
+      if (func == 'w')
+        return CPAR_STATUS_SYNTAX_ERROR;
+      comp = split_comma(body);
+      if (comp.size() > n_comp)
+        comp.resize(n_comp);
+    } else {
+      comp = split_space(body);
+      if (comp.empty())
+        return CPAR_STATUS_SYNTAX_ERROR;
+      n_comp = comp.size();
+    }
+
+    uint8_t rgb[3] = {0, 0, 0};
+    uint8_t alpha = 255;
+    int64_t hue = 0;
+    int64_t percent[3] = {0, 0, 0};
+    for (size_t i = 0; i < comp.size(); i++) {
+      cpar_status status = CPAR_STATUS_OK;
+      if (i == 3)
+        status = parse_alpha(comp[i], alpha);
+      else if (func == 'r')
+        status = parse_rgb(comp[i], rgb[i]);
+      else if (i == 0)
+        status = parse_hue(comp[i], hue);
+      else
+        status = parse_percent(comp[i], percent[i]);
+      if (status != CPAR_STATUS_OK)
+        return status;
+    }
+    if (comp.size() != n_comp)
+      return CPAR_STATUS_SYNTAX_ERROR;
+
+    if (func == 'h')
+      hsl(hue, percent[1], percent[2], rgb);
+    else if (func == 'w')
+      hwb(hue, percent[1], percent[2], rgb);
+
+    value = CPAR_COLOR_MAKE(rgb[0], rgb[1], rgb[2], alpha);
+    return CPAR_STATUS_OK;
+  }
+
+} // namespace reference
+
+#endif // CPAR_TESTS_REFERENCE_H
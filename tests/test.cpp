@@ -2,7 +2,21 @@
 #include "catch_amalgamated.hpp"
 
 #define CPAR_IMPLEMENTATION
+#define CPAR_ENABLE_STATS
+#define CPAR_ENABLE_STATS_CYCLES
 #include "cpar.h"
+#include "differential.h"
+
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <cmath>
+#include <cstdio>
+#include <cstring>
+#include <sstream>
+#include <string>
+#include <thread>
+#include <vector>
 
 static cpar_status status;
 static cpar::color clr;
@@ -61,6 +75,19 @@ TEST_CASE("#f")
   CHECK(status == CPAR_STATUS_SYNTAX_ERROR);
 }
 
+TEST_CASE("#ABC")
+{
+  ASSIGN("#ABC");
+  CHECK(status == CPAR_STATUS_OK);
+  CHECK(clr.value == 0xaabbccff);
+}
+
+TEST_CASE("#+f+f+f")
+{
+  ASSIGN("#+f+f+f");
+  CHECK(status == CPAR_STATUS_INVALID_NUMBER);
+}
+
 //
 // Medium-form HTML hex
 //
@@ -106,6 +133,13 @@ TEST_CASE("#00zz00")
   CHECK(status == CPAR_STATUS_INVALID_NUMBER);
 }
 
+TEST_CASE("#1a2B3c")
+{
+  ASSIGN("#1a2B3c");
+  CHECK(status == CPAR_STATUS_OK);
+  CHECK(clr.value == 0x1a2b3cff);
+}
+
 //
 // Long-form HTML hex
 //
@@ -173,11 +207,22 @@ TEST_CASE("#ff00ff7f")
   CHECK(clr.value == 0xff00ff7f);
 }
 
-// too long to fit in working buffer inside parse function
+TEST_CASE("#0123456g")
+{
+  ASSIGN("#0123456g");
+  CHECK(status == CPAR_STATUS_INVALID_NUMBER);
+}
+
+TEST_CASE("#0000000")
+{
+  ASSIGN("#0000000");
+  CHECK(status == CPAR_STATUS_SYNTAX_ERROR);
+}
+
 TEST_CASE("#fffffffffffffffffffffffffffffffffffffffffffffffffffffffffffffffff")
 {
   ASSIGN("#fffffffffffffffffffffffffffffffffffffffffffffffffffffffffffffffff");
-  CHECK(status == CPAR_STATUS_TOO_BIG);
+  CHECK(status == CPAR_STATUS_SYNTAX_ERROR);
 }
 
 //
@@ -233,11 +278,33 @@ TEST_CASE("rgb ( 1 , 2, 3 )")
   CHECK(clr.value == 0x010203ff);
 }
 
+TEST_CASE("rgb() with lots of whitespace")
+{
+  std::string str = "rgb(" + std::string(100, ' ') + "1," +
+                    std::string(100, '\t') + "2, 3 )";
+  ASSIGN(str);
+  CHECK(status == CPAR_STATUS_OK);
+  CHECK(clr.value == 0x010203ff);
+}
+
 TEST_CASE("rgb(50%, 100  %, 127)")
 {
   ASSIGN("rgb(50%, 100  %, 127)");
   CHECK(status == CPAR_STATUS_OK);
-  CHECK(clr.value == 0x7fff7fff);
+  CHECK(clr.value == 0x80ff7fff);
+}
+
+TEST_CASE("rgb(50.5%, 0.2%, 1e1%)")
+{
+  ASSIGN("rgb(50.5%, 0.2%, 1e1%)");
+  CHECK(status == CPAR_STATUS_OK);
+  CHECK(clr.value == 0x81011aff);
+}
+
+TEST_CASE("rgb(100.1%, 0, 0)")
+{
+  ASSIGN("rgb(100.1%, 0, 0)");
+  CHECK(status == CPAR_STATUS_NUMBER_RANGE);
 }
 
 //
@@ -250,7 +317,206 @@ TEST_CASE("rgba(50 %, 255, 100%, 0.5)")
 {
   ASSIGN("rgba(50 %, 255, 100%, 0.5)");
   CHECK(status == CPAR_STATUS_OK);
-  CHECK(clr.value == 0x7fffff7f);
+  CHECK(clr.value == 0x80ffff80);
+}
+
+TEST_CASE("rgba() alpha rounding")
+{
+  for (unsigned a = 0; a < 256; a++) {
+    char str[48];
+    std::snprintf(str, sizeof(str), "rgba(0, 0, 0, %.6f)", a / 255.0);
+    INFO(str);
+    ASSIGN(str);
+    CHECK(status == CPAR_STATUS_OK);
+    CHECK(clr.alpha() == a);
+  }
+  ASSIGN("rgba(0, 0, 0, 5e-1)");
+  CHECK(clr.alpha() == 0x80);
+  ASSIGN("rgba(0, 0, 0, .001)");
+  CHECK(clr.alpha() == 0);
+  ASSIGN("rgba(0, 0, 0, 0.0019607)");
+  CHECK(clr.alpha() == 0);
+  ASSIGN("rgba(0, 0, 0, 0.0019608)");
+  CHECK(clr.alpha() == 1);
+}
+
+TEST_CASE("rgba() bad alpha")
+{
+  ASSIGN("rgba(0, 0, 0, 1.01)");
+  CHECK(status == CPAR_STATUS_NUMBER_RANGE);
+  ASSIGN("rgba(0, 0, 0, -0.5)");
+  CHECK(status == CPAR_STATUS_NUMBER_RANGE);
+  ASSIGN("rgba(0, 0, 0, 0,5)");
+  CHECK(status == CPAR_STATUS_OK); // extra components are ignored
+  ASSIGN("rgba(0, 0, 0, 0.5.)");
+  CHECK(status == CPAR_STATUS_INVALID_NUMBER);
+  ASSIGN("rgba(0, 0, 0, inf)");
+  CHECK(status == CPAR_STATUS_INVALID_NUMBER);
+  ASSIGN("rgba(0, 0, 0, 1e)");
+  CHECK(status == CPAR_STATUS_INVALID_NUMBER);
+}
+
+TEST_CASE("rgba() percentage alpha")
+{
+  ASSIGN("rgba(0, 0, 0, 50%)");
+  CHECK(status == CPAR_STATUS_OK);
+  CHECK(clr.value == 0x00000080);
+  ASSIGN("rgba(0, 0, 0, 101%)");
+  CHECK(status == CPAR_STATUS_NUMBER_RANGE);
+}
+
+//
+// Space-separated syntax
+//
+
+TEST_CASE("rgb(255 0 0 / 50%)")
+{
+  ASSIGN("rgb(255 0 0 / 50%)");
+  CHECK(status == CPAR_STATUS_OK);
+  CHECK(clr.value == 0xff000080);
+  ASSIGN("rgb(255 0 0/0.5)");
+  CHECK(status == CPAR_STATUS_OK);
+  CHECK(clr.value == 0xff000080);
+  ASSIGN("rgba( 1 2 3 )");
+  CHECK(status == CPAR_STATUS_OK);
+  CHECK(clr.value == 0x010203ff);
+  ASSIGN("rgb(100% 50% 0%)");
+  CHECK(status == CPAR_STATUS_OK);
+  CHECK(clr.value == 0xff8000ff);
+}
+
+TEST_CASE("space-separated syntax errors")
+{
+  const char *bad[] = {"rgb(1 2)",
+                       "rgb(1 2 3 4)",
+                       "rgb(1 2 3 /)",
+                       "rgb(1 2 / 3)",
+                       "rgb(1 2 3 / 4 5)",
+                       "rgb(1 2 3 // 4)",
+                       "rgb()"};
+  for (const char *str : bad) {
+    INFO(str);
+    CHECK(cpar_color_parse(str, NULL) == CPAR_STATUS_SYNTAX_ERROR);
+  }
+  CHECK(cpar_color_parse("rgb(1 2 x)", NULL) == CPAR_STATUS_INVALID_NUMBER);
+  CHECK(cpar_color_parse("rgb(1 2 256)", NULL) == CPAR_STATUS_NUMBER_RANGE);
+}
+
+//
+// HSL and HWB functions
+//
+
+TEST_CASE("hsl()")
+{
+  ASSIGN("hsl(0, 100%, 50%)");
+  CHECK(status == CPAR_STATUS_OK);
+  CHECK(clr.value == 0xff0000ff);
+  ASSIGN("hsl(120 100% 25%)");
+  CHECK(status == CPAR_STATUS_OK);
+  CHECK(clr.value == 0x008000ff);
+  ASSIGN("hsl(30, 50%, 50%)");
+  CHECK(status == CPAR_STATUS_OK);
+  CHECK(clr.value == 0xbf8040ff);
+  ASSIGN("HSL(210 100% 56%)");
+  CHECK(status == CPAR_STATUS_OK);
+  CHECK(clr.value == 0x1f8fffff);
+  ASSIGN("hsl(0 0% 100%)");
+  CHECK(status == CPAR_STATUS_OK);
+  CHECK(clr.value == 0xffffffff);
+  ASSIGN("hsl(270 60 70)");
+  CHECK(status == CPAR_STATUS_OK);
+  CHECK(clr.value == 0xb385e0ff);
+}
+
+TEST_CASE("hsla()")
+{
+  ASSIGN("hsla(240, 100%, 50%, 0.5)");
+  CHECK(status == CPAR_STATUS_OK);
+  CHECK(clr.value == 0x0000ff80);
+  ASSIGN("hsl(240 100% 50% / 25%)");
+  CHECK(status == CPAR_STATUS_OK);
+  CHECK(clr.value == 0x0000ff40);
+  ASSIGN("hsla(240, 100%, 50%)");
+  CHECK(status == CPAR_STATUS_SYNTAX_ERROR);
+}
+
+TEST_CASE("hsl() hue units")
+{
+  const char *blue[] = {"hsl(240 100% 50%)",
+                        "hsl(240deg 100% 50%)",
+                        "hsl(240DEG 100% 50%)",
+                        "hsl(-120 100% 50%)",
+                        "hsl(600 100% 50%)",
+                        "hsl(266.6667grad 100% 50%)",
+                        "hsl(4.18879rad 100% 50%)",
+                        "hsl(0.6666667turn 100% 50%)",
+                        "hsl(240.0e0, 100%, 50%)"};
+  for (const char *str : blue) {
+    INFO(str);
+    ASSIGN(str);
+    CHECK(status == CPAR_STATUS_OK);
+    CHECK(clr.value == 0x0000ffff);
+  }
+}
+
+TEST_CASE("hsl() errors")
+{
+  CHECK(cpar_color_parse("hsl(0, 101%, 50%)", NULL) ==
+        CPAR_STATUS_NUMBER_RANGE);
+  CHECK(cpar_color_parse("hsl(0 50% -1%)", NULL) == CPAR_STATUS_NUMBER_RANGE);
+  CHECK(cpar_color_parse("hsl(0deg2 50% 50%)", NULL) ==
+        CPAR_STATUS_INVALID_NUMBER);
+  CHECK(cpar_color_parse("hsl(deg 50% 50%)", NULL) ==
+        CPAR_STATUS_INVALID_NUMBER);
+  CHECK(cpar_color_parse("hsl(0, 50%)", NULL) == CPAR_STATUS_SYNTAX_ERROR);
+  CHECK(cpar_color_parse("hsl(0 50% 50%", NULL) == CPAR_STATUS_SYNTAX_ERROR);
+}
+
+TEST_CASE("hsl() matches the floating-point conversion")
+{
+  for (int h = 0; h < 360; h += 7) {
+    for (int sat = 0; sat <= 100; sat += 10) {
+      for (int l = 0; l <= 100; l += 10) {
+        char str[48];
+        std::snprintf(str, sizeof(str), "hsl(%d %d%% %d%%)", h, sat, l);
+        INFO(str);
+        REQUIRE(cpar_color_parse(str, NULL) == CPAR_STATUS_OK);
+        cpar::color c{str};
+        double a = sat / 100.0 * std::min(l / 100.0, 1 - l / 100.0);
+        const int channels[] = {c.red(), c.green(), c.blue()};
+        const int ns[] = {0, 8, 4};
+        for (int i = 0; i < 3; i++) {
+          double k = std::fmod(ns[i] + h / 30.0, 12);
+          double t = std::max(-1.0, std::min({k - 3, 9 - k, 1.0}));
+          double expected = (l / 100.0 - a * t) * 255;
+          CHECK(std::abs(channels[i] - expected) <= 0.5 + 1e-9);
+        }
+      }
+    }
+  }
+}
+
+TEST_CASE("hwb()")
+{
+  ASSIGN("hwb(0 0% 0%)");
+  CHECK(status == CPAR_STATUS_OK);
+  CHECK(clr.value == 0xff0000ff);
+  ASSIGN("hwb(120 20% 30%)");
+  CHECK(status == CPAR_STATUS_OK);
+  CHECK(clr.value == 0x33b333ff);
+  ASSIGN("hwb(210 10% 0% / 0.5)");
+  CHECK(status == CPAR_STATUS_OK);
+  CHECK(clr.value == 0x1a8cff80);
+  // a whiteness and blackness which add up to more than 100% give a grey
+  ASSIGN("hwb(0 60% 60%)");
+  CHECK(status == CPAR_STATUS_OK);
+  CHECK(clr.value == 0x808080ff);
+  ASSIGN("hwb(0 100% 0%)");
+  CHECK(status == CPAR_STATUS_OK);
+  CHECK(clr.value == 0xffffffff);
+  // hwb() has no legacy comma-separated syntax
+  ASSIGN("hwb(0, 0%, 0%)");
+  CHECK(status == CPAR_STATUS_SYNTAX_ERROR);
 }
 
 //
@@ -278,6 +544,76 @@ TEST_CASE("MediumOrchid")
   CHECK(clr.value == 0xba55d3ff);
 }
 
+TEST_CASE("aqua")
+{
+  ASSIGN("aqua");
+  CHECK(status == CPAR_STATUS_OK);
+  CHECK(clr.value == 0x00ffffff);
+}
+
+TEST_CASE("black")
+{
+  ASSIGN("black");
+  CHECK(status == CPAR_STATUS_OK);
+  CHECK(clr.value == 0x000000ff);
+}
+
+TEST_CASE("RebeccaPurple")
+{
+  ASSIGN("RebeccaPurple");
+  CHECK(status == CPAR_STATUS_OK);
+  CHECK(clr.value == 0x663399ff);
+}
+
+TEST_CASE("transparent")
+{
+  ASSIGN("transparent");
+  CHECK(status == CPAR_STATUS_OK);
+  CHECK(clr.value == 0x00000000);
+  CHECK(std::string{cpar_lookup_color_name(0x00000000)} == "transparent");
+}
+
+TEST_CASE("every named colour")
+{
+  for (size_t i = 0; i < CPAR_N_COLOR_NAMES; i++) {
+    const char *name = cpar_color_names + cpar_color_name_offsets[i];
+    uint32_t value = 0;
+    CAPTURE(name);
+    CHECK(cpar_color_parse(name, &value) == CPAR_STATUS_OK);
+    CHECK(value == cpar_color_name_values[i]);
+  }
+}
+
+TEST_CASE("colour name table layout")
+{
+  size_t max_len = 0;
+
+  CHECK(cpar_color_name_offsets[0] == 0);
+  CHECK(cpar_color_name_offsets[CPAR_N_COLOR_NAMES] ==
+        sizeof(cpar_color_names) - 1);
+  for (size_t i = 0; i < CPAR_N_COLOR_NAMES; i++) {
+    const char *name = cpar_color_names + cpar_color_name_offsets[i];
+    size_t len = cpar_color_name_offsets[i + 1] - cpar_color_name_offsets[i];
+    CAPTURE(name);
+    CHECK(std::strlen(name) == len - 1);
+    max_len = std::max(max_len, len - 1);
+  }
+  CHECK(max_len == CPAR_MAX_COLOR_NAME_LEN);
+
+  // longer than any name, with the first bytes of one
+  uint32_t value = 0;
+  CHECK(cpar_color_parse("lightgoldenrodyellowx", &value) ==
+        CPAR_STATUS_NO_COLOR_NAME);
+  CHECK(cpar_color_parse("light goldenrod yellow", &value) == CPAR_STATUS_OK);
+  CHECK(value == 0xfafad2ff);
+}
+
+TEST_CASE("redd")
+{
+  ASSIGN("redd");
+  CHECK(status == CPAR_STATUS_NO_COLOR_NAME);
+}
+
 TEST_CASE("NOT_A_REAL_COLOR")
 {
   ASSIGN("NOT_A_REAL_COLOR");
@@ -293,3 +629,2028 @@ TEST_CASE("")
   ASSIGN("");
   CHECK(status == CPAR_STATUS_INVALID_PARAMETER);
 }
+
+//
+// Length-delimited parsing
+//
+
+TEST_CASE("cpar_color_parse_n() without zero-terminator")
+{
+  const char buf[] = {'#', 'f', '0', '0', 'f', 'f', 'f'};
+  uint32_t value = 0;
+  CHECK(cpar_color_parse_n(buf, 4, &value) == CPAR_STATUS_OK);
+  CHECK(value == 0xff0000ff);
+}
+
+TEST_CASE("cpar_color_parse_n() inside a larger string")
+{
+  const char *css = "color: rgb(1, 2, 3); background: navy;";
+  uint32_t value = 0;
+  CHECK(cpar_color_parse_n(css + 7, 12, &value) == CPAR_STATUS_OK);
+  CHECK(value == 0x010203ff);
+  CHECK(cpar_color_parse_n(css + 33, 4, &value) == CPAR_STATUS_OK);
+  CHECK(value == 0x000080ff);
+}
+
+TEST_CASE("cpar_color_parse_n() with embedded NUL")
+{
+  CHECK(cpar_color_parse_n("red\0xyz", 7, NULL) == CPAR_STATUS_SYNTAX_ERROR);
+}
+
+TEST_CASE("cpar_color_parse_n() with zero length")
+{
+  CHECK(cpar_color_parse_n("red", 0, NULL) == CPAR_STATUS_INVALID_PARAMETER);
+  CHECK(cpar_color_parse_n(NULL, 3, NULL) == CPAR_STATUS_INVALID_PARAMETER);
+}
+
+TEST_CASE("std::string_view")
+{
+  std::string_view sv{"#00ff00 trailing garbage"};
+  ASSIGN(sv.substr(0, 7));
+  CHECK(status == CPAR_STATUS_OK);
+  CHECK(clr.value == 0x00ff00ff);
+  ASSIGN(std::string{"teal"});
+  CHECK(status == CPAR_STATUS_OK);
+  CHECK(clr.value == 0x008080ff);
+}
+
+//
+// Thread safety
+//
+
+TEST_CASE("concurrent rgb() and rgba() parsing")
+{
+  static const struct {
+    const char *str;
+    uint32_t value;
+  } inputs[] = {
+      {"rgb(1,2,3)", 0x010203ff},
+      {"rgb(10, 20, 30)", 0x0a141eff},
+      {"rgba(255,128,0,1)", 0xff8000ff},
+      {"rgba(4, 5, 6, 0)", 0x04050600},
+  };
+  std::atomic<int> failures{0};
+  std::vector<std::thread> threads;
+
+  for (auto const &input : inputs) {
+    threads.emplace_back([&failures, input] {
+      for (int i = 0; i < 20000; i++) {
+        uint32_t value = 0;
+        if (cpar_color_parse(input.str, &value) != CPAR_STATUS_OK ||
+            value != input.value) {
+          failures++;
+        }
+      }
+    });
+  }
+  for (auto &thread : threads)
+    thread.join();
+
+  CHECK(failures == 0);
+}
+
+//
+// Colour name lookup
+//
+
+TEST_CASE("cpar_lookup_color_name()")
+{
+  CHECK(std::string{cpar_lookup_color_name(0xff0000ff)} == "red");
+  CHECK(std::string{cpar_lookup_color_name(0x20b2aaff)} == "lightseagreen");
+  CHECK(std::string{cpar_lookup_color_name(0xfffafaff)} == "snow");
+  CHECK(cpar_lookup_color_name(0x123456ff) == NULL);
+  CHECK(cpar_lookup_color_name(0xff000000) == NULL);
+}
+
+TEST_CASE("cpar_lookup_color_name() with aliases")
+{
+  CHECK(std::string{cpar_lookup_color_name(0x00ffffff)} == "aqua");
+  CHECK(std::string{cpar_lookup_color_name(0xff00ffff)} == "fuchsia");
+  CHECK(std::string{cpar_lookup_color_name(0x808080ff)} == "gray");
+  CHECK(std::string{cpar_lookup_color_name(0x2f4f4fff)} == "darkslategray");
+}
+
+TEST_CASE("cpar_lookup_color_name() round-trip")
+{
+  for (size_t i = 0; i < CPAR_N_COLOR_NAMES; i++) {
+    CAPTURE(cpar_color_names + cpar_color_name_offsets[i]);
+    const char *name = cpar_lookup_color_name(cpar_color_name_values[i]);
+    REQUIRE(name != NULL);
+    uint32_t value = 0;
+    CHECK(cpar_color_parse(name, &value) == CPAR_STATUS_OK);
+    CHECK(value == cpar_color_name_values[i]);
+  }
+}
+
+//
+// Batch parsing
+//
+
+TEST_CASE("cpar_color_parse_batch()")
+{
+  const char text[] = "#ff0000rgb(0, 255, 0)bluebogus# 0 0 f";
+  const cpar_string strs[] = {
+      {text, 7},
+      {text + 7, 14},
+      {text + 21, 4},
+      {text + 25, 5},
+      {text + 30, 7},
+  };
+  uint32_t results[5] = {0, 0, 0, 0xdeadbeef, 0};
+  cpar_status statuses[5];
+
+  CHECK(cpar_color_parse_batch(strs, 5, results, statuses) == 4);
+  CHECK(statuses[0] == CPAR_STATUS_OK);
+  CHECK(results[0] == 0xff0000ff);
+  CHECK(statuses[1] == CPAR_STATUS_OK);
+  CHECK(results[1] == 0x00ff00ff);
+  CHECK(statuses[2] == CPAR_STATUS_OK);
+  CHECK(results[2] == 0x0000ffff);
+  CHECK(statuses[3] == CPAR_STATUS_NO_COLOR_NAME);
+  CHECK(results[3] == 0xdeadbeef);
+  CHECK(statuses[4] == CPAR_STATUS_OK);
+  CHECK(results[4] == 0x0000ffff);
+}
+
+TEST_CASE("cpar_color_parse_batch() without outputs")
+{
+  const cpar_string strs[] = {{"red", 3}, {"#12345", 6}, {NULL, 0}};
+  CHECK(cpar_color_parse_batch(strs, 3, NULL, NULL) == 1);
+  CHECK(cpar_color_parse_batch(NULL, 3, NULL, NULL) == 0);
+}
+
+static std::vector<std::string> make_batch_strings(size_t n)
+{
+  static const char *const samples[] = {
+      "#f0c",    "rgb(1, 2, 3)", "hsl(120 50% 50%)", "red",  "bogus",
+      "#12345",  "rgba(1,2,3)",  "hwb(0 10% 20%)",   "Navy", "#ff00cc80",
+  };
+  std::vector<std::string> strings;
+  for (size_t i = 0; i < n; i++)
+    strings.push_back(samples[(i * 7 + i / 3) % 10]);
+  return strings;
+}
+
+TEST_CASE("cpar_color_parse_batch_parallel() matches cpar_color_parse_batch()")
+{
+  auto strings = make_batch_strings(100003);
+  std::vector<cpar_string> strs;
+  for (auto const &str : strings)
+    strs.push_back({str.data(), str.size()});
+  const size_t n = strs.size();
+
+  std::vector<uint32_t> expected_results(n, 0);
+  std::vector<cpar_status> expected_statuses(n);
+  size_t expected_ok = cpar_color_parse_batch(
+      strs.data(), n, expected_results.data(), expected_statuses.data());
+
+  for (unsigned n_threads : {1u, 2u, 4u}) {
+    CAPTURE(n_threads);
+    cpar::thread_pool pool{n_threads};
+    cpar_executor executor = pool.executor();
+    CHECK(pool.size() == n_threads);
+
+    // several runs on the same pool
+    for (int run = 0; run < 3; run++) {
+      std::vector<uint32_t> results(n, 0);
+      std::vector<cpar_status> statuses(n, CPAR_STATUS_NO_MEMORY);
+      CHECK(cpar_color_parse_batch_parallel(strs.data(),
+                                            n,
+                                            results.data(),
+                                            statuses.data(),
+                                            &executor) == expected_ok);
+      CHECK(results == expected_results);
+      CHECK(statuses == expected_statuses);
+    }
+    CHECK(cpar_color_parse_batch_parallel(
+              strs.data(), n, NULL, NULL, &executor) == expected_ok);
+  }
+
+  CHECK(cpar_color_parse_batch_parallel(
+            strs.data(), n, NULL, NULL, NULL) == expected_ok);
+  CHECK(cpar_color_parse_batch_parallel(NULL, n, NULL, NULL, NULL) == 0);
+}
+
+struct recording_executor {
+  std::vector<size_t> calls;
+  size_t n_runs = 0;
+
+  // runs the tasks backwards to check the order doesn't matter
+  static void run(void *user_data,
+                  void (*task)(void *arg, size_t index),
+                  void *arg,
+                  size_t n_tasks)
+  {
+    auto *self = static_cast<recording_executor *>(user_data);
+    self->n_runs++;
+    for (size_t i = n_tasks; i-- > 0;) {
+      self->calls.push_back(i);
+      task(arg, i);
+    }
+  }
+};
+
+TEST_CASE("cpar_color_parse_batch_parallel() task splitting")
+{
+  auto strings = make_batch_strings(10 * CPAR_PARALLEL_CHUNK + 5);
+  std::vector<cpar_string> strs;
+  for (auto const &str : strings)
+    strs.push_back({str.data(), str.size()});
+
+  recording_executor recorder;
+  cpar_executor executor = {recording_executor::run, &recorder};
+  std::vector<uint32_t> results(strs.size());
+  std::vector<cpar_status> statuses(strs.size());
+
+  SECTION("small batches run on the calling thread")
+  {
+    CHECK(cpar_color_parse_batch_parallel(strs.data(),
+                                          CPAR_PARALLEL_CHUNK,
+                                          results.data(),
+                                          statuses.data(),
+                                          &executor) > 0);
+    CHECK(recorder.n_runs == 0);
+  }
+
+  SECTION("each chunk is one task")
+  {
+    size_t n_ok = cpar_color_parse_batch_parallel(strs.data(),
+                                                  strs.size(),
+                                                  results.data(),
+                                                  statuses.data(),
+                                                  &executor);
+    CHECK(recorder.n_runs == 1);
+    REQUIRE(recorder.calls.size() == 11);
+    for (size_t i = 0; i < 11; i++)
+      CHECK(recorder.calls[i] == 10 - i);
+    CHECK(n_ok == static_cast<size_t>(std::count(
+                      statuses.begin(), statuses.end(), CPAR_STATUS_OK)));
+  }
+
+  SECTION("huge batches are split into at most CPAR_PARALLEL_MAX_TASKS")
+  {
+    // only the lengths matter, so every entry can share one string
+    size_t n = CPAR_PARALLEL_MAX_TASKS * CPAR_PARALLEL_CHUNK + 1;
+    std::vector<cpar_string> many(n, cpar_string{"red", 3});
+    CHECK(cpar_color_parse_batch_parallel(
+              many.data(), n, NULL, NULL, &executor) == n);
+    CHECK(recorder.calls.size() <= CPAR_PARALLEL_MAX_TASKS);
+  }
+}
+
+//
+// Bulk hex decoding
+//
+
+static std::vector<char> make_hex8_records(size_t n, size_t stride)
+{
+  static const char digits[] = "0123456789abcdefABCDEF";
+  std::vector<char> buf(n * stride, ' ');
+  uint32_t seed = 12345;
+  for (size_t i = 0; i < n; i++) {
+    char *rec = &buf[i * stride];
+    rec[0] = '#';
+    for (size_t j = 1; j < 9; j++) {
+      seed = seed * 1103515245 + 12345;
+      rec[j] = digits[(seed >> 16) % 22];
+    }
+    // sprinkle in some invalid records
+    if (i % 13 == 5)
+      rec[1 + (i % 8)] = 'g';
+    if (i % 29 == 7)
+      rec[0] = '$';
+  }
+  return buf;
+}
+
+TEST_CASE("cpar_color_parse_hex8_batch()")
+{
+  const char recs[] = "#ff0000ff#00FF0080#0000fg00#123456789abcdef0";
+  uint32_t results[4];
+  uint64_t invalid = 0;
+
+  CHECK(cpar_color_parse_hex8_batch(recs, 9, 4, results, &invalid) == 1);
+  CHECK(invalid == 0x4);
+  CHECK(results[0] == 0xff0000ff);
+  CHECK(results[1] == 0x00ff0080);
+  CHECK(results[3] == 0x12345678);
+}
+
+TEST_CASE("cpar_color_parse_hex8_batch() matches scalar parser")
+{
+  const size_t n = 1000, stride = 11;
+  std::vector<char> buf = make_hex8_records(n, stride);
+  std::vector<uint32_t> results(n);
+  std::vector<uint64_t> invalid((n + 63) / 64);
+  size_t n_invalid = 0;
+
+  size_t n_bad = cpar_color_parse_hex8_batch(
+      buf.data(), stride, n, results.data(), invalid.data());
+
+  for (size_t i = 0; i < n; i++) {
+    uint32_t value = 0;
+    bool ok = cpar_color_parse_n(&buf[i * stride], 9, &value) ==
+              CPAR_STATUS_OK;
+    bool flagged = (invalid[i / 64] >> (i % 64)) & 1;
+    CAPTURE(i);
+    CHECK(ok == !flagged);
+    if (ok)
+      CHECK(results[i] == value);
+    else
+      n_invalid++;
+  }
+  CHECK(n_bad == n_invalid);
+}
+
+TEST_CASE("hex8 kernels match portable kernel")
+{
+  const size_t n = 61, stride = 9;
+  std::vector<char> buf = make_hex8_records(n, stride);
+  std::vector<uint32_t> expected(n), results(n);
+  uint64_t expected_invalid = cpar_hex8_decode_portable(
+      buf.data(), stride, n, expected.data());
+  std::vector<cpar_hex8_kernel> kernels;
+
+#if defined(CPAR_HAVE_X86_SIMD)
+  if (__builtin_cpu_supports("ssse3"))
+    kernels.push_back(cpar_hex8_decode_ssse3);
+  if (__builtin_cpu_supports("avx2"))
+    kernels.push_back(cpar_hex8_decode_avx2);
+#elif defined(CPAR_HAVE_NEON)
+  kernels.push_back(cpar_hex8_decode_neon);
+#endif
+
+  for (auto kernel : kernels) {
+    CHECK(kernel(buf.data(), stride, n, results.data()) == expected_invalid);
+    for (size_t i = 0; i < n; i++) {
+      if (!((expected_invalid >> i) & 1))
+        CHECK(results[i] == expected[i]);
+    }
+  }
+}
+
+//
+// Pixel conversions
+//
+
+TEST_CASE("cpar_pixels_from_colors() and cpar_pixels_to_colors()")
+{
+  struct {
+    cpar_pixel_format format;
+    const char *order;
+  } formats[] = {{CPAR_PIXEL_RGBA8, "rgba"},
+                 {CPAR_PIXEL_BGRA8, "bgra"},
+                 {CPAR_PIXEL_ARGB8, "argb"},
+                 {CPAR_PIXEL_ABGR8, "abgr"}};
+  for (auto const &f : formats) {
+    // odd lengths leave a tail for the portable code after the SIMD kernels
+    for (size_t n = 0; n < 40; n++) {
+      std::vector<uint32_t> colors(n);
+      for (size_t i = 0; i < n; i++)
+        colors[i] = static_cast<uint32_t>((i + 1) * 2654435761u);
+      std::vector<uint32_t> data = colors;
+      cpar_pixels_from_colors(data.data(), n, f.format);
+      CAPTURE(f.order, n);
+      for (size_t i = 0; i < n; i++) {
+        cpar::color c{colors[i]};
+        auto px = reinterpret_cast<const uint8_t *>(&data[i]);
+        for (size_t k = 0; k < 4; k++) {
+          switch (f.order[k]) {
+            case 'r': CHECK(px[k] == c.red()); break;
+            case 'g': CHECK(px[k] == c.green()); break;
+            case 'b': CHECK(px[k] == c.blue()); break;
+            case 'a': CHECK(px[k] == c.alpha()); break;
+          }
+        }
+      }
+      cpar_pixels_to_colors(data.data(), n, f.format);
+      CHECK(data == colors);
+    }
+  }
+}
+
+// all 65536 combinations of a component and an alpha
+static std::vector<uint32_t> all_component_alpha_pairs()
+{
+  std::vector<uint32_t> colors;
+  for (uint32_t a = 0; a < 256; a++) {
+    for (uint32_t c = 0; c < 256; c++)
+      colors.push_back(CPAR_COLOR_MAKE(c, 255 - c, c / 2, a));
+  }
+  return colors;
+}
+
+static uint32_t rounded_div(uint32_t num, uint32_t den)
+{
+  return (2 * num + den) / (2 * den);
+}
+
+TEST_CASE("cpar_colors_premultiply()")
+{
+  auto colors = all_component_alpha_pairs();
+  auto result = colors;
+  cpar_colors_premultiply(result.data(), result.size());
+  for (size_t i = 0; i < colors.size(); i++) {
+    cpar::color c{colors[i]}, p{result[i]};
+    CAPTURE(i);
+    CHECK(p.red() == rounded_div(c.red() * c.alpha(), 255));
+    CHECK(p.green() == rounded_div(c.green() * c.alpha(), 255));
+    CHECK(p.blue() == rounded_div(c.blue() * c.alpha(), 255));
+    CHECK(p.alpha() == c.alpha());
+  }
+}
+
+TEST_CASE("cpar_colors_unpremultiply()")
+{
+  auto colors = all_component_alpha_pairs();
+  auto result = colors;
+  cpar_colors_unpremultiply(result.data(), result.size());
+  for (size_t i = 0; i < colors.size(); i++) {
+    cpar::color c{colors[i]}, u{result[i]};
+    uint32_t a = c.alpha();
+    CAPTURE(i);
+    if (a == 0) {
+      CHECK(u.value == 0);
+      continue;
+    }
+    CHECK(u.red() == std::min(255u, rounded_div(c.red() * 255, a)));
+    CHECK(u.green() == std::min(255u, rounded_div(c.green() * 255, a)));
+    CHECK(u.blue() == std::min(255u, rounded_div(c.blue() * 255, a)));
+    CHECK(u.alpha() == a);
+  }
+
+  // valid premultiplied colours survive the round trip
+  std::vector<uint32_t> valid;
+  for (uint32_t a = 0; a < 256; a++) {
+    for (uint32_t c = 0; c <= a; c++)
+      valid.push_back(CPAR_COLOR_MAKE(c, 0, a - c, a));
+  }
+  result = valid;
+  cpar_colors_unpremultiply(result.data(), result.size());
+  cpar_colors_premultiply(result.data(), result.size());
+  CHECK(result == valid);
+}
+
+TEST_CASE("cpar_colors_srgb_to_linear() and cpar_colors_linear_to_srgb()")
+{
+  uint32_t colors[] = {0x000000ffu, 0xffffff00u, 0x80c80a7fu};
+  cpar_colors_srgb_to_linear(colors, 3);
+  CHECK(colors[0] == 0x000000ffu);
+  CHECK(colors[1] == 0xffffff00u);
+  CHECK(colors[2] == 0x3793017fu);
+  cpar_colors_linear_to_srgb(colors, 3);
+  CHECK(colors[2] == 0x80c80d7fu); // precision is lost in the darks
+
+  uint32_t gray = 0x808080ffu;
+  cpar_colors_linear_to_srgb(&gray, 1);
+  CHECK(gray == 0xbcbcbcffu);
+
+  // both conversions are monotonic
+  std::vector<uint32_t> ramp(256);
+  for (uint32_t i = 0; i < 256; i++)
+    ramp[i] = CPAR_COLOR_MAKE(i, i, i, 255);
+  auto linear = ramp, srgb = ramp;
+  cpar_colors_srgb_to_linear(linear.data(), linear.size());
+  cpar_colors_linear_to_srgb(srgb.data(), srgb.size());
+  CHECK(std::is_sorted(linear.begin(), linear.end()));
+  CHECK(std::is_sorted(srgb.begin(), srgb.end()));
+}
+
+// the colours with components in steps of 5, with varying alphas, and
+// every value of each component
+static std::vector<uint32_t> color_space_samples()
+{
+  std::vector<uint32_t> colors;
+  for (uint32_t r = 0; r < 256; r += 5)
+    for (uint32_t g = 0; g < 256; g += 5)
+      for (uint32_t b = 0; b < 256; b += 5)
+        colors.push_back(CPAR_COLOR_MAKE(r, g, b, (r + g * 3 + b) & 0xff));
+  for (uint32_t i = 0; i < 256; i++) {
+    colors.push_back(CPAR_COLOR_MAKE(i, 0, 0, 255));
+    colors.push_back(CPAR_COLOR_MAKE(0, i, 0, i));
+    colors.push_back(CPAR_COLOR_MAKE(0, 0, i, 255 - i));
+    colors.push_back(CPAR_COLOR_MAKE(i, i, i, 255));
+  }
+  return colors;
+}
+
+static double srgb_to_linear_reference(double c)
+{
+  return c <= 0.04045 ? c / 12.92 : std::pow((c + 0.055) / 1.055, 2.4);
+}
+
+// the colour space components of the colour @a value, in double precision
+static void color_space_reference(uint32_t value,
+                                  cpar_color_space space,
+                                  double out[3])
+{
+  double r = CPAR_COLOR_RED(value) / 255.0;
+  double g = CPAR_COLOR_GREEN(value) / 255.0;
+  double b = CPAR_COLOR_BLUE(value) / 255.0;
+  double max = std::max({r, g, b}), min = std::min({r, g, b});
+  double d = max - min, h = 0;
+  if (d > 0) {
+    if (max == r)
+      h = std::fmod((g - b) / d + 6, 6);
+    else if (max == g)
+      h = (b - r) / d + 2;
+    else
+      h = (r - g) / d + 4;
+  }
+  switch (space) {
+  case CPAR_SPACE_LINEAR_SRGB:
+    out[0] = srgb_to_linear_reference(r);
+    out[1] = srgb_to_linear_reference(g);
+    out[2] = srgb_to_linear_reference(b);
+    break;
+  case CPAR_SPACE_HSL:
+    out[0] = h * 60;
+    out[2] = (max + min) / 2;
+    out[1] = d > 0 ? d / (1 - std::fabs(2 * out[2] - 1)) : 0;
+    break;
+  case CPAR_SPACE_HSV:
+    out[0] = h * 60;
+    out[1] = max > 0 ? d / max : 0;
+    out[2] = max;
+    break;
+  case CPAR_SPACE_OKLAB: {
+    r = srgb_to_linear_reference(r);
+    g = srgb_to_linear_reference(g);
+    b = srgb_to_linear_reference(b);
+    double l = std::cbrt(0.4122214708 * r + 0.5363325363 * g +
+                         0.0514459929 * b);
+    double m = std::cbrt(0.2119034982 * r + 0.6806995451 * g +
+                         0.1073969566 * b);
+    double s = std::cbrt(0.0883024619 * r + 0.2817188376 * g +
+                         0.6299787005 * b);
+    out[0] = 0.2104542553 * l + 0.7936177850 * m - 0.0040720468 * s;
+    out[1] = 1.9779984951 * l - 2.4285922050 * m + 0.4505937099 * s;
+    out[2] = 0.0259040371 * l + 0.7827717662 * m - 0.8086757660 * s;
+    break;
+  }
+  }
+}
+
+static const cpar_color_space all_color_spaces[] = {
+    CPAR_SPACE_LINEAR_SRGB, CPAR_SPACE_HSL, CPAR_SPACE_HSV, CPAR_SPACE_OKLAB};
+
+TEST_CASE("cpar_colors_to_space()")
+{
+  std::vector<uint32_t> colors = color_space_samples();
+  std::vector<float> out(4 * colors.size());
+
+  for (cpar_color_space space : all_color_spaces) {
+    cpar_colors_to_space(colors.data(), colors.size(), space, out.data());
+    size_t n_bad = 0;
+    for (size_t i = 0; i < colors.size(); i++) {
+      double expected[3];
+      float scalar[4];
+      color_space_reference(colors[i], space, expected);
+      cpar_color_to_space(colors[i], space, scalar);
+      const float *x = &out[4 * i];
+      // the hue is in degrees, and the others are around [0, 1]
+      double hue_margin =
+          space == CPAR_SPACE_HSL || space == CPAR_SPACE_HSV ? 1e-4 : 1e-6;
+      bool good =
+          std::fabs(x[0] - expected[0]) <= hue_margin &&
+          std::fabs(x[1] - expected[1]) <= 1e-6 &&
+          std::fabs(x[2] - expected[2]) <= 1e-6 &&
+          std::fabs(x[3] - CPAR_COLOR_ALPHA(colors[i]) / 255.0) <= 1e-7 &&
+          // the vector kernels match the scalar code exactly
+          std::memcmp(x, scalar, sizeof(scalar)) == 0;
+      if (!good && n_bad++ < 10)
+        FAIL_CHECK(std::hex << colors[i] << " in space " << space << " is "
+                            << x[0] << ", " << x[1] << ", " << x[2] << ", "
+                            << x[3]);
+    }
+    CHECK(n_bad == 0);
+  }
+
+  uint32_t red = 0xff000080u;
+  float c[4];
+  cpar_colors_to_space(&red, 1, CPAR_SPACE_HSL, c);
+  CHECK((c[0] == 0 && c[1] == 1 && c[2] == 0.5f));
+  CHECK(c[3] == Catch::Approx(128 / 255.0));
+  cpar_colors_to_space(&red, 1, CPAR_SPACE_HSV, c);
+  CHECK((c[0] == 0 && c[1] == 1 && c[2] == 1));
+  cpar_colors_to_space(&red, 1, CPAR_SPACE_OKLAB, c);
+  CHECK(c[0] == Catch::Approx(0.627955).margin(1e-5));
+  CHECK(c[1] == Catch::Approx(0.224863).margin(1e-5));
+  CHECK(c[2] == Catch::Approx(0.125846).margin(1e-5));
+
+  // nothing is written for an invalid space
+  float unchanged[4] = {1, 2, 3, 4};
+  cpar_colors_to_space(&red, 1, static_cast<cpar_color_space>(4), unchanged);
+  CHECK(unchanged[0] == 1);
+  cpar_colors_to_space(NULL, 0, CPAR_SPACE_HSL, NULL);
+}
+
+TEST_CASE("cpar_colors_from_space()")
+{
+  std::vector<uint32_t> colors = color_space_samples();
+  std::vector<float> in(4 * colors.size());
+  std::vector<uint32_t> result(colors.size());
+
+  // converting to each space and back gives the colour again
+  for (cpar_color_space space : all_color_spaces) {
+    CAPTURE(space);
+    cpar_colors_to_space(colors.data(), colors.size(), space, in.data());
+    cpar_colors_from_space(in.data(), in.size() / 4, space, result.data());
+    CHECK(result == colors);
+  }
+
+  // and the vector kernels round exactly like the scalar code, including
+  // values outside the gamut and halfway between 8-bit values
+  uint32_t seed = 7;
+  for (float &x : in) {
+    seed = seed * 1664525 + 1013904223;
+    x = static_cast<float>(seed >> 8) / (1 << 24) * 1.4f - 0.2f;
+  }
+  for (uint32_t k = 0; k < 255; k++)
+    in[k] = cpar_srgb_midpoints[k];
+  for (cpar_color_space space : all_color_spaces) {
+    CAPTURE(space);
+    cpar_colors_from_space(in.data(), in.size() / 4, space, result.data());
+    size_t n_bad = 0;
+    for (size_t i = 0; i < result.size(); i++) {
+      if (result[i] != cpar_color_from_space(&in[4 * i], space) &&
+          n_bad++ < 10)
+        FAIL_CHECK("colour " << i << " is " << std::hex << result[i]);
+    }
+    CHECK(n_bad == 0);
+  }
+
+  // linear values are exactly rounded
+  for (uint32_t k = 0; k < 255; k++) {
+    float mid = cpar_srgb_midpoints[k];
+    CHECK(cpar_linear_to_srgb8(mid) == k + 1);
+    CHECK(cpar_linear_to_srgb8(std::nextafter(mid, 0.0f)) == k);
+    CHECK(srgb_to_linear_reference((k + 0.5) / 255) ==
+          Catch::Approx(mid).epsilon(1e-6));
+  }
+
+  const float clamped[] = {
+      2.0f, -1.0f, NAN, 0.5f, // linear
+      -120.0f, 1.0f, 0.5f, 1.0f, // hsl
+      480.0f, 2.0f, 1.0f, 1.0f, // hsv
+      1.0f, 0.5f, 0.0f, 2.0f, // oklab
+  };
+  uint32_t c = 0;
+  cpar_colors_from_space(&clamped[0], 1, CPAR_SPACE_LINEAR_SRGB, &c);
+  CHECK(c == 0xff000080u);
+  cpar_colors_from_space(&clamped[4], 1, CPAR_SPACE_HSL, &c);
+  CHECK(c == 0x0000ffffu);
+  cpar_colors_from_space(&clamped[8], 1, CPAR_SPACE_HSV, &c);
+  CHECK(c == 0x00ff00ffu);
+  cpar_colors_from_space(&clamped[12], 1, CPAR_SPACE_OKLAB, &c);
+  CHECK(c == 0xff00f1ffu);
+
+  cpar_colors_from_space(
+      &clamped[0], 1, static_cast<cpar_color_space>(-1), &c);
+  CHECK(c == 0xff00f1ffu);
+  cpar_colors_from_space(NULL, 0, CPAR_SPACE_HSL, NULL);
+}
+
+// colours converted to OKLab and back at compile time, where no compiler
+// fuses the arithmetic, so they must match the arrays exactly
+struct constant_oklab {
+  std::array<uint32_t, 343> colors;
+  std::array<cpar::oklab, 343> lab;
+  std::array<cpar::oklab, 343> shifted;
+  std::array<uint32_t, 343> from_shifted;
+};
+
+static constexpr constant_oklab constant_oklab_samples = [] {
+  constant_oklab out{};
+  for (size_t i = 0; i < out.colors.size(); i++) {
+    cpar::color c{static_cast<uint8_t>(i % 7 * 42 + i % 5),
+                  static_cast<uint8_t>(i / 7 % 7 * 42),
+                  static_cast<uint8_t>(i / 49 * 42 + 3),
+                  static_cast<uint8_t>(i * 37)};
+    out.colors[i] = c.value;
+    out.lab[i] = cpar::to_oklab(c);
+    out.shifted[i] = {out.lab[i].l * 1.25f - 0.05f,
+                      out.lab[i].a - 0.125f,
+                      out.lab[i].b + 0.0625f,
+                      out.lab[i].alpha};
+    out.from_shifted[i] = cpar::to_color(out.shifted[i]).value;
+  }
+  return out;
+}();
+
+// at run time the compiler may fuse the arithmetic, by at most one step
+static bool nearly_equal(cpar::color a, cpar::color b)
+{
+  for (int shift = 0; shift < 32; shift += 8) {
+    int x = static_cast<int>(a.value >> shift & 0xff);
+    int y = static_cast<int>(b.value >> shift & 0xff);
+    if (x - y > 1 || y - x > 1)
+      return false;
+  }
+  return true;
+}
+
+TEST_CASE("cpar colour space conversions")
+{
+  constexpr cpar::color orange{255, 128, 0};
+  static_assert(cpar::to_linear_rgb(cpar::color{255, 255, 255}).r == 1.0f);
+  static_assert(cpar::to_hsl(orange).s == 1.0f);
+  static_assert(cpar::to_hsv(cpar::color{0, 0, 0}).v == 0.0f);
+  static_assert(cpar::to_color(cpar::hsl{120, 1, 0.5f, 1}) ==
+                cpar::color{0, 255, 0});
+  static_assert(cpar::to_color(cpar::hsv{240, 1, 1, 0}) ==
+                cpar::color{0, 0, 255, 0});
+  static_assert(cpar::to_color(cpar::to_oklab(orange)) == orange);
+  static_assert(cpar::to_color(cpar::to_linear_rgb(orange)) == orange);
+  static_assert(cpar::detail::cbrt(0.125f) == 0.5f);
+  static_assert(cpar::detail::float_bits(1.0f) == 0x3F800000u);
+  static_assert(cpar::detail::float_from_bits(0x3E000000u) == 0.125f);
+
+  // the same arithmetic as the arrays gives the same bits
+  const constant_oklab &k = constant_oklab_samples;
+  std::vector<cpar::oklab> lab(k.colors.size());
+  cpar::convert(k.colors.data(), k.colors.size(), lab.data());
+  CHECK(std::memcmp(lab.data(), k.lab.data(), sizeof(k.lab)) == 0);
+  std::vector<cpar::color> from(k.colors.size());
+  cpar::convert(k.shifted.data(), k.shifted.size(), from.data());
+  for (size_t i = 0; i < from.size(); i++)
+    CHECK(from[i].value == k.from_shifted[i]);
+
+  // the single colour functions match the arrays
+  std::vector<uint32_t> colors = color_space_samples();
+  std::vector<cpar::linear_rgb> linear(colors.size());
+  std::vector<cpar::hsl> hsl(colors.size());
+  std::vector<cpar::hsv> hsv(colors.size());
+  std::vector<cpar::oklab> oklab(colors.size());
+  cpar::convert(colors.data(), colors.size(), linear.data());
+  cpar::convert(colors.data(), colors.size(), hsl.data());
+  cpar::convert(colors.data(), colors.size(), hsv.data());
+  cpar::convert(colors.data(), colors.size(), oklab.data());
+  size_t n_bad = 0;
+  for (size_t i = 0; i < colors.size(); i++) {
+    cpar::color c{colors[i]};
+    cpar::linear_rgb l = cpar::to_linear_rgb(c);
+    cpar::hsl h = cpar::to_hsl(c);
+    cpar::hsv v = cpar::to_hsv(c);
+    cpar::oklab o = cpar::to_oklab(c);
+    bool good = std::memcmp(&l, &linear[i], sizeof(l)) == 0 &&
+                std::memcmp(&h, &hsl[i], sizeof(h)) == 0 &&
+                std::memcmp(&v, &hsv[i], sizeof(v)) == 0 &&
+                std::fabs(o.l - oklab[i].l) <= 1e-6f &&
+                std::fabs(o.a - oklab[i].a) <= 1e-6f &&
+                std::fabs(o.b - oklab[i].b) <= 1e-6f &&
+                o.alpha == oklab[i].alpha && cpar::to_color(l) == c &&
+                cpar::to_color(h) == c && cpar::to_color(v) == c &&
+                cpar::to_color(o) == c;
+    if (!good && n_bad++ < 10)
+      FAIL_CHECK(std::hex << colors[i] << " doesn't match");
+  }
+  CHECK(n_bad == 0);
+
+  // and so do the reverse conversions, for any values
+  std::vector<cpar::color> result(colors.size());
+  uint32_t seed = 11;
+  for (cpar::oklab &o : oklab) {
+    float *x = &o.l;
+    for (int k = 0; k < 4; k++) {
+      seed = seed * 1664525 + 1013904223;
+      x[k] = static_cast<float>(seed >> 8) / (1 << 24) * 1.2f - 0.2f;
+    }
+    hsl[&o - oklab.data()] = {x[0] * 1000, x[1], x[2], x[3]};
+  }
+  cpar::convert(oklab.data(), oklab.size(), result.data());
+  for (size_t i = 0; i < result.size(); i++) {
+    if (!nearly_equal(result[i], cpar::to_color(oklab[i])) && n_bad++ < 10)
+      FAIL_CHECK("oklab colour " << i << " is " << result[i]);
+  }
+  cpar::convert(hsl.data(), hsl.size(), result.data());
+  for (size_t i = 0; i < result.size(); i++) {
+    if (!nearly_equal(result[i], cpar::to_color(hsl[i])) && n_bad++ < 10)
+      FAIL_CHECK("hsl colour " << i << " is " << result[i]);
+  }
+  CHECK(n_bad == 0);
+}
+
+static double luminance_reference(uint32_t value)
+{
+  return 0.2126 * srgb_to_linear_reference(CPAR_COLOR_RED(value) / 255.0) +
+         0.7152 * srgb_to_linear_reference(CPAR_COLOR_GREEN(value) / 255.0) +
+         0.0722 * srgb_to_linear_reference(CPAR_COLOR_BLUE(value) / 255.0);
+}
+
+static double contrast_reference(uint32_t fg, uint32_t bg)
+{
+  double a = luminance_reference(fg) + 0.05;
+  double b = luminance_reference(bg) + 0.05;
+  return a > b ? a / b : b / a;
+}
+
+TEST_CASE("cpar_contrast_ratio()")
+{
+  CHECK(cpar_relative_luminance(0x000000ffu) == 0.0f);
+  CHECK(cpar_relative_luminance(0xffffff00u) == 1.0f);
+  CHECK(cpar_contrast_ratio(0x000000ffu, 0xffffffffu) == 21.0f);
+  CHECK(cpar_contrast_ratio(0xffffffffu, 0x000000ffu) == 21.0f);
+  CHECK(cpar_contrast_ratio(0x336699ffu, 0x33669900u) == 1.0f);
+  CHECK(cpar_contrast_ratio(0x767676ffu, 0xffffffffu) ==
+        Catch::Approx(4.54).margin(0.005));
+  CHECK(cpar_contrast_ratio(0x777777ffu, 0xffffffffu) ==
+        Catch::Approx(4.48).margin(0.005));
+
+  for (uint32_t value : color_space_samples()) {
+    CHECK(cpar_relative_luminance(value) ==
+          Catch::Approx(luminance_reference(value)).margin(2e-7));
+  }
+}
+
+TEST_CASE("cpar_contrast_ratios() and cpar_contrast_check()")
+{
+  std::vector<uint32_t> fg, bg;
+  uint32_t seed = 3;
+  // with a partial last word
+  for (int i = 0; i < 9997; i++) {
+    seed = seed * 1664525 + 1013904223;
+    fg.push_back(seed);
+    seed = seed * 1664525 + 1013904223;
+    bg.push_back(seed);
+  }
+  // the pairs on either side of each threshold
+  for (uint32_t c : {0x767676ffu, 0x777777ffu, 0x949494ffu, 0x959595ffu,
+                     0x595959ffu, 0x5a5a5affu}) {
+    fg.push_back(c);
+    bg.push_back(0xffffffffu);
+  }
+  size_t n = fg.size();
+
+  std::vector<float> ratios(n);
+  cpar_contrast_ratios(fg.data(), bg.data(), n, ratios.data());
+  size_t n_bad = 0;
+  for (size_t i = 0; i < n; i++) {
+    if (ratios[i] != cpar_contrast_ratio(fg[i], bg[i]) && n_bad++ < 10)
+      FAIL_CHECK("ratio " << i << " is " << ratios[i]);
+  }
+  CHECK(n_bad == 0);
+
+  const double thresholds[] = {3, 4.5, 7};
+  for (int level = 0; level < 3; level++) {
+    CAPTURE(level);
+    std::vector<uint64_t> pass((n + 63) / 64, ~uint64_t{0});
+    size_t n_pass = cpar_contrast_check(
+        fg.data(), bg.data(), n, static_cast<cpar_contrast_level>(level),
+        pass.data());
+    size_t n_set = 0;
+    for (size_t i = 0; i < n; i++) {
+      bool bit = (pass[i / 64] >> (i % 64)) & 1;
+      double ratio = contrast_reference(fg[i], bg[i]);
+      n_set += bit;
+      if (std::fabs(ratio - thresholds[level]) > 1e-5 &&
+          bit != (ratio >= thresholds[level]) && n_bad++ < 10)
+        FAIL_CHECK("pair " << i << " with ratio " << ratio << " is " << bit);
+    }
+    CHECK(n_bad == 0);
+    CHECK(n_pass == n_set);
+    CHECK(pass.back() >> (n % 64) == 0);
+  }
+
+  // 0x767676 on white just passes AA, and 0x777777 just fails
+  uint64_t pass = 0;
+  CHECK(cpar_contrast_check(&fg[n - 6], &bg[n - 6], 2, CPAR_CONTRAST_AA,
+                            &pass) == 1);
+  CHECK(pass == 1);
+  CHECK(cpar_contrast_check(&fg[n - 6], &bg[n - 6], 6, CPAR_CONTRAST_AAA,
+                            &pass) == 1);
+  CHECK(pass == 0x10);
+
+  pass = 42;
+  CHECK(cpar_contrast_check(fg.data(), bg.data(), 1,
+                            static_cast<cpar_contrast_level>(3), &pass) == 0);
+  CHECK(pass == 42);
+  cpar_contrast_ratios(NULL, NULL, 0, NULL);
+}
+
+//
+// Streaming scanner
+//
+
+static const char scanner_css[] =
+    "body { color: #333; background: rgba(0, 0, 0, 0.5); }\n"
+    "a:hover { border: 1px solid DarkOrange; outline-color: rgb(1,2,3) }\n"
+    "/* not colours: #zzz, reddish, url(red.png), 1red, -red */\n"
+    ".x { fill: navy; background: linear-gradient(red, #00f) }";
+
+static std::vector<cpar_token> scan_in_chunks(const char *text,
+                                              size_t len,
+                                              size_t chunk_len)
+{
+  std::vector<cpar_token> tokens;
+  cpar_scanner scanner;
+  cpar_token token;
+  cpar_scanner_init(&scanner);
+  for (size_t pos = 0; pos < len; pos += chunk_len) {
+    cpar_scanner_feed(&scanner, text + pos, std::min(chunk_len, len - pos));
+    while (cpar_scanner_next(&scanner, &token))
+      tokens.push_back(token);
+  }
+  cpar_scanner_end(&scanner);
+  while (cpar_scanner_next(&scanner, &token))
+    tokens.push_back(token);
+  return tokens;
+}
+
+TEST_CASE("cpar_scanner")
+{
+  std::string_view css{scanner_css};
+  auto tokens = scan_in_chunks(css.data(), css.size(), css.size());
+
+  REQUIRE(tokens.size() == 7);
+  CHECK(css.substr(tokens[0].offset, tokens[0].length) == "#333");
+  CHECK(tokens[0].value == 0x333333ff);
+  CHECK(css.substr(tokens[1].offset, tokens[1].length) ==
+        "rgba(0, 0, 0, 0.5)");
+  CHECK(tokens[1].value == 0x00000080);
+  CHECK(css.substr(tokens[2].offset, tokens[2].length) == "DarkOrange");
+  CHECK(tokens[2].value == 0xff8c00ff);
+  CHECK(css.substr(tokens[3].offset, tokens[3].length) == "rgb(1,2,3)");
+  CHECK(tokens[3].value == 0x010203ff);
+  CHECK(css.substr(tokens[4].offset, tokens[4].length) == "navy");
+  CHECK(tokens[4].value == 0x000080ff);
+  CHECK(css.substr(tokens[5].offset, tokens[5].length) == "red");
+  CHECK(css.substr(tokens[6].offset, tokens[6].length) == "#00f");
+}
+
+TEST_CASE("cpar_scanner with tokens split across chunks")
+{
+  std::string_view css{scanner_css};
+  auto expected = scan_in_chunks(css.data(), css.size(), css.size());
+
+  for (size_t chunk_len = 1; chunk_len < 20; chunk_len++) {
+    auto tokens = scan_in_chunks(css.data(), css.size(), chunk_len);
+    CAPTURE(chunk_len);
+    REQUIRE(tokens.size() == expected.size());
+    for (size_t i = 0; i < tokens.size(); i++) {
+      CHECK(tokens[i].offset == expected[i].offset);
+      CHECK(tokens[i].length == expected[i].length);
+      CHECK(tokens[i].value == expected[i].value);
+    }
+  }
+}
+
+TEST_CASE("cpar_scanner with hsl() and hwb()")
+{
+  std::string_view css{"a { color: hsl(0 100% 50%); fill: HWB(0 0% 0%) }"};
+  auto tokens = scan_in_chunks(css.data(), css.size(), 5);
+  REQUIRE(tokens.size() == 2);
+  CHECK(css.substr(tokens[0].offset, tokens[0].length) == "hsl(0 100% 50%)");
+  CHECK(tokens[0].value == 0xff0000ff);
+  CHECK(css.substr(tokens[1].offset, tokens[1].length) == "HWB(0 0% 0%)");
+  CHECK(tokens[1].value == 0xff0000ff);
+}
+
+TEST_CASE("cpar_scanner with a function too long to be a colour")
+{
+  std::string spaces(CPAR_SCANNER_TOKEN_MAX, ' ');
+  std::string css = "a { color: rgb(" + spaces + "red 0 0); fill: navy }";
+  for (size_t chunk_len : {size_t{1}, size_t{7}, css.size()}) {
+    auto tokens = scan_in_chunks(css.data(), css.size(), chunk_len);
+    CAPTURE(chunk_len);
+    REQUIRE(tokens.size() == 1);
+    CHECK(css.substr(tokens[0].offset, tokens[0].length) == "navy");
+  }
+
+  // the closing parenthesis is the character which doesn't fit
+  css = "rgb(" + spaces.substr(4) + ") red";
+  auto tokens = scan_in_chunks(css.data(), css.size(), css.size());
+  REQUIRE(tokens.size() == 1);
+  CHECK(css.substr(tokens[0].offset, tokens[0].length) == "red");
+}
+
+TEST_CASE("cpar_scanner with colour at end of input")
+{
+  auto tokens = scan_in_chunks("#fff red", 8, 3);
+  REQUIRE(tokens.size() == 2);
+  CHECK(tokens[1].offset == 5);
+  CHECK(tokens[1].value == 0xff0000ff);
+}
+
+// scans like an event loop would, checking that no call goes past the
+// budget
+static std::vector<cpar_token> poll_in_chunks(std::string_view text,
+                                              size_t chunk_len,
+                                              size_t budget,
+                                              size_t *n_yields)
+{
+  std::vector<cpar_token> tokens;
+  cpar_scanner scanner;
+  cpar_token token;
+  size_t pos = 0;
+  cpar_scanner_init(&scanner);
+  *n_yields = 0;
+  for (;;) {
+    size_t start = scanner.input_pos;
+    cpar_scan_result result = cpar_scanner_poll(&scanner, budget, &token);
+    CHECK((budget == 0 || scanner.input_pos - start <= budget));
+    if (result == CPAR_SCAN_COLOR) {
+      tokens.push_back(token);
+    } else if (result == CPAR_SCAN_YIELD) {
+      ++*n_yields;
+    } else if (result == CPAR_SCAN_NEED_INPUT) {
+      if (pos < text.size()) {
+        size_t len = std::min(chunk_len, text.size() - pos);
+        cpar_scanner_feed(&scanner, text.data() + pos, len);
+        pos += len;
+      } else {
+        cpar_scanner_end(&scanner);
+      }
+    } else {
+      break;
+    }
+  }
+  CHECK(cpar_scanner_poll(&scanner, budget, &token) == CPAR_SCAN_END);
+  return tokens;
+}
+
+TEST_CASE("cpar_scanner_poll()")
+{
+  std::string css{scanner_css};
+  css += " #fff red";
+  auto expected = scan_in_chunks(css.data(), css.size(), css.size());
+
+  for (size_t chunk_len : {size_t{1}, size_t{7}, css.size()}) {
+    for (size_t budget : {0, 1, 2, 5, 64, 1000}) {
+      CAPTURE(chunk_len, budget);
+      size_t n_yields = 0;
+      auto tokens = poll_in_chunks(css, chunk_len, budget, &n_yields);
+      REQUIRE(tokens.size() == expected.size());
+      for (size_t i = 0; i < tokens.size(); i++) {
+        CHECK(tokens[i].offset == expected[i].offset);
+        CHECK(tokens[i].length == expected[i].length);
+        CHECK(tokens[i].value == expected[i].value);
+      }
+      CHECK((n_yields == 0) == (budget == 0 || budget >= chunk_len));
+    }
+  }
+
+  // mixed with cpar_scanner_next()
+  cpar_scanner scanner;
+  cpar_token token;
+  cpar_scanner_init(&scanner);
+  CHECK(cpar_scanner_poll(&scanner, 1, &token) == CPAR_SCAN_NEED_INPUT);
+  cpar_scanner_feed(&scanner, "#abc navy", 9);
+  CHECK(cpar_scanner_poll(&scanner, 3, &token) == CPAR_SCAN_YIELD);
+  CHECK(cpar_scanner_poll(&scanner, 3, &token) == CPAR_SCAN_COLOR);
+  CHECK(token.value == 0xaabbccff);
+  CHECK(cpar_scanner_next(&scanner, &token) == 0);
+  cpar_scanner_end(&scanner);
+  CHECK(cpar_scanner_poll(&scanner, 0, &token) == CPAR_SCAN_COLOR);
+  CHECK(token.value == 0x000080ff);
+  CHECK(cpar_scanner_poll(&scanner, 0, &token) == CPAR_SCAN_END);
+  CHECK(cpar_scanner_next(&scanner, &token) == 0);
+}
+
+//
+// Formatting
+//
+
+TEST_CASE("cpar::to_string()")
+{
+  CHECK(cpar::to_string(cpar::color{0xff8000ffu}) == "#ff8000ff");
+  CHECK(cpar::to_string(cpar::color{0x0a0b0c0du}, CPAR_FORMAT_HEX) ==
+        "#0a0b0c0d");
+  CHECK(cpar::to_string(cpar::color{0x0a0b0cffu}, CPAR_FORMAT_HEX) ==
+        "#0a0b0c");
+  CHECK(cpar::to_string(cpar::color{0x0a0b0cffu}, CPAR_FORMAT_RGB) ==
+        "rgb(10,11,12)");
+  CHECK(cpar::to_string(cpar::color{0xff00807fu}, CPAR_FORMAT_RGB) ==
+        "rgba(255,0,128,0.498)");
+  CHECK(cpar::to_string(cpar::color{0x00000000u}, CPAR_FORMAT_RGB) ==
+        "rgba(0,0,0,0)");
+}
+
+TEST_CASE("cpar::to_string() shortest")
+{
+  CHECK(cpar::to_string(cpar::color{0xff0000ffu}, CPAR_FORMAT_SHORTEST) ==
+        "red");
+  CHECK(cpar::to_string(cpar::color{0x0000ffffu}, CPAR_FORMAT_SHORTEST) ==
+        "#00f");
+  CHECK(cpar::to_string(cpar::color{0xd2b48cffu}, CPAR_FORMAT_SHORTEST) ==
+        "tan");
+  CHECK(cpar::to_string(cpar::color{0xff7f50ffu}, CPAR_FORMAT_SHORTEST) ==
+        "coral");
+  CHECK(cpar::to_string(cpar::color{0x123456ffu}, CPAR_FORMAT_SHORTEST) ==
+        "#123456");
+  CHECK(cpar::to_string(cpar::color{0x11223344u}, CPAR_FORMAT_SHORTEST) ==
+        "#11223344");
+}
+
+TEST_CASE("cpar_color_format() round-trip")
+{
+  const cpar_format formats[] = {CPAR_FORMAT_HEX,
+                                 CPAR_FORMAT_HEX_ALPHA,
+                                 CPAR_FORMAT_RGB,
+                                 CPAR_FORMAT_SHORTEST};
+  for (auto format : formats) {
+    for (uint32_t a = 0; a < 256; a++) {
+      uint32_t value = 0x20406000 | a, parsed = 0;
+      char buf[CPAR_FORMAT_MAX];
+      cpar_color_format(value, format, buf, sizeof(buf));
+      CAPTURE(buf);
+      CHECK(cpar_color_parse(buf, &parsed) == CPAR_STATUS_OK);
+      CHECK(parsed == value);
+    }
+  }
+}
+
+TEST_CASE("cpar_color_format() truncation")
+{
+  char buf[5] = "xxxx";
+  CHECK(cpar_color_format(0x11223344, CPAR_FORMAT_HEX, buf, sizeof(buf)) ==
+        9);
+  CHECK(std::string{buf} == "#112");
+  CHECK(cpar_color_format(0x11223344, CPAR_FORMAT_HEX, NULL, 0) == 9);
+}
+
+TEST_CASE("cpar::to_chars()")
+{
+  char buf[9];
+  auto res = cpar::to_chars(buf, buf + 9, cpar::color{0x010203ffu});
+  CHECK(res.ec == std::errc{});
+  CHECK(std::string_view(buf, res.ptr - buf) == "#010203ff");
+  res = cpar::to_chars(buf, buf + 8, cpar::color{0x010203ffu});
+  CHECK(res.ec == std::errc::value_too_large);
+}
+
+TEST_CASE("operator<<")
+{
+  std::ostringstream out;
+  out << cpar::color{0xdeadbeefu};
+  CHECK(out.str() == "#deadbeef");
+}
+
+//
+// Compile-time colour literals
+//
+
+using namespace cpar::literals;
+
+static_assert("#ff8800"_color.value == 0xff8800ffu);
+static_assert("#F80"_color.value == 0xff8800ffu);
+static_assert("rgb(255, 136, 0)"_color.value == 0xff8800ffu);
+static_assert("rgba(100%, 0, 0, 1)"_color.value == 0xff0000ffu);
+static_assert("RebeccaPurple"_color.value == 0x663399ffu);
+static_assert(" lightgoldenrodyellow "_color.blue() == 210);
+static_assert("hsl(120 100% 25%)"_color.value == 0x008000ffu);
+static_assert("hwb(0 0% 0% / 50%)"_color.value == 0xff000080u);
+static_assert("transparent"_color.value == 0x00000000u);
+
+TEST_CASE("_color literals")
+{
+  constexpr cpar::color orange = "#ff8800"_color;
+  CHECK(orange == cpar::color{"#ff8800"});
+  CHECK("rgba(50 %, 255, 100%, 0.5)"_color ==
+        cpar::color{"rgba(50 %, 255, 100%, 0.5)"});
+}
+
+TEST_CASE("constexpr parser matches cpar_color_parse_n()")
+{
+  std::vector<std::string> inputs = {
+      "#000", "#0z0", "#f", "#ABC", "#+f+f+f", "#1a2B3c", "#ff00ff7f",
+      "#0123456g", "#0000000", "# f f f", "#", "rgb(0,0,0)", "rgb(127,127,255",
+      "rgb ( 1 , 2, 3 )", "rgb(50%, 100  %, 127)", "rgb(101%,0,0)",
+      "rgb(256,0,0)", "rgb(-1,0,0)", "rgb(-0,+1,2)", "rgb(1,,2,,3)",
+      "rgb(1,2)", "rgb(1,2,3,4)", "rgb(%,%,%)", "rgb(+,0,0)", "rgb(0x1,0,0)",
+      "rgb(99999999999999999999,0,0)", "rgb()", "rgb(", "rgba(", "RGB(1,2,3)",
+      "rgba(50 %, 255, 100%, 0.5)", "rgba(0,0,0,1)", "rgba(0,0,0,1.5)",
+      "rgba(0,0,0,-0.1)", "rgba(0,0,0,.25)", "rgba(0,0,0,1.)",
+      "rgba(0,0,0,5e-1)", "rgba(0,0,0,0.1E1)", "rgba(0,0,0,1e-50)",
+      "rgba(0,0,0,1e50)", "rgba(0,0,0,inf)", "rgba(0,0,0,.)",
+      "rgba(0,0,0,0.5%)", "rgba(0,0,0,0.333333333333333333333)",
+      "rgba(0,0,0)", "red", "Red", "r e d", "redd", "NOT_A_REAL_COLOR", " ",
+      "rgb(+,0,0)", "rgb(1 0,0,0)", "Light Sea Green", "  # F F F  ",
+      "rgb(1,2,3))", "rgb(1,2,3)x", "rgba(0,0,0, . 5 )",
+      "rgba(0,0,0,0.00000000000000000005e19)", "rgba(0,0,0,5e-1 5)",
+      "rgb(0.5%,1e2%,100.0000000001%)", "rgba(0,0,0,1e12)",
+      "rgba(0,0,0,1e-20)", "rgba(0,0,0,-0)", "rgba(0,0,0,+.5)",
+      std::string(63, 'a'), std::string(64, ' ') + "red",
+      "rgb(1 2 3)", "rgb(1 2 3 / 50%)", "rgb(1 2 3/.5)", "rgba(1 2 3)",
+      "rgb(1 2)", "rgb(1 2 3 4)", "rgb(1 2 3 /)", "rgb(1 2 / 3 4)",
+      "rgb(1 2 3 // 4)", "rgb(/ 1 2 3)", "rgba(0,0,0,50%)", "rgb(50% 0 1e1%)",
+      "hsl(0,100%,50%)", "hsl(120 100% 25%)", "hsla(30, 50%, 50%, 0.5)",
+      "hsl(240deg 100% 50% / 25%)", "hsl(0.5turn 50 50)", "hsl(3rad 1% 99%)",
+      "hsl(200GRAD 100% 50%)", "hsl(-90 100% 50%)", "hsl(1e9 100% 50%)",
+      "hsl(deg 1% 1%)", "hsl(1deg2 1% 1%)", "hsl(0, 101%, 0%)",
+      "hsl(0 -1% 0%)", "hsl(0, 50%)", "hsla(0,0%,0%)", "hsl(0 0% 0% 0)",
+      "hwb(0 0% 0%)", "hwb(120 20% 30%)", "hwb(0 60% 60%)", "hwb(0,0%,0%)",
+      "hwb(0 100% 0% / 0)", "hwb(90 0 100)", "h s l (0 0% 0%)", "hsv(0 0 0)",
+      "TRANSPARENT", "rgb(1 2 3%%)",
+  };
+  for (size_t i = 0; i < 1000; i++)
+    inputs.push_back("rgba(0,0,0," + std::to_string(i / 1000.0) + ")");
+  for (int h = 0; h < 360; h += 13) {
+    for (int p = 0; p <= 100; p += 9) {
+      std::string hue = std::to_string(h), pct = std::to_string(p) + "%";
+      inputs.push_back("hsl(" + hue + " " + pct + " " + pct + ")");
+      inputs.push_back("hwb(" + hue + " " + pct + " 10%)");
+    }
+  }
+  for (size_t i = 0; i < CPAR_N_COLOR_NAMES; i++)
+    inputs.push_back(cpar_color_names + cpar_color_name_offsets[i]);
+
+  for (auto const &input : inputs) {
+    INFO(input);
+    uint32_t expected = 0, actual = 0;
+    CHECK(cpar::detail::parse(input, actual) ==
+          cpar_color_parse_n(input.data(), input.size(), &expected));
+    CHECK(actual == expected);
+  }
+}
+
+//
+// Non-throwing parsing
+//
+
+TEST_CASE("cpar::parse()")
+{
+  static_assert(noexcept(cpar::parse(std::string_view{})));
+
+  auto res = cpar::parse("#ff8800");
+  REQUIRE(res);
+  CHECK(res.has_value());
+  CHECK(res.error() == CPAR_STATUS_OK);
+  CHECK(res->value == 0xff8800ffu);
+  CHECK(res.value().value == 0xff8800ffu);
+
+  res = cpar::parse("rgb(256, 0, 0)");
+  CHECK_FALSE(res);
+  CHECK(res.error() == CPAR_STATUS_NUMBER_RANGE);
+  CHECK(res.value_or(cpar::color{0x123456ffu}).value == 0x123456ffu);
+  CHECK_THROWS_AS(res.value(), cpar::color::error);
+
+  CHECK(cpar::parse("").error() == CPAR_STATUS_INVALID_PARAMETER);
+  CHECK(cpar::parse("notacolour").error() == CPAR_STATUS_NO_COLOR_NAME);
+}
+
+//
+// Parse cache
+//
+
+TEST_CASE("cpar_cache_parse()")
+{
+  cpar_cache *cache = cpar_cache_new(16);
+  REQUIRE(cache);
+
+  uint32_t value = 0;
+  CHECK(cpar_cache_parse(cache, "white", 5, &value) == CPAR_STATUS_OK);
+  CHECK(value == 0xffffffff);
+  value = 0;
+  CHECK(cpar_cache_parse(cache, "white", 5, &value) == CPAR_STATUS_OK);
+  CHECK(value == 0xffffffff);
+  CHECK(cpar_cache_parse(cache, "#ff00zz", 7, &value) ==
+        CPAR_STATUS_INVALID_NUMBER);
+  CHECK(cpar_cache_parse(cache, "#ff00zz", 7, &value) ==
+        CPAR_STATUS_INVALID_NUMBER);
+  CHECK(value == 0xffffffff);
+
+  cpar_cache_stats stats;
+  cpar_cache_get_stats(cache, &stats);
+  CHECK(stats.hits == 2);
+  CHECK(stats.misses == 2);
+
+  cpar_cache_clear(cache);
+  cpar_cache_get_stats(cache, &stats);
+  CHECK(stats.hits == 0);
+  CHECK(stats.misses == 0);
+  CHECK(cpar_cache_parse(cache, "white", 5, NULL) == CPAR_STATUS_OK);
+  cpar_cache_get_stats(cache, &stats);
+  CHECK(stats.misses == 1);
+
+  cpar_cache_free(cache);
+}
+
+TEST_CASE("cpar_cache_parse() matches cpar_color_parse_n()")
+{
+  // a tiny cache so that entries get replaced
+  cpar::cache cache{4};
+  std::vector<std::string> inputs;
+  for (size_t i = 0; i < CPAR_N_COLOR_NAMES; i++)
+    inputs.push_back(cpar_color_names + cpar_color_name_offsets[i]);
+  for (unsigned i = 0; i < 64; i++)
+    inputs.push_back("rgba(" + std::to_string(i) + ", 0, 0, 0.5)");
+  inputs.push_back("notacolour");
+  inputs.push_back("rgb(" + std::string(100, ' ') + "1, 2, 3)");
+
+  for (int pass = 0; pass < 3; pass++) {
+    for (auto const &input : inputs) {
+      INFO(input);
+      uint32_t expected = 0;
+      cpar_status status =
+          cpar_color_parse_n(input.data(), input.size(), &expected);
+      auto res = cache.parse(input);
+      CHECK(res.error() == status);
+      CHECK(res.value_or(0u).value == (status ? 0u : expected));
+    }
+  }
+  auto stats = cache.stats();
+  CHECK(stats.hits + stats.misses == 3 * inputs.size());
+}
+
+//
+// Colour atoms
+//
+
+TEST_CASE("cpar_atoms")
+{
+  cpar_atoms *atoms = cpar_atoms_new();
+  REQUIRE(atoms);
+  CHECK(cpar_atoms_count(atoms) == CPAR_N_COLOR_NAMES);
+
+  uint32_t id = 0;
+  CHECK(cpar_atoms_intern(atoms, "red", 3, &id) == CPAR_STATUS_OK);
+  CHECK(std::string{cpar_atoms_string(atoms, id, NULL)} == "red");
+  CHECK(cpar_atoms_value(atoms, id) == 0xff0000ff);
+  CHECK(cpar_atoms_count(atoms) == CPAR_N_COLOR_NAMES);
+
+  uint32_t upper = 0, again = 0;
+  CHECK(cpar_atoms_intern(atoms, "Red", 3, &upper) == CPAR_STATUS_OK);
+  CHECK(upper == CPAR_N_COLOR_NAMES);
+  CHECK(cpar_atoms_intern(atoms, "Red trailing", 3, &again) ==
+        CPAR_STATUS_OK);
+  CHECK(again == upper);
+  size_t len = 0;
+  CHECK(std::string{cpar_atoms_string(atoms, upper, &len)} == "Red");
+  CHECK(len == 3);
+  CHECK(cpar_atoms_value(atoms, upper) == 0xff0000ff);
+
+  CHECK(cpar_atoms_intern(atoms, "#zzz", 4, &id) ==
+        CPAR_STATUS_INVALID_NUMBER);
+  CHECK(cpar_atoms_count(atoms) == CPAR_N_COLOR_NAMES + 1);
+  CHECK(cpar_atoms_string(atoms, CPAR_N_COLOR_NAMES + 1, NULL) == NULL);
+  CHECK(cpar_atoms_value(atoms, CPAR_N_COLOR_NAMES + 1) == 0);
+
+  cpar_atoms_free(atoms);
+}
+
+TEST_CASE("cpar::atoms with many strings")
+{
+  cpar::atoms atoms;
+  std::vector<uint32_t> ids;
+  // enough to grow the index and use several arena blocks, plus one string
+  // too big for a block
+  for (unsigned i = 0; i < 5000; i++) {
+    uint32_t id = 0;
+    char str[16];
+    std::snprintf(str, sizeof(str), "#%06x", i * 3);
+    REQUIRE(atoms.intern(str, id) == CPAR_STATUS_OK);
+    ids.push_back(id);
+  }
+  std::string big = "rgb(" + std::string(5000, ' ') + "1, 2, 3)";
+  uint32_t big_id = 0;
+  REQUIRE(atoms.intern(big, big_id) == CPAR_STATUS_OK);
+  CHECK(atoms.size() == CPAR_N_COLOR_NAMES + 5001);
+
+  for (unsigned i = 0; i < 5000; i++) {
+    uint32_t id = 0;
+    char str[16];
+    std::snprintf(str, sizeof(str), "#%06x", i * 3);
+    REQUIRE(atoms.intern(str, id) == CPAR_STATUS_OK);
+    CHECK(id == ids[i]);
+    CHECK(atoms.string(id) == str);
+    CHECK(atoms.value(id).value == ((i * 3) << 8 | 0xffu));
+  }
+  CHECK(atoms.string(big_id) == big);
+  CHECK(atoms.value(big_id).value == 0x010203ffu);
+}
+
+//
+// Statistics
+//
+
+static uint64_t sum_counts(uint64_t const *counts, size_t n)
+{
+  uint64_t sum = 0;
+  for (size_t i = 0; i < n; i++)
+    sum += counts[i];
+  return sum;
+}
+
+TEST_CASE("cpar_names_new()")
+{
+  cpar_names *names = NULL;
+  uint32_t values[3] = {0x11223344, 0x55667788, 0x99aabbcc};
+  size_t repeated = 0;
+
+  auto build = [&](std::vector<std::string> const &strs) {
+    std::vector<cpar_string> list;
+    for (auto const &str : strs)
+      list.push_back(cpar_string{str.data(), str.size()});
+    cpar_status status = cpar_names_new(
+        list.data(), values, list.size(), &names, &repeated);
+    cpar_names_free(names);
+    names = NULL;
+    return status;
+  };
+
+  CHECK(build({"brand", "Brand Blue"}) == CPAR_STATUS_OK);
+  CHECK(build({"brand", "red"}) == CPAR_STATUS_OK);
+  CHECK(build({"brand", ""}) == CPAR_STATUS_INVALID_PARAMETER);
+  CHECK(build({"brand", "   "}) == CPAR_STATUS_INVALID_PARAMETER);
+  CHECK(build({"brand", " #brand"}) == CPAR_STATUS_INVALID_PARAMETER);
+  CHECK(build({"brand", "brand(1)"}) == CPAR_STATUS_INVALID_PARAMETER);
+  CHECK(build({"brand", std::string("br\0and", 6)}) ==
+        CPAR_STATUS_INVALID_PARAMETER);
+  CHECK(build({"brand", "B rand"}) == CPAR_STATUS_DUPLICATE_NAME);
+  CHECK(repeated == 1);
+  CHECK(build({"red", "brand", "RED"}) == CPAR_STATUS_DUPLICATE_NAME);
+  CHECK(repeated == 2);
+  CHECK(build({"a", "b", "a"}) == CPAR_STATUS_DUPLICATE_NAME);
+  CHECK(repeated == 2);
+
+  CHECK(cpar_names_new(NULL, values, 2, &names, NULL) ==
+        CPAR_STATUS_INVALID_PARAMETER);
+  CHECK(cpar_names_new(NULL, NULL, 0, NULL, NULL) ==
+        CPAR_STATUS_INVALID_PARAMETER);
+  REQUIRE(cpar_names_new(NULL, NULL, 0, &names, NULL) == CPAR_STATUS_OK);
+  CHECK(cpar_names_count(names) == 0);
+  uint32_t value = 0;
+  CHECK(cpar_names_parse(names, "red", 3, &value) == CPAR_STATUS_OK);
+  CHECK(value == 0xff0000ff);
+  CHECK(cpar_names_parse(names, "brand", 5, &value) ==
+        CPAR_STATUS_NO_COLOR_NAME);
+  cpar_names_free(names);
+}
+
+TEST_CASE("cpar_names_parse()")
+{
+  cpar::names names{{"Brand Blue", 0x336699ffu},
+                    {"red", cpar::color{200, 0, 0}},
+                    {"brandnavy", 0x000080ffu},
+                    {"alsoblue", 0x336699ffu}};
+  CHECK(names.size() == 4);
+
+  CHECK(names.parse("brand blue")->value == 0x336699ff);
+  CHECK(names.parse("  BRANDBLUE ")->value == 0x336699ff);
+  CHECK(names.parse("red")->value == 0xc80000ff);
+  CHECK(names.parse("green")->value == 0x008000ff);
+  CHECK(names.parse("#123")->value == 0x112233ff);
+  CHECK(names.parse("rgb(1, 2, 3)")->value == 0x010203ff);
+  CHECK(names.parse("brandblu").error() == CPAR_STATUS_NO_COLOR_NAME);
+  CHECK(names.parse("brandbluee").error() == CPAR_STATUS_NO_COLOR_NAME);
+  CHECK(cpar::parse("brandblue").error() == CPAR_STATUS_NO_COLOR_NAME);
+
+  CHECK(names.lookup(cpar::color{0x336699ffu}) == "brandblue");
+  CHECK(names.lookup(cpar::color{0x000080ffu}) == "brandnavy");
+  CHECK(names.lookup(cpar::color{0x008000ffu}) == "green");
+  CHECK(names.lookup(cpar::color{0x12345678u}).empty());
+  CHECK(std::string{cpar_names_lookup(NULL, 0x000080ff)} == "navy");
+
+  cpar::names none;
+  CHECK(none.size() == 0);
+  CHECK(none.parse("red")->value == 0xff0000ff);
+  CHECK_THROWS_AS((cpar::names{{"a", 1u}, {"A", 2u}}), cpar::color::error);
+  try {
+    cpar::names repeat{{"brand", 1u}, {"accent", 2u}, {"Brand", 3u}};
+    FAIL("a repeated name was accepted");
+  } catch (cpar::color::error const &e) {
+    CHECK(e.code() == CPAR_STATUS_DUPLICATE_NAME);
+    CHECK(std::string{e.what()} == "repeated colour name \"Brand\"");
+  }
+}
+
+TEST_CASE("cpar_names with many names")
+{
+  const unsigned n_names = 20000;
+  std::vector<std::pair<std::string, uint32_t>> pairs;
+  for (unsigned i = 0; i < n_names; i++)
+    pairs.emplace_back("theme-colour-" + std::to_string(i), i * 2654435761u);
+  cpar::names names{pairs};
+  REQUIRE(names.size() == n_names);
+
+  // lookups from several threads at once
+  std::vector<std::thread> threads;
+  std::atomic<unsigned> n_bad{0};
+  for (unsigned t = 0; t < 4; t++) {
+    threads.emplace_back([&, t] {
+      for (unsigned i = t; i < n_names; i += 4) {
+        auto result = names.parse(pairs[i].first);
+        if (!result || result->value != pairs[i].second ||
+            names.lookup(result->value) != pairs[i].first)
+          n_bad++;
+      }
+    });
+  }
+  for (auto &thread : threads)
+    thread.join();
+  CHECK(n_bad == 0);
+
+  auto miss = "theme-colour-" + std::to_string(n_names);
+  CHECK(names.parse(miss).error() == CPAR_STATUS_NO_COLOR_NAME);
+  CHECK(names.parse("red")->value == 0xff0000ff);
+}
+
+TEST_CASE("cpar_names_serialize()")
+{
+  const unsigned n_names = 5000;
+  std::vector<std::pair<std::string, uint32_t>> pairs;
+  for (unsigned i = 0; i < n_names; i++)
+    pairs.emplace_back("Theme Colour " + std::to_string(i), i * 2654435761u);
+  cpar::names names{pairs};
+
+  size_t size = cpar_names_serialize(names.get(), NULL, 0);
+  CHECK(cpar_names_serialize(NULL, NULL, 0) == 0);
+  std::vector<uint32_t> image(size / 4 + 1, 0xdeadbeef);
+  CHECK(cpar_names_serialize(names.get(), image.data(), size - 1) == size);
+  CHECK(image[0] == 0xdeadbeef);
+  REQUIRE(cpar_names_serialize(names.get(), image.data(), size) == size);
+  CHECK(names.serialize() ==
+        std::string(reinterpret_cast<const char *>(image.data()), size));
+
+  cpar_names *loaded = NULL;
+  REQUIRE(cpar_names_from_image(image.data(), size, &loaded) ==
+          CPAR_STATUS_OK);
+  CHECK(cpar_names_count(loaded) == n_names);
+  size_t n_bad = 0;
+  for (auto const &[name, value] : pairs) {
+    uint32_t parsed = 0;
+    if (cpar_names_parse(loaded, name.data(), name.size(), &parsed) !=
+            CPAR_STATUS_OK ||
+        parsed != value ||
+        cpar_names_lookup(loaded, value) != names.lookup(value))
+      n_bad++;
+  }
+  CHECK(n_bad == 0);
+  uint32_t value = 0;
+  CHECK(cpar_names_parse(loaded, "teal", 4, &value) == CPAR_STATUS_OK);
+  CHECK(cpar_names_parse(loaded, "theme colour -1", 15, &value) ==
+        CPAR_STATUS_NO_COLOR_NAME);
+  cpar_names_free(loaded);
+
+  // images which aren't valid
+  auto load = [&](std::vector<uint32_t> const &img, size_t img_size) {
+    cpar_names *n = NULL;
+    cpar_status status = cpar_names_from_image(img.data(), img_size, &n);
+    CHECK((status == CPAR_STATUS_OK) == (n != NULL));
+    cpar_names_free(n);
+    return status;
+  };
+  CHECK(load(image, size - 1) == CPAR_STATUS_INVALID_PARAMETER);
+  CHECK(load(image, 10) == CPAR_STATUS_INVALID_PARAMETER);
+  for (size_t word : {0, 2, 3, 4, 5, 6, 8, 10}) {
+    std::vector<uint32_t> bad = image;
+    bad[word] ^= 0x10;
+    CHECK(load(bad, size) == CPAR_STATUS_INVALID_PARAMETER);
+  }
+  std::vector<unsigned char> bytes(size + 1);
+  std::memcpy(bytes.data() + 1, image.data(), size);
+  CHECK(cpar_names_from_image(bytes.data() + 1, size, &loaded) ==
+        CPAR_STATUS_INVALID_PARAMETER);
+  CHECK(cpar_names_from_image(NULL, size, &loaded) ==
+        CPAR_STATUS_INVALID_PARAMETER);
+  CHECK(cpar_names_from_image(image.data(), size, NULL) ==
+        CPAR_STATUS_INVALID_PARAMETER);
+
+  // a corrupted body gives wrong answers, but lookups stay inside it
+  uint32_t seed = 7;
+  for (int round = 0; round < 20; round++) {
+    std::vector<uint32_t> bad(image.begin(), image.begin() + size / 4);
+    for (int i = 0; i < 200; i++) {
+      seed = seed * 1664525 + 1013904223;
+      size_t word = 12 + seed % (bad.size() - 13);
+      bad[word] = round % 2 ? seed : bad[word] ^ (1u << (seed >> 27));
+    }
+    bad.push_back(image[size / 4]);
+    REQUIRE(cpar_names_from_image(bad.data(), size, &loaded) ==
+            CPAR_STATUS_OK);
+    for (unsigned i = 0; i < n_names; i += 7) {
+      cpar_names_parse(loaded,
+                       pairs[i].first.data(),
+                       pairs[i].first.size(),
+                       &value);
+      const char *name = cpar_names_lookup(loaded, pairs[i].second);
+      CHECK((name == NULL || std::strlen(name) < size));
+    }
+    cpar_names_free(loaded);
+  }
+
+  // including when every entry of the value index is out of range, which
+  // cpar_names_value_at() reports as the valid colour 0xffffffff
+  {
+    std::vector<uint32_t> bad(image.begin(), image.begin() + size / 4);
+    std::fill(bad.begin() + 12, bad.end(), 0xffffffffu);
+    bad.push_back(image[size / 4]);
+    REQUIRE(cpar_names_from_image(bad.data(), size, &loaded) ==
+            CPAR_STATUS_OK);
+    const char *name = cpar_names_lookup(loaded, 0xffffffffu);
+    CHECK(name != NULL);
+    CHECK(std::strcmp(name, "white") == 0);
+    cpar_names_free(loaded);
+  }
+
+  // an empty registry too
+  cpar_names *empty = NULL;
+  REQUIRE(cpar_names_new(NULL, NULL, 0, &empty, NULL) == CPAR_STATUS_OK);
+  std::vector<uint32_t> empty_image(cpar_names_serialize(empty, NULL, 0) / 4);
+  cpar_names_serialize(empty, empty_image.data(), empty_image.size() * 4);
+  cpar_names_free(empty);
+  REQUIRE(cpar_names_from_image(
+              empty_image.data(), empty_image.size() * 4, &loaded) ==
+          CPAR_STATUS_OK);
+  CHECK(cpar_names_count(loaded) == 0);
+  CHECK(cpar_names_parse(loaded, "red", 3, &value) == CPAR_STATUS_OK);
+  cpar_names_free(loaded);
+}
+
+TEST_CASE("cpar_names_map()")
+{
+  const char *path = "test-names.bin";
+  {
+    cpar::names names{{"Brand Blue", 0x336699ffu}, {"accent", 0xff8000ffu}};
+    std::string image = names.serialize();
+    FILE *fp = std::fopen(path, "wb");
+    REQUIRE(fp != NULL);
+    std::fwrite(image.data(), 1, image.size(), fp);
+    std::fclose(fp);
+  }
+
+  cpar::names names = cpar::names::map(path);
+  CHECK(names.size() == 2);
+  CHECK(names.parse("brandblue")->value == 0x336699ff);
+  CHECK(names.parse("ACCENT")->value == 0xff8000ff);
+  CHECK(names.lookup(0x336699ffu) == "brandblue");
+  CHECK(names.parse("red")->value == 0xff0000ff);
+
+  cpar_names *loaded = NULL;
+  CHECK(cpar_names_map("no-such-file.bin", &loaded) == CPAR_STATUS_IO_ERROR);
+  CHECK(loaded == NULL);
+  FILE *fp = std::fopen(path, "wb");
+  REQUIRE(fp != NULL);
+  std::fputs("brand blue, #336699\n", fp);
+  std::fclose(fp);
+  CHECK(cpar_names_map(path, &loaded) == CPAR_STATUS_INVALID_PARAMETER);
+  CHECK(cpar_names_map(NULL, &loaded) == CPAR_STATUS_INVALID_PARAMETER);
+  CHECK_THROWS_AS(cpar::names::map("no-such-file.bin"), cpar::color::error);
+  std::remove(path);
+}
+
+// the nearest opaque named colour, by measuring the distance to all of them
+static size_t nearest_brute_force(uint32_t value, cpar_metric metric)
+{
+  float lab[3];
+  cpar_oklab_from_rgb(value, lab);
+  size_t best = CPAR_N_COLOR_VALUES;
+  double best_d = 0;
+  for (size_t i = 0; i < CPAR_N_COLOR_VALUES; i++) {
+    uint32_t v = cpar_color_value_table[i];
+    if (CPAR_COLOR_ALPHA(v) != 0xff)
+      continue;
+    double d;
+    if (metric == CPAR_METRIC_RGB) {
+      int dr = CPAR_COLOR_RED(value) - CPAR_COLOR_RED(v);
+      int dg = CPAR_COLOR_GREEN(value) - CPAR_COLOR_GREEN(v);
+      int db = CPAR_COLOR_BLUE(value) - CPAR_COLOR_BLUE(v);
+      d = dr * dr + dg * dg + db * db;
+    } else {
+      float dl = lab[0] - cpar_color_value_oklab[i][0];
+      float da = lab[1] - cpar_color_value_oklab[i][1];
+      float db = lab[2] - cpar_color_value_oklab[i][2];
+      d = dl * dl + da * da + db * db;
+    }
+    if (best == CPAR_N_COLOR_VALUES || d < best_d) {
+      best = i;
+      best_d = d;
+    }
+  }
+  return best;
+}
+
+TEST_CASE("cpar_nearest_color_name()")
+{
+  CHECK(std::string(cpar_nearest_color_name(0xff0000ff, CPAR_METRIC_RGB)) ==
+        "red");
+  CHECK(std::string(cpar_nearest_color_name(0xfe0101ff, CPAR_METRIC_OKLAB)) ==
+        "red");
+  CHECK(std::string(cpar_nearest_color_name(0x00ffff00, CPAR_METRIC_RGB)) ==
+        "aqua");
+  CHECK(std::string(cpar_nearest_color_name(0x000000ff, CPAR_METRIC_OKLAB)) ==
+        "black");
+  CHECK(std::string(cpar_nearest_color_name(0x00000000, CPAR_METRIC_RGB)) ==
+        "black");
+  CHECK(std::string(cpar_nearest_color_name(0xfefefeff, CPAR_METRIC_RGB)) ==
+        "white");
+  CHECK(cpar_nearest_color_name(0xff0000ff, static_cast<cpar_metric>(2)) ==
+        NULL);
+
+  for (int i = 0; i < 256; i++) {
+    float x = i / 255.0f;
+    CHECK(cpar_cbrtf(x) == Catch::Approx(std::cbrt(x)).epsilon(1e-6));
+  }
+
+  // every named colour is its own nearest, in either metric
+  for (size_t i = 0; i < CPAR_N_COLOR_VALUES; i++) {
+    uint32_t v = cpar_color_value_table[i];
+    if (CPAR_COLOR_ALPHA(v) != 0xff)
+      continue;
+    CHECK(std::string(cpar_nearest_color_name(v, CPAR_METRIC_RGB)) ==
+          cpar_lookup_color_name(v));
+    CHECK(std::string(cpar_nearest_color_name(v, CPAR_METRIC_OKLAB)) ==
+          cpar_lookup_color_name(v));
+  }
+
+  // the edges of the grid cells, and random colours elsewhere
+  std::vector<uint32_t> values;
+  for (int r = 0; r < 256; r += 31)
+    for (int g = 0; g < 256; g += 31)
+      for (int b = 0; b < 256; b += 31)
+        values.push_back(CPAR_COLOR_MAKE(r | r >> 5, g | g >> 5, b, 0xff));
+  uint32_t seed = 42;
+  for (int i = 0; i < 100000; i++) {
+    seed = seed * 1664525 + 1013904223;
+    values.push_back(seed | 0xff);
+  }
+  size_t n_bad = 0;
+  for (uint32_t value : values) {
+    for (cpar_metric metric : {CPAR_METRIC_RGB, CPAR_METRIC_OKLAB}) {
+      size_t expected = nearest_brute_force(value, metric);
+      if (cpar_nearest_index(value, metric) != expected && n_bad++ < 10)
+        FAIL_CHECK("nearest to " << std::hex << value << " in metric "
+                                 << metric << " isn't "
+                                 << cpar_color_value_table[expected]);
+    }
+  }
+  CHECK(n_bad == 0);
+}
+
+TEST_CASE("cpar_nearest_named_colors()")
+{
+  std::vector<uint32_t> values = {
+      0xff0000ff, 0xff000000, 0xff0101ff, 0x123456ff, 0x123456ff, 0x0000ffff};
+  std::vector<uint32_t> nearest(values.size());
+
+  for (cpar_metric metric : {CPAR_METRIC_RGB, CPAR_METRIC_OKLAB}) {
+    cpar_nearest_named_colors(
+        values.data(), values.size(), metric, nearest.data());
+    for (size_t i = 0; i < values.size(); i++) {
+      CHECK(nearest[i] ==
+            cpar_color_value_table[nearest_brute_force(values[i], metric)]);
+    }
+  }
+  CHECK(nearest[0] == 0xff0000ff);
+  CHECK(nearest[1] == 0xff0000ff);
+
+  // in place
+  std::vector<uint32_t> copy = values;
+  cpar_nearest_named_colors(
+      copy.data(), copy.size(), CPAR_METRIC_OKLAB, copy.data());
+  CHECK(copy == nearest);
+
+  std::vector<uint32_t> unchanged = values;
+  cpar_nearest_named_colors(values.data(),
+                            values.size(),
+                            static_cast<cpar_metric>(-1),
+                            unchanged.data());
+  CHECK(unchanged == values);
+  cpar_nearest_named_colors(NULL, 0, CPAR_METRIC_RGB, NULL);
+}
+
+TEST_CASE("cpar_arena_alloc()")
+{
+  alignas(16) unsigned char buffer[64];
+  cpar_arena arena;
+  cpar_arena_init(&arena, buffer, sizeof(buffer));
+
+  void *a = cpar_arena_alloc(&arena, 3, 1);
+  void *b = cpar_arena_alloc(&arena, 8, 8);
+  CHECK(a == buffer);
+  CHECK(b == buffer + 8);
+  CHECK(cpar_arena_alloc(&arena, 8, 3) == NULL);
+  CHECK(cpar_arena_alloc(&arena, 8, 0) == NULL);
+
+  // too big for the rest of the buffer, so it comes from the heap
+  auto *c = static_cast<unsigned char *>(cpar_arena_alloc(&arena, 100, 16));
+  REQUIRE(c != NULL);
+  CHECK(reinterpret_cast<uintptr_t>(c) % 16 == 0);
+  CHECK((c < buffer || c >= buffer + sizeof(buffer)));
+  std::memset(c, 0xab, 100);
+
+  // a big allocation gets its own block, and the current one is kept
+  void *d = cpar_arena_alloc(&arena, 100000, 1);
+  REQUIRE(d != NULL);
+  std::memset(d, 0xcd, 100000);
+  CHECK(static_cast<unsigned char *>(cpar_arena_alloc(&arena, 4, 1)) ==
+        c + 100);
+
+  cpar_arena_clear(&arena);
+  CHECK(cpar_arena_alloc(&arena, 1, 1) == buffer);
+  cpar_arena_release(&arena);
+  cpar_arena_release(NULL);
+
+  cpar_arena_init(&arena, NULL, 0);
+  CHECK(cpar_arena_alloc(&arena, 0, 1) != NULL);
+  cpar_arena_release(&arena);
+}
+
+TEST_CASE("cpar_color_parse_list()")
+{
+  cpar_arena arena;
+  cpar_arena_init(&arena, NULL, 0);
+  uint32_t *values = NULL;
+  size_t n = 0;
+  size_t offset = 0;
+
+  auto parse = [&](std::string const &str) {
+    return cpar_color_parse_list(
+        &arena, str.data(), str.size(), &values, &n, &offset);
+  };
+  auto list = [&]() { return std::vector<uint32_t>(values, values + n); };
+
+  REQUIRE(parse("red, #0f0, rgba(0,0,255,.5)") == CPAR_STATUS_OK);
+  CHECK(list() == std::vector<uint32_t>{0xff0000ff, 0x00ff00ff, 0x0000ff80});
+  CHECK(offset == 27);
+  REQUIRE(parse("  red #0f0\n\thsl(0 100% 50% / 1)  ,blue ") ==
+          CPAR_STATUS_OK);
+  CHECK(list() == std::vector<uint32_t>{
+                      0xff0000ff, 0x00ff00ff, 0xff0000ff, 0x0000ffff});
+  REQUIRE(parse("rgb(1, 2, 3),rgb(4 5 6)") == CPAR_STATUS_OK);
+  CHECK(list() == std::vector<uint32_t>{0x010203ff, 0x040506ff});
+  REQUIRE(parse("") == CPAR_STATUS_OK);
+  CHECK(n == 0);
+  CHECK(offset == 0);
+  REQUIRE(parse(" \n ") == CPAR_STATUS_OK);
+  CHECK(n == 0);
+
+  CHECK(parse("red,,blue") == CPAR_STATUS_SYNTAX_ERROR);
+  CHECK(list() == std::vector<uint32_t>{0xff0000ff});
+  CHECK(offset == 4);
+  CHECK(parse("red, blue ,") == CPAR_STATUS_SYNTAX_ERROR);
+  CHECK(n == 2);
+  CHECK(offset == 10);
+  CHECK(parse(",red") == CPAR_STATUS_SYNTAX_ERROR);
+  CHECK(offset == 0);
+  CHECK(parse("red, rgb(1,2,3, #fff") == CPAR_STATUS_SYNTAX_ERROR);
+  CHECK(offset == 5);
+  CHECK(parse("red, bleu") == CPAR_STATUS_NO_COLOR_NAME);
+  CHECK(offset == 5);
+  CHECK(parse("red, rgb(256,0,0)") == CPAR_STATUS_NUMBER_RANGE);
+  CHECK(parse("light blue") == CPAR_STATUS_NO_COLOR_NAME);
+
+  CHECK(cpar_color_parse_list(NULL, "red", 3, &values, &n, NULL) ==
+        CPAR_STATUS_INVALID_PARAMETER);
+  CHECK(cpar_color_parse_list(&arena, NULL, 3, &values, &n, NULL) ==
+        CPAR_STATUS_INVALID_PARAMETER);
+  CHECK(cpar_color_parse_list(&arena, "red", 3, NULL, &n, NULL) ==
+        CPAR_STATUS_INVALID_PARAMETER);
+
+  // the bound on the number of colours assumes none is shorter than this
+  for (size_t i = 0; i < CPAR_N_COLOR_NAMES; i++) {
+    CHECK(cpar_color_name_offsets[i + 1] - cpar_color_name_offsets[i] - 1 >=
+          CPAR_MIN_COLOR_LEN);
+  }
+
+  // the most colours that fit, and earlier lists are still valid
+  std::vector<std::vector<uint32_t>> lists;
+  std::vector<std::pair<uint32_t *, size_t>> stored;
+  for (size_t len = 0; len < 50; len++) {
+    std::string str;
+    for (size_t i = 0; i < len; i++)
+      str += i % 2 ? " tan" : ",red";
+    str.erase(0, 1);
+    REQUIRE(parse(str) == CPAR_STATUS_OK);
+    CHECK(n == len);
+    lists.push_back(list());
+    stored.emplace_back(values, n);
+  }
+  for (size_t i = 0; i < lists.size(); i++) {
+    CHECK(std::vector<uint32_t>(stored[i].first,
+                                stored[i].first + stored[i].second) ==
+          lists[i]);
+  }
+  cpar_arena_release(&arena);
+}
+
+TEST_CASE("cpar::parse_list()")
+{
+  unsigned char buffer[256];
+  cpar::arena arena{buffer, sizeof(buffer)};
+
+  cpar::color_list colors = cpar::parse_list("red, #0f0 rgba(0,0,255,.5)",
+                                             arena);
+  REQUIRE(colors);
+  REQUIRE(colors.size() == 3);
+  CHECK(reinterpret_cast<const unsigned char *>(colors.data()) >= buffer);
+  CHECK(reinterpret_cast<const unsigned char *>(colors.data()) <
+        buffer + sizeof(buffer));
+  CHECK(colors[0] == cpar::color{255, 0, 0});
+  CHECK(colors[2].alpha() == 0x80);
+  CHECK(std::vector<uint32_t>(colors.begin(), colors.end()) ==
+        std::vector<uint32_t>{0xff0000ff, 0x00ff00ff, 0x0000ff80});
+
+  cpar::color_list bad = cpar::parse_list("red, #12", arena);
+  CHECK_FALSE(bad);
+  CHECK(bad.size() == 1);
+  CHECK(bad.error() == CPAR_STATUS_SYNTAX_ERROR);
+  CHECK(bad.error_offset() == 5);
+  CHECK(colors.size() == 3);
+  CHECK(colors[1] == cpar::color{0x00ff00ffu});
+
+  // more than fits in the buffer
+  std::string many;
+  for (int i = 0; i < 1000; i++)
+    many += "rgb(1,2,3), ";
+  many += "#fff";
+  cpar::color_list big = cpar::parse_list(many, arena);
+  REQUIRE(big);
+  CHECK(big.size() == 1001);
+  CHECK(big[1000] == cpar::color{0xffffffffu});
+  CHECK(colors[0] == cpar::color{0xff0000ffu});
+
+  arena.clear();
+  CHECK(static_cast<unsigned char *>(arena.allocate(1, 1)) == buffer);
+  CHECK_THROWS_AS(arena.allocate(8, 3), std::bad_alloc);
+  CHECK(cpar::parse_list("", arena).empty());
+}
+
+TEST_CASE("cpar_stats_snapshot()")
+{
+  static const char *const strs[] = {
+      "#fff",         " # f f f ", "rgb(1, 2, 3)", "rgba(1 2 3 / 50%)",
+      "hsl(0 0% 0%)", "hsla(0,0%,0%,1)", "hwb(0 0% 0%)", "red",
+      "bogus",        "rgb(1, 2)", "#ff00zz",
+  };
+  cpar_stats stats;
+
+  cpar_stats_reset();
+  REQUIRE(cpar_stats_snapshot(&stats) != 0);
+  CHECK(stats.calls == 0);
+
+  for (const char *str : strs) {
+    uint32_t value = 0;
+    cpar_color_parse(str, &value);
+  }
+  CHECK(cpar_color_parse_n(NULL, 0, NULL) == CPAR_STATUS_INVALID_PARAMETER);
+
+  REQUIRE(cpar_stats_snapshot(&stats) != 0);
+  CHECK(stats.calls == 12);
+  CHECK(stats.syntax[CPAR_SYNTAX_HEX] == 3);
+  CHECK(stats.syntax[CPAR_SYNTAX_RGB] == 2);
+  CHECK(stats.syntax[CPAR_SYNTAX_RGBA] == 1);
+  CHECK(stats.syntax[CPAR_SYNTAX_HSL] == 1);
+  CHECK(stats.syntax[CPAR_SYNTAX_HSLA] == 1);
+  CHECK(stats.syntax[CPAR_SYNTAX_HWB] == 1);
+  CHECK(stats.syntax[CPAR_SYNTAX_NAME] == 2);
+  CHECK(stats.status[CPAR_STATUS_OK] == 8);
+  CHECK(stats.status[CPAR_STATUS_NO_COLOR_NAME] == 1);
+  CHECK(stats.status[CPAR_STATUS_SYNTAX_ERROR] == 1);
+  CHECK(stats.status[CPAR_STATUS_INVALID_NUMBER] == 1);
+  CHECK(stats.status[CPAR_STATUS_INVALID_PARAMETER] == 1);
+  CHECK(sum_counts(stats.status, CPAR_STATUS_COUNT) == stats.calls);
+#if defined(__x86_64__) || defined(__i386__) || defined(__aarch64__)
+  CHECK(sum_counts(stats.cycles, CPAR_STATS_CYCLE_BUCKETS) == stats.calls);
+#endif
+
+  cpar_stats_reset();
+  REQUIRE(cpar_stats_snapshot(&stats) != 0);
+  CHECK(sum_counts(stats.status, CPAR_STATUS_COUNT) == 0);
+  CHECK(sum_counts(stats.cycles, CPAR_STATS_CYCLE_BUCKETS) == 0);
+  CHECK(cpar_stats_snapshot(NULL) == 0);
+}
+
+TEST_CASE("cpar_stats_snapshot() with many threads")
+{
+  // more threads than copies of the counters, so some share
+  const unsigned n_threads = 80;
+  const unsigned n_calls = 1000;
+  std::vector<std::thread> threads;
+
+  cpar_stats_reset();
+  for (unsigned i = 0; i < n_threads; i++) {
+    threads.emplace_back([] {
+      for (unsigned j = 0; j < n_calls; j++) {
+        uint32_t value = 0;
+        cpar_color_parse("#123", &value);
+      }
+    });
+  }
+  for (auto &thread : threads)
+    thread.join();
+
+  cpar_stats stats;
+  REQUIRE(cpar_stats_snapshot(&stats) != 0);
+  CHECK(stats.calls == n_threads * n_calls);
+  CHECK(stats.syntax[CPAR_SYNTAX_HEX] == n_threads * n_calls);
+  CHECK(stats.status[CPAR_STATUS_OK] == n_threads * n_calls);
+}
+
+TEST_CASE("optimized paths match the reference parser")
+{
+  differential::checker checker;
+  std::vector<std::string> inputs = differential::generate(20000, 1);
+  std::string pixels;
+
+  for (std::string const &input : inputs) {
+    INFO(input);
+    CHECK(checker.check(input) == "");
+    pixels += input;
+  }
+  CHECK(checker.check_batch(inputs) == "");
+  CHECK(differential::check_pixels(
+            reinterpret_cast<const uint8_t *>(pixels.data()),
+            pixels.size()) == "");
+}
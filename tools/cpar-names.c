@@ -0,0 +1,271 @@
+/*
+ * Compiles lists of named colours into the binary registry format which
+ * cpar_names_map() loads, and looks names up in the result.
+ *
+ *     cpar-names compile OUTPUT [INPUT...]
+ *     cpar-names lookup IMAGE NAME...
+ *
+ * Each line of the input, or of stdin when no files are given, is a name
+ * and a colour separated by the first comma, for example `brand blue,
+ * #336699` or `accent, rgb(255 128 0)`. Blank lines and lines starting with
+ * `#` are skipped. Any line which doesn't parse is reported along with its
+ * line number, and nothing is written.
+ */
+
+// CPAR_USE_LIBRARY links against libcpar instead
+#ifndef CPAR_USE_LIBRARY
+#define CPAR_IMPLEMENTATION
+#endif
+#include "cpar.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+struct entry {
+  size_t start;
+  size_t len;
+  uint32_t value;
+  /* Where the name was read from, for reporting a repeat. */
+  const char *path;
+  size_t line_no;
+};
+
+/* The names and values read so far, with the names in one buffer. */
+struct list {
+  char *chars;
+  size_t n_chars;
+  size_t chars_capacity;
+  struct entry *entries;
+  size_t n;
+  size_t capacity;
+};
+
+static void *grow(void *p, size_t *capacity, size_t needed, size_t size)
+{
+  size_t n = *capacity ? *capacity : 64;
+  void *q = NULL;
+
+  if (needed <= *capacity)
+    return p;
+  while (n < needed)
+    n *= 2;
+  if (!(q = realloc(p, n * size))) {
+    fprintf(stderr, "cpar-names: out of memory\n");
+    exit(1);
+  }
+  *capacity = n;
+  return q;
+}
+
+static void add(struct list *list,
+                const char *name,
+                size_t len,
+                uint32_t v,
+                const char *path,
+                size_t line_no)
+{
+  list->chars = (char *)grow(
+      list->chars, &list->chars_capacity, list->n_chars + len, 1);
+  list->entries = (struct entry *)grow(
+      list->entries, &list->capacity, list->n + 1, sizeof(struct entry));
+  memcpy(list->chars + list->n_chars, name, len);
+  list->entries[list->n].start = list->n_chars;
+  list->entries[list->n].len = len;
+  list->entries[list->n].value = v;
+  list->entries[list->n].path = path;
+  list->entries[list->n].line_no = line_no;
+  list->n_chars += len;
+  list->n++;
+}
+
+/* Whether the registry accepts a name, see cpar_names_new(). */
+static int valid_name(const char *name, size_t len)
+{
+  size_t i = 0;
+
+  while (i < len && strchr(" \t\n\v\f\r", name[i]) && name[i] != '\0')
+    i++;
+  if (i == len || name[i] == '#')
+    return 0;
+  for (; i < len; i++) {
+    if (name[i] == '\0' || name[i] == '(')
+      return 0;
+  }
+  return 1;
+}
+
+/* Reads the lines of one file into the list, returning the errors. */
+static int read_list(struct list *list, FILE *fp, const char *path)
+{
+  char *line = NULL;
+  size_t capacity = 0;
+  size_t line_no = 0;
+  int n_errors = 0;
+
+  for (;;) {
+    size_t len = 0;
+    int c = 0;
+    const char *comma = NULL;
+    const char *error = NULL;
+    enum cpar_status status = CPAR_STATUS_OK;
+    uint32_t value = 0;
+
+    while ((c = getc(fp)) != EOF && c != '\n') {
+      line = (char *)grow(line, &capacity, len + 1, 1);
+      line[len++] = (char)c;
+    }
+    if (c == EOF && len == 0)
+      break;
+    line_no++;
+    if (len > 0 && line[len - 1] == '\r')
+      len--;
+
+    if (len == 0 || line[0] == '#')
+      continue;
+    comma = (const char *)memchr(line, ',', len);
+    if (!comma) {
+      error = "expected a name, a comma and a colour";
+    } else if (!valid_name(line, (size_t)(comma - line))) {
+      error = "names can't be empty, contain '(' or start with '#'";
+    } else if ((status = cpar_color_parse_n(
+                    comma + 1, len - (size_t)(comma + 1 - line), &value)) !=
+               CPAR_STATUS_OK) {
+      error = cpar_strerror(status);
+    }
+    if (error) {
+      fprintf(stderr, "%s:%zu: %s\n", path, line_no, error);
+      n_errors++;
+      continue;
+    }
+    add(list, line, (size_t)(comma - line), value, path, line_no);
+  }
+
+  free(line);
+  if (ferror(fp)) {
+    perror(path);
+    n_errors++;
+  }
+  return n_errors;
+}
+
+static int compile(const char *output, char **inputs, int n_inputs)
+{
+  struct list list;
+  struct cpar_string *strs = NULL;
+  uint32_t *values = NULL;
+  struct cpar_names *names = NULL;
+  enum cpar_status status = CPAR_STATUS_OK;
+  int n_errors = 0;
+  void *image = NULL;
+  size_t size = 0;
+  size_t repeated = 0;
+  FILE *fp = NULL;
+
+  memset(&list, 0, sizeof(list));
+  if (n_inputs == 0)
+    n_errors += read_list(&list, stdin, "<stdin>");
+  for (int i = 0; i < n_inputs; i++) {
+    if (!(fp = fopen(inputs[i], "rb"))) {
+      perror(inputs[i]);
+      n_errors++;
+      continue;
+    }
+    n_errors += read_list(&list, fp, inputs[i]);
+    fclose(fp);
+  }
+  if (n_errors > 0)
+    return 1;
+
+  strs = (struct cpar_string *)malloc(sizeof(*strs) * (list.n + 1));
+  values = (uint32_t *)malloc(sizeof(*values) * (list.n + 1));
+  if (!strs || !values) {
+    fprintf(stderr, "cpar-names: out of memory\n");
+    return 1;
+  }
+  for (size_t i = 0; i < list.n; i++) {
+    strs[i].str = list.chars + list.entries[i].start;
+    strs[i].len = list.entries[i].len;
+    values[i] = list.entries[i].value;
+  }
+
+  if (list.n >= CPAR_NAMES_MAX) {
+    fprintf(stderr, "cpar-names: too many names, the limit is %lu\n",
+            (unsigned long)CPAR_NAMES_MAX - 1);
+    return 1;
+  }
+  if ((status = cpar_names_new(strs, values, list.n, &names, &repeated)) ==
+      CPAR_STATUS_DUPLICATE_NAME) {
+    fprintf(stderr, "%s:%zu: the name repeats an earlier one\n",
+            list.entries[repeated].path, list.entries[repeated].line_no);
+    return 1;
+  } else if (status != CPAR_STATUS_OK) {
+    fprintf(stderr, "cpar-names: %s\n", cpar_strerror(status));
+    return 1;
+  }
+
+  size = cpar_names_serialize(names, NULL, 0);
+  if (!(image = malloc(size))) {
+    fprintf(stderr, "cpar-names: out of memory\n");
+    return 1;
+  }
+  cpar_names_serialize(names, image, size);
+  if (!(fp = fopen(output, "wb")) || fwrite(image, 1, size, fp) != size ||
+      fclose(fp) != 0) {
+    perror(output);
+    return 1;
+  }
+
+  fprintf(stderr, "%s: %u names, %zu bytes\n", output,
+          (unsigned)cpar_names_count(names), size);
+  cpar_names_free(names);
+  free(image);
+  free(values);
+  free(strs);
+  free(list.chars);
+  free(list.entries);
+  return 0;
+}
+
+static int lookup(const char *path, char **strs, int n_strs)
+{
+  struct cpar_names *names = NULL;
+  enum cpar_status status = cpar_names_map(path, &names);
+  int result = 0;
+
+  if (status != CPAR_STATUS_OK) {
+    fprintf(stderr, "%s: %s\n", path, cpar_strerror(status));
+    return 1;
+  }
+
+  for (int i = 0; i < n_strs; i++) {
+    uint32_t value = 0;
+    char formatted[CPAR_FORMAT_MAX];
+    status = cpar_names_parse(names, strs[i], strlen(strs[i]), &value);
+    if (status != CPAR_STATUS_OK) {
+      printf("%s: %s\n", strs[i], cpar_strerror(status));
+      result = 1;
+      continue;
+    }
+    cpar_color_format(
+        value, CPAR_FORMAT_HEX_ALPHA, formatted, sizeof(formatted));
+    printf("%s: %s\n", strs[i], formatted);
+  }
+
+  cpar_names_free(names);
+  return result;
+}
+
+int main(int argc, char **argv)
+{
+  if (argc >= 3 && strcmp(argv[1], "compile") == 0)
+    return compile(argv[2], argv + 3, argc - 3);
+  if (argc >= 4 && strcmp(argv[1], "lookup") == 0)
+    return lookup(argv[2], argv + 3, argc - 3);
+
+  fprintf(stderr,
+          "usage: %s compile OUTPUT [INPUT...]\n"
+          "       %s lookup IMAGE NAME...\n",
+          argv[0], argv[0]);
+  return 2;
+}
@@ -0,0 +1,746 @@
+#!/usr/bin/env python3
+"""
+Generates the colour name tables in `src/cpar.h`.
+
+The named colours are listed in `COLOR_NAMES` below. Running this script
+rewrites the parts of `cpar.h` between the `BEGIN GENERATED COLOR NAMES` and
+`END GENERATED COLOR NAMES` markers, which hold the `CPAR_COLOR_NAME_LIST()`
+macro used by both the C and the C++ code, and between the `BEGIN GENERATED
+COLOR TABLES` and `END GENERATED COLOR TABLES` markers, so edit the list here
+rather than the header and then run:
+
+    python3 tools/gen_color_tables.py
+
+Name lookups use a minimal perfect hash built with the "hash, displace and
+compress" method: the FNV-1a hash of a name picks a bucket, and the bucket's
+displacement is mixed into the hash to pick a unique slot. The hash functions
+here must match `cpar_hash_byte()` and `cpar_mix32()` in the header.
+
+Reverse lookups binary search a table of the distinct colour values. Where
+several names share a value, the one that sorts first alphabetically is used.
+
+The lookup tables for the pixel conversions, between the `BEGIN GENERATED
+PIXEL TABLES` and `END GENERATED PIXEL TABLES` markers, are generated too.
+
+So are the tables for the colour space conversions, between the `BEGIN
+GENERATED COLOR SPACE TABLES` and `END GENERATED COLOR SPACE TABLES` markers,
+as macros which the C code and the constexpr C++ code both expand and then
+undefine, and the grids for finding the nearest named colour, between the
+`BEGIN GENERATED NEAREST TABLES` and `END GENERATED NEAREST TABLES` markers.
+The RGB cube, and the box around the sRGB gamut in OKLab, are split into
+cells, and each cell lists the named colours which are nearest to some point
+in it: any colour whose distance to the cell is at most the smallest distance
+from another colour to the far side of the cell. A search then only measures
+the distance to those few colours, and still finds the exact nearest one.
+"""
+
+import math
+import os
+import struct
+import sys
+
+# CSS Color Module Level 4 named colours, in alphabetical order. Entries are
+# (name, r, g, b) or, for the few that aren't opaque, (name, r, g, b, a).
+COLOR_NAMES = [
+    ("aliceblue", 240, 248, 255),
+    ("antiquewhite", 250, 235, 215),
+    ("aqua", 0, 255, 255),
+    ("aquamarine", 127, 255, 212),
+    ("azure", 240, 255, 255),
+    ("beige", 245, 245, 220),
+    ("bisque", 255, 228, 196),
+    ("black", 0, 0, 0),
+    ("blanchedalmond", 255, 235, 205),
+    ("blue", 0, 0, 255),
+    ("blueviolet", 138, 43, 226),
+    ("brown", 165, 42, 42),
+    ("burlywood", 222, 184, 135),
+    ("cadetblue", 95, 158, 160),
+    ("chartreuse", 127, 255, 0),
+    ("chocolate", 210, 105, 30),
+    ("coral", 255, 127, 80),
+    ("cornflowerblue", 100, 149, 237),
+    ("cornsilk", 255, 248, 220),
+    ("crimson", 220, 20, 60),
+    ("cyan", 0, 255, 255),
+    ("darkblue", 0, 0, 139),
+    ("darkcyan", 0, 139, 139),
+    ("darkgoldenrod", 184, 134, 11),
+    ("darkgray", 169, 169, 169),
+    ("darkgreen", 0, 100, 0),
+    ("darkgrey", 169, 169, 169),
+    ("darkkhaki", 189, 183, 107),
+    ("darkmagenta", 139, 0, 139),
+    ("darkolivegreen", 85, 107, 47),
+    ("darkorange", 255, 140, 0),
+    ("darkorchid", 153, 50, 204),
+    ("darkred", 139, 0, 0),
+    ("darksalmon", 233, 150, 122),
+    ("darkseagreen", 143, 188, 143),
+    ("darkslateblue", 72, 61, 139),
+    ("darkslategray", 47, 79, 79),
+    ("darkslategrey", 47, 79, 79),
+    ("darkturquoise", 0, 206, 209),
+    ("darkviolet", 148, 0, 211),
+    ("deeppink", 255, 20, 147),
+    ("deepskyblue", 0, 191, 255),
+    ("dimgray", 105, 105, 105),
+    ("dimgrey", 105, 105, 105),
+    ("dodgerblue", 30, 144, 255),
+    ("firebrick", 178, 34, 34),
+    ("floralwhite", 255, 250, 240),
+    ("forestgreen", 34, 139, 34),
+    ("fuchsia", 255, 0, 255),
+    ("gainsboro", 220, 220, 220),
+    ("ghostwhite", 248, 248, 255),
+    ("gold", 255, 215, 0),
+    ("goldenrod", 218, 165, 32),
+    ("gray", 128, 128, 128),
+    ("green", 0, 128, 0),
+    ("greenyellow", 173, 255, 47),
+    ("grey", 128, 128, 128),
+    ("honeydew", 240, 255, 240),
+    ("hotpink", 255, 105, 180),
+    ("indianred", 205, 92, 92),
+    ("indigo", 75, 0, 130),
+    ("ivory", 255, 255, 240),
+    ("khaki", 240, 230, 140),
+    ("lavender", 230, 230, 250),
+    ("lavenderblush", 255, 240, 245),
+    ("lawngreen", 124, 252, 0),
+    ("lemonchiffon", 255, 250, 205),
+    ("lightblue", 173, 216, 230),
+    ("lightcoral", 240, 128, 128),
+    ("lightcyan", 224, 255, 255),
+    ("lightgoldenrodyellow", 250, 250, 210),
+    ("lightgray", 211, 211, 211),
+    ("lightgreen", 144, 238, 144),
+    ("lightgrey", 211, 211, 211),
+    ("lightpink", 255, 182, 193),
+    ("lightsalmon", 255, 160, 122),
+    ("lightseagreen", 32, 178, 170),
+    ("lightskyblue", 135, 206, 250),
+    ("lightslategray", 119, 136, 153),
+    ("lightslategrey", 119, 136, 153),
+    ("lightsteelblue", 176, 196, 222),
+    ("lightyellow", 255, 255, 224),
+    ("lime", 0, 255, 0),
+    ("limegreen", 50, 205, 50),
+    ("linen", 250, 240, 230),
+    ("magenta", 255, 0, 255),
+    ("maroon", 128, 0, 0),
+    ("mediumaquamarine", 102, 205, 170),
+    ("mediumblue", 0, 0, 205),
+    ("mediumorchid", 186, 85, 211),
+    ("mediumpurple", 147, 112, 219),
+    ("mediumseagreen", 60, 179, 113),
+    ("mediumslateblue", 123, 104, 238),
+    ("mediumspringgreen", 0, 250, 154),
+    ("mediumturquoise", 72, 209, 204),
+    ("mediumvioletred", 199, 21, 133),
+    ("midnightblue", 25, 25, 112),
+    ("mintcream", 245, 255, 250),
+    ("mistyrose", 255, 228, 225),
+    ("moccasin", 255, 228, 181),
+    ("navajowhite", 255, 222, 173),
+    ("navy", 0, 0, 128),
+    ("oldlace", 253, 245, 230),
+    ("olive", 128, 128, 0),
+    ("olivedrab", 107, 142, 35),
+    ("orange", 255, 165, 0),
+    ("orangered", 255, 69, 0),
+    ("orchid", 218, 112, 214),
+    ("palegoldenrod", 238, 232, 170),
+    ("palegreen", 152, 251, 152),
+    ("paleturquoise", 175, 238, 238),
+    ("palevioletred", 219, 112, 147),
+    ("papayawhip", 255, 239, 213),
+    ("peachpuff", 255, 218, 185),
+    ("peru", 205, 133, 63),
+    ("pink", 255, 192, 203),
+    ("plum", 221, 160, 221),
+    ("powderblue", 176, 224, 230),
+    ("purple", 128, 0, 128),
+    ("rebeccapurple", 102, 51, 153),
+    ("red", 255, 0, 0),
+    ("rosybrown", 188, 143, 143),
+    ("royalblue", 65, 105, 225),
+    ("saddlebrown", 139, 69, 19),
+    ("salmon", 250, 128, 114),
+    ("sandybrown", 244, 164, 96),
+    ("seagreen", 46, 139, 87),
+    ("seashell", 255, 245, 238),
+    ("sienna", 160, 82, 45),
+    ("silver", 192, 192, 192),
+    ("skyblue", 135, 206, 235),
+    ("slateblue", 106, 90, 205),
+    ("slategray", 112, 128, 144),
+    ("slategrey", 112, 128, 144),
+    ("snow", 255, 250, 250),
+    ("springgreen", 0, 255, 127),
+    ("steelblue", 70, 130, 180),
+    ("tan", 210, 180, 140),
+    ("teal", 0, 128, 128),
+    ("thistle", 216, 191, 216),
+    ("tomato", 255, 99, 71),
+    ("transparent", 0, 0, 0, 0),
+    ("turquoise", 64, 224, 208),
+    ("violet", 238, 130, 238),
+    ("wheat", 245, 222, 179),
+    ("white", 255, 255, 255),
+    ("whitesmoke", 245, 245, 245),
+    ("yellow", 255, 255, 0),
+    ("yellowgreen", 154, 205, 50),
+]
+
+HEADER = os.path.join(os.path.dirname(os.path.abspath(__file__)), "..", "src",
+                      "cpar.h")
+
+NAMES_BEGIN_MARKER = "/* BEGIN GENERATED COLOR NAMES"
+NAMES_END_MARKER = "/* END GENERATED COLOR NAMES */"
+TABLES_BEGIN_MARKER = "/* BEGIN GENERATED COLOR TABLES"
+TABLES_END_MARKER = "/* END GENERATED COLOR TABLES */"
+PIXELS_BEGIN_MARKER = "/* BEGIN GENERATED PIXEL TABLES"
+PIXELS_END_MARKER = "/* END GENERATED PIXEL TABLES */"
+SPACES_BEGIN_MARKER = "/* BEGIN GENERATED COLOR SPACE TABLES"
+SPACES_END_MARKER = "/* END GENERATED COLOR SPACE TABLES */"
+NEAREST_BEGIN_MARKER = "/* BEGIN GENERATED NEAREST TABLES"
+NEAREST_END_MARKER = "/* END GENERATED NEAREST TABLES */"
+
+KEYS_PER_BUCKET = 4
+MAX_DISPLACEMENT = 0xFFFF
+
+# buckets of the table which starts the search for the sRGB encoding of a
+# linear value, which must be narrower than the steps between the encodings
+LINEAR_BUCKETS = 4096
+
+# the fixed point scale of relative luminance, a multiple of 20 so that the
+# 0.05 which WCAG adds to luminances is exact, and small enough that the
+# luminances are exact as floats and 9 times them fit in 31 bits
+LUMINANCE_SCALE = 20 << 19
+LUMINANCE_WEIGHTS = (0.2126, 0.7152, 0.0722)
+
+# cells along each axis of the nearest colour grids
+NEAREST_GRID = 8
+# how far the OKLab grid cells are widened, and the slack in the distances,
+# which cover the rounding of the single-precision search
+NEAREST_OKLAB_PAD = 1e-4
+NEAREST_OKLAB_SLACK = 1e-5
+
+
+def fnv1a(data):
+    h = 0x811C9DC5
+    for c in data.encode("ascii"):
+        h ^= c
+        h = (h * 0x01000193) & 0xFFFFFFFF
+    return h
+
+
+def mix32(h):
+    h ^= h >> 16
+    h = (h * 0x85EBCA6B) & 0xFFFFFFFF
+    h ^= h >> 13
+    h = (h * 0xC2B2AE35) & 0xFFFFFFFF
+    h ^= h >> 16
+    return h
+
+
+def build_perfect_hash(keys):
+    """Returns (displacements, slots) where slots maps slot -> key index."""
+    n_keys = len(keys)
+    n_buckets = (n_keys + KEYS_PER_BUCKET - 1) // KEYS_PER_BUCKET
+    hashes = [fnv1a(k) for k in keys]
+
+    buckets = [[] for _ in range(n_buckets)]
+    for i, h in enumerate(hashes):
+        buckets[h % n_buckets].append(i)
+
+    displacements = [0] * n_buckets
+    slots = [None] * n_keys
+    order = sorted(range(n_buckets), key=lambda b: -len(buckets[b]))
+
+    for b in order:
+        if not buckets[b]:
+            continue
+        for d in range(MAX_DISPLACEMENT + 1):
+            wanted = [mix32(hashes[i] ^ d) % n_keys for i in buckets[b]]
+            if len(set(wanted)) == len(wanted) and \
+               all(slots[s] is None for s in wanted):
+                for i, s in zip(buckets[b], wanted):
+                    slots[s] = i
+                displacements[b] = d
+                break
+        else:
+            sys.exit("failed to find a displacement for bucket %d" % b)
+
+    return displacements, slots
+
+
+def with_alpha(color):
+    """Returns (name, r, g, b, a) for an entry of COLOR_NAMES."""
+    return color if len(color) == 5 else color + (255,)
+
+
+def build_value_index(colors):
+    """Returns (values, names) sorted by value, first name wins on ties."""
+    index = {}
+    for i, (_, r, g, b, a) in enumerate(map(with_alpha, colors)):
+        value = (r << 24) | (g << 16) | (b << 8) | a
+        index.setdefault(value, i)
+    values = sorted(index)
+    return values, [index[v] for v in values]
+
+
+def format_floats(values):
+    out = []
+    for v in values:
+        v = "%.9g" % v
+        out.append(v + ("f" if "." in v or "e" in v else ".0f"))
+    return out
+
+
+def to_float(x):
+    """Rounds x to single precision."""
+    return struct.unpack("f", struct.pack("f", x))[0]
+
+
+def format_array(values, indent="    ", width=80):
+    lines = []
+    line = indent
+    for v in values:
+        item = "%s," % v
+        if len(line) + len(item) + 1 > width:
+            lines.append(line.rstrip())
+            line = indent
+        line += item + " "
+    lines.append(line.rstrip())
+    return "\n".join(lines)
+
+
+def format_macro(name, values):
+    """Formats a macro which expands to the values, separated by commas."""
+    lines = ["#define %s" % name]
+    lines += format_array(values, indent="  ", width=77).split("\n")
+    width = max(len(line) for line in lines) + 1
+    return "\n".join([line.ljust(width) + "\\" for line in lines[:-1]] +
+                     [lines[-1]])
+
+
+def check_names():
+    names = [c[0] for c in COLOR_NAMES]
+    assert names == sorted(names), "COLOR_NAMES must be sorted"
+    assert len(set(names)) == len(names), "COLOR_NAMES has duplicates"
+    return names
+
+
+def generate_names():
+    items = ['X("%s", %d, %d, %d, %d)' % with_alpha(c) for c in COLOR_NAMES]
+    lines = ["#define CPAR_COLOR_NAME_LIST(X)"] + ["  " + i for i in items]
+    width = max(len(line) for line in lines) + 1
+
+    out = []
+    out.append("%s: do not edit, see tools/gen_color_tables.py */"
+               % NAMES_BEGIN_MARKER)
+    out.append("")
+    out.append("/**")
+    out.append(" * Expands to `X(name, r, g, b, a)` for each of the named colours, in")
+    out.append(" * alphabetical order.")
+    out.append(" */")
+    for line in lines[:-1]:
+        out.append(line.ljust(width) + "\\")
+    out.append(lines[-1])
+    out.append("")
+    out.append(NAMES_END_MARKER)
+    return "\n".join(out)
+
+
+def generate_tables():
+    names = check_names()
+    displacements, slots = build_perfect_hash(names)
+    n_buckets = len(displacements)
+    values, value_names = build_value_index(COLOR_NAMES)
+    offsets = [0]
+    for name in names:
+        offsets.append(offsets[-1] + len(name) + 1)
+    assert offsets[-1] <= 0xFFFF, "the names don't fit 16-bit offsets"
+
+    out = []
+    out.append("%s: do not edit, see tools/gen_color_tables.py */"
+               % TABLES_BEGIN_MARKER)
+    out.append("")
+    out.append("#define CPAR_N_COLOR_NAMES %d" % len(names))
+    out.append("#define CPAR_N_COLOR_NAME_BUCKETS %d" % n_buckets)
+    out.append("#define CPAR_N_COLOR_VALUES %d" % len(values))
+    out.append("#define CPAR_MAX_COLOR_NAME_LEN %d" % max(map(len, names)))
+    out.append("")
+    out.append("/*")
+    out.append(" * The names are stored as a structure of arrays: every name in one")
+    out.append(" * block, each followed by a NUL, the offset of each in the block and")
+    out.append(" * the values separately. There are no pointers to relocate, and the")
+    out.append(" * length of name i is the difference of offsets i + 1 and i, less one.")
+    out.append(" */")
+    out.append("static const char cpar_color_names[] =")
+    out.append("#define CPAR_COLOR_NAME_ENTRY(name, r, g, b, a) name \"\\0\"")
+    out.append("    CPAR_COLOR_NAME_LIST(CPAR_COLOR_NAME_ENTRY);")
+    out.append("#undef CPAR_COLOR_NAME_ENTRY")
+    out.append("")
+    out.append("static const uint16_t")
+    out.append("    cpar_color_name_offsets[CPAR_N_COLOR_NAMES + 1] = {")
+    out.append(format_array(offsets))
+    out.append("};")
+    out.append("")
+    out.append("static const uint32_t cpar_color_name_values[CPAR_N_COLOR_NAMES] = {")
+    out.append("#define CPAR_COLOR_NAME_ENTRY(name, r, g, b, a) \\")
+    out.append("  CPAR_COLOR_MAKE(r, g, b, a),")
+    out.append("    CPAR_COLOR_NAME_LIST(CPAR_COLOR_NAME_ENTRY)")
+    out.append("#undef CPAR_COLOR_NAME_ENTRY")
+    out.append("};")
+    out.append("")
+    out.append("/* Per-bucket displacements of the perfect hash. */")
+    out.append("static const uint16_t")
+    out.append("    cpar_color_name_displacements[CPAR_N_COLOR_NAME_BUCKETS]"
+               " = {")
+    out.append(format_array(displacements))
+    out.append("};")
+    out.append("")
+    out.append("/* Maps each perfect hash slot to an index in the name table. */")
+    out.append("static const uint8_t cpar_color_name_slots[CPAR_N_COLOR_NAMES]"
+               " = {")
+    out.append(format_array(slots))
+    out.append("};")
+    out.append("")
+    out.append("/* The distinct colour values in ascending order. */")
+    out.append("static const uint32_t cpar_color_value_table[CPAR_N_COLOR_VALUES]"
+               " = {")
+    out.append(format_array(["0x%08xu" % v for v in values]))
+    out.append("};")
+    out.append("")
+    out.append("/* Maps each entry of the value table to an index in the name "
+               "table. */")
+    out.append("static const uint8_t cpar_color_value_names[CPAR_N_COLOR_VALUES]"
+               " = {")
+    out.append(format_array(value_names))
+    out.append("};")
+    out.append("")
+    out.append(TABLES_END_MARKER)
+    return "\n".join(out)
+
+
+def srgb_to_linear(c):
+    return c / 12.92 if c <= 0.04045 else ((c + 0.055) / 1.055) ** 2.4
+
+
+def linear_to_srgb(c):
+    return c * 12.92 if c <= 0.0031308 else 1.055 * c ** (1 / 2.4) - 0.055
+
+
+def to_byte(c):
+    return int(math.floor(c * 255 + 0.5))
+
+
+def generate_pixel_tables():
+    to_linear = [to_byte(srgb_to_linear(i / 255)) for i in range(256)]
+    to_srgb = [to_byte(linear_to_srgb(i / 255)) for i in range(256)]
+    # x * ceil(2^24 / a) >> 24 is exactly floor(x / a) for any 16-bit x
+    recip = [0] + [-(-(1 << 24) // a) for a in range(1, 256)]
+
+    out = []
+    out.append("%s: do not edit, see tools/gen_color_tables.py */"
+               % PIXELS_BEGIN_MARKER)
+    out.append("")
+    out.append("/* Each 8-bit sRGB-encoded value converted to linear light. */")
+    out.append("static const uint8_t cpar_srgb_to_linear_table[256] = {")
+    out.append(format_array(to_linear))
+    out.append("};")
+    out.append("")
+    out.append("/* Each 8-bit linear value converted to the sRGB encoding. */")
+    out.append("static const uint8_t cpar_linear_to_srgb_table[256] = {")
+    out.append(format_array(to_srgb))
+    out.append("};")
+    out.append("")
+    out.append("/* Multipliers which divide by each alpha value, see "
+               "cpar_unpremultiply(). */")
+    out.append("static const uint32_t cpar_unpremultiply_table[256] = {")
+    out.append(format_array(recip))
+    out.append("};")
+    out.append("")
+    out.append("/* See CPAR_SRGB_MIDPOINT_FLOATS and CPAR_LINEAR_BUCKET_VALUES. */")
+    out.append("#define CPAR_LINEAR_BUCKETS %d" % LINEAR_BUCKETS)
+    out.append("#ifdef __cplusplus")
+    out.append("static const float (&cpar_srgb_midpoints)[255] = "
+               "cpar::detail::srgb_midpoints;")
+    out.append("static const uint8_t (&cpar_linear_bucket_table)"
+               "[CPAR_LINEAR_BUCKETS + 3] =")
+    out.append("    cpar::detail::linear_buckets;")
+    out.append("#else")
+    out.append("static const float cpar_srgb_midpoints[255] = "
+               "{CPAR_SRGB_MIDPOINT_FLOATS};")
+    out.append("static const uint8_t cpar_linear_bucket_table"
+               "[CPAR_LINEAR_BUCKETS + 3] = {")
+    out.append("    CPAR_LINEAR_BUCKET_VALUES};")
+    out.append("#undef CPAR_SRGB_TO_LINEAR_FLOATS")
+    out.append("#undef CPAR_SRGB_MIDPOINT_FLOATS")
+    out.append("#undef CPAR_LINEAR_BUCKET_VALUES")
+    out.append("#endif")
+    out.append("")
+    out.append("/* The weighted relative luminance of each 8-bit red, green and "
+               "blue value,")
+    out.append(" * scaled by CPAR_LUMINANCE_SCALE. */")
+    out.append("#define CPAR_LUMINANCE_SCALE %d" % LUMINANCE_SCALE)
+    out.append("static const uint32_t cpar_luminance_table[3][256] = {")
+    for table in luminance_tables():
+        out.append("    {")
+        out.append(format_array(table, indent="        "))
+        out.append("    },")
+    out.append("};")
+    out.append("")
+    out.append(PIXELS_END_MARKER)
+    return "\n".join(out)
+
+
+def linear_encoding():
+    """Returns the midpoints between the linear values of the 8-bit sRGB
+    values, as floats, and the encodings of the start of each bucket.
+
+    The encoding of a linear value x is the number of midpoints which are at
+    most x. Each bucket holds at most one midpoint, so the encoding is the
+    bucket's, plus one if x is at least the next midpoint."""
+    midpoints = [to_float(srgb_to_linear((k + 0.5) / 255))
+                 for k in range(255)]
+    buckets = []
+    k = 0
+    for i in range(LINEAR_BUCKETS):
+        x = i / LINEAR_BUCKETS
+        while k < 255 and midpoints[k] <= x:
+            k += 1
+        buckets.append(k)
+        end = (i + 1) / LINEAR_BUCKETS
+        assert k == 255 or k == 254 or midpoints[k + 1] >= end
+    return midpoints, buckets
+
+
+def luminance_tables():
+    """Returns the rounded luminance of each component value, adjusted so
+    that white is exactly LUMINANCE_SCALE."""
+    tables = [[round(w * srgb_to_linear(i / 255) * LUMINANCE_SCALE)
+               for i in range(256)] for w in LUMINANCE_WEIGHTS]
+    tables[1][255] += LUMINANCE_SCALE - sum(t[255] for t in tables)
+    for t in tables:
+        assert all(a < b for a, b in zip(t, t[1:]))
+    assert 9 * (LUMINANCE_SCALE + LUMINANCE_SCALE // 20) < 1 << 31
+    assert LUMINANCE_SCALE + LUMINANCE_SCALE // 20 < 1 << 24
+    return tables
+
+
+def generate_space_tables():
+    midpoints, buckets = linear_encoding()
+    out = []
+    out.append("%s: do not edit," % SPACES_BEGIN_MARKER)
+    out.append(" * see tools/gen_color_tables.py */")
+    out.append("")
+    out.append("/*")
+    out.append(" * The tables of the colour space conversions, as lists for "
+               "initializers so")
+    out.append(" * that the C implementation and the constexpr conversions in "
+               "C++ share")
+    out.append(" * them. CPAR_SRGB_TO_LINEAR_FLOATS is each 8-bit sRGB-encoded "
+               "value in")
+    out.append(" * linear light, and CPAR_SRGB_MIDPOINT_FLOATS the linear "
+               "values halfway")
+    out.append(" * between each one and the next. CPAR_LINEAR_BUCKET_VALUES is "
+               "the sRGB")
+    out.append(" * encoding of the start of each 1/%d of linear light, padded "
+               "so that it" % LINEAR_BUCKETS)
+    out.append(" * can be read 4 bytes at a time.")
+    out.append(" *")
+    out.append(" * They're only defined where they're needed, the first time "
+               "the header is")
+    out.append(" * included in C++ and for the implementation in C, and are "
+               "undefined once")
+    out.append(" * the arrays are, so they aren't part of the API.")
+    out.append(" */")
+    out.append("#if defined(__cplusplus) ? !defined(CPAR_HPP) "
+               ": defined(CPAR_IMPLEMENTATION)")
+    out.append("")
+    out.append(format_macro("CPAR_SRGB_TO_LINEAR_FLOATS",
+                            format_floats(srgb_to_linear(i / 255)
+                                          for i in range(256))))
+    out.append("")
+    out.append(format_macro("CPAR_SRGB_MIDPOINT_FLOATS",
+                            format_floats(midpoints)))
+    out.append("")
+    out.append(format_macro("CPAR_LINEAR_BUCKET_VALUES", buckets + [255] * 3))
+    out.append("")
+    out.append("#endif")
+    out.append("")
+    out.append(SPACES_END_MARKER)
+    return "\n".join(out)
+
+
+def oklab(r, g, b):
+    """Converts 8-bit sRGB to OKLab, as cpar_oklab_from_rgb() does."""
+    lin = [srgb_to_linear(c / 255) for c in (r, g, b)]
+    lms = [sum(k * c for k, c in zip(row, lin)) for row in OKLAB_M1]
+    lms = [c ** (1 / 3) for c in lms]
+    return [sum(k * c for k, c in zip(row, lms)) for row in OKLAB_M2]
+
+
+OKLAB_M1 = [
+    [0.4122214708, 0.5363325363, 0.0514459929],
+    [0.2119034982, 0.6806995451, 0.1073969566],
+    [0.0883024619, 0.2817188376, 0.6299787005],
+]
+OKLAB_M2 = [
+    [0.2104542553, 0.7936177850, -0.0040720468],
+    [1.9779984951, -2.4285922050, 0.4505937099],
+    [0.0259040371, 0.7827717662, -0.8086757660],
+]
+
+
+def oklab_gamut():
+    """Returns the bounds of the sRGB gamut in OKLab, from the cube's faces
+    where the extremes are."""
+    lo = [math.inf] * 3
+    hi = [-math.inf] * 3
+    for x in range(256):
+        for y in range(256):
+            for face in (0, 255):
+                for rgb in ((face, x, y), (x, face, y), (x, y, face)):
+                    for k, c in enumerate(oklab(*rgb)):
+                        lo[k] = min(lo[k], c)
+                        hi[k] = max(hi[k], c)
+    return lo, hi
+
+
+def build_grid(points, cell_bounds, slack):
+    """Returns (offsets, candidates) for the cells in the grid order, where
+    cell_bounds(i, j, k) gives the (low, high) corners of a cell."""
+    offsets = [0]
+    candidates = []
+    for i in range(NEAREST_GRID):
+        for j in range(NEAREST_GRID):
+            for k in range(NEAREST_GRID):
+                lo, hi = cell_bounds(i, j, k)
+                near = []
+                far = []
+                for _, p in points:
+                    near.append(sum(max(l - c, 0, c - h) ** 2
+                                    for c, l, h in zip(p, lo, hi)))
+                    far.append(sum(max(c - l, h - c) ** 2
+                                   for c, l, h in zip(p, lo, hi)))
+                limit = min(far) + slack
+                candidates += [index for (index, _), d in zip(points, near)
+                               if d <= limit]
+                offsets.append(len(candidates))
+    return offsets, candidates
+
+
+def generate_nearest_tables():
+    values, _ = build_value_index(COLOR_NAMES)
+    rgbs = [((v >> 24) & 0xFF, (v >> 16) & 0xFF, (v >> 8) & 0xFF)
+            for v in values]
+    labs = [oklab(*rgb) for rgb in rgbs]
+    opaque = [i for i, v in enumerate(values) if v & 0xFF == 0xFF]
+
+    step = 256 // NEAREST_GRID
+    rgb_offsets, rgb_candidates = build_grid(
+        [(i, rgbs[i]) for i in opaque],
+        lambda *cell: ([c * step for c in cell],
+                       [c * step + step - 1 for c in cell]), 0)
+
+    gamut_lo, gamut_hi = oklab_gamut()
+    gamut_lo = [c - NEAREST_OKLAB_PAD for c in gamut_lo]
+    gamut_hi = [c + NEAREST_OKLAB_PAD for c in gamut_hi]
+    size = [(h - l) / NEAREST_GRID for l, h in zip(gamut_lo, gamut_hi)]
+    lab_offsets, lab_candidates = build_grid(
+        [(i, labs[i]) for i in opaque],
+        lambda *cell: ([l + c * s - NEAREST_OKLAB_PAD
+                        for c, l, s in zip(cell, gamut_lo, size)],
+                       [l + (c + 1) * s + NEAREST_OKLAB_PAD
+                        for c, l, s in zip(cell, gamut_lo, size)]),
+        NEAREST_OKLAB_SLACK)
+    assert max(rgb_offsets[-1], lab_offsets[-1]) <= 0xFFFF
+
+    n_cells = NEAREST_GRID ** 3
+    out = []
+    out.append("%s: do not edit, see tools/gen_color_tables.py */"
+               % NEAREST_BEGIN_MARKER)
+    out.append("")
+    out.append("#define CPAR_NEAREST_GRID %d" % NEAREST_GRID)
+    out.append("")
+    out.append("/* The OKLab coordinates of each entry of the value table. */")
+    out.append("static const float cpar_color_value_oklab[CPAR_N_COLOR_VALUES]"
+               "[3] = {")
+    for lab in labs:
+        out.append("    {%s}," % ", ".join(format_floats(lab)))
+    out.append("};")
+    out.append("")
+    out.append("/* The corner of the OKLab grid and the cells per unit. */")
+    out.append("static const float cpar_oklab_grid_min[3] = {")
+    out.append("    %s," % ", ".join(format_floats(gamut_lo)))
+    out.append("};")
+    out.append("static const float cpar_oklab_grid_scale[3] = {")
+    out.append("    %s," % ", ".join(format_floats(1 / s for s in size)))
+    out.append("};")
+    out.append("")
+    for name, offsets, candidates in (
+            ("rgb", rgb_offsets, rgb_candidates),
+            ("oklab", lab_offsets, lab_candidates)):
+        out.append("/* The candidates of cell i of the %s grid are entries "
+                   "offsets[i] to" % ("RGB" if name == "rgb" else "OKLab"))
+        out.append(" * offsets[i + 1] - 1 of the candidates, which are "
+                   "indices in the value")
+        out.append(" * table. */")
+        out.append("static const uint16_t cpar_nearest_%s_offsets[%d] = {"
+                   % (name, n_cells + 1))
+        out.append(format_array(offsets))
+        out.append("};")
+        out.append("")
+        out.append("static const uint8_t cpar_nearest_%s_candidates[%d] = {"
+                   % (name, len(candidates)))
+        out.append(format_array(candidates))
+        out.append("};")
+        out.append("")
+    out.append("/* See CPAR_SRGB_TO_LINEAR_FLOATS. */")
+    out.append("#ifdef __cplusplus")
+    out.append("static const float (&cpar_srgb_to_linear_float)[256] =")
+    out.append("    cpar::detail::srgb_to_linear;")
+    out.append("#else")
+    out.append("static const float cpar_srgb_to_linear_float[256] = {")
+    out.append("    CPAR_SRGB_TO_LINEAR_FLOATS};")
+    out.append("#endif")
+    out.append("")
+    out.append(NEAREST_END_MARKER)
+    return "\n".join(out)
+
+
+def replace_region(text, begin_marker, end_marker, region):
+    begin = text.find(begin_marker)
+    end = text.find(end_marker)
+    if begin < 0 or end < 0:
+        sys.exit("generated markers '%s' not found in %s"
+                 % (begin_marker, HEADER))
+    end += len(end_marker)
+    return text[:begin] + region + text[end:]
+
+
+def main():
+    with open(HEADER) as f:
+        text = f.read()
+
+    text = replace_region(text, NAMES_BEGIN_MARKER, NAMES_END_MARKER,
+                          generate_names())
+    text = replace_region(text, TABLES_BEGIN_MARKER, TABLES_END_MARKER,
+                          generate_tables())
+    text = replace_region(text, PIXELS_BEGIN_MARKER, PIXELS_END_MARKER,
+                          generate_pixel_tables())
+    text = replace_region(text, NEAREST_BEGIN_MARKER, NEAREST_END_MARKER,
+                          generate_nearest_tables())
+    text = replace_region(text, SPACES_BEGIN_MARKER, SPACES_END_MARKER,
+                          generate_space_tables())
+    with open(HEADER, "w") as f:
+        f.write(text)
+
+
+if __name__ == "__main__":
+    main()